@@ -40,6 +40,8 @@
 
 #cmakedefine HAVE_FCNTL_H         1
 
+#cmakedefine HAVE_PTHREAD_H       1
+
 #cmakedefine HAVE_MATH_H          1
 
 #cmakedefine HAVE_STDIO_H         1
@@ -72,6 +74,10 @@
 
 #cmakedefine CTPP_MAX_TEMPLATE_RECURSION_DEPTH ${CTPP_MAX_TEMPLATE_RECURSION_DEPTH}
 
+#cmakedefine PARALLEL_SORT       1
+
+#cmakedefine CTPP_PARALLEL_SORT_THRESHOLD ${CTPP_PARALLEL_SORT_THRESHOLD}
+
 #cmakedefine ICU_SUPPORT         1
 
 #cmakedefine ICONV_SUPPORT       1
@@ -80,6 +86,8 @@
 
 #cmakedefine ICONV_TRANSLITERATE 1
 
+#cmakedefine ZLIB_SUPPORT        1
+
 #cmakedefine CTPP_VERSION         "${CTPP_VERSION}"
 #cmakedefine CTPP_IDENT           "${CTPP_IDENT}"
 #cmakedefine CTPP_MASTER_SITE_URL "${CTPP_MASTER_SITE_URL}"
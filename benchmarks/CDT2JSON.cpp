@@ -40,6 +40,71 @@ unsigned long getMSTime() {
 }
 #endif
 
+// Reference conversion, one character at a time; does not share code with CDT2JSON and DumpCDT2JSON
+void referenceString(const STLW::string & sData, STLW::string & sResult) {
+	static const char hexChars[] = "0123456789abcdef";
+	sResult.append(1, '"');
+	for (size_t i = 0; i < sData.size(); ++i) {
+		const unsigned char ch = sData[i];
+		switch (ch) {
+			case '"':  sResult.append("\\\""); continue;
+			case '\\': sResult.append("\\\\"); continue;
+			case '/':  sResult.append("\\/");  continue;
+			case '\b': sResult.append("\\b");  continue;
+			case '\f': sResult.append("\\f");  continue;
+			case '\n': sResult.append("\\n");  continue;
+			case '\r': sResult.append("\\r");  continue;
+			case '\t': sResult.append("\\t");  continue;
+			default: break;
+		}
+		// U+2028 and U+2029 are line terminators in JavaScript
+		if (ch == 0xE2 && i + 2 < sData.size() && (unsigned char)sData[i + 1] == 0x80 && ((unsigned char)sData[i + 2] == 0xA8 || (unsigned char)sData[i + 2] == 0xA9)) {
+			sResult.append((unsigned char)sData[i + 2] == 0xA8 ? "\\u2028" : "\\u2029");
+			i += 2;
+			continue;
+		}
+		if (ch < 0x20) {
+			sResult.append("\\u00");
+			sResult.append(1, hexChars[ch >> 4]);
+			sResult.append(1, hexChars[ch & 0x0F]);
+			continue;
+		}
+		sResult.append(1, ch);
+	}
+	sResult.append(1, '"');
+}
+
+void referenceJSON(const CDT & cdt, STLW::string & sResult) {
+	switch (cdt.GetType()) {
+		case CDT::UNDEF:
+			sResult.append("null");
+			break;
+		case CDT::STRING_VAL:
+			referenceString(cdt.GetString(), sResult);
+			break;
+		case CDT::ARRAY_VAL:
+			sResult.append(1, '[');
+			for (UINT_32 i = 0; i < cdt.Size(); ++i) {
+				if (i != 0) { sResult.append(1, ','); }
+				referenceJSON(cdt.GetCDT(i), sResult);
+			}
+			sResult.append(1, ']');
+			break;
+		case CDT::HASH_VAL:
+			sResult.append(1, '{');
+			for (CDT::ConstIterator it = cdt.Begin(); it != cdt.End(); ++it) {
+				if (it != cdt.Begin()) { sResult.append(1, ','); }
+				referenceString(it -> first, sResult);
+				sResult.append(1, ':');
+				referenceJSON(it -> second, sResult);
+			}
+			sResult.append(1, '}');
+			break;
+		default:
+			sResult.append(cdt.GetString());
+	}
+}
+
 void usage(const char * name) {
 	cout << "Usage:\n\t" << name << " -[t|b] filename \n\t\t -t - test stream and non-stream CDT to JSON conversions\n\t\t -b - run stream vs non-stream CDT to JSON conversions benchmark\n\t filename - name of file with JSON object which will be used in test/benchmark" << endl;
 }
@@ -90,9 +155,12 @@ int main(int argc, char ** argv) {
 	DumpBuffer ss;
 	DumpCDT2JSON(cdt, ss);
 	s2.assign(ss.Data(), ss.Data() + ss.Size());
-	if(s1 != s2) {
+	STLW::string reference;
+	referenceJSON(cdt, reference);
+	if(s1 != reference || s2 != reference) {
 		cout << "S1 = " << s1 << endl << endl;
 		cout << "S2 = " << s2 << endl << endl;
+		cout << "Reference = " << reference << endl << endl;
 		cerr << "Results doens't match\n";
 		return 3;
 	}
@@ -0,0 +1,233 @@
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include <iostream>
+
+#include <CTPP2JSONFastParser.hpp>
+#include <CTPP2JSONParser.hpp>
+#include <CTPP2JSONStreamParser.hpp>
+#include <CTPP2ParserException.hpp>
+#include <CDT.hpp>
+
+using namespace CTPP;
+using namespace std;
+
+#ifdef _MSC_VER
+unsigned long getMSTime() {
+	SYSTEMTIME st;
+	GetSystemTime(&st);
+	return st.wSecond * 1000000 + st.wMilliseconds * 1000;
+}
+#else
+unsigned long getMSTime() {
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+#endif
+
+void usage(const char * name) {
+	cout << "Usage:\n\t" << name << " -[t|b] filename \n\t\t -t - check that fast, lazy, incremental and character-at-a-time JSON parsers produce the same data\n\t\t -b - run parse throughput benchmark\n\t filename - name of file with JSON object which will be used in test/benchmark" << endl;
+}
+
+int main(int argc, char ** argv) {
+	if (argc < 3 || argv[1][0] != '-' || (argv[1][1] != 't' && argv[1][1] != 'b')) {
+		usage(argv[0]);
+		return 3;
+	}
+
+	struct stat oStat;
+	const char * filename = argv[2];
+	if (stat(filename, &oStat) == -1 || oStat.st_size == 0) {
+		cerr << "ERROR: Cannot get size of file " << filename << endl;
+		return 2;
+	}
+
+	FILE * F = fopen(filename, "r");
+	if (F == NULL) {
+		cerr << "ERROR: Cannot open file " << filename << " for reading" << endl;
+		return 1;
+	}
+
+	// Allocate memory
+	CHAR_8 * szJSONBuffer = (CHAR_8 *)malloc(oStat.st_size + 1);
+	// Read from file
+	if (fread(szJSONBuffer, oStat.st_size, 1, F) != 1)
+	{
+		fprintf(stderr, "ERROR: Cannot read from file `%s`\n", filename);
+		fclose(F);
+		free(szJSONBuffer);
+		return EX_SOFTWARE;
+	}
+	fclose(F);
+
+	szJSONBuffer[oStat.st_size] = '\0';
+	CCHAR_P szEnd = szJSONBuffer + oStat.st_size;
+
+	CDT oSlow;
+	CTPP2JSONParser oSlowParser(oSlow, false);
+	oSlowParser.Parse(szJSONBuffer, szEnd);
+
+	CDT oFast;
+	CTPP2JSONFastParser oFastParser(oFast);
+	if (!oFastParser.Parse(szJSONBuffer, szEnd)) {
+		cerr << "Fast parser rejected " << filename << endl;
+		free(szJSONBuffer);
+		return 3;
+	}
+
+	if (oSlow.RecursiveDump() != oFast.RecursiveDump()) {
+		cout << "Slow = " << oSlow.RecursiveDump() << endl << endl;
+		cout << "Fast = " << oFast.RecursiveDump() << endl << endl;
+		cerr << "Results doens't match\n";
+		free(szJSONBuffer);
+		return 3;
+	}
+	// Lazy containers, both partially and fully materialized
+	{
+		CDT oLazy;
+		CTPP2JSONFastParser oLazyParser(oLazy);
+		if (!oLazyParser.ParseLazy(szJSONBuffer, szEnd)) {
+			cerr << "Fast parser rejected " << filename << " in lazy mode" << endl;
+			free(szJSONBuffer);
+			return 3;
+		}
+
+		if (oSlow.GetType() != oLazy.GetType() || oSlow.Size() != oLazy.Size() || oSlow.RecursiveDump() != oLazy.RecursiveDump()) {
+			cout << "Slow = " << oSlow.RecursiveDump() << endl << endl;
+			cout << "Lazy = " << oLazy.RecursiveDump() << endl << endl;
+			cerr << "Results doens't match in lazy mode\n";
+			free(szJSONBuffer);
+			return 3;
+		}
+	}
+
+	// Incremental parser, data in chunks of different size
+	const unsigned int chunks[] = { 1, 7, 4096 };
+	for(unsigned int c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+		CDT oStream;
+		CTPP2JSONStreamParser oStreamParser(oStream);
+		for(CCHAR_P szChunk = szJSONBuffer; szChunk < szEnd; szChunk += chunks[c]) {
+			oStreamParser.Parse(szChunk, (szEnd - szChunk) > chunks[c] ? szChunk + chunks[c] : szEnd);
+		}
+		oStreamParser.Finish();
+
+		if (oSlow.RecursiveDump() != oStream.RecursiveDump()) {
+			cout << "Slow   = " << oSlow.RecursiveDump() << endl << endl;
+			cout << "Stream = " << oStream.RecursiveDump() << endl << endl;
+			cerr << "Results doens't match, chunk size " << chunks[c] << "\n";
+			free(szJSONBuffer);
+			return 3;
+		}
+	}
+
+	// -t mode
+	if(argv[1][1] == 't') {
+		free(szJSONBuffer);
+
+		// Values at top level are accepted as by CTPP2JSONParser
+		const char * scalars[] = { "true\n", "null\n", " False ", "12", "-1.5e3\n", "\"x\"", "'x'\n", "/* c */ 0", "nil\n", NULL };
+		for(unsigned int s = 0; scalars[s] != NULL; ++s) {
+			CDT oScalarSlow;
+			CTPP2JSONParser oScalarSlowParser(oScalarSlow, false);
+			bool slowAccepted = true;
+			try { oScalarSlowParser.Parse(scalars[s], scalars[s] + strlen(scalars[s])); }
+			catch(CTPPParserSyntaxError & e) { slowAccepted = false; }
+
+			CDT oScalarStream;
+			CTPP2JSONStreamParser oScalarStreamParser(oScalarStream);
+			bool streamAccepted = true;
+			try {
+				oScalarStreamParser.Parse(scalars[s], scalars[s] + strlen(scalars[s]));
+				oScalarStreamParser.Finish();
+			}
+			catch(CTPPParserSyntaxError & e) { streamAccepted = false; }
+
+			if (slowAccepted != streamAccepted || oScalarSlow.RecursiveDump() != oScalarStream.RecursiveDump()) {
+				cerr << "Parsers disagree on top-level value " << scalars[s] << endl;
+				return 3;
+			}
+		}
+		return 0;
+	}
+
+	const unsigned long total = 1000;
+	const double megabytes = 1. * total * oStat.st_size / (1024 * 1024);
+
+	unsigned long slowTime = 1;
+	unsigned long fastTime = 1;
+	{
+		unsigned long t0 = getMSTime();
+		for(unsigned long i = 0; i < total; ++i) {
+			CDT cdt;
+			CTPP2JSONParser oParser(cdt, false);
+			oParser.Parse(szJSONBuffer, szEnd);
+		}
+		unsigned long t1 = getMSTime();
+
+		slowTime = t1 - t0;
+		cout << "Character-at-a-time: " << total << " in " << slowTime << " microsecs, avg = " << 1. * slowTime / total << " microsec/parse, "
+			<< 1000000. * megabytes / slowTime << " MB/s" << endl;
+	}
+	{
+		unsigned long t0 = getMSTime();
+		for(unsigned long i = 0; i < total; ++i) {
+			CDT cdt;
+			CTPP2JSONParser oParser(cdt);
+			oParser.Parse(szJSONBuffer, szEnd);
+		}
+		unsigned long t1 = getMSTime();
+
+		fastTime = t1 - t0;
+		cout << "Structural index:    " << total << " in " << fastTime << " microsecs, avg = " << 1. * fastTime / total << " microsec/parse, "
+			<< 1000000. * megabytes / fastTime << " MB/s" << endl;
+	}
+	{
+		unsigned long t0 = getMSTime();
+		for(unsigned long i = 0; i < total; ++i) {
+			CDT cdt;
+			CTPP2JSONStreamParser oParser(cdt);
+			for(CCHAR_P szChunk = szJSONBuffer; szChunk < szEnd; szChunk += 4096) {
+				oParser.Parse(szChunk, (szEnd - szChunk) > 4096 ? szChunk + 4096 : szEnd);
+			}
+			oParser.Finish();
+		}
+		unsigned long t1 = getMSTime();
+
+		cout << "Incremental:         " << total << " in " << (t1 - t0) << " microsecs, avg = " << 1. * (t1 - t0) / total << " microsec/parse, "
+			<< 1000000. * megabytes / (t1 - t0) << " MB/s" << endl;
+	}
+	{
+		unsigned long t0 = getMSTime();
+		for(unsigned long i = 0; i < total; ++i) {
+			CDT cdt;
+			CTPP2JSONFastParser oParser(cdt);
+			oParser.ParseLazy(szJSONBuffer, szEnd);
+			cdt.Size();
+		}
+		unsigned long t1 = getMSTime();
+
+		cout << "Lazy, top level:     " << total << " in " << (t1 - t0) << " microsecs, avg = " << 1. * (t1 - t0) / total << " microsec/parse, "
+			<< 1000000. * megabytes / (t1 - t0) << " MB/s" << endl;
+	}
+	cout << "Speedup = " << (1. * slowTime / fastTime) << "x\n";
+
+	free(szJSONBuffer);
+
+	return 0;
+}
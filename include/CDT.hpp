@@ -100,6 +100,12 @@ public:
 	// FWD
 	class CTPP2DECL SortingComparator;
 
+	// FWD
+	class CTPP2DECL DataProvider;
+
+	// FWD
+	class CTPP2DECL Generator;
+
 	/**
 	  @brief Constructor
 	  @param oValue - type of value
@@ -168,6 +174,18 @@ public:
 	*/
 	CDT(void * oValue);
 
+	/**
+	  @brief Lazy ARRAY or HASH backed by data provider
+	  @param pProvider - data provider; CDT does not own it, so provider MUST outlive all copies of object
+	*/
+	CDT(DataProvider * pProvider);
+
+	/**
+	  @brief Forward-only ARRAY backed by generator
+	  @param pGenerator - element generator; CDT does not own it, so generator MUST outlive all copies of object
+	*/
+	CDT(Generator * pGenerator);
+
 	/**
 	  @brief Copy operator
 	  @param oValue - INT_64 value to copy
@@ -1610,6 +1628,19 @@ public:
 	*/
 	STLW::string GetString(CCHAR_P szFormat = "") const;
 
+	/**
+	  @brief Get string value without copying
+	  @param iLength - string length [out]
+	  @return pointer to string data or NULL, if value is not STRING_VAL, STRING_INT_VAL or STRING_REAL_VAL
+	*/
+	CCHAR_P GetStringData(UINT_32 & iLength) const;
+
+	/**
+	  @brief Get identity of shareable value; copies of value have same identity until one of them is changed
+	  @return pointer to shared data of STRING, ARRAY or HASH value, NULL for other types
+	*/
+	const void * GetIdentity() const;
+
 	/**
 	  @brief Cast value to W_FLOAT
         */
@@ -1737,8 +1768,12 @@ public:
 	void MergeCDT(const CDT & oSource, const eMergeStrategy & eStrategy = FAST_MERGE);
 
 	/**
-	  @brief Quick sort ARRAY
+	  @brief Sort ARRAY
 	  @param oSortingComparator - variables comparator
+
+	  If comparator provides sorting key (see SortingComparator::GetKeyType), keys are extracted
+	  once per element and array is sorted by them; elements with equal keys keep their order.
+	  Large arrays are sorted by parallel merge sort.
 	*/
 	void SortArray(const SortingComparator & oSortingComparator);
 
@@ -1754,6 +1789,14 @@ public:
 		*/
 		enum eSortingDirection { ASC, DESC };
 
+		/**
+		  @brief Type of sorting key
+		*/
+		enum eSortingKey { CUSTOM_KEY,  /**< no key, use operator() only       */
+		                   NUMERIC_KEY, /**< compare keys as operator< does    */
+		                   STRING_KEY   /**< compare keys as Less() does       */
+		                 };
+
 		/**
 		  @brief Compare two values.
 		  @param oX - first value to compare
@@ -1766,6 +1809,130 @@ public:
 		  @brief A dertructor
 		*/
 		virtual ~SortingComparator() throw();
+
+		// Methods added after 2.8.4 follow destructor, so slots of older methods stay in place
+
+		/**
+		  @brief Get type of sorting key; operator() must be consistent with it
+		  @return CUSTOM_KEY by default
+		*/
+		virtual eSortingKey GetKeyType() const;
+
+		/**
+		  @brief Get sorting direction
+		  @return ASC by default
+		*/
+		virtual eSortingDirection GetDirection() const;
+
+		/**
+		  @brief Get sorting key of value
+		  @param oValue - array element
+		  @return value itself by default
+		*/
+		virtual const CDT & GetKey(const CDT & oValue) const;
+	};
+
+	/**
+	  @class DataProvider CDT.hpp <CDT.hpp>
+	  @brief Source of data for lazy ARRAY or HASH.
+
+	  Elements are requested only when template or function reads them; every fetched element
+	  (and every missing hash key) is memoized inside CDT, so provider is asked at most once per key.
+	  Operations that need whole container (iterators, joins, sorting, merging, write access)
+	  materialize it via Iterate().
+	*/
+	class CTPP2DECL DataProvider
+	{
+	public:
+		/**
+		  @class Visitor CDT.hpp <CDT.hpp>
+		  @brief Receives all elements of container
+		*/
+		class CTPP2DECL Visitor
+		{
+		public:
+			/**
+			  @brief Receive hash element
+			  @param sKey - element key
+			  @param oValue - element value
+			*/
+			virtual void VisitKey(const STLW::string & sKey, const CDT & oValue) = 0;
+
+			/**
+			  @brief Receive next array element
+			  @param oValue - element value
+			*/
+			virtual void VisitElement(const CDT & oValue) = 0;
+
+			/**
+			  @brief A destructor
+			*/
+			virtual ~Visitor() throw();
+		};
+
+		/**
+		  @brief Get container type
+		  @return ARRAY_VAL or HASH_VAL
+		*/
+		virtual eValType GetType() const = 0;
+
+		/**
+		  @brief Fetch hash element
+		  @param sKey - element key [in]
+		  @param oValue - element value [out]
+		  @return true, if element exist, false - otherwise
+		*/
+		virtual bool GetKey(const STLW::string & sKey, CDT & oValue);
+
+		/**
+		  @brief Fetch array element
+		  @param iPos - element index, always less than Size() [in]
+		  @param oValue - element value [out]
+		  @return true, if element exist, false - otherwise
+		*/
+		virtual bool GetIndex(const UINT_32 iPos, CDT & oValue);
+
+		/**
+		  @brief Get number of elements
+		  @return number of elements in container
+		*/
+		virtual UINT_32 Size() = 0;
+
+		/**
+		  @brief Pass all elements to visitor, in index order for arrays
+		  @param oVisitor - element visitor
+		*/
+		virtual void Iterate(Visitor & oVisitor) = 0;
+
+		/**
+		  @brief A destructor
+		*/
+		virtual ~DataProvider() throw();
+	};
+
+	/**
+	  @class Generator CDT.hpp <CDT.hpp>
+	  @brief Source of elements for forward-only ARRAY (DB cursor, file reader, etc).
+
+	  Only current element and one element of lookahead are kept in memory. Size() returns number of
+	  elements known so far (current position plus lookahead), so it is exact only at the end of stream;
+	  this is enough to detect last element in loops. Access to element before current one throws
+	  CDTRangeException; whole-container operations are possible only before first access.
+	*/
+	class CTPP2DECL Generator
+	{
+	public:
+		/**
+		  @brief Get next element
+		  @param oValue - element value [out]
+		  @return true, if element was generated, false - at the end of stream
+		*/
+		virtual bool Next(CDT & oValue) = 0;
+
+		/**
+		  @brief A destructor
+		*/
+		virtual ~Generator() throw();
 	};
 
 	/**
@@ -1867,6 +2034,11 @@ private:
 	*/
 	void Unshare();
 
+	/**
+	  @brief Fetch all elements of lazy container and drop data provider
+	*/
+	void Materialize() const;
+
 	/**
 	  @brief Dump CDT into string
 	  @param iLevel  - level of recursion
@@ -64,6 +64,25 @@ public:
 	*/
 	bool operator()(const CDT & oX, const CDT & oY) const;
 
+	/**
+	  @brief Get type of sorting key
+	  @return NUMERIC_KEY
+	*/
+	CDT::SortingComparator::eSortingKey GetKeyType() const;
+
+	/**
+	  @brief Get sorting direction
+	  @return sorting direction
+	*/
+	CDT::SortingComparator::eSortingDirection GetDirection() const;
+
+	/**
+	  @brief Get sorting key of value
+	  @param oValue - array element
+	  @return value itself
+	*/
+	const CDT & GetKey(const CDT & oValue) const;
+
 	/**
 	  @brief A destructor
 	*/
@@ -95,6 +114,25 @@ public:
 	*/
 	bool operator()(const CDT & oX, const CDT & oY) const;
 
+	/**
+	  @brief Get type of sorting key
+	  @return STRING_KEY
+	*/
+	CDT::SortingComparator::eSortingKey GetKeyType() const;
+
+	/**
+	  @brief Get sorting direction
+	  @return sorting direction
+	*/
+	CDT::SortingComparator::eSortingDirection GetDirection() const;
+
+	/**
+	  @brief Get sorting key of value
+	  @param oValue - array element
+	  @return value itself
+	*/
+	const CDT & GetKey(const CDT & oValue) const;
+
 	/**
 	  @brief A destructor
 	*/
@@ -128,6 +166,25 @@ public:
 	*/
 	bool operator()(const CDT & oX, const CDT & oY) const;
 
+	/**
+	  @brief Get type of sorting key
+	  @return NUMERIC_KEY
+	*/
+	CDT::SortingComparator::eSortingKey GetKeyType() const;
+
+	/**
+	  @brief Get sorting direction
+	  @return sorting direction
+	*/
+	CDT::SortingComparator::eSortingDirection GetDirection() const;
+
+	/**
+	  @brief Get sorting key of value
+	  @param oValue - array element
+	  @return value of HASH element with key sKey
+	*/
+	const CDT & GetKey(const CDT & oValue) const;
+
 	/**
 	  @brief A destructor
 	*/
@@ -164,6 +221,25 @@ public:
 	*/
 	bool operator()(const CDT & oX, const CDT & oY) const;
 
+	/**
+	  @brief Get type of sorting key
+	  @return STRING_KEY
+	*/
+	CDT::SortingComparator::eSortingKey GetKeyType() const;
+
+	/**
+	  @brief Get sorting direction
+	  @return sorting direction
+	*/
+	CDT::SortingComparator::eSortingDirection GetDirection() const;
+
+	/**
+	  @brief Get sorting key of value
+	  @param oValue - array element
+	  @return value of HASH element with key sKey
+	*/
+	const CDT & GetKey(const CDT & oValue) const;
+
 	/**
 	  @brief A destructor
 	*/
@@ -200,6 +276,25 @@ public:
 	*/
 	bool operator()(const CDT & oX, const CDT & oY) const;
 
+	/**
+	  @brief Get type of sorting key
+	  @return NUMERIC_KEY
+	*/
+	CDT::SortingComparator::eSortingKey GetKeyType() const;
+
+	/**
+	  @brief Get sorting direction
+	  @return sorting direction
+	*/
+	CDT::SortingComparator::eSortingDirection GetDirection() const;
+
+	/**
+	  @brief Get sorting key of value
+	  @param oValue - array element
+	  @return ARRAY element with index iIndex
+	*/
+	const CDT & GetKey(const CDT & oValue) const;
+
 	/**
 	  @brief A destructor
 	*/
@@ -235,6 +330,25 @@ public:
 	*/
 	bool operator()(const CDT & oX, const CDT & oY) const;
 
+	/**
+	  @brief Get type of sorting key
+	  @return STRING_KEY
+	*/
+	CDT::SortingComparator::eSortingKey GetKeyType() const;
+
+	/**
+	  @brief Get sorting direction
+	  @return sorting direction
+	*/
+	CDT::SortingComparator::eSortingDirection GetDirection() const;
+
+	/**
+	  @brief Get sorting key of value
+	  @param oValue - array element
+	  @return ARRAY element with index iIndex
+	*/
+	const CDT & GetKey(const CDT & oValue) const;
+
 	/**
 	  @brief A destructor
 	*/
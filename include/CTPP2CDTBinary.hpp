@@ -0,0 +1,242 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2CDTBinary.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_CDT_BINARY_HPP__
+#define _CTPP2_CDT_BINARY_HPP__ 1
+
+#include "CDT.hpp"
+
+#include "STLMap.hpp"
+#include "STLString.hpp"
+#include "STLVector.hpp"
+
+/**
+  @file CTPP2CDTBinary.hpp
+  @brief Compact binary CDT serialization.
+
+  Layout (all fixed-size numbers are little-endian UINT_32):
+
+  Header:     "CDTB", version, total length, offset of root value, offset of key dictionary
+  Value:      1 byte of type (CDT::eValType) and payload:
+              INT_VAL    - zigzag varint
+              REAL_VAL   - 8 bytes of IEEE 754 double
+              STRING_VAL - varint length and bytes
+              ARRAY_VAL  - varint count and count * offset of element
+              HASH_VAL   - varint count and count * (key id, offset of value), sorted by key id
+              UNDEF      - no payload (also used for POINTER_VAL)
+  Dictionary: varint count, count * offset of key (varint length and bytes),
+              number of slots (power of 2) and slots of open-addressing hash table (key id + 1, 0 - empty slot)
+
+  Children are written before parents, so writer needs only one pass and works with lazy
+  data and generators.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @class CTPP2CDTBinaryWriter CTPP2CDTBinary.hpp <CTPP2CDTBinary.hpp>
+  @brief Serialize CDT into compact binary form
+*/
+class CTPP2DECL CTPP2CDTBinaryWriter
+{
+public:
+	/**
+	  @brief Constructor
+	  @param sIBuffer - output buffer
+	*/
+	CTPP2CDTBinaryWriter(STLW::string & sIBuffer);
+
+	/**
+	  @brief Serialize data; buffer is overwritten
+	  @param oData - data to serialize
+	  @return size of serialized data
+	*/
+	UINT_32 Write(const CDT & oData);
+
+	/**
+	  @brief A destructor
+	*/
+	~CTPP2CDTBinaryWriter() throw();
+private:
+	/** Output buffer          */
+	STLW::string                          & sBuffer;
+	/** Key dictionary         */
+	STLW::map<STLW::string, UINT_32>        mKeys;
+	/** Keys in order of ids   */
+	STLW::vector<const STLW::string *>      vKeys;
+
+	/**
+	  @brief Write value and all its children
+	  @param oData - value to write
+	  @return offset of value
+	*/
+	UINT_32 WriteValue(const CDT & oData);
+
+	/**
+	  @brief Write key dictionary
+	  @return offset of dictionary
+	*/
+	UINT_32 WriteDictionary();
+
+	/**
+	  @brief Get key id, add key to dictionary if need
+	  @param sKey - key
+	  @return key id
+	*/
+	UINT_32 GetKeyId(const STLW::string & sKey);
+
+	/**
+	  @brief Append varint
+	  @param iValue - value to append
+	*/
+	void AppendVarint(UINT_64 iValue);
+
+	/**
+	  @brief Append little-endian 32-bit value
+	  @param iValue - value to append
+	*/
+	void AppendUInt32(const UINT_32 iValue);
+
+	/**
+	  @brief Store little-endian 32-bit value at given position
+	  @param iPos - position in buffer
+	  @param iValue - value to store
+	*/
+	void StoreUInt32(const UINT_32 iPos, const UINT_32 iValue);
+};
+
+// FWD
+class CTPP2CDTBinaryContainer;
+
+/**
+  @class CTPP2CDTBinaryReader CTPP2CDTBinary.hpp <CTPP2CDTBinary.hpp>
+  @brief Read-only CDT view of serialized data.
+
+  Buffer is not copied; arrays and hashes are lazy CDT objects, elements are decoded when template
+  or function reads them. Buffer and reader MUST outlive all CDT objects obtained from reader.
+*/
+class CTPP2DECL CTPP2CDTBinaryReader
+{
+public:
+	/**
+	  @brief Constructor
+	  @param szIData - serialized data (for example, mmapped file)
+	  @param iIDataLength - data length
+	*/
+	CTPP2CDTBinaryReader(CCHAR_P szIData, const UINT_32 iIDataLength);
+
+	/**
+	  @brief Get root value
+	  @return root value
+	*/
+	CDT GetRoot();
+
+	/**
+	  @brief Check serialized data header
+	  @param szData - serialized data
+	  @param iDataLength - data length
+	  @return true, if data looks like binary CDT, false - otherwise
+	*/
+	static bool IsBinaryCDT(CCHAR_P szData, const UINT_32 iDataLength);
+
+	/**
+	  @brief A destructor
+	*/
+	~CTPP2CDTBinaryReader() throw();
+private:
+	friend class CTPP2CDTBinaryContainer;
+
+	/** Serialized data      */
+	CCHAR_P                                   szData;
+	/** Data length          */
+	UINT_32                                   iDataLength;
+	/** Offset of root value */
+	UINT_32                                   iRootOffset;
+	/** Number of keys       */
+	UINT_32                                   iKeysCount;
+	/** Offset of key table  */
+	UINT_32                                   iKeysOffset;
+	/** Number of hash slots */
+	UINT_32                                   iSlotsCount;
+	/** Offset of hash slots */
+	UINT_32                                   iSlotsOffset;
+	/** Lazy containers      */
+	STLW::map<UINT_32, CTPP2CDTBinaryContainer *>  mContainers;
+
+	/**
+	  @brief Decode value
+	  @param iOffset - value offset
+	  @param oValue - decoded value [out]
+	*/
+	void ReadValue(const UINT_32 iOffset, CDT & oValue);
+
+	/**
+	  @brief Read varint
+	  @param iOffset - varint offset, moved to end of varint [in/out]
+	  @return decoded value
+	*/
+	UINT_64 ReadVarint(UINT_32 & iOffset) const;
+
+	/**
+	  @brief Read little-endian 32-bit value
+	  @param iOffset - value offset
+	  @return decoded value
+	*/
+	UINT_32 ReadUInt32(const UINT_32 iOffset) const;
+
+	/**
+	  @brief Read key by id
+	  @param iKeyId - key id
+	  @param iKeyLength - key length [out]
+	  @return pointer to start of key
+	*/
+	CCHAR_P GetKey(const UINT_32 iKeyId, UINT_32 & iKeyLength) const;
+
+	/**
+	  @brief Find key in dictionary
+	  @param sKey - key to find
+	  @param iKeyId - key id [out]
+	  @return true, if key found, false - otherwise
+	*/
+	bool FindKey(const STLW::string & sKey, UINT_32 & iKeyId) const;
+
+	/**
+	  @brief Check range of data
+	  @param iOffset - start of data
+	  @param iLength - data length
+	*/
+	void CheckRange(const UINT_32 iOffset, const UINT_64 iLength) const;
+};
+
+} // namespace CTPP
+#endif // _CTPP2_CDT_BINARY_HPP__
+// End.
@@ -0,0 +1,140 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2ChunkedOutputCollector.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_CHUNKED_OUTPUT_COLLECTOR_HPP__
+#define _CTPP2_CHUNKED_OUTPUT_COLLECTOR_HPP__ 1
+
+#include "CTPP2OutputCollector.hpp"
+#include "STLString.hpp"
+#include "STLVector.hpp"
+
+/**
+  @file CTPP2ChunkedOutputCollector.hpp
+  @brief Virtual machine output data collector with bounded buffer and early flush
+
+  Output is passed to target collector in chunks while template is still running, so first bytes
+  reach the client before whole page is rendered. Chunk is flushed when buffer is full, or when buffered
+  data contains one of flush markers (for example "</head>" or "<!-- flush -->" placed in template).
+  Memory used for output never exceeds chunk size.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @var C_CHUNKED_COLLECTOR_CHUNK_SIZE
+  @brief Default chunk size
+*/
+#define C_CHUNKED_COLLECTOR_CHUNK_SIZE 16384
+
+/**
+  @class ChunkedOutputCollector CTPP2ChunkedOutputCollector.hpp <CTPP2ChunkedOutputCollector.hpp>
+  @brief Output data collector with bounded buffer and early flush
+*/
+class CTPP2DECL ChunkedOutputCollector:
+  public OutputCollector
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oITarget - flush callback; every chunk is passed with one Collect() call, so target
+	                    should send it to client immediately (FCGX_PutStr + FCGX_FFlush, writev, etc)
+	  @param iIChunkSize - max. size of buffered data
+	*/
+	ChunkedOutputCollector(OutputCollector  & oITarget,
+	                       const UINT_32      iIChunkSize = C_CHUNKED_COLLECTOR_CHUNK_SIZE);
+
+	/**
+	  @brief Add flush marker; chunk is flushed right after marker is written
+	  @param sMarker - marker
+	*/
+	void AddFlushMarker(const STLW::string & sMarker);
+
+	/**
+	  @brief Pass buffered data to target collector
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Flush();
+
+	/**
+	  @brief Get number of flushed chunks
+	  @return number of chunks passed to target collector
+	*/
+	UINT_32 GetChunksNum() const;
+
+	/**
+	  @brief A destructor; flushes buffered data
+	*/
+	~ChunkedOutputCollector() throw();
+private:
+	/** Target collector          */
+	OutputCollector              & oTarget;
+	/** Chunk size                */
+	UINT_32                        iChunkSize;
+	/** Buffer                    */
+	CHAR_P                         szBuffer;
+	/** Used part of buffer       */
+	UINT_32                        iBufferUsed;
+	/** Flush markers             */
+	STLW::vector<STLW::string>     vMarkers;
+	/** Max. marker length        */
+	UINT_32                        iMaxMarkerLength;
+	/** Last bytes of flushed data, marker may start in them */
+	STLW::string                   sTail;
+	/** Number of flushed chunks  */
+	UINT_32                        iChunksNum;
+
+	/**
+	  @brief Check buffer for flush markers
+	  @param iFrom - start of new data in buffer
+	  @return true if any marker found
+	*/
+	bool FindMarker(const UINT_32 iFrom) const;
+
+	/**
+	  @brief Keep last bytes of flushed data, up to max. marker length - 1
+	  @param szData - flushed data
+	  @param iDataLength - data length
+	*/
+	void KeepTail(CCHAR_P szData, const UINT_32 iDataLength);
+
+	/**
+	  @brief Collect data
+	  @param vData - data to store
+	  @param iDataLength - data length
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength);
+};
+
+} // namespace CTPP
+#endif // _CTPP2_CHUNKED_OUTPUT_COLLECTOR_HPP__
+// End.
@@ -89,6 +89,20 @@ public:
 	*/
 	INT_32 OutputVariable(const VMDebugInfo & oDebugInfo = VMDebugInfo());
 
+	/**
+	  @brief  Send result of system call to standard output collector; system call must be last instruction
+	  @param oDebugInfo - debug information object
+	*/
+	INT_32 OutputCallResult(const VMDebugInfo & oDebugInfo = VMDebugInfo());
+
+	/**
+	  @brief  Escape variable and send it to standard output collector
+	  @param iEscapeType - escaping rules, eCTPP2EscapeType
+	  @param oDebugInfo - debug information object
+	*/
+	INT_32 OutputEscapedVariable(const UINT_32        iEscapeType,
+	                             const VMDebugInfo  & oDebugInfo = VMDebugInfo());
+
 	/**
 	  @brief Send text data to standard output collector
 	  @param vBuffer - data
@@ -279,6 +293,22 @@ public:
 	*/
 	void PrepareCallBlock(const VMDebugInfo & oDebugInfo = VMDebugInfo());
 
+	/**
+	  @brief Start of cached fragment; fragment name, keys and TTL should be pushed into stack
+	  @param iArgCount - number of values in stack, including fragment name and TTL
+	  @param oDebugInfo - debug information object
+	  @return instruction pointer of jump over fragment body
+	*/
+	INT_32 StartCache(const UINT_32        iArgCount,
+	                  const VMDebugInfo  & oDebugInfo = VMDebugInfo());
+
+	/**
+	  @brief End of cached fragment
+	  @param oDebugInfo - debug information object
+	  @return instruction pointer if success, -1 if any error occured
+	*/
+	INT_32 EndCache(const VMDebugInfo & oDebugInfo = VMDebugInfo());
+
 	// ////////////////////////////////////////////////////////////////////////////////
 
 	/**
@@ -308,6 +338,17 @@ public:
 	*/
 	INT_32 RemoveInstruction();
 
+	/**
+	  @brief Replace string pushed into stack by instruction
+	  @param iIP - instruction number
+	  @param szData - data
+	  @param iDataLength - data length
+	  @return instruction pointer if success, -1 if instruction does not push string
+	*/
+	INT_32 ChangeString(const UINT_32        iIP,
+	                    CCHAR_P              szData,
+	                    const UINT_32        iDataLength);
+
 	/**
 	  @brief Addition
 	  @param oDebugInfo - debug information object
@@ -0,0 +1,220 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2DeflateOutputCollector.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_DEFLATE_OUTPUT_COLLECTOR_HPP__
+#define _CTPP2_DEFLATE_OUTPUT_COLLECTOR_HPP__ 1
+
+#include "CTPP2OutputCollector.hpp"
+#include "STLMap.hpp"
+#include "STLString.hpp"
+
+#ifdef ZLIB_SUPPORT
+    #include <zlib.h>
+#endif // ZLIB_SUPPORT
+
+/**
+  @file CTPP2DeflateOutputCollector.hpp
+  @brief Virtual machine output data collector with on-the-fly gzip/deflate compression
+
+  Data is compressed as it is collected, so page is never buffered as a whole.
+  Large static text runs of template can be compressed once (DeflateStaticText) and spliced
+  into output stream as is: live stream is byte-aligned and its history is reset with full flush,
+  then pre-deflated blocks are copied and CRC-32 of gzip trailer is combined with CRC-32 of block.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+#ifdef ZLIB_SUPPORT
+
+// FWD
+struct VMMemoryCore;
+
+/**
+  @var C_DEFLATE_STATIC_MIN_LENGTH
+  @brief Default min. length of static text run to pre-deflate
+*/
+#define C_DEFLATE_STATIC_MIN_LENGTH 1024
+
+/**
+  @var C_DEFLATE_BUFFER_LEN
+  @brief Size of compressed data buffer
+*/
+#define C_DEFLATE_BUFFER_LEN        16384
+
+/**
+  @class DeflateStaticText CTPP2DeflateOutputCollector.hpp <CTPP2DeflateOutputCollector.hpp>
+  @brief Pre-deflated large static text runs of template; built once per loaded core and kept alongside it
+*/
+class CTPP2DECL DeflateStaticText
+{
+public:
+	/**
+	  @brief Constructor
+	  @param pVMMemoryCore - core of template; MUST outlive object
+	  @param iLevel - compression level, 0 .. 9 or Z_DEFAULT_COMPRESSION
+	  @param iMinLength - min. length of static text run to pre-deflate
+	*/
+	DeflateStaticText(const VMMemoryCore  * pVMMemoryCore,
+	                  const INT_32          iLevel = Z_DEFAULT_COMPRESSION,
+	                  const UINT_32         iMinLength = C_DEFLATE_STATIC_MIN_LENGTH);
+
+	/**
+	  @brief Find pre-deflated block for static text run
+	  @param szData - text, pointer to static text segment of core
+	  @param iDataLength - text length
+	  @param szBlock - pre-deflated block [out]
+	  @param iBlockLength - block length [out]
+	  @param iCRC - CRC-32 of text [out]
+	  @return true if block found
+	*/
+	bool Find(CCHAR_P          szData,
+	          const UINT_32    iDataLength,
+	          CCHAR_P        & szBlock,
+	          UINT_32        & iBlockLength,
+	          UINT_32        & iCRC) const;
+
+	/**
+	  @brief Get number of pre-deflated blocks
+	  @return number of blocks
+	*/
+	UINT_32 GetBlocksNum() const;
+
+	/**
+	  @brief A destructor
+	*/
+	~DeflateStaticText() throw();
+private:
+	/**
+	  @struct Block CTPP2DeflateOutputCollector.hpp <CTPP2DeflateOutputCollector.hpp>
+	  @brief Pre-deflated block
+	*/
+	struct Block
+	{
+		/** Text length          */
+		UINT_32    text_length;
+		/** Offset in sBlocks    */
+		UINT_32    offset;
+		/** Block length         */
+		UINT_32    length;
+		/** CRC-32 of text       */
+		UINT_32    crc;
+	};
+
+	/** Min. text length             */
+	UINT_32                       iMinLength;
+	/** Blocks by address of text    */
+	STLW::map<CCHAR_P, Block>     mBlocks;
+	/** Compressed data              */
+	STLW::string                  sBlocks;
+};
+
+/**
+  @class DeflateOutputCollector CTPP2DeflateOutputCollector.hpp <CTPP2DeflateOutputCollector.hpp>
+  @brief Output data collector with on-the-fly compression
+*/
+class CTPP2DECL DeflateOutputCollector:
+  public OutputCollector
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oITarget - collector for compressed data
+	  @param bIGzip - write gzip (RFC 1952) header and trailer, raw deflate (RFC 1951) otherwise
+	  @param iLevel - compression level, 0 .. 9 or Z_DEFAULT_COMPRESSION
+	  @param pIStaticText - pre-deflated static text of template, may be NULL
+
+	  If target collector rejects gzip header, Collect, Flush and Finish return -1
+	*/
+	DeflateOutputCollector(OutputCollector          & oITarget,
+	                       const bool                 bIGzip = true,
+	                       const INT_32               iLevel = Z_DEFAULT_COMPRESSION,
+	                       const DeflateStaticText  * pIStaticText = NULL);
+
+	/**
+	  @brief Compress pending data and pass it to target collector (Z_SYNC_FLUSH)
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Flush();
+
+	/**
+	  @brief Finish compressed stream; no data can be collected after this call
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Finish();
+
+	/**
+	  @brief A destructor; finishes stream, if need
+	*/
+	~DeflateOutputCollector() throw();
+private:
+	/** Target collector              */
+	OutputCollector           & oTarget;
+	/** Pre-deflated static text      */
+	const DeflateStaticText   * pStaticText;
+	/** Write gzip header and trailer */
+	bool                        bGzip;
+	/** Stream is finished            */
+	bool                        bFinished;
+	/** gzip header was not written   */
+	bool                        bFailed;
+	/** Compression stream            */
+	z_stream                    oStream;
+	/** CRC-32 of uncompressed data   */
+	uLong                       iCRC;
+	/** Uncompressed data length      */
+	uLong                       iTotalLength;
+	/** Compressed data buffer        */
+	Bytef                       aBuffer[C_DEFLATE_BUFFER_LEN];
+
+	/**
+	  @brief Compress data
+	  @param vData - data
+	  @param iDataLength - data length
+	  @param iFlush - zlib flush mode
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Deflate(const void * vData, const UINT_32 iDataLength, const INT_32 iFlush);
+
+	/**
+	  @brief Collect data
+	  @param vData - data to store
+	  @param iDataLength - data length
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength);
+};
+
+#endif // ZLIB_SUPPORT
+
+} // namespace CTPP
+#endif // _CTPP2_DEFLATE_OUTPUT_COLLECTOR_HPP__
+// End.
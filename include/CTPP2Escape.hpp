@@ -0,0 +1,85 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2Escape.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_ESCAPE_HPP__
+#define _CTPP2_ESCAPE_HPP__ 1
+
+#include "CTPP2Types.h"
+#include "STLString.hpp"
+
+/**
+  @file CTPP2Escape.hpp
+  @brief HTML, XML, WML, URL and URI escaping straight into destination buffer.
+
+  Runs of characters that need no escaping are found 16 (SSE2, NEON) or 32 (AVX2) bytes at a time,
+  or with lookup table on other platforms, and copied in one piece.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+// FWD
+class OutputCollector;
+
+/**
+  @enum eCTPP2EscapeType CTPP2Escape.hpp <CTPP2Escape.hpp>
+  @brief Escaping rules
+*/
+enum eCTPP2EscapeType { ESCAPE_HTML, ESCAPE_XML, ESCAPE_WML, ESCAPE_URL, ESCAPE_URI, ESCAPE_NONE };
+
+/**
+  @fn void EscapeData(const eCTPP2EscapeType eType, CCHAR_P szData, const UINT_32 iDataLength, STLW::string & sResult)
+  @brief Escape data and append it to string
+  @param eType - escaping rules
+  @param szData - data to escape
+  @param iDataLength - data length
+  @param sResult - destination string
+*/
+CTPP2DECL void EscapeData(const eCTPP2EscapeType   eType,
+                          CCHAR_P                  szData,
+                          const UINT_32            iDataLength,
+                          STLW::string           & sResult);
+
+/**
+  @fn void EscapeData(const eCTPP2EscapeType eType, CCHAR_P szData, const UINT_32 iDataLength, OutputCollector & oCollector)
+  @brief Escape data and pass it to output collector; small pieces are collected in a stack buffer
+  @param eType - escaping rules
+  @param szData - data to escape
+  @param iDataLength - data length
+  @param oCollector - output collector
+*/
+CTPP2DECL void EscapeData(const eCTPP2EscapeType   eType,
+                          CCHAR_P                  szData,
+                          const UINT_32            iDataLength,
+                          OutputCollector        & oCollector);
+
+} // namespace CTPP
+#endif // _CTPP2_ESCAPE_HPP__
+// End.
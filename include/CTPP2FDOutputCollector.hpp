@@ -0,0 +1,137 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2FDOutputCollector.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_FD_OUTPUT_COLLECTOR_HPP__
+#define _CTPP2_FD_OUTPUT_COLLECTOR_HPP__ 1
+
+#include "CTPP2OutputCollector.hpp"
+
+/**
+  @file CTPP2FDOutputCollector.hpp
+  @brief Virtual machine output data collector, scatter-gather output to file descriptor
+
+  Collector keeps list of chunks and writes them with one writev(2) call. Static text of template
+  (it outlives the render) is referenced, not copied; only dynamic data is copied to internal buffer.
+*/
+
+// FWD
+struct iovec;
+
+namespace CTPP // C++ Template Engine
+{
+// FWD
+struct VMMemoryCore;
+
+/**
+  @var C_FD_COLLECTOR_FLUSH_THRESHOLD
+  @brief Default size of pending data that triggers writev(2)
+*/
+#define C_FD_COLLECTOR_FLUSH_THRESHOLD 65536
+
+/**
+  @var C_FD_COLLECTOR_MAX_IOVECS
+  @brief Max. number of chunks per writev(2) call
+*/
+#define C_FD_COLLECTOR_MAX_IOVECS      1024
+
+/**
+  @class FDOutputCollector CTPP2FDOutputCollector.hpp <CTPP2FDOutputCollector.hpp>
+  @brief Buffered scatter-gather output data collector
+*/
+class CTPP2DECL FDOutputCollector:
+  public OutputCollector
+{
+public:
+	/**
+	  @brief Constructor
+	  @param iIFHandle - opened file descriptor; collector does not close it
+	  @param pVMMemoryCore - core of template; static text of core is written without copying, MUST outlive collector. May be NULL
+	  @param iIFlushThreshold - size of pending data that triggers writev(2); dynamic data buffer has the same size
+	*/
+	FDOutputCollector(const INT_32          iIFHandle,
+	                  const VMMemoryCore  * pVMMemoryCore = NULL,
+	                  const UINT_32         iIFlushThreshold = C_FD_COLLECTOR_FLUSH_THRESHOLD);
+
+	/**
+	  @brief Write all pending data
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Flush();
+
+	/**
+	  @brief Get unix file number
+	  @return file descriptor
+	*/
+	INT_32 GetFileNo() const;
+
+	/**
+	  @brief A destructor; writes all pending data
+	*/
+	~FDOutputCollector() throw();
+private:
+	/** File descriptor                */
+	INT_32            iFHandle;
+	/** Static text of core            */
+	CCHAR_P           szStaticBegin;
+	/** End of static text             */
+	CCHAR_P           szStaticEnd;
+	/** Pending data size to flush at  */
+	UINT_32           iFlushThreshold;
+	/** Pending data size              */
+	UINT_32           iPendingSize;
+	/** Chunks                         */
+	struct iovec    * aIOVecs;
+	/** Number of chunks               */
+	UINT_32           iIOVecsUsed;
+	/** Dynamic data buffer            */
+	CHAR_P            szBuffer;
+	/** Used part of buffer            */
+	UINT_32           iBufferUsed;
+
+	/**
+	  @brief Add chunk, merge with previous one if possible; there is always room for one chunk
+	  @param szData - data
+	  @param iDataLength - data length
+	*/
+	void AddChunk(CCHAR_P szData, const UINT_32 iDataLength);
+
+	/**
+	  @brief Collect data
+	  @param vData - data to store
+	  @param iDataLength - data length
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength);
+};
+
+} // namespace CTPP
+#endif // _CTPP2_FD_OUTPUT_COLLECTOR_HPP__
+// End.
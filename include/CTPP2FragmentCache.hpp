@@ -0,0 +1,183 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2FragmentCache.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_FRAGMENT_CACHE_HPP__
+#define _CTPP2_FRAGMENT_CACHE_HPP__ 1
+
+#include "CTPP2Types.h"
+#include "STLString.hpp"
+
+/**
+  @file CTPP2FragmentCache.hpp
+  @brief Storage of output of &lt;TMPL_cache&gt; fragments
+
+  Fragment &lt;TMPL_cache key(Expr, ...) ttl(Expr)&gt; ..... &lt;/TMPL_cache&gt; is executed only if storage
+  has no output for given key; otherwise stored output is written and fragment code is skipped.
+  Storage is shared by virtual machines running in different threads.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @var C_FRAGMENT_CACHE_MAX_SIZE
+  @brief Default max. size of stored data, bytes
+*/
+#define C_FRAGMENT_CACHE_MAX_SIZE (16 * 1024 * 1024)
+
+/**
+  @var C_FRAGMENT_CACHE_SHARDS
+  @brief Default number of independently locked parts of cache
+*/
+#define C_FRAGMENT_CACHE_SHARDS   16
+
+/**
+  @class FragmentCache CTPP2FragmentCache.hpp <CTPP2FragmentCache.hpp>
+  @brief Storage of fragments output; implementation must be thread-safe
+*/
+class CTPP2DECL FragmentCache
+{
+public:
+	/**
+	  @brief Get fragment output
+	  @param sKey - fragment key
+	  @param sData - fragment output [out]
+	  @return true if output found
+	*/
+	virtual bool Get(const STLW::string  & sKey,
+	                 STLW::string        & sData) = 0;
+
+	/**
+	  @brief Store fragment output
+	  @param sKey - fragment key
+	  @param sData - fragment output
+	  @param iTTL - time to live, seconds; 0 - without expiration
+	*/
+	virtual void Put(const STLW::string  & sKey,
+	                 const STLW::string  & sData,
+	                 const UINT_32         iTTL) = 0;
+
+	/**
+	  @brief A destructor
+	*/
+	virtual ~FragmentCache() throw();
+};
+
+/**
+  @class LRUFragmentCache CTPP2FragmentCache.hpp <CTPP2FragmentCache.hpp>
+  @brief In-process storage; keys are spread over shards with own lock and LRU list
+*/
+class CTPP2DECL LRUFragmentCache:
+  public FragmentCache
+{
+public:
+	/**
+	  @brief Constructor
+	  @param iIMaxSize - max. size of stored data, bytes
+	  @param iIShardsNum - number of shards
+	*/
+	LRUFragmentCache(const UINT_32  iIMaxSize   = C_FRAGMENT_CACHE_MAX_SIZE,
+	                 const UINT_32  iIShardsNum = C_FRAGMENT_CACHE_SHARDS);
+
+	/**
+	  @brief Get fragment output
+	  @param sKey - fragment key
+	  @param sData - fragment output [out]
+	  @return true if output found
+	*/
+	bool Get(const STLW::string  & sKey,
+	         STLW::string        & sData);
+
+	/**
+	  @brief Store fragment output; least recently used fragments are evicted
+	  @param sKey - fragment key
+	  @param sData - fragment output
+	  @param iTTL - time to live, seconds; 0 - without expiration
+	*/
+	void Put(const STLW::string  & sKey,
+	         const STLW::string  & sData,
+	         const UINT_32         iTTL);
+
+	/**
+	  @brief Remove all fragments
+	*/
+	void Clear();
+
+	/**
+	  @brief Get number of successful lookups
+	*/
+	UINT_64 GetHits() const;
+
+	/**
+	  @brief Get number of failed lookups
+	*/
+	UINT_64 GetMisses() const;
+
+	/**
+	  @brief Get number of stored fragments
+	*/
+	UINT_32 GetEntriesNum() const;
+
+	/**
+	  @brief Get size of stored data, bytes
+	*/
+	UINT_64 GetSize() const;
+
+	/**
+	  @brief A destructor
+	*/
+	~LRUFragmentCache() throw();
+private:
+	// FWD
+	struct Shard;
+
+	/** Shards                    */
+	Shard          * aShards;
+	/** Number of shards          */
+	UINT_32          iShardsNum;
+	/** Max. size of shard data   */
+	UINT_64          iShardMaxSize;
+
+	/**
+	  @brief Get shard by key
+	  @param sKey - fragment key
+	  @return shard for key
+	*/
+	Shard & GetShard(const STLW::string & sKey) const;
+
+	// Does not exist
+	LRUFragmentCache(const LRUFragmentCache & oRhs);
+	LRUFragmentCache & operator=(const LRUFragmentCache & oRhs);
+};
+
+} // namespace CTPP
+#endif // _CTPP2_FRAGMENT_CACHE_HPP__
+// End.
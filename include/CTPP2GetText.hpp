@@ -75,7 +75,7 @@ public:
 	  @param sDomain - i18n domain (if none, default domain used)
 	  @return translated message
 	*/
-	STLW::string FindMessage(const STLW::string & sLang, const STLW::string & sMessage, const STLW::string & sDomain = "");
+	STLW::string FindMessage(const STLW::string & sLang, const STLW::string & sMessage, const STLW::string & sDomain = "") const;
 
 	/**
 	  @brief Find translated message with correct plural form
@@ -87,7 +87,15 @@ public:
 	  @return translated message
 	*/
 	STLW::string FindPluralMessage(const STLW::string & sLang, const STLW::string & sMessage, const STLW::string & sPlMessage,
-	                               UINT_32 iCount, const STLW::string & ssDomain = "");
+	                               UINT_32 iCount, const STLW::string & ssDomain = "") const;
+
+	/**
+	  @brief Check that catalog is loaded
+	  @param sLang - language of translation
+	  @param sDomain - i18n domain (if none, default domain used)
+	  @return true if catalog for language and domain is loaded
+	*/
+	bool HasTranslation(const STLW::string & sLang, const STLW::string & sDomain = "") const;
 
 	/**
 	  @brief Set default i18n domain
@@ -102,63 +110,76 @@ public:
 	void InitSTDLibFunction(SyscallFactory & oSyscallFactory);
 
 	/**
-	  @brief Set language for system calls FnGetText/FnGetText_
+	  @brief Set default language for system calls FnGetText/FnGetText_; language of SyscallContext
+	         passed to virtual machine (VM::SetContext) takes precedence and does not touch shared handlers
 	  @param oSyscallFactory - factory with system calls
 	  @param sLang - language of translation
 	*/
 	void SetLanguage(SyscallFactory & oSyscallFactory, const STLW::string & sLang);
 
 private:
-	enum eCTPP2Instruction { INS_NONE  = 0,
-	                         INS_EQ    = 1,
-	                         INS_NE    = 2,
-	                         INS_LE    = 3,
-	                         INS_LT    = 4,
-	                         INS_GE    = 5,
-	                         INS_GT    = 6,
-	                         INS_MOD   = 7,
-	                         INS_JN    = 8,
-	                         INS_JMP   = 9,
-	                         INS_JLAND = 10,
-	                         INS_JLOR  = 11 };
+	/** Maximal depth of plural form rule evaluation stack */
+	static const UINT_32 C_MAX_PLURAL_STACK = 32;
+
+	enum eCTPP2Instruction { INS_PUSH_N  = 0,
+	                         INS_PUSH    = 1,
+	                         INS_EQ      = 2,
+	                         INS_NE      = 3,
+	                         INS_LE      = 4,
+	                         INS_LT      = 5,
+	                         INS_GE      = 6,
+	                         INS_GT      = 7,
+	                         INS_MOD     = 8,
+	                         INS_BOOL    = 9,
+	                         INS_JZ      = 10,
+	                         INS_JMP     = 11,
+	                         INS_JLAND   = 12,
+	                         INS_JLOR    = 13 };
 
 	/**
-	  @struct CTPP2Data CTPP2GetText.hpp <CTPP2GetText.hpp>
-	  @brief Representation of number/placeholder in plural form rule
+	  @struct CTPP2Instruction CTPP2GetText.hpp <CTPP2GetText.hpp>
+	  @brief Compiled instruction of plural form rule
 	*/
-	struct CTPP2Data
+	struct CTPP2Instruction
 	{
-		/**
-		  @brief A constructor for number data
-		  @param iValue - number
-		*/
-		CTPP2Data(UINT_32 iValue) : i_value(iValue), b_variable(false) { ;; }
-
-		/**
-		  @brief A constructor for placeholder data
-		*/
-		CTPP2Data() : i_value(0), b_variable(true) { ;; }
-
-		/** value of number  */
-		UINT_32 i_value;
-		/** placeholder flag */
-		bool b_variable;
+		/** Instruction code                                */
+		eCTPP2Instruction instruction;
+		/** Constant to push or absolute address of jump    */
+		UINT_32           argument;
 	};
 
 	/**
-	  @struct CTPP2Data CTPP2GetText.hpp <CTPP2GetText.hpp>
-	  @brief i18n catalog
+	  @struct CTPP2Message CTPP2GetText.hpp <CTPP2GetText.hpp>
+	  @brief Slot of message index; offsets point into .mo data
+	*/
+	struct CTPP2Message
+	{
+		/** Hash of message, (UINT_32)-1 if slot is empty   */
+		UINT_32  hash;
+		/** Offset of message                               */
+		UINT_32  key_offset;
+		/** Length of message (singular form only)          */
+		UINT_32  key_length;
+		/** Offset of translation                           */
+		UINT_32  value_offset;
+		/** Length of all translated forms, '\0'-separated  */
+		UINT_32  value_length;
+	};
+
+	/**
+	  @struct CTPP2Catalog CTPP2GetText.hpp <CTPP2GetText.hpp>
+	  @brief i18n catalog, frozen after loading
 	*/
 	struct CTPP2Catalog
 	{
-		/** stack of data for determining of plural form */
-		STLW::vector<CTPP2Data> v_pl_stack;
-		/** list of instructions for determining of plural form */
-		STLW::vector<eCTPP2Instruction> v_pl_instructions;
+		/** Raw .mo data, messages are referenced by offset                */
+		STLW::string s_data;
+		/** Open addressing index of messages, size is power of 2           */
+		STLW::vector<CTPP2Message> v_messages;
+		/** Compiled plural form rule, empty if catalog has no rule          */
+		STLW::vector<CTPP2Instruction> v_plural;
 		/** charset of messages from .mo file */
 		STLW::string s_charset;
-		/** messages with translations */
-		STLW::map<STLW::string, STLW::vector<STLW::string> > m_messages;
 		/** generic information from .mo file */
 		STLW::map<STLW::string, STLW::string> m_info;
 		/** flag of endiannes of .mo file */
@@ -175,130 +196,155 @@ private:
 
 	/** i18n domain for generating plural form rule */
 	STLW::string sWorkableDomain;
-	/** Language for generating plural form rule    */
-	STLW::string sWorkableLang;
+	/** Stack depth of plural form rule compiler    */
+	UINT_32      iWorkableDepth;
 
-	// Parsing of .mo file ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/**
+	  @brief Find catalog
+	  @param sLang - language of translation
+	  @param sDomain - i18n domain
+	  @return pointer to catalog or NULL if not found
+	*/
+	const CTPP2Catalog * FindCatalog(const STLW::string & sLang, const STLW::string & sDomain) const;
 
 	/**
-	  @brief Parse line of metadata from .mo file
-	  @param sLine - line of metadata
-	  @param sLastKey - key for multiline value
+	  @brief Find message in catalog index
+	  @param oCatalog - catalog
+	  @param sMessage - message
+	  @return pointer to index slot or NULL if not found
 	*/
-	void ParseMetadataLine(const STLW::string & sLine, STLW::string & sLastKey);
+	static const CTPP2Message * FindEntry(const CTPP2Catalog & oCatalog, const STLW::string & sMessage);
+
+	// Parsing of .mo file ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	/**
-	  @brief Parse metadata from .mo file
-	  @param sMeta - metadata
+	  @brief Load .mo file into catalog
+	  @param sFileName - .mo filename
+	  @param oCatalog - catalog to fill
 	*/
-	void ParseMetadata(const STLW::string & sMeta);
+	void LoadCatalog(const STLW::string & sFileName, CTPP2Catalog & oCatalog);
 
 	/**
-	  @brief Read .mo data by 4 bytes
-	  @param pData - .mo data
-	  @param iOffset - offset of reading
-	  @return integer value
+	  @brief Parse line of metadata from .mo file
+	  @param sLine - line of metadata
+	  @param sLastKey - key for multiline value
+	  @param oCatalog - catalog
 	*/
-	UINT_32 ReadMOData(UCCHAR_P pData, INT_32 iOffset);
+	void ParseMetadataLine(const STLW::string & sLine, STLW::string & sLastKey, CTPP2Catalog & oCatalog);
 
 	/**
-	  @brief Read .mo file
-	  @param szFileName - .mo filename
-	  @param iLength - length of read file
-	  @return data
+	  @brief Parse metadata from .mo file
+	  @param sMeta - metadata
+	  @param oCatalog - catalog
 	*/
-	UCHAR_P ReadFile(CCHAR_P szFileName, UINT_32 & iLength);
+	void ParseMetadata(const STLW::string & sMeta, CTPP2Catalog & oCatalog);
 
 	/**
-	  @brief Extract message from .mo data
-	  @param pData - .mo data
-	  @param iLength - length of .mo data
+	  @brief Add message to catalog index
+	  @param oCatalog - catalog
 	  @param iMasteridx - message index
 	  @param iTransidx - translated message index
 	*/
-	void ExtractMessage(UCCHAR_P pData, UINT_32 iLength, INT_32 iMasteridx, INT_32 iTransidx);
+	void ExtractMessage(CTPP2Catalog & oCatalog, UINT_32 iMasteridx, UINT_32 iTransidx);
 
 	// Expressions for generating plural form rule ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	/**
-	  @brief Term           = number | "n" | "(" TernaryExpr ")" | TernaryExpr
+	  @brief Term           = number | "n" | "(" TernaryExpr ")"
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
 	*/
-	STLW::string::size_type IsTerm(const STLW::string & sData, STLW::string::size_type iPos);
+	STLW::string::size_type IsTerm(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
 
 	/**
 	  @brief ModExpr        = Term { "%" Term }
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
 	*/
-	STLW::string::size_type IsModExpr(const STLW::string & sData, STLW::string::size_type iPos);
+	STLW::string::size_type IsModExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
 
 	/**
 	  @brief LtOrGtExpr     = ModExpr { LtOrGtRelation ModExpr }
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
 	*/
-	STLW::string::size_type IsLtOrGtExpr(const STLW::string & sData, STLW::string::size_type iPos);
+	STLW::string::size_type IsLtOrGtExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
 
 	/**
 	  @brief EqExpr         = LtOrGtExpr { EqRelation LtOrGtExpr }
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
 	*/
-	STLW::string::size_type IsEqExpr(const STLW::string & sData, STLW::string::size_type iPos);
+	STLW::string::size_type IsEqExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
 
 	/**
-	  @brief AndExpr        = EqExpr { "&&" AndExpr }
+	  @brief AndExpr        = EqExpr { "&&" EqExpr }
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
 	*/
-	STLW::string::size_type IsAndExpr(const STLW::string & sData, STLW::string::size_type iPos);
+	STLW::string::size_type IsAndExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
 
 	/**
-	  @brief OrExpr         = AndExpr { "||" OrExpr }
+	  @brief OrExpr         = AndExpr { "||" AndExpr }
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
 	*/
-	STLW::string::size_type IsOrExpr(const STLW::string & sData, STLW::string::size_type iPos);
+	STLW::string::size_type IsOrExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
 
 	/**
-	  @brief TernaryExpr    = OrExpr { "?" TernaryExpr ":" TernaryExpr }
+	  @brief TernaryExpr    = OrExpr [ "?" TernaryExpr ":" TernaryExpr ]
 	  @param sData - current stream
 	  @param iPos - current stream position
-	  @return STLW::string::npos if sequence not found or position to end of sequence
+	  @param vCode - compiled rule
+	  @return position to end of sequence
+	*/
+	STLW::string::size_type IsTernaryExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode);
+
+	/**
+	  @brief Append instruction to compiled rule
+	  @param vCode - compiled rule
+	  @param eInstruction - instruction
+	  @param iArgument - constant or jump address
+	  @param iStackDelta - change of stack depth after instruction
+	  @return address of instruction
 	*/
-	STLW::string::size_type IsTernaryExpr(const STLW::string & sData, STLW::string::size_type iPos);
+	UINT_32 EmitInstruction(STLW::vector<CTPP2Instruction> & vCode, eCTPP2Instruction eInstruction, UINT_32 iArgument, INT_32 iStackDelta);
 
 	// Other stuff ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	/**
 	  @brief Calculate plural form of message
 	  @param iCount - determine plural form
-	  @param sLang - language of translation
-	  @param sDomain - i18n domain
+	  @param oCatalog - catalog with compiled plural form rule
 	  @return Number of plural form
 	*/
-	UINT_32 CalculatePluralForm(UINT_32 iCount, const STLW::string & sLang, const STLW::string & sDomain);
+	static UINT_32 CalculatePluralForm(UINT_32 iCount, const CTPP2Catalog & oCatalog);
 
 	/**
 	  @brief Generate plural form rule
 	  @param sPluralRule - string of plural form rule from .mo file
+	  @param oCatalog - catalog
 	*/
-	void GeneratePluralRule(const STLW::string & sPluralRule);
+	void GeneratePluralRule(const STLW::string & sPluralRule, CTPP2Catalog & oCatalog);
 
 	/**
 	  @brief Stringify instruction for determining plural form
 	  @param eType - instruction for determining plural form
 	  @return string representation of instruction
 	*/
-	CCHAR_P StringifyInstruction(eCTPP2Instruction eType);
+	static CCHAR_P StringifyInstruction(eCTPP2Instruction eType);
 
 };
 
@@ -0,0 +1,207 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2JSONFastParser.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_JSON_FAST_PARSER_H__
+#define _CTPP2_JSON_FAST_PARSER_H__ 1
+
+#include "CDT.hpp"
+
+#include "STLMap.hpp"
+#include "STLString.hpp"
+#include "STLVector.hpp"
+
+/**
+  @file CTPP2JSONFastParser.hpp
+  @brief Fast parser of strict JSON.
+
+  Stage 1 classifies input in 64-byte blocks (quotes, backslashes, structural characters, white space),
+  finds escaped characters and string bodies with bit arithmetic and collects positions of
+  structural characters, quotes and starts of numbers and literals into structural index.
+  Stage 2 walks the index and builds CDT; strings are copied in bulk.
+
+  Everything CTPP2JSONParser handles in its own way (comments, single-quoted strings, bare words,
+  numeric keys, leading zeros, exponent without decimal point, uppercase \\u escapes)
+  is rejected, so caller can fall back to CTPP2JSONParser and get the same result or the same error.
+
+  In lazy mode (ParseLazy) stage 2 only validates data and remembers where every ARRAY and HASH ends;
+  containers are lazy CDT objects which index their elements when template or function touches them
+  for the first time, untouched subtrees are never converted.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+// FWD
+class CTPP2JSONLazyContainer;
+
+/**
+  @class CTPP2JSONFastParser CTPP2JSONFastParser.hpp <CTPP2JSONFastParser.hpp>
+  @brief Fast parser of strict JSON
+*/
+class CTPP2DECL CTPP2JSONFastParser
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oICDT - data collector
+	*/
+	CTPP2JSONFastParser(CDT & oICDT);
+
+	/**
+	  @brief Parse JSON data
+	  @param szIData - start of data
+	  @param szIEnd - end of data
+	  @return true if data parsed, false if data is not strict JSON; data collector is not changed in this case
+	*/
+	bool Parse(CCHAR_P szIData, CCHAR_P szIEnd);
+
+	/**
+	  @brief Validate and index JSON data; ARRAYs and HASHes are materialized on first access
+	  @param szIData - start of data
+	  @param szIEnd - end of data
+	  @return true if data indexed, false if data is not strict JSON; data collector is not changed in this case
+
+	  Data is not copied: data and parser MUST outlive data collector and all CDT objects obtained from it.
+	  Next call of Parse or ParseLazy destroys lazy containers and resets data collector.
+	*/
+	bool ParseLazy(CCHAR_P szIData, CCHAR_P szIEnd);
+
+	/**
+	  @brief A destructor
+	*/
+	~CTPP2JSONFastParser() throw();
+private:
+	friend class CTPP2JSONLazyContainer;
+
+	/** Data collector             */
+	CDT                    & oCDT;
+	/** Data                       */
+	CCHAR_P                  szData;
+	/** Data length                */
+	UINT_32                  iLength;
+	/** Structural index           */
+	STLW::vector<UINT_32>    vIndex;
+	/** Current token              */
+	UINT_32                  iToken;
+	/** Temp. buffer               */
+	STLW::string             sTMPBuf;
+	/** Hash key                   */
+	STLW::string             sKey;
+	/** Lazy mode: for opening tokens of ARRAY and HASH - token after the closing one */
+	STLW::vector<UINT_32>    vSkip;
+	/** Lazy containers            */
+	STLW::map<UINT_32, CTPP2JSONLazyContainer *>  mContainers;
+
+	/**
+	  @brief Build structural index
+	  @return false if string is not terminated
+	*/
+	bool BuildIndex();
+
+	/**
+	  @brief JSON value
+	  @param oValue - CDT object
+	  @param iDepth - nesting level
+	  @return false if value is not strict JSON
+	*/
+	bool ParseValue(CDT & oValue, const UINT_32 iDepth);
+
+	/**
+	  @brief JSON object
+	  @param oValue - CDT object
+	  @param iDepth - nesting level
+	  @return false if object is not strict JSON
+	*/
+	bool ParseObject(CDT & oValue, const UINT_32 iDepth);
+
+	/**
+	  @brief JSON array
+	  @param oValue - CDT object
+	  @param iDepth - nesting level
+	  @return false if array is not strict JSON
+	*/
+	bool ParseArray(CDT & oValue, const UINT_32 iDepth);
+
+	/**
+	  @brief Validate JSON value, remember ends of ARRAYs and HASHes
+	  @param iDepth - nesting level
+	  @return false if value is not strict JSON
+	*/
+	bool IndexValue(const UINT_32 iDepth);
+
+	/**
+	  @brief Build value of given token; ARRAY and HASH are lazy
+	  @param iValueToken - first token of value
+	  @param oValue - CDT object
+	*/
+	void BuildLazyValue(const UINT_32 iValueToken, CDT & oValue);
+
+	/**
+	  @brief JSON string
+	  @param iStringToken - token of opening quote; closing quote is always next token
+	  @param sValue - unescaped string
+	  @return false if string is not strict JSON
+	*/
+	bool ParseString(const UINT_32 iStringToken, STLW::string & sValue);
+
+	/**
+	  @brief Check JSON string escapes without unescaping
+	  @param iStringToken - token of opening quote
+	  @return false if string is not strict JSON
+	*/
+	bool CheckString(const UINT_32 iStringToken) const;
+
+	/**
+	  @brief Delete lazy containers and reset data collector, if it refers to them
+	*/
+	void ClearContainers();
+
+	/**
+	  @brief JSON number
+	  @param iPos - position of first character
+	  @param oValue - CDT object
+	  @return false if number is not strict JSON
+	*/
+	bool ParseNumber(const UINT_32 iPos, CDT & oValue);
+
+	/**
+	  @brief JSON literal (true, false, null)
+	  @param iPos - position of first character
+	  @param szLiteral - literal
+	  @param iLiteralLength - literal length
+	  @return false if literal does not match
+	*/
+	bool ParseLiteral(const UINT_32 iPos, CCHAR_P szLiteral, const UINT_32 iLiteralLength);
+};
+
+} // namespace CTPP
+#endif // _CTPP2_JSON_FAST_PARSER_H__
+// End.
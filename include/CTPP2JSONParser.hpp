@@ -54,8 +54,10 @@ class CTPP2DECL CTPP2JSONParser
 public:
 	/**
 	  @brief Constructor
+	  @param oICDT - data collector
+	  @param bIUseFastParser - try CTPP2JSONFastParser first and parse data here only if it is not strict JSON
 	*/
-	CTPP2JSONParser(CDT & oICDT);
+	CTPP2JSONParser(CDT & oICDT, const bool & bIUseFastParser = true);
 
 	/**
 	  @brief Parse JSON data
@@ -72,6 +74,8 @@ public:
 private:
 	/** Data collector        */
 	CDT           & oCDT;
+	/** Try fast parser first */
+	bool            bUseFastParser;
 	/** Temp. buffer          */
 	STLW::string    sTMPBuf;
 	/** Parsed integer value  */
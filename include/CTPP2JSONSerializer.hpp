@@ -0,0 +1,127 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2JSONSerializer.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_JSON_SERIALIZER_H__
+#define _CTPP2_JSON_SERIALIZER_H__ 1
+
+#include "CTPP2Types.h"
+
+/**
+  @file CTPP2JSONSerializer.hpp
+  @brief Streaming CDT to JSON serializer.
+
+  Output is accumulated in small internal buffer and passed to output collector in large chunks;
+  long runs of characters that need no escaping are passed to collector directly, without copying.
+  Such runs are found 16 bytes at a time (SSE2), or with lookup table on other platforms.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+// FWD
+class CDT;
+class OutputCollector;
+
+/**
+  @var C_JSON_SERIALIZER_BUFFER_LEN
+  @brief Size of internal buffer
+*/
+#define C_JSON_SERIALIZER_BUFFER_LEN 4096
+
+/**
+  @class CTPP2JSONSerializer CTPP2JSONSerializer.hpp <CTPP2JSONSerializer.hpp>
+  @brief Streaming CDT to JSON serializer
+*/
+class CTPP2DECL CTPP2JSONSerializer
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oICollector - output collector
+	  @param bIECMAConventions - use ECMA-262 conventions for escape sequences (\\', \\v, \\0)
+	  @param bIHTMLSafe - escape '<' and '>' as \\u003c and \\u003e
+	*/
+	CTPP2JSONSerializer(OutputCollector  & oICollector,
+	                    const bool       & bIECMAConventions = false,
+	                    const bool       & bIHTMLSafe = true);
+
+	/**
+	  @brief Write CDT as JSON value
+	  @param oCDT - input data
+	*/
+	void WriteCDT(const CDT & oCDT);
+
+	/**
+	  @brief Write escaped string, without quotes
+	  @param szData - input data
+	  @param iDataLength - data length
+	*/
+	void WriteString(CCHAR_P szData, const UINT_32 iDataLength);
+
+	/**
+	  @brief Write data as is
+	  @param szData - data
+	  @param iDataLength - data length
+	*/
+	void Write(CCHAR_P szData, const UINT_32 iDataLength);
+
+	/**
+	  @brief Pass buffered data to output collector
+	*/
+	void Flush();
+
+	/**
+	  @brief A destructor; flushes buffered data
+	*/
+	~CTPP2JSONSerializer() throw();
+private:
+	/** Output collector            */
+	OutputCollector  & oCollector;
+	/** Escape classes to check     */
+	UCHAR_8            iEscapeMask;
+	/** Use ECMA-262 conventions    */
+	bool               bECMAConventions;
+	/** Buffered data length        */
+	UINT_32            iBufferLength;
+	/** Buffer                      */
+	CHAR_8             aBuffer[C_JSON_SERIALIZER_BUFFER_LEN];
+
+	/**
+	  @brief Find next character that should be escaped
+	  @param szData - start of data
+	  @param szEnd - end of data
+	  @return pointer to character or szEnd
+	*/
+	CCHAR_P FindEscape(CCHAR_P szData, CCHAR_P szEnd) const;
+};
+
+} // namespace CTPP
+#endif // _CTPP2_JSON_SERIALIZER_H__
+// End.
@@ -0,0 +1,219 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2JSONStreamParser.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_JSON_STREAM_PARSER_H__
+#define _CTPP2_JSON_STREAM_PARSER_H__ 1
+
+#include "CDT.hpp"
+
+#include "STLString.hpp"
+#include "STLVector.hpp"
+
+/**
+  @file CTPP2JSONStreamParser.hpp
+  @brief Incremental (push-mode) JSON parser.
+
+  Document is passed in chunks of any size, for example as it is read from pipe or socket;
+  parser keeps its state between calls and builds CDT on the fly, so raw text does not need to be
+  kept in memory. Accepts the same syntax as CTPP2JSONParser: comments, single-quoted strings,
+  case-insensitive null/true/false and numeric keys. As in CTPP2JSONParser, document may be a single
+  value of any type, not only ARRAY or HASH.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @class CTPP2JSONStreamParser CTPP2JSONStreamParser.hpp <CTPP2JSONStreamParser.hpp>
+  @brief Incremental JSON parser
+*/
+class CTPP2DECL CTPP2JSONStreamParser
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oICDT - data collector
+	*/
+	CTPP2JSONStreamParser(CDT & oICDT);
+
+	/**
+	  @brief Parse next chunk of JSON data
+	  @param szData - start of chunk
+	  @param szEnd - end of chunk
+	  @return 0 if success; throws CTPPParserSyntaxError on error
+	*/
+	INT_32 Parse(CCHAR_P szData, CCHAR_P szEnd);
+
+	/**
+	  @brief Finish parsing, check that document is complete
+	  @return 0 if success; throws CTPPParserSyntaxError on error
+	*/
+	INT_32 Finish();
+
+	/**
+	  @brief A destructor
+	*/
+	~CTPP2JSONStreamParser() throw();
+private:
+	/**
+	  @enum eExpect CTPP2JSONStreamParser.hpp <CTPP2JSONStreamParser.hpp>
+	  @brief What parser expects after white space
+	*/
+	enum eExpect { VALUE,
+	               VALUE_OR_CLOSE,
+	               KEY,
+	               KEY_OR_CLOSE,
+	               COLON,
+	               COMMA_OR_CLOSE,
+	               NOTHING };
+
+	/**
+	  @enum eToken CTPP2JSONStreamParser.hpp <CTPP2JSONStreamParser.hpp>
+	  @brief Token that is not finished yet
+	*/
+	enum eToken { NONE,
+	              STRING,
+	              STRING_ESCAPE,
+	              STRING_UNICODE,
+	              NUMBER,
+	              WORD,
+	              SLASH,
+	              LINE_COMMENT,
+	              BLOCK_COMMENT,
+	              BLOCK_COMMENT_STAR };
+
+	/**
+	  @struct Frame CTPP2JSONStreamParser.hpp <CTPP2JSONStreamParser.hpp>
+	  @brief Open ARRAY or HASH
+	*/
+	struct Frame
+	{
+		/** Container                  */
+		CDT      * container;
+		/** Index of current element   */
+		UINT_32    index;
+		/** true, if container is HASH */
+		bool       is_hash;
+	};
+
+	/** Data collector                 */
+	CDT                   & oCDT;
+	/** Open containers                */
+	STLW::vector<Frame>     vStack;
+	/** Expected token                 */
+	eExpect                 eExpected;
+	/** Unfinished token               */
+	eToken                  eCurrentToken;
+	/** Unfinished token is HASH key   */
+	bool                    bKeyToken;
+	/** String terminator, ' or "      */
+	CHAR_8                  chQuote;
+	/** Number parsing phase           */
+	UINT_32                 iNumberPhase;
+	/** Number of \\u digits read      */
+	UINT_32                 iUnicodeDigits;
+	/** \\u code point                 */
+	UINT_32                 iUnicode;
+	/** Token text                     */
+	STLW::string            sTMPBuf;
+	/** Current HASH key               */
+	STLW::string            sKey;
+	/** Bytes parsed before chunk      */
+	UINT_64                 iChunkOffset;
+	/** Offset of current line         */
+	UINT_64                 iLineOffset;
+	/** Current line                   */
+	UINT_32                 iLine;
+	/** Current chunk                  */
+	CCHAR_P                 szChunk;
+
+	/**
+	  @brief Throw syntax error at given position of current chunk
+	  @param szReason - error description
+	  @param szPos - position of error
+	*/
+	void SyntaxError(CCHAR_P szReason, CCHAR_P szPos) const;
+
+	/**
+	  @brief Throw error describing expected token
+	  @param szPos - position of error
+	*/
+	void UnexpectedToken(CCHAR_P szPos) const;
+
+	/**
+	  @brief Register line feed
+	  @param szPos - position of line feed
+	*/
+	void LineFeed(CCHAR_P szPos);
+
+	/**
+	  @brief Get slot for new value
+	  @return reference to new value
+	*/
+	CDT & ValueSlot();
+
+	/**
+	  @brief Finish value
+	*/
+	void ValueDone();
+
+	/**
+	  @brief Open ARRAY or HASH
+	  @param bIsHash - true, if HASH should be opened
+	*/
+	void OpenContainer(const bool bIsHash);
+
+	/**
+	  @brief Finish string token
+	*/
+	void StringDone();
+
+	/**
+	  @brief Finish number token
+	*/
+	void NumberDone();
+
+	/**
+	  @brief Finish bare word token
+	  @param szPos - position after the word
+	*/
+	void WordDone(CCHAR_P szPos);
+
+	/**
+	  @brief Parse token start or structural character
+	  @param szPos - current position
+	*/
+	void ParseStructural(CCHAR_P szPos);
+};
+
+} // namespace CTPP
+#endif // _CTPP2_JSON_STREAM_PARSER_H__
+// End.
@@ -0,0 +1,64 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2NumberFormat.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_NUMBER_FORMAT_HPP__
+#define _CTPP2_NUMBER_FORMAT_HPP__ 1
+
+#include "CTPP2Types.h"
+
+/**
+  @file CTPP2NumberFormat.hpp
+  @brief Fast number-to-string conversion, replacement of snprintf("%lli") and snprintf("%.*G")
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @brief Format integer, same output as snprintf("%lli")
+  @param iValue - value to format
+  @param szBuffer - output buffer, at least 21 bytes; result is NOT zero-terminated
+  @return length of formatted value
+*/
+CTPP2DECL UINT_32 FormatInteger(const INT_64 iValue, CHAR_P szBuffer);
+
+/**
+  @brief Format floating point value, same output as snprintf("%.*G", iPrecision)
+  @param dValue - value to format
+  @param iPrecision - number of significant digits, 1 .. 17
+  @param szBuffer - output buffer, at least 32 bytes; result is NOT zero-terminated
+  @return length of formatted value
+*/
+CTPP2DECL UINT_32 FormatFloat(const W_FLOAT dValue, const INT_32 iPrecision, CHAR_P szBuffer);
+
+} // namespace CTPP
+#endif // _CTPP2_NUMBER_FORMAT_HPP__
+// End.
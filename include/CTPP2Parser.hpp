@@ -34,6 +34,7 @@
 
 #include "CTPP2CharIterator.hpp"
 #include "CTPP2Compiler.hpp"
+#include "CTPP2Escape.hpp"
 #include "CDT.hpp"
 
 /**
@@ -48,6 +49,8 @@ namespace CTPP // C++ Template Engine
 class StaticData;
 class StaticText;
 class CTPP2SourceLoader;
+class CTPP2GetText;
+class SyscallFactory;
 
 /**
   @class CTPP2Parser CTPP2Parser.hpp <CTPP2Parser.hpp>
@@ -80,6 +83,25 @@ public:
 	*/
 	INT_32 Compile(const UINT_32 & iHalt = 1);
 
+	/**
+	  @brief Set default escaping of &lt;TMPL_var&gt; for whole template and included files
+	  @param eIEscapeMode - escaping rules, ESCAPE_NONE to output values as is
+	*/
+	void SetEscapeMode(const eCTPP2EscapeType eIEscapeMode);
+
+	/**
+	  @brief Translate GETTEXT() and _() calls with literal arguments at compile time; other calls are executed at run time
+	  @param pIGetText - message catalogs, NULL to disable
+	  @param sILanguage - language of translation
+	*/
+	void SetGetText(const CTPP2GetText * pIGetText, const STLW::string & sILanguage);
+
+	/**
+	  @brief Evaluate calls of pure functions (CTPP2_SYSCALL_PURE) with literal arguments at compile time
+	  @param pISyscallFactory - functions available at run time, NULL to disable
+	*/
+	void SetSyscallFactory(const SyscallFactory * pISyscallFactory);
+
 	/**
 	  @brief A destructor
 	*/
@@ -103,7 +125,9 @@ private:
 	                      TMPL_comment = 11,
 	                      TMPL_break   = 12,
 	                      TMPL_block   = 13,
-	                      TMPL_verbose = 14 };
+	                      TMPL_verbose = 14,
+	                      TMPL_cache   = 15,
+	                      TMPL_escape  = 16 };
 
 	enum eCTPP2ExprOperator { EXPR_UNDEF        = 0,
 	                          EXPR_INT_VALUE    = 1,
@@ -200,6 +224,8 @@ private:
 	STLW::string         sSourceName;
 	/** Template source name ID */
 	UINT_32             iSourceNameId;
+	/** Hash of template source */
+	UINT_32             iSourceHash;
 	/** Foreach flag            */
 	bool                bInForeach;
 	/** Recursion level         */
@@ -217,6 +243,20 @@ private:
 
 	/** JMP points for TMPL_break */
 	STLW::vector<STLW::vector<INT_32> > vBreakJMPPoints;
+	/** Loop nesting level of innermost TMPL_cache */
+	UINT_32             iCacheLoopLevel;
+	/** Default escaping of TMPL_var */
+	eCTPP2EscapeType    eEscapeMode;
+	/** Catalogs for compile-time translation */
+	const CTPP2GetText * pGetText;
+	/** Language of compile-time translation  */
+	STLW::string        sLanguage;
+	/** Functions for compile-time evaluation */
+	const SyscallFactory * pSyscallFactory;
+	/** First instruction of last function call (with arguments) */
+	UINT_32             iLastCallIP;
+	/** Instruction after last function call */
+	UINT_32             iLastCallEndIP;
 
 	// Simple tokens: open and close tags, operators, variables, strings and numbers //////////////////////////////////////////////////////////////////////////////////
 
@@ -255,6 +295,35 @@ private:
 	*/
 	CCharIterator IsFunc(CCharIterator szData, CCharIterator szEnd, CCharIterator & sFuncEnd, UINT_32 & iFunctionParams);
 
+	/**
+	  @brief Function [a-zA-Z_][a-zA-Z0-9_]( Expr [, Expr2 ... ] ), collects values of literal arguments
+	  @param szData - current stream position
+	  @param szEnd - end of stream position
+	  @param sFuncEnd - end of function name
+	  @param iFunctionParams - number of function parameters
+	  @param vConstArgs - values of leading arguments that are string or integer literals
+	  @return NULL if sequence not found or pointer to end of sequence
+	*/
+	CCharIterator IsFunc(CCharIterator szData, CCharIterator szEnd, CCharIterator & sFuncEnd, UINT_32 & iFunctionParams, STLW::vector<CDT> & vConstArgs);
+
+	/**
+	  @brief Translate call of GETTEXT or _ with literal arguments at compile time
+	  @param sFuncName - function name
+	  @param vArgs - values of arguments
+	  @param sResult - translated message
+	  @return true if call is translated, false if it should be executed at run time
+	*/
+	bool TranslateCall(const STLW::string & sFuncName, const STLW::vector<CDT> & vArgs, STLW::string & sResult) const;
+
+	/**
+	  @brief Evaluate call of pure function with literal arguments at compile time
+	  @param sFuncName - function name
+	  @param vArgs - values of arguments
+	  @param oResult - string or integer result of call
+	  @return true if call is evaluated, false if it should be executed at run time
+	*/
+	bool EvaluateCall(const STLW::string & sFuncName, const STLW::vector<CDT> & vArgs, CDT & oResult) const;
+
 	/**
 	  @brief CTPP2 function a-zA-Z_[a-zA-Z0-9_]
 	  @param szData - current stream position
@@ -532,6 +601,22 @@ private:
 	*/
 	CCharIterator VerboseOperator(CCharIterator szData, CCharIterator szEnd);
 
+	/**
+	  @brief Cached fragment &lt;TMPL_cache key(Expr, ...) ttl(Expr)&gt; ..... &lt/TMPL_cache&gt;
+	  @param szData - current stream position
+	  @param szEnd - end of stream position
+	  @return NULL if sequence not found or pointer to end of sequence
+	*/
+	CCharIterator CacheOperator(CCharIterator szData, CCharIterator szEnd);
+
+	/**
+	  @brief Default escaping of TMPL_var &lt;TMPL_escape "html"&gt; ..... &lt/TMPL_escape&gt;
+	  @param szData - current stream position
+	  @param szEnd - end of stream position
+	  @return NULL if sequence not found or pointer to end of sequence
+	*/
+	CCharIterator EscapeOperator(CCharIterator szData, CCharIterator szEnd);
+
 	/**
 	  @brief Break operator; &lt;TMPL_break&gt;
 	  @param szData - current stream position
@@ -580,6 +665,14 @@ private:
 	*/
 	bool CheckTrailingFlag(CCharIterator & szData, CCharIterator szEnd);
 
+	/**
+	  @brief Check "raw output" flag of TMPL_var
+	  @param szData - current stream position
+	  @param szEnd - end of stream position
+	  @return NULL if flag not found or pointer to end of flag
+	*/
+	CCharIterator IsRawFlag(CCharIterator szData, CCharIterator szEnd);
+
 	/**
 	  @brief Remove trailing newline(s)
 	  @param szData - current stream position
@@ -604,6 +697,16 @@ private:
 	*/
 	CCharIterator CallArgs(CCharIterator szData, CCharIterator szEnd, UINT_32 & iArgCount);
 
+	/**
+	  @brief Parse list of expressions: name (a, b, c)
+	  @param szData - current stream position
+	  @param szEnd - end of stream position
+	  @param szName - name of list
+	  @param iArgCount - number of expressions
+	  @return NULL if sequence not found or pointer to end of sequence
+	*/
+	CCharIterator ExprList(CCharIterator szData, CCharIterator szEnd, CCHAR_P szName, UINT_32 & iArgCount);
+
 	/**
 	  @brief Set information about blocks
 	  @param mIBlockArgSizes - block argument sizes
@@ -0,0 +1,184 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2RecodeOutputCollector.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_RECODE_OUTPUT_COLLECTOR_HPP__
+#define _CTPP2_RECODE_OUTPUT_COLLECTOR_HPP__ 1
+
+#include "CTPP2StringIconvOutputCollector.hpp"
+
+/**
+  @file CTPP2RecodeOutputCollector.hpp
+  @brief Virtual machine output data collector with buffered charset recoding
+
+  UTF-8 output recoded to one of built-in single-byte charsets (CP1251, KOI8-R, CP866, ISO-8859-5,
+  ISO-8859-1, CP1252, US-ASCII) is converted with lookup tables without iconv. Any other pair of charsets
+  is converted with iconv in large blocks. Recoded data is passed to target collector in blocks too.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @var C_RECODE_COLLECTOR_BLOCK_SIZE
+  @brief Default size of conversion block
+*/
+#define C_RECODE_COLLECTOR_BLOCK_SIZE 65536
+
+struct RecodeCharsetTable;
+
+/**
+  @class RecodeOutputCollector CTPP2RecodeOutputCollector.hpp <CTPP2RecodeOutputCollector.hpp>
+  @brief Output data collector with buffered charset recoding
+*/
+class CTPP2DECL RecodeOutputCollector:
+  public OutputCollector
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oITarget - target collector
+	  @param sISrcEnc - Source charset
+	  @param sIDstEnc - Destination charset
+	  @param iIFlags - conversion flags, C_ICONV_DISCARD_ILSEQ and C_ICONV_TRANSLITERATE
+	  @param iIBlockSize - size of conversion block
+	*/
+	RecodeOutputCollector(OutputCollector     & oITarget,
+	                      const STLW::string  & sISrcEnc,
+	                      const STLW::string  & sIDstEnc,
+	                      const UINT_32         iIFlags = 0,
+	                      const UINT_32         iIBlockSize = C_RECODE_COLLECTOR_BLOCK_SIZE);
+
+	/**
+	  @brief Check whether charsets are recoded with built-in tables
+	  @return true if iconv is not used
+	*/
+	bool IsTableDriven() const;
+
+	/**
+	  @brief Recode buffered data and pass it to target collector
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Flush();
+
+	/**
+	  @brief A destructor; flushes buffered data
+	*/
+	~RecodeOutputCollector() throw();
+private:
+	/**
+	  @struct HighChar CTPP2RecodeOutputCollector.hpp <CTPP2RecodeOutputCollector.hpp>
+	  @brief Reverse mapping of character outside of direct lookup table
+	*/
+	struct HighChar
+	{
+		/** Unicode code point   */
+		UINT_32    ucs;
+		/** Destination byte     */
+		UCHAR_8    ch;
+	};
+
+	/** Target collector          */
+	OutputCollector              & oTarget;
+	/** Source charset            */
+	const STLW::string             sSrcEnc;
+	/** Destination charset       */
+	const STLW::string             sDstEnc;
+	/** Conversion flags          */
+	UINT_32                        iFlags;
+	/** Block size                */
+	UINT_32                        iBlockSize;
+
+	/** Output buffer             */
+	CHAR_P                         szOutBuffer;
+	/** Used part of output buffer */
+	UINT_32                        iOutUsed;
+
+	/** Built-in table, if any    */
+	const RecodeCharsetTable     * pTable;
+	/** Code points U+0080 - U+07FF, 0 if character cannot be represented */
+	UCHAR_8                        aDirect[0x0800];
+	/** Other code points, sorted */
+	HighChar                       aHigh[128];
+	/** Number of other code points */
+	UINT_32                        iHighNum;
+	/** Incomplete UTF-8 sequence */
+	UCHAR_8                        aTail[4];
+	/** Length of incomplete sequence */
+	UINT_32                        iTailLength;
+
+#ifdef ICONV_SUPPORT
+	/** Iconv converter           */
+	iconv_t                        oIconv;
+#endif // ICONV_SUPPORT
+	/** Input buffer, iconv only  */
+	CHAR_P                         szInBuffer;
+	/** Used part of input buffer */
+	UINT_32                        iInUsed;
+
+	/**
+	  @brief Pass output buffer to target collector
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 FlushOutput();
+
+	/**
+	  @brief Write recoded character to output buffer
+	  @param iUCS - Unicode code point
+	*/
+	void PutChar(const UINT_32 iUCS);
+
+	/**
+	  @brief Recode UTF-8 data with built-in table
+	  @param sData - data to recode
+	  @param sEnd - end of data
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 RecodeTable(CCHAR_P sData, CCHAR_P sEnd);
+
+	/**
+	  @brief Recode input buffer with iconv
+	  @param bFinal - discard incomplete character at end of buffer
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 RecodeIconv(const bool bFinal);
+
+	/**
+	  @brief Collect data
+	  @param vData - data to store
+	  @param iDataLength - data length
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength);
+};
+
+} // namespace CTPP
+#endif // _CTPP2_RECODE_OUTPUT_COLLECTOR_HPP__
+// End.
@@ -38,6 +38,7 @@
 */
 
 #include "CTPP2Types.h"
+#include "CTPP2Escape.hpp"
 #include <string>
 #include <stdio.h>
 
@@ -60,8 +61,10 @@ public:
 	/**
 	  @brief Constructor
 	  @param sSourceFile - source file
+	  @param eEscapeMode - default escaping of &lt;TMPL_var&gt;
 	*/
-	SimpleCompiler(const std::string & sSourceFile);
+	SimpleCompiler(const std::string       & sSourceFile,
+	               const eCTPP2EscapeType    eEscapeMode = ESCAPE_NONE);
 
 	/**
 	  @brief Save compiled data to file
@@ -46,9 +46,11 @@ namespace CTPP // C++ Template Engine
 
 // FWD
 class CDT;
+class FragmentCache;
 class OutputCollector;
 class Logger;
 class VMLoader;
+struct SyscallContext;
 struct VMMemoryCore;
 
 /**
@@ -132,6 +134,24 @@ public:
 	*/
 	UINT_32 Run(CDT & oData, const VMMemoryCore * pCore, OutputCollector & oCollector, Logger & oLogger);
 
+	/**
+	  @brief Set storage of &lt;TMPL_cache&gt; fragments
+	  @param pFragmentCache - fragment storage, not owned by virtual machine
+	*/
+	void SetFragmentCache(FragmentCache * pFragmentCache);
+
+	/**
+	  @brief Set per-render context of system calls (language, i18n domain)
+	  @param pContext - context, not owned by virtual machine
+	*/
+	void SetContext(const SyscallContext * pContext);
+
+	/**
+	  @brief Enable or disable reuse of results of pure costly system calls during render
+	  @param bMemoize - true to store results (default)
+	*/
+	void SetMemoization(const bool bMemoize);
+
 	/**
 	  @brief A destructor
 	*/
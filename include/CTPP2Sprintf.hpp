@@ -44,8 +44,44 @@
 namespace CTPP // C++ Template Engine
 {
 
+/**
+  @brief Format arguments stored in CDT array
+  @param sFormatString - format string
+  @param sResult - formatted string [out]
+  @param oArgs - array of arguments
+  @return 0 - if success, -1 - if format string is invalid
+*/
 CTPP2DECL INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult, const CDT & oArgs);
 
+/**
+  @brief Format arguments of syscall
+  @param sFormatString - format string
+  @param sResult - formatted string [out]
+  @param aArguments - arguments in reverse order, as passed to SyscallHandler
+  @param iArgNum - number of arguments
+  @return 0 - if success, -1 - if format string is invalid
+*/
+CTPP2DECL INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult, const CDT * aArguments, const UINT_32 iArgNum);
+
+/**
+  @brief Parse format string into compact descriptor
+  @param sFormatString - format string
+  @param sDescriptor - parsed format string [out]
+  @return 0 - if success, -1 - if format string is invalid; descriptor reproduces output up to the error
+*/
+CTPP2DECL INT_32 CompileFormatString(const STLW::string & sFormatString, STLW::string & sDescriptor);
+
+/**
+  @brief Format arguments of syscall with parsed format string
+  @param szDescriptor - descriptor created by CompileFormatString
+  @param iDescriptorLength - descriptor length
+  @param sResult - formatted string [out]
+  @param aArguments - arguments in reverse order, as passed to SyscallHandler
+  @param iArgNum - number of arguments
+  @return 0 - if success, -1 - if format string is invalid or descriptor is broken
+*/
+CTPP2DECL INT_32 FormatCompiled(CCHAR_P szDescriptor, const UINT_32 iDescriptorLength, STLW::string & sResult, const CDT * aArguments, const UINT_32 iArgNum);
+
 } // namespace CTPP
 #endif // _CTPP2_SPRINTF_HPP__
 // End.
@@ -86,6 +86,13 @@ public:
 	*/
 	UINT_32 GetRecordsNum() const;
 
+	/**
+	  @brief Get whole text segment
+	  @param iDataSize - segment length
+	  @return pointer to start of segment
+	*/
+	CCHAR_P GetRawData(UINT_32 & iDataSize) const;
+
 	/**
 	  @brief A destructor
 	*/
@@ -99,6 +106,8 @@ protected:
 	const UINT_32          iUsedDataOffsetsSize;
 	/** Stored data offsets        */
 	const TextDataIndex  * aDataOffsets;
+	/** Length of stored data      */
+	UINT_32                iDataSize;
 };
 
 /**
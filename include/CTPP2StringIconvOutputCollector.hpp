@@ -47,11 +47,11 @@
 namespace CTPP // C++ Template Engine
 {
 
-#ifdef ICONV_SUPPORT
-
 #define C_ICONV_DISCARD_ILSEQ    0x00000001
 #define C_ICONV_TRANSLITERATE    0x00000002
 
+#ifdef ICONV_SUPPORT
+
 /**
   @class StringIconvOutputCollector StringIconvOutputCollector.hpp <StringIconvOutputCollector.hpp>
   @brief Output data collector with charset recoding
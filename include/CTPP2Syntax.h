@@ -59,6 +59,11 @@
 #define TMPL_BREAK_TOK            "break"
 #define TMPL_BLOCK_TOK            "block"
 #define TMPL_VERBOSE_TOK          "verbose"
+#define TMPL_CACHE_TOK            "cache"
+#define TMPL_ESCAPE_TOK           "escape"
+
+// Output of TMPL_var without default escaping
+#define TMPL_RAW_FLAG             "raw"
 
 // Relations
 #define TMPL_EQ      "eq"
@@ -0,0 +1,72 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2SyscallContext.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_SYSCALL_CONTEXT_HPP__
+#define _CTPP2_SYSCALL_CONTEXT_HPP__ 1
+
+#include "CTPP2Types.h"
+#include "STLString.hpp"
+
+/**
+  @file CTPP2SyscallContext.hpp
+  @brief Per-render parameters of system calls
+
+  Context is set on virtual machine before render (VM::SetContext) and passed to every system call,
+  so one set of handlers may serve concurrent renders in different languages.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @struct SyscallContext CTPP2SyscallContext.hpp <CTPP2SyscallContext.hpp>
+  @brief Per-render parameters of system calls
+*/
+struct CTPP2DECL SyscallContext
+{
+	/**
+	  @brief Constructor
+	  @param sILanguage - language of translation
+	  @param sIDomain - i18n domain (if empty, default domain is used)
+	*/
+	SyscallContext(const STLW::string & sILanguage = "",
+	               const STLW::string & sIDomain   = ""): language(sILanguage),
+	                                                      domain(sIDomain) { ;; }
+
+	/** Language of translation */
+	STLW::string    language;
+	/** i18n domain             */
+	STLW::string    domain;
+};
+
+} // namespace CTPP
+#endif // _CTPP2_SYSCALL_CONTEXT_HPP__
+// End.
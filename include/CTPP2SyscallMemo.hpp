@@ -0,0 +1,123 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2SyscallMemo.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_SYSCALL_MEMO_HPP__
+#define _CTPP2_SYSCALL_MEMO_HPP__ 1
+
+#include "CDT.hpp"
+#include "STLMap.hpp"
+#include "STLString.hpp"
+
+/**
+  @file CTPP2SyscallMemo.hpp
+  @brief Per-render memoization of results of pure system calls
+
+  Results of handlers with CTPP2_SYSCALL_PURE and CTPP2_SYSCALL_COSTLY capabilities are stored
+  by virtual machine for one render. Numbers and strings are compared by value, arrays and hashes
+  by identity (CDT::GetIdentity); arguments are kept while result is stored, so identity cannot be reused.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @var C_MAX_MEMOIZED_CALLS
+  @brief Max. number of stored results; storage is cleared when limit is reached
+*/
+#define C_MAX_MEMOIZED_CALLS 1024
+
+/**
+  @class SyscallMemo CTPP2SyscallMemo.hpp <CTPP2SyscallMemo.hpp>
+  @brief Results of pure system calls
+*/
+class CTPP2DECL SyscallMemo
+{
+public:
+	/**
+	  @brief Constructor
+	*/
+	SyscallMemo();
+
+	/**
+	  @brief Find result of call
+	  @param iCallNum - number of system call
+	  @param aArguments - list of arguments, as in stack frame
+	  @param iArgNum - number of arguments
+	  @param oResult - stored result [out]
+	  @return true if result found; false if not found or arguments cannot be compared (POINTER)
+	*/
+	bool Find(const UINT_32    iCallNum,
+	          const CDT      * aArguments,
+	          const UINT_32    iArgNum,
+	          CDT            & oResult);
+
+	/**
+	  @brief Store result of call; must follow Find with same arguments that returned false
+	  @param oResult - result of call
+	*/
+	void Store(const CDT & oResult);
+
+	/**
+	  @brief Remove all results
+	*/
+	void Clear();
+
+	/**
+	  @brief A destructor
+	*/
+	~SyscallMemo() throw();
+
+private:
+	/**
+	  @struct MemoRecord CTPP2SyscallMemo.hpp <CTPP2SyscallMemo.hpp>
+	  @brief Stored result
+	*/
+	struct MemoRecord
+	{
+		/** Result of call                           */
+		CDT    result;
+		/** Arrays and hashes referenced by key      */
+		CDT    arguments;
+	};
+
+	/** Results, by call number and arguments       */
+	STLW::map<STLW::string, MemoRecord>  mResults;
+	/** Key of last call passed to Find             */
+	STLW::string                         sKey;
+	/** Arrays and hashes of last call              */
+	CDT                                  oArguments;
+	/** Last call can be stored                     */
+	bool                                 bKeyValid;
+};
+
+} // namespace CTPP
+#endif // _CTPP2_SYSCALL_MEMO_HPP__
+// End.
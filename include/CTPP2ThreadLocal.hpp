@@ -0,0 +1,184 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2ThreadLocal.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_THREAD_LOCAL_HPP__
+#define _CTPP2_THREAD_LOCAL_HPP__ 1
+
+#include "CTPP2SysHeaders.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/**
+  @file CTPP2ThreadLocal.hpp
+  @brief Per-thread copy of object, used by system calls for caches of non-reentrant state
+
+  Object is created on first access from thread and destroyed when thread exits. Holder keeps list
+  of all copies and destroys copies of live threads with itself, so it must not be destroyed while
+  other threads still use it. If key of thread-specific data cannot be created (all keys are in use),
+  Get() returns NULL and caller works without cache. Without pthreads one shared copy is used.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @class ThreadLocal CTPP2ThreadLocal.hpp <CTPP2ThreadLocal.hpp>
+  @brief Per-thread copy of object
+*/
+template <typename T>class ThreadLocal
+{
+public:
+	/**
+	  @brief Constructor
+	*/
+	ThreadLocal()
+	{
+#ifdef HAVE_PTHREAD_H
+		pHead       = NULL;
+		bKeyCreated = (pthread_key_create(&oKey, Destroy) == 0);
+		pthread_mutex_init(&oMutex, NULL);
+#endif
+	}
+
+	/**
+	  @brief Get copy of object for current thread
+	  @return pointer to copy, or NULL if thread-specific data is not available
+	*/
+	T * Get()
+	{
+#ifdef HAVE_PTHREAD_H
+		if (!bKeyCreated) { return NULL; }
+
+		Slot * pSlot = (Slot *)pthread_getspecific(oKey);
+		if (pSlot == NULL)
+		{
+			pSlot = new Slot(this);
+			if (pthread_setspecific(oKey, pSlot) != 0) { delete pSlot; return NULL; }
+
+			pthread_mutex_lock(&oMutex);
+			pSlot -> next = pHead;
+			if (pHead != NULL) { pHead -> prev = pSlot; }
+			pHead = pSlot;
+			pthread_mutex_unlock(&oMutex);
+		}
+
+		return &(pSlot -> object);
+#else
+		return &oObject;
+#endif
+	}
+
+	/**
+	  @brief A destructor
+	*/
+	~ThreadLocal() throw()
+	{
+#ifdef HAVE_PTHREAD_H
+		// No more copies are destroyed on thread exit
+		if (bKeyCreated) { pthread_key_delete(oKey); }
+
+		pthread_mutex_lock(&oMutex);
+		while (pHead != NULL)
+		{
+			Slot * pSlot = pHead;
+			pHead = pSlot -> next;
+			delete pSlot;
+		}
+		pthread_mutex_unlock(&oMutex);
+
+		pthread_mutex_destroy(&oMutex);
+#endif
+	}
+
+private:
+	// Does not exist
+	ThreadLocal(const ThreadLocal & oRhs);
+	ThreadLocal & operator=(const ThreadLocal & oRhs);
+
+#ifdef HAVE_PTHREAD_H
+	/**
+	  @struct Slot
+	  @brief Copy of object, element of list of copies
+	*/
+	struct Slot
+	{
+		/**
+		  @brief Constructor
+		  @param pIOwner - holder of copy
+		*/
+		Slot(ThreadLocal * pIOwner): owner(pIOwner), prev(NULL), next(NULL) { ;; }
+
+		/** Copy of object   */
+		T               object;
+		/** Holder of copy   */
+		ThreadLocal   * owner;
+		/** Previous copy    */
+		Slot          * prev;
+		/** Next copy        */
+		Slot          * next;
+	};
+
+	/**
+	  @brief Destroy copy of object on thread exit
+	*/
+	static void Destroy(void * pData)
+	{
+		Slot * pSlot = (Slot *)pData;
+		ThreadLocal * pOwner = pSlot -> owner;
+
+		pthread_mutex_lock(&(pOwner -> oMutex));
+		if (pSlot -> prev != NULL) { pSlot -> prev -> next = pSlot -> next; }
+		else                       { pOwner -> pHead       = pSlot -> next; }
+		if (pSlot -> next != NULL) { pSlot -> next -> prev = pSlot -> prev; }
+		pthread_mutex_unlock(&(pOwner -> oMutex));
+
+		delete pSlot;
+	}
+
+	/** Key of thread-specific data       */
+	pthread_key_t      oKey;
+	/** Key is created                    */
+	bool               bKeyCreated;
+	/** Lock of list of copies            */
+	pthread_mutex_t    oMutex;
+	/** Copies of live threads            */
+	Slot             * pHead;
+#else
+	/** Shared copy of object             */
+	T                  oObject;
+#endif
+};
+
+} // namespace CTPP
+#endif // _CTPP2_THREAD_LOCAL_HPP__
+// End.
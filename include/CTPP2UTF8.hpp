@@ -0,0 +1,77 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2UTF8.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_UTF8_HPP__
+#define _CTPP2_UTF8_HPP__ 1
+
+#include "CTPP2Types.h"
+
+/**
+  @file CTPP2UTF8.hpp
+  @brief Counting and skipping of characters in UTF-8 strings.
+
+  Character boundaries are the same as found by utf_charlen. Pure ASCII blocks and blocks of whole
+  well-formed sequences are counted 16 (SSE2) or 32 (AVX2) bytes at a time; blocks with broken
+  sequences, and other platforms, fall back to utf_charlen, with 8-byte ASCII check.
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @fn UINT_32 UTF8Length(CCHAR_P szString, CCHAR_P szStringEnd)
+  @brief Number of characters in UTF-8 string
+  @param szString - start of string
+  @param szStringEnd - end of string
+  @return number of characters; every byte of broken sequence is counted as character,
+          incomplete sequence at the end of string is not counted
+*/
+CTPP2DECL UINT_32 UTF8Length(CCHAR_P   szString,
+                             CCHAR_P   szStringEnd);
+
+/**
+  @fn CCHAR_P UTF8Skip(CCHAR_P szString, CCHAR_P szStringEnd, const UINT_32 iChars, UINT_32 & iSkipped)
+  @brief Skip characters of UTF-8 string
+  @param szString - start of string
+  @param szStringEnd - end of string
+  @param iChars - number of characters to skip
+  @param iSkipped - number of skipped characters [out], less than iChars if string is shorter
+  @return position right after last skipped character, or position of incomplete sequence at the end of string;
+          bytes of broken sequences are skipped without counting
+*/
+CTPP2DECL CCHAR_P UTF8Skip(CCHAR_P          szString,
+                           CCHAR_P          szStringEnd,
+                           const UINT_32    iChars,
+                           UINT_32        & iSkipped);
+
+} // namespace CTPP
+#endif // _CTPP2_UTF8_HPP__
+// End.
@@ -37,16 +37,21 @@
   @brief Virtual Machine
 */
 
+#include "CTPP2SyscallMemo.hpp"
 #include "CTPP2VMArgStack.hpp"
 #include "CTPP2VMCodeStack.hpp"
+#include "STLVector.hpp"
 
 namespace CTPP // C++ Template Engine
 {
 
 // FWD
+class FragmentCache;
+class FragmentCapture;
 class OutputCollector;
 class SyscallFactory;
 class SyscallHandler;
+struct SyscallContext;
 struct VMMemoryCore;
 class Logger;
 
@@ -96,6 +101,24 @@ public:
 	*/
 	INT_32 Reset();
 
+	/**
+	  @brief Set storage of &lt;TMPL_cache&gt; fragments; without storage fragments are always executed
+	  @param pIFragmentCache - fragment storage, not owned by virtual machine
+	*/
+	void SetFragmentCache(FragmentCache * pIFragmentCache);
+
+	/**
+	  @brief Set per-render context of system calls (language, i18n domain)
+	  @param pIContext - context, not owned by virtual machine; NULL resets to empty context
+	*/
+	void SetContext(const SyscallContext * pIContext);
+
+	/**
+	  @brief Enable or disable reuse of results of pure costly system calls during render (enabled by default)
+	  @param bIMemoize - true to store results
+	*/
+	void SetMemoization(const bool bIMemoize);
+
 	/**
 	  @brief A destructor
 	*/
@@ -120,6 +143,8 @@ private:
 	UINT_32            iMaxUsedCalls;
 	/** System calls translation map */
 	SyscallHandler  ** aCallTranslationMap;
+	/** Results of calls may be reused */
+	bool             * aCallMemoizable;
 
 	/** Stack of arguments           */
 	VMArgStack         oVMArgStack;
@@ -131,6 +156,22 @@ private:
 	/** Virtual flags                */
 	UINT_32            iFlags;
 
+	/** Storage of cached fragments  */
+	FragmentCache                  * pFragmentCache;
+	/** Fragments being captured     */
+	STLW::vector<FragmentCapture *>  vCaptures;
+	/** Context of system calls      */
+	const SyscallContext           * pContext;
+	/** Reuse results of pure calls  */
+	bool                             bMemoize;
+	/** Results of pure calls        */
+	SyscallMemo                      oMemo;
+
+	/**
+	  @brief Discard unfinished fragment captures
+	*/
+	void ClearCaptures();
+
 	void CheckStackOnlyRegs(const UINT_32 iSrcReg, const UINT_32 iDstReg, const VMMemoryCore  * pMemoryCore, const UINT_32 iIP);
 };
 
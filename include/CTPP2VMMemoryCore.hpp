@@ -59,6 +59,21 @@ struct CTPP2DECL VMMemoryCore
 	*/
 	VMMemoryCore(const VMExecutable  * pVMExecutable);
 
+	/**
+	  @brief Get expected size of template output
+	  @return moving estimate of output size with some headroom, 0 if template was never rendered
+	*/
+	UINT_32 GetOutputSizeHint() const;
+
+	/**
+	  @brief Account size of rendered output
+	  @param iOutputSize - size of output of finished render, bytes
+
+	  One memory core may be shared by VMs running in several threads; the estimate is read and written
+	  with relaxed atomic operations, so concurrent updates may overwrite each other, but never tear.
+	*/
+	void UpdateOutputSize(const UINT_32  iOutputSize) const;
+
 	/** Code segment size                    */
 	const UINT_32                code_size;
 	/** Code segment                         */
@@ -75,6 +90,8 @@ struct CTPP2DECL VMMemoryCore
 	const ReducedHashTable       calls_table;
 	/** System calls translation map         */
 	INT_32                     * syscall_map;
+	/** Moving estimate of output size; accessed with relaxed atomic operations only, see UpdateOutputSize */
+	mutable UINT_32              output_size;
 };
 
 } // namespace CTPP
@@ -57,6 +57,7 @@
 #define RET              0x01050000 // Return from procedure
 #define JMP              0x01060000 // Unconditional jump
 #define LOOP             0x01070000 // Loop
+#define OUTCALL          0x01080000 // System call, result is sent to output collector
 
 #define RCALL            0x01140000 // Procedure call, relational version
 #define RJMP             0x01160000 // Unconditional jump, relational version
@@ -99,6 +100,7 @@
 #define MOVSIZE          0x04060000 // Move size of array or hash to register
 #define MOVIREGI         0x04070000 // Move indirect ARRAY from REGISTER pointed by REGISTER to another register
 #define MOVIREGS         0x04080000 // Move indirect HASH from REGISTER pointed by REGISTER to another register
+#define MOVREST          0x04090000 // Move number of ARRAY elements after index pointed by REGISTER to register
 
 // Comparison ops. ///// 0x-5-X---- //////////////////////////////////////////////////////////////////
 #define CMP              0x05010000 // Compare values, arithmetic
@@ -148,6 +150,9 @@
 #define SAVEBP           0x08090000 // Save base pointer
 #define RESTBP           0x080A0000 // Restore base pointer
 #define REPLIND          0x080B0000 // Replace ARRAY/HASH variable in stack with it's element
+#define CACHEGET         0x080C0000 // Output cached fragment or start capturing of fragment output
+#define CACHEPUT         0x080D0000 // Store captured fragment output in cache
+#define OUTPUTESC        0x080E0000 // Escape value and output it to output collector
 
 // Sources ///////////// 0x-------X //////////////////////////////////////////////////////////////////
 #define ARG_SRC_AR       0x00000000 // AR is source register
@@ -44,12 +44,21 @@ namespace CTPP // C++ Template Engine
 
 #define CTPP2_INT_HANDLER_PREFIX "__ctpp2"
 
+// API versions of system calls, see SyscallHandler::GetVersion
+#define CTPP2_SYSCALL_API_BASE    0 // Handler and ContextHandler only
+#define CTPP2_SYSCALL_API_OUTPUT  1 // OutputHandler writes result straight to output collector
+
+// Capabilities of system calls, see SyscallHandler::GetCapabilities
+#define CTPP2_SYSCALL_PURE        0x00000001 // Result depends on arguments only, call has no side effects
+#define CTPP2_SYSCALL_COSTLY      0x00000002 // Call is expensive, result is worth storing for reuse
+
 // FWD
 class CDT;
 class OutputCollector;
 class ReducedStaticText;
 class ReducedStaticData;
 class Logger;
+struct SyscallContext;
 
 /**
   @class SyscallHandler CTPP2VMSyscall.hpp <CTPP2VMSyscall.hpp>
@@ -99,6 +108,7 @@ public:
 
 	/**
 	  @brief Get API version
+	  @return CTPP2_SYSCALL_API_BASE by default, CTPP2_SYSCALL_API_OUTPUT if OutputHandler is implemented
 	*/
 	virtual INT_32 GetVersion() const;
 
@@ -113,6 +123,108 @@ public:
 	  @brief A destructor
 	*/
 	virtual ~SyscallHandler() throw();
+
+	// Methods added after 2.8.4 follow destructor, so slots of older methods stay in place
+
+	/**
+	  @brief Handler with per-render context; default implementation ignores context
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCDTRetVal - return value
+	  @param oContext - per-render context
+	  @param oLogger - logger
+	*/
+	virtual INT_32 ContextHandler(CDT                   * aArguments,
+	                              const UINT_32           iArgNum,
+	                              CDT                   & oCDTRetVal,
+	                              const SyscallContext  & oContext,
+	                              Logger                & oLogger);
+
+	/**
+	  @brief Handler that writes result to output collector instead of returning it; called by VM for
+	         <TMPL_var FUNCTION(...)> if GetVersion() returns CTPP2_SYSCALL_API_OUTPUT or greater.
+	         Default implementation calls ContextHandler and writes result as string
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCollector - output data collector
+	  @param oContext - per-render context
+	  @param oLogger - logger
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	virtual INT_32 OutputHandler(CDT                   * aArguments,
+	                             const UINT_32           iArgNum,
+	                             OutputCollector       & oCollector,
+	                             const SyscallContext  & oContext,
+	                             Logger                & oLogger);
+
+	/**
+	  @brief Get capabilities of function
+	  @return 0 by default; CTPP2_SYSCALL_PURE - call with literal arguments may be evaluated at compile time,
+	          CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY - result may be reused by virtual machine during render
+	*/
+	virtual UINT_32 GetCapabilities() const;
+};
+
+/**
+  @class SyscallWriter CTPP2VMSyscall.hpp <CTPP2VMSyscall.hpp>
+  @brief Base class of functions that write result piece by piece; Write is used both for return value
+         and for output collector, so <TMPL_var FUNCTION(...)> does not build result in memory
+*/
+class CTPP2DECL SyscallWriter:
+  public SyscallHandler
+{
+public:
+	/**
+	  @brief Handler, collects result of Write into return value
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCDTRetVal - return value
+	  @param oLogger - logger
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Handler(CDT            * aArguments,
+	               const UINT_32    iArgNum,
+	               CDT            & oCDTRetVal,
+	               Logger         & oLogger);
+
+	/**
+	  @brief Handler with output to collector, calls Write
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCollector - output data collector
+	  @param oContext - per-render context
+	  @param oLogger - logger
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 OutputHandler(CDT                   * aArguments,
+	                     const UINT_32           iArgNum,
+	                     OutputCollector       & oCollector,
+	                     const SyscallContext  & oContext,
+	                     Logger                & oLogger);
+
+	/**
+	  @brief Get API version
+	  @return CTPP2_SYSCALL_API_OUTPUT
+	*/
+	INT_32 GetVersion() const;
+
+	/**
+	  @brief Write result to output collector
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCollector - output data collector
+	  @param oLogger - logger
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	virtual INT_32 Write(CDT              * aArguments,
+	                     const UINT_32      iArgNum,
+	                     OutputCollector  & oCollector,
+	                     Logger           & oLogger) = 0;
+
+	/**
+	  @brief A destructor
+	*/
+	~SyscallWriter() throw();
 };
 
 } // namespace CTPP
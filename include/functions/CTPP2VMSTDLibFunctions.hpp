@@ -106,6 +106,7 @@
 #include "FnRussianSpellOut.hpp"
 #include "FnSize.hpp"
 #include "FnSprintf.hpp"
+#include "FnSprintfCompiled.hpp"
 #include "FnSubstring.hpp"
 #include "FnTime.hpp"
 #include "FnTruncate.hpp"
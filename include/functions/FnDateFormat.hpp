@@ -32,8 +32,11 @@
 #ifndef _FN_DATE_FORMAT_HPP__
 #define _FN_DATE_FORMAT_HPP__ 1
 
+#include "CTPP2ThreadLocal.hpp"
 #include "CTPP2VMSyscall.hpp"
 
+#include <time.h>
+
 /**
   @file FnDateFormat.hpp
   @brief Virtual machine standard library function, date formatting function
@@ -50,7 +53,7 @@ class Logger;
   @brief Date formatting function
 */
 class FnDateFormat:
-  public SyscallHandler
+  public SyscallWriter
 {
 	/**
 	  @brief Constructor
@@ -66,22 +69,50 @@ private:
 	friend class STDLibInitializer;
 
 	/**
-	  @brief Handler
+	  @brief Format date and write result to output collector
 	  @param aArguments - list of arguments
 	  @param iArgNum - number of arguments
-	  @param oCDTRetVal - return value
+	  @param oCollector - output data collector
 	  @param oLogger - logger
 	  @return 0 - if success, -1 - otherwise
 	*/
-	INT_32 Handler(CDT            * aArguments,
-	               const UINT_32    iArgNum,
-	               CDT            & oCDTRetVal,
-	               Logger         & oLogger);
+	INT_32 Write(CDT              * aArguments,
+	             const UINT_32      iArgNum,
+	             OutputCollector  & oCollector,
+	             Logger           & oLogger);
 
 	/**
 	  @brief Get function name
 	*/
 	CCHAR_P GetName() const;
+
+	/**
+	  @struct TimeCache FnDateFormat.hpp <FnDateFormat.hpp>
+	  @brief Broken-down local time of last formatted hour
+	*/
+	struct TimeCache
+	{
+		/**
+		  @brief Constructor
+		*/
+		TimeCache(): hour_start(-1) { ;; }
+
+		/** Start of hour, -1 if cache is empty */
+		time_t      hour_start;
+		/** Local time at start of hour         */
+		struct tm   hour_tm;
+	};
+
+	/**
+	  @brief Convert time to broken-down local time
+	  @param iTime - time to convert
+	  @param oTM - broken-down time [out]
+	  @return 0 - if success, -1 - if time cannot be represented
+	*/
+	INT_32 LocalTime(const time_t iTime, struct tm & oTM);
+
+	/** Per-thread cache of local time */
+	ThreadLocal<TimeCache>   oTimeCache;
 };
 
 } // namespace CTPP
@@ -30,6 +30,9 @@ public:
 
 	// Имя функции
 	virtual CCHAR_P GetName() const;
+
+	// Свойства функции
+	virtual UINT_32 GetCapabilities() const;
 };
 
 } // namespace 
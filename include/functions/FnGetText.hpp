@@ -45,6 +45,7 @@ namespace CTPP // C++ Template Engine
 class CDT;
 class Logger;
 class CTPP2GetText;
+struct SyscallContext;
 
 /**
   @class FnGetText FnGetText.hpp <FnGetText.hpp>
@@ -80,6 +81,38 @@ private:
 	               CDT            & oCDTRetVal,
 	               Logger         & oLogger);
 
+	/**
+	  @brief Handler, language and i18n domain are taken from per-render context
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCDTRetVal - return value
+	  @param oContext - per-render context
+	  @param oLogger - logger
+	  @return 0 - if success, -1 - otherwise
+	*/
+	INT_32 ContextHandler(CDT                   * aArguments,
+	                      const UINT_32           iArgNum,
+	                      CDT                   & oCDTRetVal,
+	                      const SyscallContext  & oContext,
+	                      Logger                & oLogger);
+
+	/**
+	  @brief Find translation
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCDTRetVal - return value
+	  @param sLang - language of translation
+	  @param sDomain - i18n domain if not given in arguments
+	  @param oLogger - logger
+	  @return 0 - if success, -1 - otherwise
+	*/
+	INT_32 Translate(CDT                 * aArguments,
+	                 const UINT_32         iArgNum,
+	                 CDT                 & oCDTRetVal,
+	                 const STLW::string  & sLang,
+	                 const STLW::string  & sDomain,
+	                 Logger              & oLogger) const;
+
 	/**
 	  @brief Get function name
 	*/
@@ -92,7 +125,7 @@ private:
 	void SetGetText(CTPP2GetText * pGetText);
 
 	/**
-	  @brief Set language of translation
+	  @brief Set language of translation if render context has none
 	  @param sLang - language
 	*/
 	void SetLanguage(const STLW::string & sLang);
@@ -100,7 +133,7 @@ private:
 	/** GetText pointer         */
 	CTPP2GetText * pGetText;
 
-	/** Language of translation */
+	/** Default language of translation */
 	STLW::string sLanguage;
 
 	/** Name of function */
@@ -89,6 +89,11 @@ private:
 	*/
 	CCHAR_P GetName() const;
 
+	/**
+	  @brief Get capabilities of function
+	*/
+	UINT_32 GetCapabilities() const;
+
 #ifdef WIN32
 	/** @brief Win32 CryptoAPI provider handle */
 	HCRYPTPROV hCryptProv;
@@ -50,7 +50,7 @@ class Logger;
   @brief Escape value, see http://www.w3.org/
 */
 class FnHTMLEscape:
-  public SyscallHandler
+  public SyscallWriter
 {
 	/**
 	  @brief Constructor
@@ -66,22 +66,27 @@ private:
 	friend class STDLibInitializer;
 
 	/**
-	  @brief Handler
+	  @brief Escape arguments and write result to output collector
 	  @param aArguments - list of arguments
 	  @param iArgNum - number of arguments
-	  @param oCDTRetVal - return value
+	  @param oCollector - output data collector
 	  @param oLogger - logger
 	  @return 0 - if success, -1 - otherwise
 	*/
-	INT_32 Handler(CDT            * aArguments,
-	               const UINT_32    iArgNum,
-	               CDT            & oCDTRetVal,
-	               Logger         & oLogger);
+	INT_32 Write(CDT              * aArguments,
+	             const UINT_32      iArgNum,
+	             OutputCollector  & oCollector,
+	             Logger           & oLogger);
 
 	/**
 	  @brief Get function name
 	*/
 	CCHAR_P GetName() const;
+
+	/**
+	  @brief Get capabilities of function
+	*/
+	UINT_32 GetCapabilities() const;
 };
 
 } // namespace CTPP
@@ -6,7 +6,9 @@
 
 #include <CDT.hpp>
 
+#include <CTPP2ThreadLocal.hpp>
 #include <CTPP2VMSyscall.hpp>
+#include <STLMap.hpp>
 #include <unicode/smpdtfmt.h>
 
 namespace CTPP
@@ -16,9 +18,51 @@ class FnICUFormatDate:
   public CTPP::SyscallHandler
 {
 private:
+	/**
+	  @struct FormatterCache FnICUFormatDate.hpp <FnICUFormatDate.hpp>
+	  @brief Parsers of ISO dates and formatters keyed by (locale, pattern); ICU formats are not thread-safe
+	*/
+	struct FormatterCache
+	{
+		FormatterCache();
+		~FormatterCache() throw();
 
-	icu::SimpleDateFormat *tparser;
-	icu::SimpleDateFormat *dparser;
+		/** Parser of "yyyy-MM-dd HH:mm:ss" */
+		icu::SimpleDateFormat  * tparser;
+		/** Parser of "yyyy-MM-dd"          */
+		icu::SimpleDateFormat  * dparser;
+		/** Formatters                      */
+		STLW::map<STLW::string, icu::SimpleDateFormat *>  formatters;
+	};
+
+	/**
+	  @brief Get formatter for pattern and locale
+	  @param oCache - cache of current thread
+	  @param sPattern - pattern
+	  @param pLanguage - language, NULL for default locale
+	  @param pCountry - country, NULL for default locale
+	*/
+	icu::SimpleDateFormat * GetFormatter(FormatterCache      & oCache,
+	                                     const STLW::string  & sPattern,
+	                                     const CDT           * pLanguage,
+	                                     const CDT           * pCountry);
+
+	/**
+	  @brief Format date
+	  @param oThreadCache - cache of current thread or of one call
+	  @param aArguments - list of arguments
+	  @param iArgNum - number of arguments
+	  @param oCDTRetVal - return value
+	  @param logger - logger
+	*/
+	INT_32 FormatDate(FormatterCache  & oThreadCache,
+	                  CTPP::CDT       * aArguments,
+	                  const UINT_32     iArgNum,
+	                  CTPP::CDT       & oCDTRetVal,
+	                  CTPP::Logger    & logger);
+
+	/** Per-thread parsers and formatters */
+	ThreadLocal<FormatterCache>   oCache;
 
 public:
 	FnICUFormatDate();
@@ -98,6 +98,11 @@ private:
 	  @brief Get function name
 	*/
 	CCHAR_P GetName() const;
+
+	/**
+	  @brief Get capabilities of function
+	*/
+	UINT_32 GetCapabilities() const;
 };
 
 } // namespace CTPP
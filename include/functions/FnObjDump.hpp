@@ -50,7 +50,7 @@ class Logger;
   @brief Dump variables
 */
 class FnObjDump:
-  public SyscallHandler
+  public SyscallWriter
 {
 private:
 	friend class STDLibInitializer;
@@ -82,17 +82,17 @@ private:
 	                       Logger                   & oLogger);
 
 	/**
-	  @brief Handler
+	  @brief Dump arguments or global data object and write result to output collector
 	  @param aArguments - list of arguments
 	  @param iArgNum - number of arguments
-	  @param oCDTRetVal - return value
+	  @param oCollector - output data collector
 	  @param oLogger - logger
 	  @return 0 - if success, -1 - otherwise
 	*/
-	INT_32 Handler(CDT            * aArguments,
-	               const UINT_32    iArgNum,
-	               CDT            & oCDTRetVal,
-	               Logger         & oLogger);
+	INT_32 Write(CDT              * aArguments,
+	             const UINT_32      iArgNum,
+	             OutputCollector  & oCollector,
+	             Logger           & oLogger);
 
 	/**
 	  @brief Get function name
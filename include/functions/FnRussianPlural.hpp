@@ -24,6 +24,9 @@ public:
 
 
 	virtual CCHAR_P GetName() const;
+
+	// Свойства функции
+	virtual UINT_32 GetCapabilities() const;
 };
 
 } // namespace 
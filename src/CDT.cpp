@@ -30,14 +30,25 @@
  * $CTPP$
  */
 #include "CDT.hpp"
+#include "CTPP2NumberFormat.hpp"
 #include "STLFunctional.hpp"
 
+#include <math.h>
 #include <stdio.h>
 
+#ifdef PARALLEL_SORT
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #ifdef WIN32
 #define strtoll _strtoi64
 #endif
 
+#ifndef CTPP_PARALLEL_SORT_THRESHOLD
+#define CTPP_PARALLEL_SORT_THRESHOLD 32768
+#endif
+
 namespace CTPP
 {
 
@@ -46,6 +57,87 @@ STLW::string EscapeJSONString(const STLW::string  & sSource,
                               const bool          & bECMAConventions = true,
                               const bool          & bHTMLSafe = true);
 
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Struct _LazyState
+//
+/**
+  @struct _LazyState CDT.cpp
+  @brief State of lazy (provider-backed) container
+*/
+struct _LazyState
+{
+	/** Data provider, NULL for generators         */
+	CDT::DataProvider     * provider;
+	/** Provider size, -1 if not requested yet     */
+	INT_64                  size;
+	/** Array: fetched elements                    */
+	STLW::vector<bool>      fetched;
+	/** Hash: keys that provider does not know     */
+	STLW::map<STLW::string, bool>  misses;
+
+	/** Generator, NULL for data providers         */
+	CDT::Generator        * generator;
+	/** Index of current element, -1 if none yet   */
+	INT_64                  position;
+	/** Current element                            */
+	CDT                     current;
+	/** Next element                               */
+	CDT                     lookahead;
+	/** Next element was generated                 */
+	bool                    has_lookahead;
+	/** End of stream reached                      */
+	bool                    exhausted;
+
+	/** Constructor */
+	_LazyState(CDT::DataProvider * pProvider): provider(pProvider), size(-1), generator(NULL), position(-1), has_lookahead(false), exhausted(false) { ;; }
+
+	/** Constructor */
+	_LazyState(CDT::Generator * pGenerator): provider(NULL), size(-1), generator(pGenerator), position(-1), has_lookahead(false), exhausted(false) { ;; }
+
+	/** Get provider size or number of generated elements with lookahead */
+	UINT_32 GetSize()
+	{
+		if (generator != NULL)
+		{
+			if (!has_lookahead && !exhausted)
+			{
+				has_lookahead = generator -> Next(lookahead);
+				exhausted     = !has_lookahead;
+			}
+			return UINT_32(position + 1 + (has_lookahead ? 1 : 0));
+		}
+
+		if (size == -1) { size = provider -> Size(); }
+		return UINT_32(size);
+	}
+
+	/** Move generator to next element */
+	bool Pull()
+	{
+		if (has_lookahead)
+		{
+			current       = lookahead;
+			lookahead     = CDT();
+			has_lookahead = false;
+		}
+		else
+		{
+			if (exhausted) { return false; }
+
+			CDT oValue;
+			if (!generator -> Next(oValue))
+			{
+				exhausted = true;
+				return false;
+			}
+			current = oValue;
+		}
+		++position;
+	return true;
+	}
+};
+
 // ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // Struct _CDT
@@ -81,6 +173,9 @@ struct CDT::_CDT
 		W_FLOAT                d_data;
 	} uc;
 
+	/** Lazy container state, NULL for ordinary containers */
+	_LazyState      * lazy;
+
 	/** Constructor */
 	_CDT();
 };
@@ -88,7 +183,7 @@ struct CDT::_CDT
 //
 // Constructor
 //
-CDT::_CDT::_CDT(): refcount(1), value_type(UNDEF)
+CDT::_CDT::_CDT(): refcount(1), value_type(UNDEF), lazy(NULL)
 {
 	u.s_data  = NULL;
 	uc.i_data = 0;
@@ -107,6 +202,8 @@ CDT::Iterator CDT::Begin()
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 return Iterator(u.p_data -> u.m_data -> begin());
 }
 
@@ -117,6 +214,8 @@ CDT::Iterator CDT::End()
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	return Iterator(u.p_data -> u.m_data -> end());
 }
 
@@ -127,6 +226,8 @@ CDT::Iterator CDT::Find(const STLW::string & sKey)
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 return Iterator(u.p_data -> u.m_data -> find(sKey));
 }
 
@@ -137,6 +238,8 @@ CDT::ConstIterator CDT::Begin() const
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 return ConstIterator(Iterator(u.p_data -> u.m_data -> begin()));
 }
 
@@ -147,6 +250,8 @@ CDT::ConstIterator CDT::End() const
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 return ConstIterator(Iterator(u.p_data -> u.m_data -> end()));
 }
 
@@ -157,6 +262,8 @@ CDT::ConstIterator CDT::Find(const STLW::string & sKey) const
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 return ConstIterator(Iterator(u.p_data -> u.m_data -> find(sKey)));
 }
 
@@ -200,6 +307,257 @@ SortHelper::SortHelper(const CDT::SortingComparator  & oISortingComparator): oSo
 //
 bool SortHelper::operator()(const CDT & oX, const CDT & oY) const { return oSortingComparator.operator()(oX, oY); }
 
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Key-extracting sort
+//
+
+/**
+  @struct SortItem CDT.cpp
+  @brief Extracted sorting key and position of ARRAY element
+*/
+template <typename T> struct SortItem
+{
+	/** Sorting key              */
+	T        key;
+	/** Position of element      */
+	UINT_32  pos;
+};
+
+//
+// Compare sorting keys
+//
+static inline bool SortKeyLess(const INT_64    iX, const INT_64    iY) { return iX < iY; }
+static inline bool SortKeyLess(const W_FLOAT   dX, const W_FLOAT   dY) { return dX < dY; }
+static inline bool SortKeyLess(const STLW::string * pX, const STLW::string * pY) { return *pX < *pY; }
+
+/**
+  @class SortItemCompare CDT.cpp
+  @brief Non-virtual comparator of extracted keys; equal keys are ordered by position
+*/
+template <typename T, bool bDesc> class SortItemCompare
+{
+public:
+	/**
+	  @brief Comparison operator
+	  @param oX - first item to compare
+	  @param oY - seond item to compare
+	  @return true, if oX < oY, false - otherwise
+	*/
+	bool operator()(const SortItem<T> & oX, const SortItem<T> & oY) const
+	{
+		if (bDesc)
+		{
+			if (SortKeyLess(oY.key, oX.key)) { return true;  }
+			if (SortKeyLess(oX.key, oY.key)) { return false; }
+		}
+		else
+		{
+			if (SortKeyLess(oX.key, oY.key)) { return true;  }
+			if (SortKeyLess(oY.key, oX.key)) { return false; }
+		}
+
+	return oX.pos < oY.pos;
+	}
+};
+
+#ifdef PARALLEL_SORT
+
+/**
+  @struct MergeSortTask CDT.cpp
+  @brief Part of array sorted by separate thread
+*/
+template <typename T> struct MergeSortTask
+{
+	/** First item              */
+	T        * first;
+	/** Item after last         */
+	T        * last;
+	/** Recursion depth         */
+	UINT_32    depth;
+};
+
+//
+// Sort range [pFirst, pLast) with 2^iDepth threads
+//
+template <typename T, typename C> static void ParallelMergeSort(T * pFirst, T * pLast, const UINT_32 iDepth);
+
+//
+// Thread entry point
+//
+template <typename T, typename C> static void * MergeSortThread(void * vTask)
+{
+	MergeSortTask<T> * pTask = (MergeSortTask<T> *)vTask;
+
+	ParallelMergeSort<T, C>(pTask -> first, pTask -> last, pTask -> depth);
+
+return NULL;
+}
+
+//
+// Sort range [pFirst, pLast) with 2^iDepth threads
+//
+template <typename T, typename C> static void ParallelMergeSort(T * pFirst, T * pLast, const UINT_32 iDepth)
+{
+	if (iDepth == 0) { STLW::sort(pFirst, pLast, C()); return; }
+
+	T * pMiddle = pFirst + (pLast - pFirst) / 2;
+
+	MergeSortTask<T> oTask = { pFirst, pMiddle, iDepth - 1 };
+
+	pthread_t oThread;
+	const bool bThreaded = (pthread_create(&oThread, NULL, MergeSortThread<T, C>, &oTask) == 0);
+	// Can't start thread, sort left half here
+	if (!bThreaded) { ParallelMergeSort<T, C>(pFirst, pMiddle, iDepth - 1); }
+
+	ParallelMergeSort<T, C>(pMiddle, pLast, iDepth - 1);
+
+	if (bThreaded) { pthread_join(oThread, NULL); }
+
+	STLW::inplace_merge(pFirst, pMiddle, pLast, C());
+}
+
+//
+// Get number of halvings for parallel sort, 0 - sort in current thread
+//
+static UINT_32 ParallelSortDepth(const UINT_32 iSize)
+{
+	if (iSize < CTPP_PARALLEL_SORT_THRESHOLD) { return 0; }
+
+	const long iCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+
+	// At most 8 threads, at least CTPP_PARALLEL_SORT_THRESHOLD / 2 items per thread
+	UINT_32 iDepth = 0;
+	while (iDepth < 3 && (2L << iDepth) <= iCPUs && (iSize >> (iDepth + 1)) >= CTPP_PARALLEL_SORT_THRESHOLD / 2) { ++iDepth; }
+
+return iDepth;
+}
+
+#endif // PARALLEL_SORT
+
+//
+// Sort items by keys
+//
+template <typename T, bool bDesc> static void SortItems(STLW::vector<SortItem<T> > & vItems)
+{
+	typedef SortItemCompare<T, bDesc> Compare;
+#ifdef PARALLEL_SORT
+	const UINT_32 iDepth = ParallelSortDepth(vItems.size());
+	if (iDepth != 0)
+	{
+		ParallelMergeSort<SortItem<T>, Compare>(&vItems[0], &vItems[0] + vItems.size(), iDepth);
+		return;
+	}
+#endif
+	STLW::sort(vItems.begin(), vItems.end(), Compare());
+}
+
+//
+// Sort items by keys and reorder ARRAY
+//
+template <typename T> static void SortByKeys(STLW::vector<CDT> & vData, STLW::vector<SortItem<T> > & vItems, const bool bDesc)
+{
+	if (bDesc) { SortItems<T, true>(vItems);  }
+	else       { SortItems<T, false>(vItems); }
+
+	STLW::vector<CDT> vSorted;
+	vSorted.reserve(vData.size());
+	for (UINT_32 iPos = 0; iPos < vItems.size(); ++iPos) { vSorted.push_back(vData[vItems[iPos].pos]); }
+
+	vData.swap(vSorted);
+}
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class MaterializeVisitor
+//
+
+/**
+  @class MaterializeVisitor
+  @brief Fills container with elements of lazy CDT
+*/
+class MaterializeVisitor:
+  public CDT::DataProvider::Visitor
+{
+public:
+	/**
+	  @brief Constructor
+	  @param pIVector - array to fill or NULL
+	  @param pIMap - hash to fill or NULL
+	  @param pILazy - lazy container state
+	*/
+	MaterializeVisitor(STLW::vector<CDT>              * pIVector,
+	                   STLW::map<STLW::string, CDT>   * pIMap,
+	                   _LazyState                     * pILazy);
+
+	/**
+	  @brief Receive hash element
+	*/
+	void VisitKey(const STLW::string & sKey, const CDT & oValue);
+
+	/**
+	  @brief Receive next array element
+	*/
+	void VisitElement(const CDT & oValue);
+
+	/**
+	  @brief A destructor
+	*/
+	~MaterializeVisitor() throw();
+private:
+	/** Array to fill       */
+	STLW::vector<CDT>              * pVector;
+	/** Hash to fill        */
+	STLW::map<STLW::string, CDT>   * pMap;
+	/** Lazy state          */
+	_LazyState                     * pLazy;
+	/** Current array index */
+	UINT_32                          iPos;
+};
+
+//
+// Constructor
+//
+MaterializeVisitor::MaterializeVisitor(STLW::vector<CDT>              * pIVector,
+                                       STLW::map<STLW::string, CDT>   * pIMap,
+                                       _LazyState                     * pILazy): pVector(pIVector),
+                                                                                 pMap(pIMap),
+                                                                                 pLazy(pILazy),
+                                                                                 iPos(0)
+{
+	;;
+}
+
+//
+// Receive hash element
+//
+void MaterializeVisitor::VisitKey(const STLW::string & sKey, const CDT & oValue)
+{
+	if (pMap == NULL) { throw CDTAccessException(); }
+
+	// Already fetched values are kept as is
+	pMap -> insert(STLW::pair<const STLW::string, CDT>(sKey, oValue));
+}
+
+//
+// Receive next array element
+//
+void MaterializeVisitor::VisitElement(const CDT & oValue)
+{
+	if (pVector == NULL) { throw CDTAccessException(); }
+
+	if (iPos >= pVector -> size()) { pVector -> resize(iPos + 1); }
+
+	if (iPos >= pLazy -> fetched.size() || !pLazy -> fetched[iPos]) { (*pVector)[iPos] = oValue; }
+
+	++iPos;
+}
+
+//
+// A destructor
+//
+MaterializeVisitor::~MaterializeVisitor() throw() { ;; }
+
 // ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // Class CDT
@@ -423,6 +781,46 @@ CDT::CDT(CCHAR_P oValue): eValueType(STRING_VAL)
 //
 CDT::CDT(void * oValue): eValueType(POINTER_VAL) { u.pp_data = oValue; }
 
+//
+// Lazy ARRAY or HASH backed by data provider
+//
+CDT::CDT(DataProvider * pProvider)
+{
+	if (pProvider == NULL) { throw CDTTypeCastException("Data provider is NULL"); }
+
+	eValueType = pProvider -> GetType();
+	if      (eValueType == ARRAY_VAL)
+	{
+		u.p_data = new _CDT();
+		u.p_data -> u.v_data = new Vector;
+	}
+	else if (eValueType == HASH_VAL)
+	{
+		u.p_data = new _CDT();
+		u.p_data -> u.m_data = new Map;
+	}
+	else
+	{
+		eValueType = UNDEF;
+		throw CDTTypeCastException("Data provider MUST be an ARRAY or HASH");
+	}
+
+	u.p_data -> lazy = new _LazyState(pProvider);
+}
+
+//
+// Forward-only ARRAY backed by generator
+//
+CDT::CDT(Generator * pGenerator)
+{
+	if (pGenerator == NULL) { throw CDTTypeCastException("Generator is NULL"); }
+
+	eValueType = ARRAY_VAL;
+	u.p_data = new _CDT();
+	u.p_data -> u.v_data = new Vector;
+	u.p_data -> lazy = new _LazyState(pGenerator);
+}
+
 // ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 //
@@ -574,7 +972,37 @@ const CDT & CDT::GetCDT(const UINT_32  iPos) const
 {
 	if (eValueType != ARRAY_VAL) { return oNonExistentCDT; }
 
-	if (iPos >= u.p_data -> u.v_data -> size()) { throw CDTRangeException(); }
+	_LazyState * pLazy = u.p_data -> lazy;
+	if (pLazy != NULL && pLazy -> generator != NULL)
+	{
+		// Forward-only access
+		if (INT_64(iPos) < pLazy -> position) { throw CDTRangeException(); }
+
+		while (pLazy -> position < INT_64(iPos))
+		{
+			if (!pLazy -> Pull()) { throw CDTRangeException(); }
+		}
+
+		return pLazy -> current;
+	}
+	else if (pLazy != NULL)
+	{
+		const UINT_32 iSize = pLazy -> GetSize();
+		if (iPos >= iSize) { throw CDTRangeException(); }
+
+		if (pLazy -> fetched.size() != iSize)
+		{
+			pLazy -> fetched.resize(iSize, false);
+			u.p_data -> u.v_data -> resize(iSize);
+		}
+
+		if (!pLazy -> fetched[iPos])
+		{
+			pLazy -> provider -> GetIndex(iPos, u.p_data -> u.v_data -> operator[](iPos));
+			pLazy -> fetched[iPos] = true;
+		}
+	}
+	else if (iPos >= u.p_data -> u.v_data -> size()) { throw CDTRangeException(); }
 
 return u.p_data -> u.v_data -> operator[](iPos);
 }
@@ -604,6 +1032,18 @@ const CDT & CDT::GetExistedCDT(const STLW::string & sKey, bool & bCDTExist) cons
 	Map::iterator itmHash = u.p_data -> u.m_data -> find(sKey);
 	if (itmHash == u.p_data -> u.m_data -> end())
 	{
+		_LazyState * pLazy = u.p_data -> lazy;
+		if (pLazy != NULL && pLazy -> misses.find(sKey) == pLazy -> misses.end())
+		{
+			CDT oValue;
+			if (pLazy -> provider -> GetKey(sKey, oValue))
+			{
+				bCDTExist = true;
+				return u.p_data -> u.m_data -> insert(STLW::pair<const String, CDT>(sKey, oValue)).first -> second;
+			}
+			pLazy -> misses[sKey] = true;
+		}
+
 		bCDTExist = false;
 		return oNonExistentCDT;
 	}
@@ -636,7 +1076,7 @@ bool CDT::Exists(const UINT_32  iPos) const
 {
 	if (eValueType != ARRAY_VAL) { throw CDTAccessException(); }
 
-	if (iPos >= u.p_data -> u.v_data -> size()) { return false; }
+	if (iPos >= Size()) { return false; }
 
 return true;
 }
@@ -648,10 +1088,10 @@ bool CDT::Exists(const STLW::string & sKey) const
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
-	Map::iterator itmHash = u.p_data -> u.m_data -> find(sKey);
-	if (itmHash == u.p_data -> u.m_data -> end()) { return false; }
+	bool bCDTExist = false;
+	GetExistedCDT(sKey, bCDTExist);
 
-return true;
+return bCDTExist;
 }
 
 //
@@ -694,7 +1134,11 @@ void CDT::PushBack(CCHAR_P oValue)              { PushBack(CDT(oValue)); }
 //
 void CDT::PushBack(const CDT & oValue)
 {
-	if      (eValueType == ARRAY_VAL) { u.p_data -> u.v_data -> push_back(oValue); }
+	if      (eValueType == ARRAY_VAL)
+	{
+		Materialize();
+		u.p_data -> u.v_data -> push_back(oValue);
+	}
 	else if (eValueType == UNDEF)
 	{
 		(*this) = CDT(CDT::ARRAY_VAL);
@@ -731,11 +1175,8 @@ bool CDT::Nonzero() const
 			break;
 
 		case ARRAY_VAL:
-			if (u.p_data -> u.v_data -> size() != 0) { return true; }
-			break;
-
 		case HASH_VAL:
-			if (u.p_data -> u.m_data -> size() != 0) { return true; }
+			if (Size() != 0) { return true; }
 			break;
 
 		case POINTER_VAL:
@@ -753,6 +1194,8 @@ CDT & CDT::At(const UINT_32  iPos)
 {
 	if (eValueType != ARRAY_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	if (iPos >= u.p_data -> u.v_data -> size()) { throw CDTRangeException(); }
 
 return u.p_data -> u.v_data -> operator[](iPos);
@@ -765,6 +1208,8 @@ CDT & CDT::At(const STLW::string & sKey)
 {
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	Map::iterator itmHash = u.p_data -> u.m_data -> find(sKey);
 	if (itmHash == u.p_data -> u.m_data -> end()) { throw CDTRangeException(); }
 
@@ -3437,6 +3882,16 @@ CDT & CDT::Concat(CCHAR_P szData, const INT_32 iDataLength)
 {
 	if (iDataLength == -1) { return Concat(STLW::string(szData)); }
 
+	// Append in place, without temporary string
+	if (eValueType == STRING_VAL     ||
+	    eValueType == STRING_INT_VAL ||
+	    eValueType == STRING_REAL_VAL)
+	{
+		Unshare();
+		u.p_data -> u.s_data -> append(szData, iDataLength);
+		return *this;
+	}
+
 return Concat(STLW::string(szData, iDataLength));
 }
 
@@ -3456,7 +3911,7 @@ CDT & CDT::Append(CCHAR_P szData, const INT_32 iDataLength)  { return Concat(szD
 CDT & CDT::Append(const INT_64  oValue)
 {
 	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
-	UINT_32 iLen = snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%lli", (long long) (oValue));
+	UINT_32 iLen = FormatInteger(oValue, szBuf);
 
 	if (eValueType == UNDEF)
 	{
@@ -3503,7 +3958,7 @@ CDT & CDT::Append(const UINT_32  oValue) { return Append(INT_64(oValue)); }
 CDT & CDT::Append(const W_FLOAT  oValue)
 {
 	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
-	UINT_32 iLen = snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%.*G", CTPP_FLOAT_PRECISION, oValue);
+	UINT_32 iLen = FormatFloat(oValue, CTPP_FLOAT_PRECISION, szBuf);
 
 	if (eValueType == UNDEF)
 	{
@@ -3601,7 +4056,7 @@ return *this;
 CDT & CDT::Prepend(const INT_64  oValue)
 {
 	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
-	UINT_32 iLen = snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%lli", (long long) (oValue));
+	UINT_32 iLen = FormatInteger(oValue, szBuf);
 
 	if (eValueType == UNDEF)
 	{
@@ -3647,7 +4102,7 @@ CDT & CDT::Prepend(const UINT_32  oValue) { return Prepend(UINT_64(oValue)); }
 CDT & CDT::Prepend(const W_FLOAT  oValue)
 {
 	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
-	UINT_32 iLen = snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%.*G", CTPP_FLOAT_PRECISION, oValue);
+	UINT_32 iLen = FormatFloat(oValue, CTPP_FLOAT_PRECISION, szBuf);
 
 	if (eValueType == UNDEF)
 	{
@@ -3856,7 +4311,7 @@ STLW::string CDT::GetString(CCHAR_P szFormat) const
 				}
 				else
 				{
-					snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%lli", (long long) (u.i_data));
+					return STLW::string(szBuf, FormatInteger(u.i_data, szBuf));
 				}
 
 			return szBuf;
@@ -3871,7 +4326,7 @@ STLW::string CDT::GetString(CCHAR_P szFormat) const
 				}
 				else
 				{
-					snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%.*G", CTPP_FLOAT_PRECISION, u.d_data);
+					return STLW::string(szBuf, FormatFloat(u.d_data, CTPP_FLOAT_PRECISION, szBuf));
 				}
 			return szBuf;
 			}
@@ -3915,6 +4370,30 @@ STLW::string CDT::GetString(CCHAR_P szFormat) const
 	}
 }
 
+//
+// Get string value without copying
+//
+CCHAR_P CDT::GetStringData(UINT_32 & iLength) const
+{
+	if (eValueType != STRING_VAL     &&
+	    eValueType != STRING_INT_VAL &&
+	    eValueType != STRING_REAL_VAL) { iLength = 0; return NULL; }
+
+	iLength = u.p_data -> u.s_data -> size();
+
+return u.p_data -> u.s_data -> data();
+}
+
+//
+// Get identity of shareable value
+//
+const void * CDT::GetIdentity() const
+{
+	if ((eValueType & (STRING_VAL | ARRAY_VAL | HASH_VAL)) == 0) { return NULL; }
+
+return u.p_data;
+}
+
 //
 // Get generic pointer
 //
@@ -4097,9 +4576,11 @@ UINT_32 CDT::Size() const
 			return u.p_data -> u.s_data -> size();
 
 		case ARRAY_VAL:
+			if (u.p_data -> lazy != NULL) { return u.p_data -> lazy -> GetSize(); }
 			return u.p_data -> u.v_data -> size();
 
 		case HASH_VAL:
+			if (u.p_data -> lazy != NULL) { return u.p_data -> lazy -> GetSize(); }
 			return u.p_data -> u.m_data -> size();
 
 		default:
@@ -4132,6 +4613,8 @@ STLW::string CDT::JoinArrayElements(const STLW::string  & sDelimiter) const
 
 	if (eValueType != ARRAY_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	Vector::const_iterator itvArray = u.p_data -> u.v_data -> begin();
 	const Vector::const_iterator itvEnd = u.p_data -> u.v_data -> end();
 
@@ -4157,6 +4640,8 @@ STLW::string CDT::JoinHashKeys(const STLW::string  & sDelimiter) const
 
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	Map::const_iterator itmHash = u.p_data -> u.m_data -> begin();
 	const Map::const_iterator itmEnd = u.p_data -> u.m_data -> end();
 
@@ -4182,6 +4667,8 @@ STLW::string CDT::JoinHashValues(const STLW::string  & sDelimiter) const
 
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	Map::const_iterator itmHash = u.p_data -> u.m_data -> begin();
 	const Map::const_iterator itmEnd = u.p_data -> u.m_data -> end();
 
@@ -4207,6 +4694,8 @@ CDT CDT::GetHashKeys() const
 
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	Map::const_iterator itmHash = u.p_data -> u.m_data -> begin();
 	const Map::const_iterator itmEnd = u.p_data -> u.m_data -> end();
 
@@ -4228,6 +4717,8 @@ CDT CDT::GetHashValues() const
 
 	if (eValueType != HASH_VAL) { throw CDTAccessException(); }
 
+	Materialize();
+
 	Map::const_iterator itmHash = u.p_data -> u.m_data -> begin();
 	const Map::const_iterator itmEnd = u.p_data -> u.m_data -> end();
 
@@ -4253,6 +4744,8 @@ void CDT::MergeCDT(const CDT & oSource, const eMergeStrategy & eStrategy)
 //
 void CDT::MergeCDT(CDT & oDestination, const CDT & oSource, const eMergeStrategy & eStrategy)
 {
+	if (oSource.eValueType == ARRAY_VAL || oSource.eValueType == HASH_VAL) { oSource.Materialize(); }
+
 	if (oDestination.eValueType == UNDEF)
 	{
 		oDestination = oSource;
@@ -4390,22 +4883,156 @@ void CDT::MergeCDT(CDT & oDestination, const CDT & oSource, const eMergeStrategy
 }
 
 //
-// Quick sort ARRAY
+// Sort ARRAY
 //
 void CDT::SortArray(const CDT::SortingComparator  & oSortingComparator)
 {
-	if (eValueType != ARRAY_VAL || u.p_data -> u.v_data -> size() <= 1) { return; }
+	if (eValueType != ARRAY_VAL) { return; }
+
+	Materialize();
+
+	Vector & vData = *(u.p_data -> u.v_data);
+	const UINT_32 iSize = vData.size();
+	if (iSize <= 1) { return; }
+
+	const SortingComparator::eSortingKey eKeyType = oSortingComparator.GetKeyType();
+	if (eKeyType != SortingComparator::CUSTOM_KEY)
+	{
+		// Extract keys once and count their types
+		STLW::vector<const CDT *> vKeys(iSize);
+		UINT_32 iIntKeys    = 0;
+		UINT_32 iRealKeys   = 0;
+		UINT_32 iStringKeys = 0;
+		UINT_32 iOtherKeys  = 0;
+		for (UINT_32 iPos = 0; iPos < iSize; ++iPos)
+		{
+			const CDT & oKey = oSortingComparator.GetKey(vData[iPos]);
+			vKeys[iPos] = &oKey;
+			switch (oKey.eValueType)
+			{
+				case INT_VAL:
+				case STRING_INT_VAL:
+					++iIntKeys;
+					break;
+				case REAL_VAL:
+				case STRING_REAL_VAL:
+					++iRealKeys;
+					break;
+				case STRING_VAL:
+					++iStringKeys;
+					break;
+				default:
+					++iOtherKeys;
+			}
+		}
+
+		const bool bDesc = (oSortingComparator.GetDirection() == SortingComparator::DESC);
+
+		// Both operator< and Less() compare strings as is
+		if (iStringKeys == iSize)
+		{
+			STLW::vector<SortItem<const String *> > vItems(iSize);
+			for (UINT_32 iPos = 0; iPos < iSize; ++iPos)
+			{
+				vItems[iPos].key = vKeys[iPos] -> u.p_data -> u.s_data;
+				vItems[iPos].pos = iPos;
+			}
+			SortByKeys(vData, vItems, bDesc);
+			return;
+		}
+
+		// operator< compares integers as integers
+		if (eKeyType == SortingComparator::NUMERIC_KEY && iIntKeys == iSize)
+		{
+			STLW::vector<SortItem<INT_64> > vItems(iSize);
+			for (UINT_32 iPos = 0; iPos < iSize; ++iPos)
+			{
+				vItems[iPos].key = vKeys[iPos] -> GetInt();
+				vItems[iPos].pos = iPos;
+			}
+			SortByKeys(vData, vItems, bDesc);
+			return;
+		}
 
-	STLW::sort(u.p_data -> u.v_data -> begin(), u.p_data -> u.v_data -> end(), SortHelper(oSortingComparator));
+		// operator< compares numbers as reals, Less() compares as reals everything except strings
+		if ((eKeyType == SortingComparator::NUMERIC_KEY && iIntKeys + iRealKeys == iSize) ||
+		    (eKeyType == SortingComparator::STRING_KEY  && iStringKeys == 0 && iOtherKeys == 0))
+		{
+			bool bExact = true;
+			STLW::vector<SortItem<W_FLOAT> > vItems(iSize);
+			for (UINT_32 iPos = 0; iPos < iSize && bExact; ++iPos)
+			{
+				const W_FLOAT dKey = vKeys[iPos] -> GetFloat();
+				// NaN is not ordered
+				if (dKey != dKey) { bExact = false; }
+				// operator< compares pair of integers as integers, so they should fit into mantissa
+				if (eKeyType == SortingComparator::NUMERIC_KEY && iIntKeys != 0 &&
+				    (vKeys[iPos] -> eValueType == INT_VAL || vKeys[iPos] -> eValueType == STRING_INT_VAL) &&
+				    fabs(dKey) > 9007199254740992.0) { bExact = false; }
+
+				vItems[iPos].key = dKey;
+				vItems[iPos].pos = iPos;
+			}
+
+			if (bExact)
+			{
+				SortByKeys(vData, vItems, bDesc);
+				return;
+			}
+		}
+	}
+
+	// Mixed or custom keys, compare values by comparator
+	STLW::sort(vData.begin(), vData.end(), SortHelper(oSortingComparator));
 }
 
 // ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey CDT::SortingComparator::GetKeyType() const { return CUSTOM_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection CDT::SortingComparator::GetDirection() const { return ASC; }
+
+//
+// Get sorting key of value
+//
+const CDT & CDT::SortingComparator::GetKey(const CDT & oValue) const { return oValue; }
+
 //
 // A destructor
 //
 CDT::SortingComparator::~SortingComparator() throw() { ;; }
 
+//
+// Fetch hash element
+//
+bool CDT::DataProvider::GetKey(const STLW::string & sKey, CDT & oValue) { return false; }
+
+//
+// Fetch array element
+//
+bool CDT::DataProvider::GetIndex(const UINT_32 iPos, CDT & oValue) { return false; }
+
+//
+// A destructor
+//
+CDT::DataProvider::~DataProvider() throw() { ;; }
+
+//
+// A destructor
+//
+CDT::DataProvider::Visitor::~Visitor() throw() { ;; }
+
+//
+// A destructor
+//
+CDT::Generator::~Generator() throw() { ;; }
+
 //
 // A destructor
 //
@@ -4442,6 +5069,7 @@ void CDT::Destroy() throw()
 			if (u.p_data -> refcount == 0)
 			{
 				delete u.p_data -> u.v_data;
+				delete u.p_data -> lazy;
 				delete u.p_data;
 			}
 			break;
@@ -4451,6 +5079,7 @@ void CDT::Destroy() throw()
 			if (u.p_data -> refcount == 0)
 			{
 				delete u.p_data -> u.m_data;
+				delete u.p_data -> lazy;
 				delete u.p_data;
 			}
 			break;
@@ -4468,6 +5097,8 @@ void CDT::Unshare()
 {
 	if (u.p_data -> refcount != 1)
 	{
+		Materialize();
+
 		_CDT * pTMP = new _CDT();
 
 		if      (eValueType == STRING_VAL)     { pTMP -> u.s_data = new String(*(u.p_data -> u.s_data)); }
@@ -4487,6 +5118,50 @@ void CDT::Unshare()
 		-- u.p_data -> refcount;
 		u.p_data = pTMP;
 	}
+	else
+	{
+		Materialize();
+	}
+}
+
+//
+// Fetch all elements of lazy container and drop data provider
+//
+void CDT::Materialize() const
+{
+	_LazyState * pLazy = u.p_data -> lazy;
+	if (pLazy == NULL) { return; }
+
+	if (pLazy -> generator != NULL)
+	{
+		// Consumed elements are lost
+		if (pLazy -> position != -1) { throw CDTAccessException(); }
+
+		if (pLazy -> has_lookahead) { u.p_data -> u.v_data -> push_back(pLazy -> lookahead); }
+
+		if (!pLazy -> exhausted)
+		{
+			CDT oValue;
+			while (pLazy -> generator -> Next(oValue))
+			{
+				u.p_data -> u.v_data -> push_back(oValue);
+				oValue = CDT();
+			}
+		}
+	}
+	else if (eValueType == ARRAY_VAL)
+	{
+		MaterializeVisitor oVisitor(u.p_data -> u.v_data, NULL, pLazy);
+		pLazy -> provider -> Iterate(oVisitor);
+	}
+	else
+	{
+		MaterializeVisitor oVisitor(NULL, u.p_data -> u.m_data, pLazy);
+		pLazy -> provider -> Iterate(oVisitor);
+	}
+
+	u.p_data -> lazy = NULL;
+	delete pLazy;
 }
 
 //
@@ -4640,11 +5315,8 @@ CDT::eValType CDT::CastToNumber(INT_64 & iData, W_FLOAT & dData) const
 			return REAL_VAL;
 
 		case ARRAY_VAL:
-			iData = u.p_data -> u.v_data -> size();
-			return INT_VAL;
-
 		case HASH_VAL:
-			iData = u.p_data -> u.m_data -> size();
+			iData = Size();
 			return INT_VAL;
 
 		case POINTER_VAL:
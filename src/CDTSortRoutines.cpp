@@ -61,6 +61,21 @@ bool SortCompareNum::operator()(const CDT & oX, const CDT & oY) const
 return iRC < 0;
 }
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey SortCompareNum::GetKeyType() const { return CDT::SortingComparator::NUMERIC_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection SortCompareNum::GetDirection() const { return eDirection; }
+
+//
+// Get sorting key of value
+//
+const CDT & SortCompareNum::GetKey(const CDT & oValue) const { return oValue; }
+
 //
 // A destructor
 //
@@ -91,6 +106,21 @@ bool SortCompareStr::operator()(const CDT & oX, const CDT & oY) const
 return iRC < 0;
 }
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey SortCompareStr::GetKeyType() const { return CDT::SortingComparator::STRING_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection SortCompareStr::GetDirection() const { return eDirection; }
+
+//
+// Get sorting key of value
+//
+const CDT & SortCompareStr::GetKey(const CDT & oValue) const { return oValue; }
+
 //
 // A destructor
 //
@@ -126,6 +156,21 @@ bool SortCompareNumHashElement::operator()(const CDT & oX, const CDT & oY) const
 return iRC < 0;
 }
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey SortCompareNumHashElement::GetKeyType() const { return CDT::SortingComparator::NUMERIC_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection SortCompareNumHashElement::GetDirection() const { return eDirection; }
+
+//
+// Get sorting key of value
+//
+const CDT & SortCompareNumHashElement::GetKey(const CDT & oValue) const { return oValue.GetCDT(sKey); }
+
 //
 // A dertructor
 //
@@ -161,6 +206,21 @@ bool SortCompareStrHashElement::operator()(const CDT & oX, const CDT & oY) const
 return iRC < 0;
 }
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey SortCompareStrHashElement::GetKeyType() const { return CDT::SortingComparator::STRING_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection SortCompareStrHashElement::GetDirection() const { return eDirection; }
+
+//
+// Get sorting key of value
+//
+const CDT & SortCompareStrHashElement::GetKey(const CDT & oValue) const { return oValue.GetCDT(sKey); }
+
 //
 // A destructor
 //
@@ -196,6 +256,21 @@ bool SortCompareNumArrayElement::operator()(const CDT & oX, const CDT & oY) cons
 return iRC < 0;
 }
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey SortCompareNumArrayElement::GetKeyType() const { return CDT::SortingComparator::NUMERIC_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection SortCompareNumArrayElement::GetDirection() const { return eDirection; }
+
+//
+// Get sorting key of value
+//
+const CDT & SortCompareNumArrayElement::GetKey(const CDT & oValue) const { return oValue.GetCDT(iIndex); }
+
 //
 // A destructor
 //
@@ -230,6 +305,21 @@ bool SortCompareStrArrayElement::operator()(const CDT & oX, const CDT & oY) cons
 return iRC < 0;
 }
 
+//
+// Get type of sorting key
+//
+CDT::SortingComparator::eSortingKey SortCompareStrArrayElement::GetKeyType() const { return CDT::SortingComparator::STRING_KEY; }
+
+//
+// Get sorting direction
+//
+CDT::SortingComparator::eSortingDirection SortCompareStrArrayElement::GetDirection() const { return eDirection; }
+
+//
+// Get sorting key of value
+//
+const CDT & SortCompareStrArrayElement::GetKey(const CDT & oValue) const { return oValue.GetCDT(iIndex); }
+
 //
 // A destructor
 //
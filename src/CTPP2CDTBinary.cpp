@@ -0,0 +1,670 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2CDTBinary.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2CDTBinary.hpp"
+
+#include <string.h>
+
+namespace CTPP // C++ Template Engine
+{
+
+// FWD
+UINT_64 HashFunc(CCHAR_P        sKey,
+                 const UINT_32  iLength);
+
+/** Magic number and format version */
+static const CHAR_8  aBinaryCDTMagic[]   = { 'C', 'D', 'T', 'B' };
+static const UINT_32 C_BINARY_CDT_VERSION = 1;
+/** Size of header: magic, version, length, root offset, dictionary offset */
+static const UINT_32 C_BINARY_CDT_HEADER  = 20;
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class CTPP2CDTBinaryContainer
+//
+
+/**
+  @class CTPP2CDTBinaryContainer
+  @brief Lazy ARRAY or HASH over serialized data
+*/
+class CTPP2CDTBinaryContainer:
+  public CDT::DataProvider
+{
+public:
+	/**
+	  @brief Constructor
+	  @param pIReader - reader
+	  @param iIOffset - offset of container
+	*/
+	CTPP2CDTBinaryContainer(CTPP2CDTBinaryReader  * pIReader,
+	                        const UINT_32           iIOffset);
+
+	/**
+	  @brief Get container type
+	*/
+	CDT::eValType GetType() const;
+
+	/**
+	  @brief Fetch hash element
+	*/
+	bool GetKey(const STLW::string & sKey, CDT & oValue);
+
+	/**
+	  @brief Fetch array element
+	*/
+	bool GetIndex(const UINT_32 iPos, CDT & oValue);
+
+	/**
+	  @brief Get number of elements
+	*/
+	UINT_32 Size();
+
+	/**
+	  @brief Pass all elements to visitor
+	*/
+	void Iterate(Visitor & oVisitor);
+
+	/**
+	  @brief A destructor
+	*/
+	~CTPP2CDTBinaryContainer() throw();
+private:
+	/**
+	  @brief Decode element; writer stores children before container, so element offset must be less than offset of container
+	  @param iEntry - position of element offset in entry table
+	  @param oValue - element value [out]
+	*/
+	void ReadElement(const UINT_32 iEntry, CDT & oValue);
+
+	/** Reader                 */
+	CTPP2CDTBinaryReader  * pReader;
+	/** Offset of container    */
+	UINT_32                 iOffset;
+	/** Container type         */
+	CDT::eValType           eType;
+	/** Number of elements     */
+	UINT_32                 iCount;
+	/** Offset of entry table  */
+	UINT_32                 iTableOffset;
+};
+
+//
+// Constructor
+//
+CTPP2CDTBinaryContainer::CTPP2CDTBinaryContainer(CTPP2CDTBinaryReader  * pIReader,
+                                                 const UINT_32           iIOffset): pReader(pIReader),
+                                                                                  iOffset(iIOffset)
+{
+	eType = CDT::eValType(UCHAR_8(pReader -> szData[iOffset]));
+
+	UINT_32 iPos = iOffset + 1;
+	const UINT_64 iElements = pReader -> ReadVarint(iPos);
+
+	// Array: offsets, hash: pairs of key id and offset
+	pReader -> CheckRange(iPos, iElements * (eType == CDT::ARRAY_VAL ? 4 : 8));
+
+	iCount       = UINT_32(iElements);
+	iTableOffset = iPos;
+}
+
+//
+// Get container type
+//
+CDT::eValType CTPP2CDTBinaryContainer::GetType() const { return eType; }
+
+//
+// Fetch hash element
+//
+bool CTPP2CDTBinaryContainer::GetKey(const STLW::string & sKey, CDT & oValue)
+{
+	if (eType != CDT::HASH_VAL) { return false; }
+
+	UINT_32 iKeyId = 0;
+	if (!pReader -> FindKey(sKey, iKeyId)) { return false; }
+
+	// Entries are sorted by key id
+	UINT_32 iLeft  = 0;
+	UINT_32 iRight = iCount;
+	while (iLeft < iRight)
+	{
+		const UINT_32 iMiddle = iLeft + (iRight - iLeft) / 2;
+		const UINT_32 iEntry  = iTableOffset + iMiddle * 8;
+		const UINT_32 iId     = pReader -> ReadUInt32(iEntry);
+
+		if      (iId < iKeyId) { iLeft  = iMiddle + 1; }
+		else if (iId > iKeyId) { iRight = iMiddle;     }
+		else
+		{
+			ReadElement(iEntry + 4, oValue);
+			return true;
+		}
+	}
+
+return false;
+}
+
+//
+// Fetch array element
+//
+bool CTPP2CDTBinaryContainer::GetIndex(const UINT_32 iPos, CDT & oValue)
+{
+	if (eType != CDT::ARRAY_VAL || iPos >= iCount) { return false; }
+
+	ReadElement(iTableOffset + iPos * 4, oValue);
+
+return true;
+}
+
+//
+// Get number of elements
+//
+UINT_32 CTPP2CDTBinaryContainer::Size() { return iCount; }
+
+//
+// Pass all elements to visitor
+//
+void CTPP2CDTBinaryContainer::Iterate(Visitor & oVisitor)
+{
+	if (eType == CDT::ARRAY_VAL)
+	{
+		for (UINT_32 iPos = 0; iPos < iCount; ++iPos)
+		{
+			CDT oValue;
+			ReadElement(iTableOffset + iPos * 4, oValue);
+			oVisitor.VisitElement(oValue);
+		}
+		return;
+	}
+
+	for (UINT_32 iPos = 0; iPos < iCount; ++iPos)
+	{
+		const UINT_32 iEntry = iTableOffset + iPos * 8;
+
+		UINT_32 iKeyLength = 0;
+		CCHAR_P szKey = pReader -> GetKey(pReader -> ReadUInt32(iEntry), iKeyLength);
+
+		CDT oValue;
+		ReadElement(iEntry + 4, oValue);
+		oVisitor.VisitKey(STLW::string(szKey, iKeyLength), oValue);
+	}
+}
+
+//
+// Decode element
+//
+void CTPP2CDTBinaryContainer::ReadElement(const UINT_32 iEntry, CDT & oValue)
+{
+	const UINT_32 iElementOffset = pReader -> ReadUInt32(iEntry);
+	// Reference to container itself or to one of its ancestors
+	if (iElementOffset >= iOffset) { throw CTPPLogicError("Invalid binary CDT element offset"); }
+
+	pReader -> ReadValue(iElementOffset, oValue);
+}
+
+//
+// A destructor
+//
+CTPP2CDTBinaryContainer::~CTPP2CDTBinaryContainer() throw() { ;; }
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class CTPP2CDTBinaryWriter
+//
+
+//
+// Constructor
+//
+CTPP2CDTBinaryWriter::CTPP2CDTBinaryWriter(STLW::string & sIBuffer): sBuffer(sIBuffer)
+{
+	;;
+}
+
+//
+// Serialize data
+//
+UINT_32 CTPP2CDTBinaryWriter::Write(const CDT & oData)
+{
+	mKeys.clear();
+	vKeys.clear();
+
+	sBuffer.assign(aBinaryCDTMagic, sizeof(aBinaryCDTMagic));
+	AppendUInt32(C_BINARY_CDT_VERSION);
+	// Length, root and dictionary offsets
+	AppendUInt32(0);
+	AppendUInt32(0);
+	AppendUInt32(0);
+
+	const UINT_32 iRootOffset       = WriteValue(oData);
+	const UINT_32 iDictionaryOffset = WriteDictionary();
+
+	StoreUInt32(8,  UINT_32(sBuffer.size()));
+	StoreUInt32(12, iRootOffset);
+	StoreUInt32(16, iDictionaryOffset);
+
+return UINT_32(sBuffer.size());
+}
+
+//
+// Write value and all its children
+//
+UINT_32 CTPP2CDTBinaryWriter::WriteValue(const CDT & oData)
+{
+	switch (oData.GetType())
+	{
+		case CDT::INT_VAL:
+			{
+				const UINT_32 iOffset = UINT_32(sBuffer.size());
+				sBuffer.push_back(CHAR_8(CDT::INT_VAL));
+
+				// Zigzag encoding
+				const INT_64 iValue = oData.GetInt();
+				AppendVarint((UINT_64(iValue) << 1) ^ UINT_64(iValue >> 63));
+				return iOffset;
+			}
+
+		case CDT::REAL_VAL:
+			{
+				const UINT_32 iOffset = UINT_32(sBuffer.size());
+				sBuffer.push_back(CHAR_8(CDT::REAL_VAL));
+
+				const W_FLOAT dValue = oData.GetFloat();
+				UINT_64 iBits = 0;
+				memcpy(&iBits, &dValue, sizeof(iBits));
+				for (UINT_32 iI = 0; iI < 8; ++iI) { sBuffer.push_back(CHAR_8(iBits >> (iI * 8))); }
+				return iOffset;
+			}
+
+		case CDT::ARRAY_VAL:
+			{
+				STLW::vector<UINT_32> vOffsets;
+				// Size of generator is known only one element ahead
+				for (UINT_32 iPos = 0; iPos < oData.Size(); ++iPos) { vOffsets.push_back(WriteValue(oData.GetCDT(iPos))); }
+
+				const UINT_32 iOffset = UINT_32(sBuffer.size());
+				sBuffer.push_back(CHAR_8(CDT::ARRAY_VAL));
+				AppendVarint(vOffsets.size());
+				for (UINT_32 iPos = 0; iPos < vOffsets.size(); ++iPos) { AppendUInt32(vOffsets[iPos]); }
+				return iOffset;
+			}
+
+		case CDT::HASH_VAL:
+			{
+				// Key id -> value offset, sorted by key id
+				STLW::map<UINT_32, UINT_32> mEntries;
+				CDT::ConstIterator itmHash = oData.Begin();
+				while (itmHash != oData.End())
+				{
+					const UINT_32 iKeyId = GetKeyId(itmHash -> first);
+					mEntries[iKeyId] = WriteValue(itmHash -> second);
+					++itmHash;
+				}
+
+				const UINT_32 iOffset = UINT_32(sBuffer.size());
+				sBuffer.push_back(CHAR_8(CDT::HASH_VAL));
+				AppendVarint(mEntries.size());
+
+				STLW::map<UINT_32, UINT_32>::const_iterator itmEntries = mEntries.begin();
+				while (itmEntries != mEntries.end())
+				{
+					AppendUInt32(itmEntries -> first);
+					AppendUInt32(itmEntries -> second);
+					++itmEntries;
+				}
+				return iOffset;
+			}
+
+		case CDT::STRING_VAL:
+		case CDT::STRING_INT_VAL:
+		case CDT::STRING_REAL_VAL:
+			break;
+
+		// UNDEF; pointers have no meaning outside of process
+		default:
+			{
+				const UINT_32 iOffset = UINT_32(sBuffer.size());
+				sBuffer.push_back(CHAR_8(CDT::UNDEF));
+				return iOffset;
+			}
+	}
+
+	// Strings are stored as is, even if they look like numbers
+	const STLW::string sValue = oData.GetString();
+
+	const UINT_32 iOffset = UINT_32(sBuffer.size());
+	sBuffer.push_back(CHAR_8(CDT::STRING_VAL));
+	AppendVarint(sValue.size());
+	sBuffer.append(sValue);
+
+return iOffset;
+}
+
+//
+// Write key dictionary
+//
+UINT_32 CTPP2CDTBinaryWriter::WriteDictionary()
+{
+	const UINT_32 iKeysCount = UINT_32(vKeys.size());
+
+	// Keys
+	STLW::vector<UINT_32> vKeyOffsets(iKeysCount);
+	for (UINT_32 iKeyId = 0; iKeyId < iKeysCount; ++iKeyId)
+	{
+		vKeyOffsets[iKeyId] = UINT_32(sBuffer.size());
+		AppendVarint(vKeys[iKeyId] -> size());
+		sBuffer.append(*vKeys[iKeyId]);
+	}
+
+	// Hash table, load factor is not greater than 0.5
+	UINT_32 iSlotsCount = 2;
+	while (iSlotsCount < iKeysCount * 2) { iSlotsCount <<= 1; }
+
+	STLW::vector<UINT_32> vSlots(iSlotsCount, 0);
+	for (UINT_32 iKeyId = 0; iKeyId < iKeysCount; ++iKeyId)
+	{
+		UINT_32 iSlot = UINT_32(HashFunc(vKeys[iKeyId] -> data(), vKeys[iKeyId] -> size())) & (iSlotsCount - 1);
+		while (vSlots[iSlot] != 0) { iSlot = (iSlot + 1) & (iSlotsCount - 1); }
+		vSlots[iSlot] = iKeyId + 1;
+	}
+
+	const UINT_32 iOffset = UINT_32(sBuffer.size());
+	AppendVarint(iKeysCount);
+	for (UINT_32 iKeyId = 0; iKeyId < iKeysCount; ++iKeyId) { AppendUInt32(vKeyOffsets[iKeyId]); }
+	AppendUInt32(iSlotsCount);
+	for (UINT_32 iSlot = 0; iSlot < iSlotsCount; ++iSlot) { AppendUInt32(vSlots[iSlot]); }
+
+return iOffset;
+}
+
+//
+// Get key id, add key to dictionary if need
+//
+UINT_32 CTPP2CDTBinaryWriter::GetKeyId(const STLW::string & sKey)
+{
+	STLW::map<STLW::string, UINT_32>::iterator itmKeys = mKeys.find(sKey);
+	if (itmKeys != mKeys.end()) { return itmKeys -> second; }
+
+	const UINT_32 iKeyId = UINT_32(vKeys.size());
+	itmKeys = mKeys.insert(STLW::pair<const STLW::string, UINT_32>(sKey, iKeyId)).first;
+	vKeys.push_back(&(itmKeys -> first));
+
+return iKeyId;
+}
+
+//
+// Append varint
+//
+void CTPP2CDTBinaryWriter::AppendVarint(UINT_64 iValue)
+{
+	while (iValue >= 0x80)
+	{
+		sBuffer.push_back(CHAR_8((iValue & 0x7F) | 0x80));
+		iValue >>= 7;
+	}
+	sBuffer.push_back(CHAR_8(iValue));
+}
+
+//
+// Append little-endian 32-bit value
+//
+void CTPP2CDTBinaryWriter::AppendUInt32(const UINT_32 iValue)
+{
+	sBuffer.push_back(CHAR_8(iValue));
+	sBuffer.push_back(CHAR_8(iValue >> 8));
+	sBuffer.push_back(CHAR_8(iValue >> 16));
+	sBuffer.push_back(CHAR_8(iValue >> 24));
+}
+
+//
+// Store little-endian 32-bit value at given position
+//
+void CTPP2CDTBinaryWriter::StoreUInt32(const UINT_32 iPos, const UINT_32 iValue)
+{
+	sBuffer[iPos]     = CHAR_8(iValue);
+	sBuffer[iPos + 1] = CHAR_8(iValue >> 8);
+	sBuffer[iPos + 2] = CHAR_8(iValue >> 16);
+	sBuffer[iPos + 3] = CHAR_8(iValue >> 24);
+}
+
+//
+// A destructor
+//
+CTPP2CDTBinaryWriter::~CTPP2CDTBinaryWriter() throw() { ;; }
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class CTPP2CDTBinaryReader
+//
+
+//
+// Constructor
+//
+CTPP2CDTBinaryReader::CTPP2CDTBinaryReader(CCHAR_P        szIData,
+                                           const UINT_32  iIDataLength): szData(szIData),
+                                                                         iDataLength(iIDataLength)
+{
+	if (!IsBinaryCDT(szData, iDataLength)) { throw CTPPLogicError("Invalid binary CDT header"); }
+
+	if (ReadUInt32(4) != C_BINARY_CDT_VERSION) { throw CTPPLogicError("Unsupported binary CDT version"); }
+
+	// Buffer may be larger than serialized data
+	const UINT_32 iLength = ReadUInt32(8);
+	if (iLength > iDataLength) { throw CTPPLogicError("Binary CDT is truncated"); }
+	iDataLength = iLength;
+
+	iRootOffset = ReadUInt32(12);
+	CheckRange(iRootOffset, 1);
+
+	UINT_32 iPos = ReadUInt32(16);
+	iKeysCount  = UINT_32(ReadVarint(iPos));
+	iKeysOffset = iPos;
+	CheckRange(iKeysOffset, UINT_64(iKeysCount) * 4 + 4);
+
+	iSlotsCount  = ReadUInt32(iKeysOffset + iKeysCount * 4);
+	iSlotsOffset = iKeysOffset + iKeysCount * 4 + 4;
+	if (iSlotsCount == 0 || (iSlotsCount & (iSlotsCount - 1)) != 0) { throw CTPPLogicError("Invalid binary CDT key dictionary"); }
+	CheckRange(iSlotsOffset, UINT_64(iSlotsCount) * 4);
+}
+
+//
+// Get root value
+//
+CDT CTPP2CDTBinaryReader::GetRoot()
+{
+	CDT oRoot;
+	ReadValue(iRootOffset, oRoot);
+
+return oRoot;
+}
+
+//
+// Check serialized data header
+//
+bool CTPP2CDTBinaryReader::IsBinaryCDT(CCHAR_P szData, const UINT_32 iDataLength)
+{
+	if (szData == NULL || iDataLength < C_BINARY_CDT_HEADER) { return false; }
+
+return memcmp(szData, aBinaryCDTMagic, sizeof(aBinaryCDTMagic)) == 0;
+}
+
+//
+// Decode value
+//
+void CTPP2CDTBinaryReader::ReadValue(const UINT_32 iOffset, CDT & oValue)
+{
+	CheckRange(iOffset, 1);
+
+	UINT_32 iPos = iOffset + 1;
+	switch (UCHAR_8(szData[iOffset]))
+	{
+		case CDT::UNDEF:
+			oValue = CDT();
+			break;
+
+		case CDT::INT_VAL:
+			{
+				const UINT_64 iZigZag = ReadVarint(iPos);
+				oValue = INT_64((iZigZag >> 1) ^ (~(iZigZag & 1) + 1));
+			}
+			break;
+
+		case CDT::REAL_VAL:
+			{
+				CheckRange(iPos, 8);
+				UINT_64 iBits = 0;
+				for (UINT_32 iI = 0; iI < 8; ++iI) { iBits |= UINT_64(UCHAR_8(szData[iPos + iI])) << (iI * 8); }
+
+				W_FLOAT dValue = 0;
+				memcpy(&dValue, &iBits, sizeof(dValue));
+				oValue = dValue;
+			}
+			break;
+
+		case CDT::STRING_VAL:
+			{
+				const UINT_64 iLength = ReadVarint(iPos);
+				CheckRange(iPos, iLength);
+				oValue = STLW::string(szData + iPos, UINT_32(iLength));
+			}
+			break;
+
+		case CDT::ARRAY_VAL:
+		case CDT::HASH_VAL:
+			{
+				// One provider per container
+				STLW::map<UINT_32, CTPP2CDTBinaryContainer *>::iterator itmContainers = mContainers.find(iOffset);
+				if (itmContainers == mContainers.end())
+				{
+					itmContainers = mContainers.insert(STLW::pair<const UINT_32, CTPP2CDTBinaryContainer *>(iOffset, new CTPP2CDTBinaryContainer(this, iOffset))).first;
+				}
+				oValue = CDT(itmContainers -> second);
+			}
+			break;
+
+		default:
+			throw CTPPLogicError("Invalid binary CDT value type");
+	}
+}
+
+//
+// Read varint
+//
+UINT_64 CTPP2CDTBinaryReader::ReadVarint(UINT_32 & iOffset) const
+{
+	UINT_64 iValue = 0;
+	for (UINT_32 iShift = 0; iShift < 64; iShift += 7)
+	{
+		CheckRange(iOffset, 1);
+		const UCHAR_8 ucByte = szData[iOffset++];
+
+		iValue |= UINT_64(ucByte & 0x7F) << iShift;
+		if ((ucByte & 0x80) == 0) { return iValue; }
+	}
+
+	throw CTPPLogicError("Invalid binary CDT varint");
+}
+
+//
+// Read little-endian 32-bit value
+//
+UINT_32 CTPP2CDTBinaryReader::ReadUInt32(const UINT_32 iOffset) const
+{
+	CheckRange(iOffset, 4);
+
+	UCCHAR_P pData = (UCCHAR_P)szData + iOffset;
+
+return UINT_32(pData[0]) | (UINT_32(pData[1]) << 8) | (UINT_32(pData[2]) << 16) | (UINT_32(pData[3]) << 24);
+}
+
+//
+// Read key by id
+//
+CCHAR_P CTPP2CDTBinaryReader::GetKey(const UINT_32 iKeyId, UINT_32 & iKeyLength) const
+{
+	if (iKeyId >= iKeysCount) { throw CTPPLogicError("Invalid binary CDT key id"); }
+
+	UINT_32 iPos = ReadUInt32(iKeysOffset + iKeyId * 4);
+	const UINT_64 iLength = ReadVarint(iPos);
+	CheckRange(iPos, iLength);
+
+	iKeyLength = UINT_32(iLength);
+
+return szData + iPos;
+}
+
+//
+// Find key in dictionary
+//
+bool CTPP2CDTBinaryReader::FindKey(const STLW::string & sKey, UINT_32 & iKeyId) const
+{
+	UINT_32 iSlot = UINT_32(HashFunc(sKey.data(), sKey.size())) & (iSlotsCount - 1);
+	for (UINT_32 iProbe = 0; iProbe < iSlotsCount; ++iProbe)
+	{
+		const UINT_32 iSlotValue = ReadUInt32(iSlotsOffset + iSlot * 4);
+		if (iSlotValue == 0) { return false; }
+
+		UINT_32 iKeyLength = 0;
+		CCHAR_P szKey = GetKey(iSlotValue - 1, iKeyLength);
+		if (iKeyLength == sKey.size() && memcmp(szKey, sKey.data(), iKeyLength) == 0)
+		{
+			iKeyId = iSlotValue - 1;
+			return true;
+		}
+
+		iSlot = (iSlot + 1) & (iSlotsCount - 1);
+	}
+
+return false;
+}
+
+//
+// Check range of data
+//
+void CTPP2CDTBinaryReader::CheckRange(const UINT_32 iOffset, const UINT_64 iLength) const
+{
+	if (UINT_64(iOffset) + iLength > iDataLength) { throw CTPPLogicError("Binary CDT offset is out of range"); }
+}
+
+//
+// A destructor
+//
+CTPP2CDTBinaryReader::~CTPP2CDTBinaryReader() throw()
+{
+	STLW::map<UINT_32, CTPP2CDTBinaryContainer *>::iterator itmContainers = mContainers.begin();
+	while (itmContainers != mContainers.end())
+	{
+		delete itmContainers -> second;
+		++itmContainers;
+	}
+}
+
+} // namespace CTPP
+// End.
@@ -0,0 +1,191 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2ChunkedOutputCollector.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2ChunkedOutputCollector.hpp"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+//
+// Constructor
+//
+ChunkedOutputCollector::ChunkedOutputCollector(OutputCollector  & oITarget,
+                                               const UINT_32      iIChunkSize): oTarget(oITarget),
+                                                                                iChunkSize(iIChunkSize),
+                                                                                iBufferUsed(0),
+                                                                                iMaxMarkerLength(0),
+                                                                                iChunksNum(0)
+{
+	if (iChunkSize == 0) { iChunkSize = C_CHUNKED_COLLECTOR_CHUNK_SIZE; }
+
+	szBuffer = new CHAR_8[iChunkSize];
+}
+
+//
+// Add flush marker
+//
+void ChunkedOutputCollector::AddFlushMarker(const STLW::string & sMarker)
+{
+	if (sMarker.empty()) { return; }
+
+	vMarkers.push_back(sMarker);
+	if (sMarker.size() > iMaxMarkerLength) { iMaxMarkerLength = sMarker.size(); }
+}
+
+//
+// Check buffer for flush markers
+//
+bool ChunkedOutputCollector::FindMarker(const UINT_32 iFrom) const
+{
+	// Marker may start in previously buffered data
+	const UINT_32 iStart = (iFrom > iMaxMarkerLength - 1) ? iFrom - (iMaxMarkerLength - 1) : 0;
+
+	// ... or in data already flushed because buffer was full
+	STLW::string sWindow;
+	if (iFrom < iMaxMarkerLength - 1 && !sTail.empty())
+	{
+		sWindow.assign(sTail);
+		sWindow.append(szBuffer, (iBufferUsed < iMaxMarkerLength - 1) ? iBufferUsed : iMaxMarkerLength - 1);
+	}
+	const UINT_32 iWindowFrom = sTail.size() + iFrom;
+
+	STLW::vector<STLW::string>::const_iterator itvMarkers = vMarkers.begin();
+	while (itvMarkers != vMarkers.end())
+	{
+		CCHAR_P       szMarker       = itvMarkers -> data();
+		const UINT_32 iMarkerLength  = itvMarkers -> size();
+
+		// Marker starts in flushed data and ends in new data
+		for (UINT_32 iPos = 0; iPos < sTail.size() && iPos + iMarkerLength <= sWindow.size(); ++iPos)
+		{
+			if (iPos + iMarkerLength > iWindowFrom && sWindow.compare(iPos, iMarkerLength, *itvMarkers) == 0) { return true; }
+		}
+
+		CCHAR_P szPos = szBuffer + iStart;
+		CCHAR_P szEnd = szBuffer + iBufferUsed;
+		while (szEnd - szPos >= INT_32(iMarkerLength))
+		{
+			szPos = (CCHAR_P)memchr(szPos, *szMarker, szEnd - szPos - iMarkerLength + 1);
+			if (szPos == NULL) { break; }
+
+			// New data should be part of marker
+			if (szPos + iMarkerLength > szBuffer + iFrom && memcmp(szPos, szMarker, iMarkerLength) == 0) { return true; }
+			++szPos;
+		}
+		++itvMarkers;
+	}
+
+return false;
+}
+
+//
+// Collect data
+//
+INT_32 ChunkedOutputCollector::Collect(const void * vData, const UINT_32 iDataLength)
+{
+	if (iDataLength > iChunkSize - iBufferUsed)
+	{
+		if (Flush() != 0) { return -1; }
+
+		// Chunk larger than buffer is passed as is
+		if (iDataLength >= iChunkSize)
+		{
+			KeepTail((CCHAR_P)vData, iDataLength);
+			++iChunksNum;
+			return oTarget.Collect(vData, iDataLength);
+		}
+	}
+
+	const UINT_32 iFrom = iBufferUsed;
+	memcpy(szBuffer + iBufferUsed, vData, iDataLength);
+	iBufferUsed += iDataLength;
+
+	if (iBufferUsed == iChunkSize || (!vMarkers.empty() && FindMarker(iFrom))) { return Flush(); }
+
+return 0;
+}
+
+//
+// Pass buffered data to target collector
+//
+INT_32 ChunkedOutputCollector::Flush()
+{
+	if (iBufferUsed == 0) { return 0; }
+
+	const UINT_32 iDataLength = iBufferUsed;
+	iBufferUsed = 0;
+	++iChunksNum;
+
+	KeepTail(szBuffer, iDataLength);
+
+return oTarget.Collect(szBuffer, iDataLength);
+}
+
+//
+// Keep last bytes of flushed data
+//
+void ChunkedOutputCollector::KeepTail(CCHAR_P szData, const UINT_32 iDataLength)
+{
+	if (iMaxMarkerLength <= 1) { return; }
+
+	const UINT_32 iTailLength = iMaxMarkerLength - 1;
+	if (iDataLength >= iTailLength)
+	{
+		sTail.assign(szData + iDataLength - iTailLength, iTailLength);
+		return;
+	}
+
+	sTail.append(szData, iDataLength);
+	if (sTail.size() > iTailLength) { sTail.erase(0, sTail.size() - iTailLength); }
+}
+
+//
+// Get number of flushed chunks
+//
+UINT_32 ChunkedOutputCollector::GetChunksNum() const { return iChunksNum; }
+
+//
+// A destructor
+//
+ChunkedOutputCollector::~ChunkedOutputCollector() throw()
+{
+	Flush();
+
+	delete [] szBuffer;
+}
+
+} // namespace CTPP
+// End.
@@ -200,6 +200,36 @@ INT_32 CTPP2Compiler::OutputVariable(const VMDebugInfo & oDebugInfo)
 return oVMOpcodeCollector.Insert(CreateInstruction(OUTPUT | ARG_SRC_STACK, 0, oDebugInfo.GetInfo()));
 }
 
+//
+// Send result of system call to standard output collector
+//
+INT_32 CTPP2Compiler::OutputCallResult(const VMDebugInfo & oDebugInfo)
+{
+	COMPILER_REPORTER("OutputCallResult");
+
+	// Result is not pushed into stack, handler writes it to output collector
+	const UINT_32 iIP = oVMOpcodeCollector.GetCodeSize() - 1;
+	VMInstruction * pInstruction = oVMOpcodeCollector.GetInstruction(iIP);
+	if (pInstruction == NULL || pInstruction -> instruction != SYSCALL) { return OutputVariable(oDebugInfo); }
+
+	pInstruction -> instruction = OUTCALL;
+
+	--iStackDepth;
+return iIP;
+}
+
+//
+// Escape variable and send it to standard output collector
+//
+INT_32 CTPP2Compiler::OutputEscapedVariable(const UINT_32        iEscapeType,
+                                            const VMDebugInfo  & oDebugInfo)
+{
+	COMPILER_REPORTER("OutputEscapedVariable");
+
+	--iStackDepth;
+return oVMOpcodeCollector.Insert(CreateInstruction(OUTPUTESC | ARG_SRC_STACK, iEscapeType, oDebugInfo.GetInfo()));
+}
+
 //
 // Send text data to standard output collector
 //
@@ -344,6 +374,7 @@ return iRetPoint;
 // Reset scope to previous CDT data (for ARRAY iterating)
 //
 //
+//	MOVREST  FR, GR.size() - ER
 //	LOOP     FR, ER, @RET_POINT
 //	POP47
 
@@ -365,6 +396,8 @@ INT_32 CTPP2Compiler::ResetScope(const UINT_32        iIP,
 	--iScopeNumber;
 	oSymbolTable.UnmarkScope();
 
+	// Re-read number of iterations, size of generator is known only one element ahead
+	oVMOpcodeCollector.Insert(CreateInstruction(MOVREST | ARG_DST_FR | ARG_SRC_GR   , ARG_SRC_ER, iDebugInfo));
 	oVMOpcodeCollector.Insert(CreateInstruction(LOOP | ARG_SRC_FR | ARG_DST_ER      ,   iIP, iDebugInfo));
 
 	UINT_32 iEndPoint =
@@ -463,6 +496,43 @@ void CTPP2Compiler::PrepareCallBlock(const VMDebugInfo & oDebugInfo)
 	vSavedStackDepths.push_back(iStackDepth);
 }
 
+//
+// Start of cached fragment
+//
+//	PUSH     "fragment name"
+//	PUSH     key1 ... keyN
+//	PUSH     TTL
+//	CACHEGET N + 2
+//	JMP      @END       ; cache hit
+//
+//	Fragment code
+//
+//	CACHEPUT
+//  @END:
+//
+INT_32 CTPP2Compiler::StartCache(const UINT_32        iArgCount,
+                                 const VMDebugInfo  & oDebugInfo)
+{
+	COMPILER_REPORTER("StartCache");
+
+	UINT_64 iDebugInfo = oDebugInfo.GetInfo();
+
+	oVMOpcodeCollector.Insert(CreateInstruction(CACHEGET, iArgCount, iDebugInfo));
+	iStackDepth -= iArgCount;
+
+return oVMOpcodeCollector.Insert(CreateInstruction(JMP, (UINT_32)-1, iDebugInfo));
+}
+
+//
+// End of cached fragment
+//
+INT_32 CTPP2Compiler::EndCache(const VMDebugInfo & oDebugInfo)
+{
+	COMPILER_REPORTER("EndCache");
+
+return oVMOpcodeCollector.Insert(CreateInstruction(CACHEPUT, 0, oDebugInfo.GetInfo()));
+}
+
 //
 // Get system call by id
 //
@@ -723,6 +793,23 @@ INT_32 CTPP2Compiler::RemoveInstruction()
 return oVMOpcodeCollector.Remove();
 }
 
+//
+// Replace string pushed into stack by instruction
+//
+INT_32 CTPP2Compiler::ChangeString(const UINT_32        iIP,
+                                   CCHAR_P              szData,
+                                   const UINT_32        iDataLength)
+{
+	COMPILER_REPORTER("ChangeString");
+
+	VMInstruction * pInstruction = oVMOpcodeCollector.GetInstruction(iIP);
+	if (pInstruction == NULL || pInstruction -> instruction != (PUSH | ARG_SRC_STR)) { return -1; }
+
+	pInstruction -> argument = oStaticText.StoreData(szData, iDataLength);
+
+return iIP;
+}
+
 //
 // Unconditional jump
 //
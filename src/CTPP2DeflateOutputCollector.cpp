@@ -0,0 +1,273 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2DeflateOutputCollector.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2DeflateOutputCollector.hpp"
+
+#ifdef ZLIB_SUPPORT
+
+#include "CTPP2Exception.hpp"
+#include "CTPP2VMMemoryCore.hpp"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+/** gzip header: magic, method, flags, mtime, extra flags, OS (unix) */
+static const UCHAR_8 aGzipHeader[10] = { 0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 };
+
+//
+// Initialize raw deflate stream
+//
+static void InitRawDeflate(z_stream & oStream, const INT_32 iLevel)
+{
+	memset(&oStream, 0, sizeof(oStream));
+	if (deflateInit2(&oStream, iLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		throw CTPPLogicError("Cannot initialize deflate stream");
+	}
+}
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class DeflateStaticText
+//
+
+//
+// Constructor
+//
+DeflateStaticText::DeflateStaticText(const VMMemoryCore  * pVMMemoryCore,
+                                     const INT_32          iLevel,
+                                     const UINT_32         iIMinLength): iMinLength(iIMinLength)
+{
+	const ReducedStaticText & oStaticText = pVMMemoryCore -> static_text;
+
+	Bytef aBuffer[C_DEFLATE_BUFFER_LEN];
+	for (UINT_32 iDataId = 0; iDataId < oStaticText.GetRecordsNum(); ++iDataId)
+	{
+		UINT_32 iDataLength = 0;
+		CCHAR_P szData = oStaticText.GetData(iDataId, iDataLength);
+		if (iDataLength < iMinLength || mBlocks.find(szData) != mBlocks.end()) { continue; }
+
+		// Every block is independent and ends at byte boundary
+		z_stream oStream;
+		InitRawDeflate(oStream, iLevel);
+
+		const UINT_32 iOffset = sBlocks.size();
+		oStream.next_in  = (Bytef *)szData;
+		oStream.avail_in = iDataLength;
+		do
+		{
+			oStream.next_out  = aBuffer;
+			oStream.avail_out = C_DEFLATE_BUFFER_LEN;
+			deflate(&oStream, Z_FULL_FLUSH);
+			sBlocks.append((CCHAR_P)aBuffer, C_DEFLATE_BUFFER_LEN - oStream.avail_out);
+		}
+		while (oStream.avail_out == 0);
+		deflateEnd(&oStream);
+
+		// Incompressible text
+		if (sBlocks.size() - iOffset >= iDataLength) { sBlocks.erase(iOffset); continue; }
+
+		Block oBlock;
+		oBlock.text_length = iDataLength;
+		oBlock.offset      = iOffset;
+		oBlock.length      = sBlocks.size() - iOffset;
+		oBlock.crc         = crc32(crc32(0L, Z_NULL, 0), (const Bytef *)szData, iDataLength);
+
+		mBlocks[szData] = oBlock;
+	}
+}
+
+//
+// Find pre-deflated block for static text run
+//
+bool DeflateStaticText::Find(CCHAR_P          szData,
+                             const UINT_32    iDataLength,
+                             CCHAR_P        & szBlock,
+                             UINT_32        & iBlockLength,
+                             UINT_32        & iCRC) const
+{
+	if (iDataLength < iMinLength) { return false; }
+
+	STLW::map<CCHAR_P, Block>::const_iterator itmBlocks = mBlocks.find(szData);
+	if (itmBlocks == mBlocks.end() || itmBlocks -> second.text_length != iDataLength) { return false; }
+
+	szBlock      = sBlocks.data() + itmBlocks -> second.offset;
+	iBlockLength = itmBlocks -> second.length;
+	iCRC         = itmBlocks -> second.crc;
+
+return true;
+}
+
+//
+// Get number of pre-deflated blocks
+//
+UINT_32 DeflateStaticText::GetBlocksNum() const { return mBlocks.size(); }
+
+//
+// A destructor
+//
+DeflateStaticText::~DeflateStaticText() throw() { ;; }
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class DeflateOutputCollector
+//
+
+//
+// Constructor
+//
+DeflateOutputCollector::DeflateOutputCollector(OutputCollector          & oITarget,
+                                               const bool                 bIGzip,
+                                               const INT_32               iLevel,
+                                               const DeflateStaticText  * pIStaticText): oTarget(oITarget),
+                                                                                         pStaticText(pIStaticText),
+                                                                                         bGzip(bIGzip),
+                                                                                         bFinished(false),
+                                                                                         bFailed(false),
+                                                                                         iTotalLength(0)
+{
+	// gzip wrapper is written here, zlib does not know about spliced blocks
+	InitRawDeflate(oStream, iLevel);
+	iCRC = crc32(0L, Z_NULL, 0);
+
+	if (bGzip && oTarget.Collect(aGzipHeader, sizeof(aGzipHeader)) != 0) { bFailed = true; }
+}
+
+//
+// Compress data
+//
+INT_32 DeflateOutputCollector::Deflate(const void * vData, const UINT_32 iDataLength, const INT_32 iFlush)
+{
+	oStream.next_in  = (Bytef *)vData;
+	oStream.avail_in = iDataLength;
+	do
+	{
+		oStream.next_out  = aBuffer;
+		oStream.avail_out = C_DEFLATE_BUFFER_LEN;
+
+		// Z_BUF_ERROR means "nothing to do"
+		if (deflate(&oStream, iFlush) == Z_STREAM_ERROR) { return -1; }
+
+		const UINT_32 iCompressed = C_DEFLATE_BUFFER_LEN - oStream.avail_out;
+		if (iCompressed != 0 && oTarget.Collect(aBuffer, iCompressed) != 0) { return -1; }
+	}
+	while (oStream.avail_out == 0);
+
+return 0;
+}
+
+//
+// Collect data
+//
+INT_32 DeflateOutputCollector::Collect(const void * vData, const UINT_32 iDataLength)
+{
+	if (bFinished || bFailed) { return -1; }
+	if (iDataLength == 0)     { return 0;  }
+
+	iTotalLength += iDataLength;
+
+	CCHAR_P szBlock      = NULL;
+	UINT_32 iBlockLength = 0;
+	UINT_32 iBlockCRC    = 0;
+	if (pStaticText != NULL && pStaticText -> Find((CCHAR_P)vData, iDataLength, szBlock, iBlockLength, iBlockCRC))
+	{
+		// Align output and forget history, then splice block as is
+		if (Deflate(NULL, 0, Z_FULL_FLUSH) != 0) { return -1; }
+
+		iCRC = crc32_combine(iCRC, iBlockCRC, iDataLength);
+		return oTarget.Collect(szBlock, iBlockLength);
+	}
+
+	iCRC = crc32(iCRC, (const Bytef *)vData, iDataLength);
+
+return Deflate(vData, iDataLength, Z_NO_FLUSH);
+}
+
+//
+// Compress pending data and pass it to target collector
+//
+INT_32 DeflateOutputCollector::Flush()
+{
+	if (bFinished || bFailed) { return -1; }
+
+return Deflate(NULL, 0, Z_SYNC_FLUSH);
+}
+
+//
+// Finish compressed stream
+//
+INT_32 DeflateOutputCollector::Finish()
+{
+	if (bFinished) { return bFailed ? -1 : 0; }
+	bFinished = true;
+
+	// Stream without header is useless, only free it
+	if (bFailed)
+	{
+		deflateEnd(&oStream);
+		return -1;
+	}
+
+	INT_32 iRC = Deflate(NULL, 0, Z_FINISH);
+	deflateEnd(&oStream);
+
+	if (bGzip)
+	{
+		// CRC-32 and length of uncompressed data, little-endian
+		UCHAR_8 aTrailer[8];
+		for (UINT_32 iI = 0; iI < 4; ++iI)
+		{
+			aTrailer[iI]     = UCHAR_8(iCRC >> (iI * 8));
+			aTrailer[iI + 4] = UCHAR_8(iTotalLength >> (iI * 8));
+		}
+		if (oTarget.Collect(aTrailer, sizeof(aTrailer)) != 0) { iRC = -1; }
+	}
+
+return iRC;
+}
+
+//
+// A destructor
+//
+DeflateOutputCollector::~DeflateOutputCollector() throw()
+{
+	Finish();
+}
+
+} // namespace CTPP
+
+#endif // ZLIB_SUPPORT
+// End.
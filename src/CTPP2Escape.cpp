@@ -0,0 +1,484 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2Escape.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2Escape.hpp"
+
+#include "CTPP2OutputCollector.hpp"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define C_ESCAPE_NEON 1
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+// Escape classes
+#define C_ESCAPE_MARKUP  0x01
+#define C_ESCAPE_WML     0x02
+#define C_ESCAPE_URL     0x04
+
+//
+// Characters that should be escaped: '"', '\'', '<', '>', '&' in HTML and XML;
+// the same plus control characters and '$' in WML; everything except [A-Za-z0-9/._-] in URL and URI
+//
+static const UCHAR_8 aEscapeClass[256] =
+{
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	4, 4, 7, 4, 6, 4, 7, 7, 4, 4, 4, 4, 4, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 7, 4, 7, 4,
+	4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 0,
+	4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+};
+
+static const CHAR_8 aHexChars[] = "0123456789ABCDEF";
+
+#if defined(__SSE2__) || defined(C_ESCAPE_NEON)
+//
+// Position of lowest set bit
+//
+static inline UINT_32 LowestBit(const UINT_64 iMask)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(iMask);
+#else
+	UINT_32 iPos = 0;
+	while (((iMask >> iPos) & 1) == 0) { ++iPos; }
+
+return iPos;
+#endif
+}
+#endif
+
+#if defined(C_ESCAPE_NEON)
+//
+// Pack comparison result to 4 bits per byte
+//
+static inline UINT_64 NEONMask(const uint8x16_t vMatch)
+{
+	return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vMatch), 4)), 0);
+}
+#endif
+
+//
+// Find next character that should be escaped in HTML, XML or WML
+//
+static CCHAR_P FindMarkupEscape(CCHAR_P szData, CCHAR_P szEnd, const bool bWML)
+{
+#if defined(__AVX2__)
+	{
+		const __m256i vQuote   = _mm256_set1_epi8('"');
+		const __m256i vApos    = _mm256_set1_epi8('\'');
+		const __m256i vLess    = _mm256_set1_epi8('<');
+		const __m256i vGreater = _mm256_set1_epi8('>');
+		const __m256i vAmp     = _mm256_set1_epi8('&');
+		// '$' and control characters are checked in WML only
+		const __m256i vDollar  = _mm256_set1_epi8(bWML ? '$' : '"');
+		const __m256i vControl = _mm256_set1_epi8(0x1F);
+		const __m256i vWML     = _mm256_set1_epi8(bWML ? -1 : 0);
+
+		while (szEnd - szData >= 32)
+		{
+			const __m256i vBlock = _mm256_loadu_si256((const __m256i *)szData);
+
+			__m256i vMatch = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(vBlock, vControl), vControl), vWML);
+			vMatch = _mm256_or_si256(vMatch, _mm256_cmpeq_epi8(vBlock, vQuote));
+			vMatch = _mm256_or_si256(vMatch, _mm256_cmpeq_epi8(vBlock, vApos));
+			vMatch = _mm256_or_si256(vMatch, _mm256_cmpeq_epi8(vBlock, vLess));
+			vMatch = _mm256_or_si256(vMatch, _mm256_cmpeq_epi8(vBlock, vGreater));
+			vMatch = _mm256_or_si256(vMatch, _mm256_cmpeq_epi8(vBlock, vAmp));
+			vMatch = _mm256_or_si256(vMatch, _mm256_cmpeq_epi8(vBlock, vDollar));
+
+			const UINT_32 iMask = _mm256_movemask_epi8(vMatch);
+			if (iMask != 0) { return szData + LowestBit(iMask); }
+
+			szData += 32;
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	{
+		const __m128i vQuote   = _mm_set1_epi8('"');
+		const __m128i vApos    = _mm_set1_epi8('\'');
+		const __m128i vLess    = _mm_set1_epi8('<');
+		const __m128i vGreater = _mm_set1_epi8('>');
+		const __m128i vAmp     = _mm_set1_epi8('&');
+		// '$' and control characters are checked in WML only
+		const __m128i vDollar  = _mm_set1_epi8(bWML ? '$' : '"');
+		const __m128i vControl = _mm_set1_epi8(0x1F);
+		const __m128i vWML     = _mm_set1_epi8(bWML ? -1 : 0);
+
+		while (szEnd - szData >= 16)
+		{
+			const __m128i vBlock = _mm_loadu_si128((const __m128i *)szData);
+
+			__m128i vMatch = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(vBlock, vControl), vControl), vWML);
+			vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vQuote));
+			vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vApos));
+			vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vLess));
+			vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vGreater));
+			vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vAmp));
+			vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vDollar));
+
+			const UINT_32 iMask = _mm_movemask_epi8(vMatch);
+			if (iMask != 0) { return szData + LowestBit(iMask); }
+
+			szData += 16;
+		}
+	}
+#elif defined(C_ESCAPE_NEON)
+	{
+		const uint8x16_t vQuote   = vdupq_n_u8('"');
+		const uint8x16_t vApos    = vdupq_n_u8('\'');
+		const uint8x16_t vLess    = vdupq_n_u8('<');
+		const uint8x16_t vGreater = vdupq_n_u8('>');
+		const uint8x16_t vAmp     = vdupq_n_u8('&');
+		// '$' and control characters are checked in WML only
+		const uint8x16_t vDollar  = vdupq_n_u8(bWML ? '$' : '"');
+		const uint8x16_t vControl = vdupq_n_u8(0x1F);
+		const uint8x16_t vWML     = vdupq_n_u8(bWML ? 0xFF : 0);
+
+		while (szEnd - szData >= 16)
+		{
+			const uint8x16_t vBlock = vld1q_u8((const uint8_t *)szData);
+
+			uint8x16_t vMatch = vandq_u8(vcleq_u8(vBlock, vControl), vWML);
+			vMatch = vorrq_u8(vMatch, vceqq_u8(vBlock, vQuote));
+			vMatch = vorrq_u8(vMatch, vceqq_u8(vBlock, vApos));
+			vMatch = vorrq_u8(vMatch, vceqq_u8(vBlock, vLess));
+			vMatch = vorrq_u8(vMatch, vceqq_u8(vBlock, vGreater));
+			vMatch = vorrq_u8(vMatch, vceqq_u8(vBlock, vAmp));
+			vMatch = vorrq_u8(vMatch, vceqq_u8(vBlock, vDollar));
+
+			const UINT_64 iMask = NEONMask(vMatch);
+			if (iMask != 0) { return szData + (LowestBit(iMask) >> 2); }
+
+			szData += 16;
+		}
+	}
+#endif
+	const UCHAR_8 iClass = bWML ? C_ESCAPE_WML : C_ESCAPE_MARKUP;
+	while (szData != szEnd && (aEscapeClass[UCHAR_8(*szData)] & iClass) == 0) { ++szData; }
+
+return szData;
+}
+
+//
+// Find next character that should be escaped in URL or URI
+//
+static CCHAR_P FindURLEscape(CCHAR_P szData, CCHAR_P szEnd)
+{
+	// Safe characters: '-', '.', '/', '0' - '9' (0x2D - 0x39), 'A' - 'Z', 'a' - 'z' and '_'
+#if defined(__AVX2__)
+	{
+		const __m256i vDigitsLo  = _mm256_set1_epi8(0x2D);
+		const __m256i vDigitsLen = _mm256_set1_epi8(0x39 - 0x2D);
+		const __m256i vUpperLo   = _mm256_set1_epi8('A');
+		const __m256i vLowerLo   = _mm256_set1_epi8('a');
+		const __m256i vAlphaLen  = _mm256_set1_epi8('Z' - 'A');
+		const __m256i vUnderline = _mm256_set1_epi8('_');
+		const __m256i vZero      = _mm256_setzero_si256();
+
+		while (szEnd - szData >= 32)
+		{
+			const __m256i vBlock = _mm256_loadu_si256((const __m256i *)szData);
+
+			// x in [lo, lo + len] <=> saturated (x - lo) - len == 0
+			__m256i vSafe = _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_sub_epi8(vBlock, vDigitsLo), vDigitsLen), vZero);
+			vSafe = _mm256_or_si256(vSafe, _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_sub_epi8(vBlock, vUpperLo), vAlphaLen), vZero));
+			vSafe = _mm256_or_si256(vSafe, _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_sub_epi8(vBlock, vLowerLo), vAlphaLen), vZero));
+			vSafe = _mm256_or_si256(vSafe, _mm256_cmpeq_epi8(vBlock, vUnderline));
+
+			const UINT_32 iMask = ~UINT_32(_mm256_movemask_epi8(vSafe));
+			if (iMask != 0) { return szData + LowestBit(iMask); }
+
+			szData += 32;
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	{
+		const __m128i vDigitsLo  = _mm_set1_epi8(0x2D);
+		const __m128i vDigitsLen = _mm_set1_epi8(0x39 - 0x2D);
+		const __m128i vUpperLo   = _mm_set1_epi8('A');
+		const __m128i vLowerLo   = _mm_set1_epi8('a');
+		const __m128i vAlphaLen  = _mm_set1_epi8('Z' - 'A');
+		const __m128i vUnderline = _mm_set1_epi8('_');
+		const __m128i vZero      = _mm_setzero_si128();
+
+		while (szEnd - szData >= 16)
+		{
+			const __m128i vBlock = _mm_loadu_si128((const __m128i *)szData);
+
+			// x in [lo, lo + len] <=> saturated (x - lo) - len == 0
+			__m128i vSafe = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(vBlock, vDigitsLo), vDigitsLen), vZero);
+			vSafe = _mm_or_si128(vSafe, _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(vBlock, vUpperLo), vAlphaLen), vZero));
+			vSafe = _mm_or_si128(vSafe, _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(vBlock, vLowerLo), vAlphaLen), vZero));
+			vSafe = _mm_or_si128(vSafe, _mm_cmpeq_epi8(vBlock, vUnderline));
+
+			const UINT_32 iMask = ~UINT_32(_mm_movemask_epi8(vSafe)) & 0xFFFF;
+			if (iMask != 0) { return szData + LowestBit(iMask); }
+
+			szData += 16;
+		}
+	}
+#elif defined(C_ESCAPE_NEON)
+	{
+		const uint8x16_t vDigitsLo  = vdupq_n_u8(0x2D);
+		const uint8x16_t vDigitsLen = vdupq_n_u8(0x39 - 0x2D);
+		const uint8x16_t vUpperLo   = vdupq_n_u8('A');
+		const uint8x16_t vLowerLo   = vdupq_n_u8('a');
+		const uint8x16_t vAlphaLen  = vdupq_n_u8('Z' - 'A');
+		const uint8x16_t vUnderline = vdupq_n_u8('_');
+
+		while (szEnd - szData >= 16)
+		{
+			const uint8x16_t vBlock = vld1q_u8((const uint8_t *)szData);
+
+			uint8x16_t vSafe = vcleq_u8(vsubq_u8(vBlock, vDigitsLo), vDigitsLen);
+			vSafe = vorrq_u8(vSafe, vcleq_u8(vsubq_u8(vBlock, vUpperLo), vAlphaLen));
+			vSafe = vorrq_u8(vSafe, vcleq_u8(vsubq_u8(vBlock, vLowerLo), vAlphaLen));
+			vSafe = vorrq_u8(vSafe, vceqq_u8(vBlock, vUnderline));
+
+			const UINT_64 iMask = NEONMask(vmvnq_u8(vSafe));
+			if (iMask != 0) { return szData + (LowestBit(iMask) >> 2); }
+
+			szData += 16;
+		}
+	}
+#endif
+	while (szData != szEnd && (aEscapeClass[UCHAR_8(*szData)] & C_ESCAPE_URL) == 0) { ++szData; }
+
+return szData;
+}
+
+//
+// Escaped data writer: append to string
+//
+class EscapeStringWriter
+{
+public:
+	EscapeStringWriter(STLW::string & sIResult): sResult(sIResult) { ;; }
+
+	void Write(CCHAR_P szData, const UINT_32 iDataLength) { sResult.append(szData, iDataLength); }
+
+	void Flush() { ;; }
+private:
+	/** Destination string */
+	STLW::string  & sResult;
+};
+
+//
+// Escaped data writer: short pieces are buffered, long runs are passed to output collector as is
+//
+class EscapeCollectorWriter
+{
+public:
+	EscapeCollectorWriter(OutputCollector & oICollector): oCollector(oICollector), iBufferLength(0) { ;; }
+
+	void Write(CCHAR_P szData, const UINT_32 iDataLength)
+	{
+		if (iBufferLength + iDataLength > CTPP_ESCAPE_BUFFER_LEN) { Flush(); }
+
+		if (iDataLength >= CTPP_ESCAPE_BUFFER_LEN / 4)
+		{
+			Flush();
+			oCollector.Collect(szData, iDataLength);
+			return;
+		}
+
+		memcpy(aBuffer + iBufferLength, szData, iDataLength);
+		iBufferLength += iDataLength;
+	}
+
+	void Flush()
+	{
+		if (iBufferLength == 0) { return; }
+
+		oCollector.Collect(aBuffer, iBufferLength);
+		iBufferLength = 0;
+	}
+private:
+	/** Output collector    */
+	OutputCollector  & oCollector;
+	/** Buffered data size  */
+	UINT_32            iBufferLength;
+	/** Buffer              */
+	CHAR_8             aBuffer[CTPP_ESCAPE_BUFFER_LEN];
+};
+
+//
+// Escape HTML, XML or WML
+//
+template <typename T> static void EscapeMarkup(CCHAR_P                   szData,
+                                               CCHAR_P                   szEnd,
+                                               const eCTPP2EscapeType    eType,
+                                               T                       & oWriter)
+{
+	const bool bWML = (eType == ESCAPE_WML);
+
+	// HTML has no &apos; entity
+	CCHAR_P       szApos       = (eType == ESCAPE_HTML) ? "&#39;" : "&apos;";
+	const UINT_32 iAposLength  = (eType == ESCAPE_HTML) ? 5 : 6;
+
+	for (;;)
+	{
+		CCHAR_P szEscape = FindMarkupEscape(szData, szEnd, bWML);
+		if (szEscape != szData) { oWriter.Write(szData, szEscape - szData); }
+		if (szEscape == szEnd)  { break; }
+
+		switch (*szEscape)
+		{
+			case '"':  oWriter.Write("&quot;", 6);         break;
+			case '\'': oWriter.Write(szApos, iAposLength); break;
+			case '<':  oWriter.Write("&lt;",   4);         break;
+			case '>':  oWriter.Write("&gt;",   4);         break;
+			case '&':  oWriter.Write("&amp;",  5);         break;
+			case '$':  oWriter.Write("$$",     2);         break;
+			// Control characters are removed from WML
+			default:
+				;;
+		}
+
+		szData = szEscape + 1;
+	}
+
+	oWriter.Flush();
+}
+
+//
+// Escape URL or URI
+//
+template <typename T> static void EscapeURL(CCHAR_P    szData,
+                                            CCHAR_P    szEnd,
+                                            T        & oWriter)
+{
+	CHAR_8 aEscaped[3 * 32];
+
+	for (;;)
+	{
+		CCHAR_P szEscape = FindURLEscape(szData, szEnd);
+		if (szEscape != szData) { oWriter.Write(szData, szEscape - szData); }
+		if (szEscape == szEnd)  { break; }
+
+		// Encode run of unsafe characters at once (non-ASCII text consists of them)
+		UINT_32 iEscapedLength = 0;
+		do
+		{
+			const UCHAR_8 uCH = *szEscape++;
+			aEscaped[iEscapedLength++] = '%';
+			aEscaped[iEscapedLength++] = aHexChars[uCH >> 4];
+			aEscaped[iEscapedLength++] = aHexChars[uCH & 0x0F];
+		}
+		while (szEscape != szEnd && iEscapedLength != sizeof(aEscaped) && (aEscapeClass[UCHAR_8(*szEscape)] & C_ESCAPE_URL) != 0);
+
+		oWriter.Write(aEscaped, iEscapedLength);
+
+		szData = szEscape;
+	}
+
+	oWriter.Flush();
+}
+
+//
+// Escape data with given rules
+//
+template <typename T> static void Escape(const eCTPP2EscapeType    eType,
+                                         CCHAR_P                   szData,
+                                         const UINT_32             iDataLength,
+                                         T                       & oWriter)
+{
+	switch (eType)
+	{
+		case ESCAPE_HTML:
+		case ESCAPE_XML:
+		case ESCAPE_WML:
+			EscapeMarkup(szData, szData + iDataLength, eType, oWriter);
+			break;
+
+		case ESCAPE_URL:
+		case ESCAPE_URI:
+			EscapeURL(szData, szData + iDataLength, oWriter);
+			break;
+
+		case ESCAPE_NONE:
+			oWriter.Write(szData, iDataLength);
+			oWriter.Flush();
+			break;
+	}
+}
+
+//
+// Escape data and append it to string
+//
+void EscapeData(const eCTPP2EscapeType   eType,
+                CCHAR_P                  szData,
+                const UINT_32            iDataLength,
+                STLW::string           & sResult)
+{
+	EscapeStringWriter oWriter(sResult);
+	Escape(eType, szData, iDataLength, oWriter);
+}
+
+//
+// Escape data and pass it to output collector
+//
+void EscapeData(const eCTPP2EscapeType   eType,
+                CCHAR_P                  szData,
+                const UINT_32            iDataLength,
+                OutputCollector        & oCollector)
+{
+	EscapeCollectorWriter oWriter(oCollector);
+	Escape(eType, szData, iDataLength, oWriter);
+}
+
+} // namespace CTPP
+// End.
@@ -0,0 +1,198 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2FDOutputCollector.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2FDOutputCollector.hpp"
+
+#include "CTPP2VMMemoryCore.hpp"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+//
+// Constructor
+//
+FDOutputCollector::FDOutputCollector(const INT_32          iIFHandle,
+                                     const VMMemoryCore  * pVMMemoryCore,
+                                     const UINT_32         iIFlushThreshold): iFHandle(iIFHandle),
+                                                                              szStaticBegin(NULL),
+                                                                              szStaticEnd(NULL),
+                                                                              iFlushThreshold(iIFlushThreshold),
+                                                                              iPendingSize(0),
+                                                                              iIOVecsUsed(0),
+                                                                              iBufferUsed(0)
+{
+	if (iFlushThreshold == 0) { iFlushThreshold = C_FD_COLLECTOR_FLUSH_THRESHOLD; }
+
+	if (pVMMemoryCore != NULL)
+	{
+		UINT_32 iStaticSize = 0;
+		szStaticBegin = pVMMemoryCore -> static_text.GetRawData(iStaticSize);
+		szStaticEnd   = szStaticBegin + iStaticSize;
+	}
+
+	aIOVecs  = new struct iovec[C_FD_COLLECTOR_MAX_IOVECS];
+	szBuffer = new CHAR_8[iFlushThreshold];
+}
+
+//
+// Add chunk
+//
+void FDOutputCollector::AddChunk(CCHAR_P szData, const UINT_32 iDataLength)
+{
+	iPendingSize += iDataLength;
+
+	if (iIOVecsUsed != 0)
+	{
+		struct iovec & oLast = aIOVecs[iIOVecsUsed - 1];
+		if ((CCHAR_P)oLast.iov_base + oLast.iov_len == szData) { oLast.iov_len += iDataLength; return; }
+	}
+
+	aIOVecs[iIOVecsUsed].iov_base = (void *)szData;
+	aIOVecs[iIOVecsUsed].iov_len  = iDataLength;
+	++iIOVecsUsed;
+}
+
+//
+// Collect data
+//
+INT_32 FDOutputCollector::Collect(const void * vData, const UINT_32 iDataLength)
+{
+	if (iDataLength == 0) { return 0; }
+
+	// Room for one more chunk
+	if (iIOVecsUsed == C_FD_COLLECTOR_MAX_IOVECS && Flush() != 0) { return -1; }
+
+	CCHAR_P szData = (CCHAR_P)vData;
+	// Static text outlives the render
+	if (szData >= szStaticBegin && szData + iDataLength <= szStaticEnd)
+	{
+		AddChunk(szData, iDataLength);
+	}
+	else
+	{
+		if (iDataLength > iFlushThreshold - iBufferUsed)
+		{
+			// Large chunk is written together with pending data, without copying
+			if (iDataLength > iFlushThreshold / 2)
+			{
+				AddChunk(szData, iDataLength);
+				return Flush();
+			}
+
+			if (Flush() != 0) { return -1; }
+		}
+
+		memcpy(szBuffer + iBufferUsed, szData, iDataLength);
+		AddChunk(szBuffer + iBufferUsed, iDataLength);
+		iBufferUsed += iDataLength;
+	}
+
+	if (iPendingSize >= iFlushThreshold) { return Flush(); }
+
+return 0;
+}
+
+//
+// Write all pending data
+//
+INT_32 FDOutputCollector::Flush()
+{
+	struct iovec * pIOVec   = aIOVecs;
+	UINT_32        iIOVecs  = iIOVecsUsed;
+
+	INT_32 iRC = 0;
+	while (iIOVecs != 0)
+	{
+		const ssize_t iWritten = writev(iFHandle, pIOVec, iIOVecs);
+		if (iWritten == -1)
+		{
+			if (errno == EINTR) { continue; }
+			iRC = -1;
+			break;
+		}
+
+		// Skip written chunks, partially written chunk is adjusted
+		size_t iLeft = iWritten;
+		while (iIOVecs != 0 && iLeft >= pIOVec -> iov_len)
+		{
+			iLeft -= pIOVec -> iov_len;
+			++pIOVec;
+			--iIOVecs;
+		}
+
+		if (iIOVecs != 0)
+		{
+			pIOVec -> iov_base  = (CHAR_P)pIOVec -> iov_base + iLeft;
+			pIOVec -> iov_len  -= iLeft;
+		}
+	}
+
+	iIOVecsUsed  = 0;
+	iBufferUsed  = 0;
+	iPendingSize = 0;
+
+return iRC;
+}
+
+//
+// Get unix file number
+//
+INT_32 FDOutputCollector::GetFileNo() const { return iFHandle; }
+
+//
+// A destructor
+//
+FDOutputCollector::~FDOutputCollector() throw()
+{
+	Flush();
+
+	delete [] szBuffer;
+	delete [] aIOVecs;
+}
+
+} // namespace CTPP
+// End.
@@ -0,0 +1,421 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2FragmentCache.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2FragmentCache.hpp"
+
+#include "STLMap.hpp"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+// Approximate memory overhead of stored fragment
+#define C_FRAGMENT_ENTRY_OVERHEAD 96
+
+//
+// A destructor
+//
+FragmentCache::~FragmentCache() throw()
+{
+	;;
+}
+
+// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class LRUFragmentCache
+//
+
+//
+// Shard of cache
+//
+struct LRUFragmentCache::Shard
+{
+	struct Entry;
+	typedef STLW::map<STLW::string, Entry *> EntryMap;
+
+	/**
+	  @struct Entry
+	  @brief Stored fragment, element of LRU list
+	*/
+	struct Entry
+	{
+		/** Position in map           */
+		EntryMap::iterator    position;
+		/** Fragment output           */
+		STLW::string          data;
+		/** Expiration time, 0 - none */
+		time_t                expires;
+		/** Previous (more recent)    */
+		Entry               * prev;
+		/** Next (less recent)        */
+		Entry               * next;
+	};
+
+	/** Fragments                 */
+	EntryMap                entries;
+	/** Most recently used        */
+	Entry                 * head;
+	/** Least recently used       */
+	Entry                 * tail;
+	/** Size of data              */
+	UINT_64                 size;
+	/** Successful lookups        */
+	UINT_64                 hits;
+	/** Failed lookups            */
+	UINT_64                 misses;
+#ifdef HAVE_PTHREAD_H
+	/** Shard lock                */
+	pthread_mutex_t         mutex;
+#endif
+
+	/**
+	  @brief Constructor
+	*/
+	Shard();
+
+	/**
+	  @brief Unlink entry from LRU list
+	*/
+	void Unlink(Entry * pEntry);
+
+	/**
+	  @brief Insert entry at head of LRU list
+	*/
+	void LinkHead(Entry * pEntry);
+
+	/**
+	  @brief Remove entry
+	*/
+	void Remove(Entry * pEntry);
+
+	/**
+	  @brief A destructor
+	*/
+	~Shard() throw();
+};
+
+//
+// Lock of shard
+//
+class FragmentShardLocker
+{
+public:
+#ifdef HAVE_PTHREAD_H
+	FragmentShardLocker(pthread_mutex_t & oIMutex): oMutex(oIMutex) { pthread_mutex_lock(&oMutex); }
+
+	~FragmentShardLocker() throw() { pthread_mutex_unlock(&oMutex); }
+private:
+	/** Locked mutex */
+	pthread_mutex_t  & oMutex;
+#else
+	FragmentShardLocker(INT_32) { ;; }
+#endif
+};
+
+#ifdef HAVE_PTHREAD_H
+    #define FRAGMENT_SHARD_LOCK(x) FragmentShardLocker oLocker((x).mutex)
+#else
+    #define FRAGMENT_SHARD_LOCK(x) FragmentShardLocker oLocker(0)
+#endif
+
+//
+// Constructor
+//
+LRUFragmentCache::Shard::Shard(): head(NULL),
+                                  tail(NULL),
+                                  size(0),
+                                  hits(0),
+                                  misses(0)
+{
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_init(&mutex, NULL);
+#endif
+}
+
+//
+// Unlink entry from LRU list
+//
+void LRUFragmentCache::Shard::Unlink(Entry * pEntry)
+{
+	if (pEntry -> prev != NULL) { pEntry -> prev -> next = pEntry -> next; }
+	else                        { head = pEntry -> next;                   }
+
+	if (pEntry -> next != NULL) { pEntry -> next -> prev = pEntry -> prev; }
+	else                        { tail = pEntry -> prev;                   }
+}
+
+//
+// Insert entry at head of LRU list
+//
+void LRUFragmentCache::Shard::LinkHead(Entry * pEntry)
+{
+	pEntry -> prev = NULL;
+	pEntry -> next = head;
+
+	if (head != NULL) { head -> prev = pEntry; }
+	else              { tail = pEntry;         }
+
+	head = pEntry;
+}
+
+//
+// Remove entry
+//
+void LRUFragmentCache::Shard::Remove(Entry * pEntry)
+{
+	Unlink(pEntry);
+	size -= pEntry -> position -> first.size() + pEntry -> data.size() + C_FRAGMENT_ENTRY_OVERHEAD;
+	entries.erase(pEntry -> position);
+	delete pEntry;
+}
+
+//
+// A destructor
+//
+LRUFragmentCache::Shard::~Shard() throw()
+{
+	while (head != NULL) { Remove(head); }
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_destroy(&mutex);
+#endif
+}
+
+//
+// Constructor
+//
+LRUFragmentCache::LRUFragmentCache(const UINT_32  iIMaxSize,
+                                   const UINT_32  iIShardsNum): aShards(NULL),
+                                                                iShardsNum(iIShardsNum)
+{
+	if (iShardsNum == 0) { iShardsNum = 1; }
+
+	aShards       = new Shard[iShardsNum];
+	iShardMaxSize = iIMaxSize / iShardsNum;
+}
+
+//
+// Get shard by key
+//
+LRUFragmentCache::Shard & LRUFragmentCache::GetShard(const STLW::string & sKey) const
+{
+	// FNV-1a
+	UINT_32 iHash = 2166136261U;
+	STLW::string::const_iterator itsKey = sKey.begin();
+	while (itsKey != sKey.end())
+	{
+		iHash = (iHash ^ UCHAR_8(*itsKey)) * 16777619U;
+		++itsKey;
+	}
+
+return aShards[iHash % iShardsNum];
+}
+
+//
+// Get fragment output
+//
+bool LRUFragmentCache::Get(const STLW::string  & sKey,
+                           STLW::string        & sData)
+{
+	Shard & oShard = GetShard(sKey);
+	FRAGMENT_SHARD_LOCK(oShard);
+
+	Shard::EntryMap::iterator itmEntries = oShard.entries.find(sKey);
+	if (itmEntries == oShard.entries.end())
+	{
+		++oShard.misses;
+		return false;
+	}
+
+	Shard::Entry * pEntry = itmEntries -> second;
+	if (pEntry -> expires != 0 && pEntry -> expires <= time(NULL))
+	{
+		oShard.Remove(pEntry);
+		++oShard.misses;
+		return false;
+	}
+
+	// Most recently used
+	if (pEntry != oShard.head)
+	{
+		oShard.Unlink(pEntry);
+		oShard.LinkHead(pEntry);
+	}
+
+	++oShard.hits;
+	sData.assign(pEntry -> data);
+
+return true;
+}
+
+//
+// Store fragment output
+//
+void LRUFragmentCache::Put(const STLW::string  & sKey,
+                           const STLW::string  & sData,
+                           const UINT_32         iTTL)
+{
+	const UINT_64 iEntrySize = sKey.size() + sData.size() + C_FRAGMENT_ENTRY_OVERHEAD;
+	const time_t  iExpires   = (iTTL == 0) ? 0 : time(NULL) + iTTL;
+
+	Shard & oShard = GetShard(sKey);
+	FRAGMENT_SHARD_LOCK(oShard);
+
+	Shard::EntryMap::iterator itmEntries = oShard.entries.find(sKey);
+	// Too large to store; previous output of fragment is outdated
+	if (iEntrySize > iShardMaxSize)
+	{
+		if (itmEntries != oShard.entries.end()) { oShard.Remove(itmEntries -> second); }
+		return;
+	}
+
+	if (itmEntries != oShard.entries.end())
+	{
+		Shard::Entry * pEntry = itmEntries -> second;
+
+		oShard.size += sData.size();
+		oShard.size -= pEntry -> data.size();
+		pEntry -> data.assign(sData);
+		pEntry -> expires = iExpires;
+
+		oShard.Unlink(pEntry);
+		oShard.LinkHead(pEntry);
+	}
+	else
+	{
+		Shard::Entry * pEntry = new Shard::Entry;
+		pEntry -> position = oShard.entries.insert(Shard::EntryMap::value_type(sKey, pEntry)).first;
+		pEntry -> data.assign(sData);
+		pEntry -> expires = iExpires;
+
+		oShard.size += iEntrySize;
+		oShard.LinkHead(pEntry);
+	}
+
+	// Evict least recently used fragments
+	while (oShard.size > iShardMaxSize) { oShard.Remove(oShard.tail); }
+}
+
+//
+// Remove all fragments
+//
+void LRUFragmentCache::Clear()
+{
+	for (UINT_32 iPos = 0; iPos < iShardsNum; ++iPos)
+	{
+		Shard & oShard = aShards[iPos];
+		FRAGMENT_SHARD_LOCK(oShard);
+
+		while (oShard.head != NULL) { oShard.Remove(oShard.head); }
+	}
+}
+
+//
+// Get number of successful lookups
+//
+UINT_64 LRUFragmentCache::GetHits() const
+{
+	UINT_64 iHits = 0;
+	for (UINT_32 iPos = 0; iPos < iShardsNum; ++iPos)
+	{
+		Shard & oShard = aShards[iPos];
+		FRAGMENT_SHARD_LOCK(oShard);
+
+		iHits += oShard.hits;
+	}
+return iHits;
+}
+
+//
+// Get number of failed lookups
+//
+UINT_64 LRUFragmentCache::GetMisses() const
+{
+	UINT_64 iMisses = 0;
+	for (UINT_32 iPos = 0; iPos < iShardsNum; ++iPos)
+	{
+		Shard & oShard = aShards[iPos];
+		FRAGMENT_SHARD_LOCK(oShard);
+
+		iMisses += oShard.misses;
+	}
+return iMisses;
+}
+
+//
+// Get number of stored fragments
+//
+UINT_32 LRUFragmentCache::GetEntriesNum() const
+{
+	UINT_32 iEntries = 0;
+	for (UINT_32 iPos = 0; iPos < iShardsNum; ++iPos)
+	{
+		Shard & oShard = aShards[iPos];
+		FRAGMENT_SHARD_LOCK(oShard);
+
+		iEntries += oShard.entries.size();
+	}
+return iEntries;
+}
+
+//
+// Get size of stored data
+//
+UINT_64 LRUFragmentCache::GetSize() const
+{
+	UINT_64 iSize = 0;
+	for (UINT_32 iPos = 0; iPos < iShardsNum; ++iPos)
+	{
+		Shard & oShard = aShards[iPos];
+		FRAGMENT_SHARD_LOCK(oShard);
+
+		iSize += oShard.size;
+	}
+return iSize;
+}
+
+//
+// A destructor
+//
+LRUFragmentCache::~LRUFragmentCache() throw()
+{
+	delete [] aShards;
+}
+
+} // namespace CTPP
+// End.
@@ -38,7 +38,6 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
-#include <stdio.h>
 #include <ctype.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -139,67 +138,6 @@ int Reporter::iLevel = 0;
 #endif // Reporter class
 
 
-/**
-  @class ScopeGuard
-  @brief Deallocate memory of pointer when go out from scope
-  @tparam type of pointer
-*/
-template<typename T>
-class ScopeGuard
-{
-	/** Type of function, that deallocate memory */
-	typedef void (*DeleteFuncType)(T *);
-
-public:
-	/**
-	  @brief Constructor
-	  @param p - pointer
-	  @param func - function for deleting pointer
-	*/
-    ScopeGuard(T *p, DeleteFuncType func = DefaultDeleteFunc) :
-        pData(p), deleteFunc(func) { ;; }
-
-	/**
-	  @brief Destructor
-	*/
-    ~ScopeGuard() throw() { if (pData) { deleteFunc(pData); } }
-
-	/**
-	  @brief Get pointer
-	  @return pointer
-    */
-    T * Get() const { return pData; }
-
-	/**
-	  @brief Release pointer
-	  @return pointer
-	*/
-    T * Release()
-	{
-        T * pTemp = pData;
-        pData = NULL;
-        return pTemp;
-    }
-
-private:
-	// Does not exist
-    ScopeGuard(const ScopeGuard &);
-    ScopeGuard & operator=(const ScopeGuard &);
-
-	/** Default function for deleting pointer */
-    static void DefaultDeleteFunc(T * p) { delete p; }
-
-	/** Pointer                               */
-	T * pData;
-	/** Function for deleting pointer         */
-	DeleteFuncType deleteFunc;
-};
-
-//
-// Deletes array
-//
-static void DeleteArrFunc(UCHAR_P pData) { delete[] pData; }
-
 //
 // Split string into vector of substrings by separator
 //
@@ -233,152 +171,232 @@ static void Trim(STLW::string & s)
 }
 
 //
-// A constructor
+// Hash of message; (UINT_32)-1 is reserved for empty slots
 //
-CTPP2GetText::CTPP2GetText() { sDefaultDomain.assign("default"); }
+static UINT_32 MessageHash(CCHAR_P szData, const UINT_32 iLength)
+{
+	UINT_32 iHash = 5381;
+	UCCHAR_P sEnd = (UCCHAR_P)szData + iLength;
+
+	while ((UCCHAR_P)szData != sEnd)
+	{
+		iHash += (iHash << 5);
+		iHash ^= (UINT_32) *(UCCHAR_P)szData++;
+	}
+
+	if (iHash == (UINT_32)-1) { --iHash; }
+return iHash;
+}
 
 //
-// A destructor
+// Read .mo data by 4 bytes
 //
-CTPP2GetText::~CTPP2GetText() throw() { ;; }
+static UINT_32 ReadMOData(const STLW::string & sData, UINT_32 iOffset, bool bReversed)
+{
+	UINT_32 iValue = 0;
+	memcpy(&iValue, sData.data() + iOffset, sizeof(UINT_32));
+
+	if (bReversed)
+	{
+		UINT_32 i0 = (iValue >>  0) & 0xFF;
+		UINT_32 i1 = (iValue >>  8) & 0xFF;
+		UINT_32 i2 = (iValue >> 16) & 0xFF;
+		UINT_32 i3 = (iValue >> 24) & 0xFF;
+
+		return (i0 << 24) | (i1 << 16) | (i2 << 8) | i3;
+	}
+
+return iValue;
+}
 
 //
-// Add translation
+// Read .mo file
 //
-void CTPP2GetText::AddTranslation(const STLW::string & sFileName, const STLW::string & sDomain, const STLW::string & sLang)
+static void ReadFile(CCHAR_P szFileName, STLW::string & sData)
 {
-	UINT_32 iLength = 0;
-
-    ScopeGuard<UCHAR_8> pData(ReadFile(sFileName.c_str(), iLength), DeleteArrFunc);
+	FILE * pFile = ::fopen(szFileName, "rb");
+	if (!pFile)
+	{
+		STLW::string sMsg = STLW::string(szFileName) + ": " + strerror(errno);
+		throw CTPPGetTextError(sMsg.c_str());
+	}
 
-	sWorkableDomain = sDomain;
-	sWorkableLang = sLang;
+	struct stat st;
+	if (::fstat(fileno(pFile), &st) == -1)
+	{
+		STLW::string sMsg = STLW::string(szFileName) + ": fstat failed";
+		::fclose(pFile);
+		throw CTPPGetTextError(sMsg.c_str());
+	}
 
-	CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
+	sData.resize(st.st_size);
+	if (st.st_size != 0 && ::fread(&sData[0], st.st_size, 1, pFile) < 1)
+	{
+		STLW::string sMsg = STLW::string(szFileName) + ": fread failed";
+		::fclose(pFile);
+		throw CTPPGetTextError(sMsg.c_str());
+	}
 
-    UINT_32 iMagic = (reinterpret_cast<UINT_32 *>(pData.Get()))[0];
+	::fclose(pFile);
+}
 
-    switch (iMagic)
+//
+// Get N-th '\0'-separated form of translation
+//
+static STLW::string GetForm(CCHAR_P szForms, UINT_32 iLength, UINT_32 iN, bool & bFound)
+{
+	CCHAR_P szEnd = szForms + iLength;
+	for (;;)
 	{
-	case LE_MAGIC:
-		oCatalog.b_reversed = false;
-		break;
-	case BE_MAGIC:
-		oCatalog.b_reversed = true;
-		break;
-	default:
+		CCHAR_P szSep = (CCHAR_P)memchr(szForms, '\0', szEnd - szForms);
+		if (szSep == NULL) { szSep = szEnd; }
+
+		if (iN == 0)
 		{
-			STLW::string sMsg = sFileName + ": invalid MO file";
-			throw CTPPGetTextError(sMsg.c_str());
+			bFound = true;
+			return STLW::string(szForms, szSep - szForms);
 		}
-		break;
+
+		if (szSep == szEnd) { break; }
+		szForms = szSep + 1;
+		--iN;
 	}
 
-    UINT_32 iMsgCount = ReadMOData(pData.Get(), 8);
-    UINT_32 iMasteridx = ReadMOData(pData.Get(), 12);
-    UINT_32 iTransidx = ReadMOData(pData.Get(), 16);
+	bFound = false;
+return "";
+}
 
-    for (UINT_32 iI = 0; iI < iMsgCount; ++iI)
-	{
-        ExtractMessage(pData.Get(), iLength, iMasteridx, iTransidx);
-		iMasteridx += 2 * sizeof(UINT_32);
-		iTransidx += 2 * sizeof(UINT_32);
-    }
+//
+// A constructor
+//
+CTPP2GetText::CTPP2GetText(): iWorkableDepth(0) { sDefaultDomain.assign("default"); }
+
+//
+// A destructor
+//
+CTPP2GetText::~CTPP2GetText() throw() { ;; }
 
+//
+// Add translation
+//
+void CTPP2GetText::AddTranslation(const STLW::string & sFileName, const STLW::string & sDomain, const STLW::string & sLang)
+{
+	STLW::map<STLW::string, CTPP2Catalog> & mDomains = mCatalog[sLang];
+
+	CTPP2Catalog & oCatalog = mDomains[sDomain];
+	oCatalog = CTPP2Catalog();
+
+	sWorkableDomain = sDomain;
+	try
+	{
+		LoadCatalog(sFileName, oCatalog);
+	}
+	catch(...)
+	{
+		sWorkableDomain.erase();
+		mDomains.erase(sDomain);
+		throw;
+	}
 	sWorkableDomain.erase();
-	sWorkableLang.erase();
 
 #if _GETTEXT_PLURAL_DEBUG
-	CatalogMap::const_iterator itmC = mCatalog.begin();
-	for (; itmC != mCatalog.end(); ++itmC)
+	fprintf(stdout, "Catalog %s/%s: %u slots, charset %s\n", sLang.c_str(), sDomain.c_str(),
+	                UINT_32(oCatalog.v_messages.size()), oCatalog.s_charset.c_str());
+	for (UINT_32 iI = 0; iI < oCatalog.v_plural.size(); ++iI)
 	{
-		fprintf(stdout, "============================================\n");
-		fprintf(stdout, "Language %s\n", itmC -> first.c_str());
-		fprintf(stdout, "============================================\n");
-		STLW::map<STLW::string, CTPP2Catalog>::const_iterator itm = itmC -> second;
-		for (; itm != itmC -> end(); ++itm)
-		{
-			fprintf(stdout, "CTPP2Catalog %s\n", itm -> first.c_str());
-			fprintf(stdout, "--------------------------------------------\n");
-			fprintf(stdout, "Charset: %s\n", itm -> second.s_charset.c_str());
-			fprintf(stdout, "Info:\n");
-			{
-				STLW::map<STLW::string, STLW::string>::const_iterator mit = itm -> second.m_info.begin();
-				for (; mit != itm -> second.m_info.end(); ++mit) {
-					fprintf(stdout, "\t%s: %s\n", mit -> first.c_str(), mit -> second.c_str());
-				}
-			}
-			fprintf(stdout, "Reversed: %d\n", itm -> second.b_reversed);
-			fprintf(stdout, "Messages:\n");
-			{
-				STLW::map<STLW::string, STLW::vector<STLW::string> >::const_iterator itmM = itm -> second.m_messages.begin();
-				++itmM;
-				for (; itmM != itm -> second.m_messages.end(); ++itmM) {
-					fprintf(stdout, "\t'%s':\n", itmM -> first.c_str());
-					STLW::vector<STLW::string>::const_iterator vit = itmM -> second.begin();
-					for (; itv != itmM -> second.end(); ++itv) {
-						fprintf(stdout, "\t\t'%s' ", itv -> c_str());
-					}
-					fprintf(stdout, "\n");
-				}
-			}
-			fprintf(stdout, "--------------------------------------------\n");
-		}
-		fprintf(stdout, "============================================\n");
+		fprintf(stdout, "%04u %-6s %u\n", iI, StringifyInstruction(oCatalog.v_plural[iI].instruction), oCatalog.v_plural[iI].argument);
 	}
 #endif
 }
 
 //
-// Find translated message
+// Find catalog
+//
+const CTPP2GetText::CTPP2Catalog * CTPP2GetText::FindCatalog(const STLW::string & sLang, const STLW::string & sDomain) const
+{
+	CatalogMap::const_iterator itmLang = mCatalog.find(sLang);
+	if (itmLang == mCatalog.end()) { return NULL; }
+
+	const STLW::string & sRealDomain = sDomain.empty() ? sDefaultDomain : sDomain;
+	STLW::map<STLW::string, CTPP2Catalog>::const_iterator itmDomain = itmLang -> second.find(sRealDomain);
+	if (itmDomain == itmLang -> second.end()) { return NULL; }
+
+return &(itmDomain -> second);
+}
+
 //
-STLW::string CTPP2GetText::FindMessage(const STLW::string & sLang, const STLW::string & sMessage, const STLW::string & sDomain_)
+// Find message in catalog index
+//
+const CTPP2GetText::CTPP2Message * CTPP2GetText::FindEntry(const CTPP2Catalog & oCatalog, const STLW::string & sMessage)
 {
-	STLW::string sDomain = sDomain_;
-	if (sDomain.empty()) { sDomain = sDefaultDomain; }
+	if (oCatalog.v_messages.empty()) { return NULL; }
 
-	if (mCatalog.find(sLang) == mCatalog.end() || mCatalog[sLang].find(sDomain) == mCatalog[sLang].end()) { return sMessage; }
+	const UINT_32 iHash = MessageHash(sMessage.data(), sMessage.size());
+	const UINT_32 iMask = oCatalog.v_messages.size() - 1;
+	CCHAR_P       szData = oCatalog.s_data.data();
 
-	typedef STLW::map<STLW::string, STLW::vector<STLW::string> > MessageMap;
-	MessageMap & oMessages = mCatalog[sLang][sDomain].m_messages;
-	MessageMap::const_iterator itM = oMessages.find(sMessage);
+	// Index is never full, so an empty slot always terminates probing
+	for (UINT_32 iPos = iHash & iMask; ; iPos = (iPos + 1) & iMask)
+	{
+		const CTPP2Message & oMessage = oCatalog.v_messages[iPos];
+		if (oMessage.hash == (UINT_32)-1) { return NULL; }
 
-	if (itM == oMessages.end()) { return sMessage; }
+		if (oMessage.hash == iHash && oMessage.key_length == sMessage.size() &&
+		    memcmp(szData + oMessage.key_offset, sMessage.data(), sMessage.size()) == 0) { return &oMessage; }
+	}
 
-    return itM -> second[0];
+// Make compiler happy
+return NULL;
+}
+
+//
+// Find translated message
+//
+STLW::string CTPP2GetText::FindMessage(const STLW::string & sLang, const STLW::string & sMessage, const STLW::string & sDomain) const
+{
+	const CTPP2Catalog * pCatalog = FindCatalog(sLang, sDomain);
+	if (pCatalog == NULL) { return sMessage; }
+
+	const CTPP2Message * pMessage = FindEntry(*pCatalog, sMessage);
+	if (pMessage == NULL) { return sMessage; }
+
+	bool bFound = false;
+return GetForm(pCatalog -> s_data.data() + pMessage -> value_offset, pMessage -> value_length, 0, bFound);
 }
 
 //
 // Find translated message with correct plural form
 //
 STLW::string CTPP2GetText::FindPluralMessage(const STLW::string & sLang, const STLW::string & sMessage,
-                                            const STLW::string & sPlMessage, UINT_32 iCount, const STLW::string & sDomain_)
+                                            const STLW::string & sPlMessage, UINT_32 iCount, const STLW::string & sDomain) const
 {
-	STLW::string sDomain = sDomain_;
-	if (sDomain.empty()) { sDomain = sDefaultDomain; }
+	const CTPP2Catalog * pCatalog = FindCatalog(sLang, sDomain);
+	const CTPP2Message * pMessage = NULL;
+	if (pCatalog != NULL) { pMessage = FindEntry(*pCatalog, sMessage); }
 
-	if (mCatalog.find(sLang) == mCatalog.end() ||
-	    mCatalog[sLang].find(sDomain) == mCatalog[sLang].end() ||
-	    mCatalog[sLang][sDomain].m_messages.find(sMessage) == mCatalog[sLang][sDomain].m_messages.end())
+	if (pMessage == NULL)
 	{
 		if (iCount > 1) { return sPlMessage; }
 		else            { return sMessage;   }
 	}
 
-    UINT_32 iN = CalculatePluralForm(iCount, sLang, sDomain);
-
-	typedef STLW::map<STLW::string, STLW::vector<STLW::string> > MessageMap;
-	MessageMap & oMessages = mCatalog[sLang][sDomain].m_messages;
-	MessageMap::const_iterator itM = oMessages.find(sMessage);
+	const UINT_32 iN = CalculatePluralForm(iCount, *pCatalog);
 
-	if (iN >= itM -> second.size())
+	bool bFound = false;
+	STLW::string sResult = GetForm(pCatalog -> s_data.data() + pMessage -> value_offset, pMessage -> value_length, iN, bFound);
+	if (!bFound)
 	{
-		STLW::string sMsg = STLW::string("i18n domain '") + sDomain + "': failed to found plural form: " + sMessage;
+		STLW::string sMsg = STLW::string("i18n domain '") + (sDomain.empty() ? sDefaultDomain : sDomain) + "': failed to found plural form: " + sMessage;
 		throw CTPPGetTextError(sMsg.c_str());
 	}
-    return itM -> second[iN];
+return sResult;
 }
 
+//
+// Check that catalog is loaded
+//
+bool CTPP2GetText::HasTranslation(const STLW::string & sLang, const STLW::string & sDomain) const { return FindCatalog(sLang, sDomain) != NULL; }
+
 //
 // Set default i18n domain
 //
@@ -408,10 +426,69 @@ void CTPP2GetText::SetLanguage(SyscallFactory & oSyscallFactory, const STLW::str
 
 // Parsing of .mo file ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+//
+// Load .mo file into catalog
+//
+void CTPP2GetText::LoadCatalog(const STLW::string & sFileName, CTPP2Catalog & oCatalog)
+{
+	ReadFile(sFileName.c_str(), oCatalog.s_data);
+
+	const UINT_32 iLength = oCatalog.s_data.size();
+	if (iLength < 5 * sizeof(UINT_32))
+	{
+		STLW::string sMsg = sFileName + ": invalid MO file";
+		throw CTPPGetTextError(sMsg.c_str());
+	}
+
+	UINT_32 iMagic = ReadMOData(oCatalog.s_data, 0, false);
+	switch (iMagic)
+	{
+	case LE_MAGIC:
+		oCatalog.b_reversed = false;
+		break;
+	case BE_MAGIC:
+		oCatalog.b_reversed = true;
+		break;
+	default:
+		{
+			STLW::string sMsg = sFileName + ": invalid MO file";
+			throw CTPPGetTextError(sMsg.c_str());
+		}
+		break;
+	}
+
+	UINT_32 iMsgCount  = ReadMOData(oCatalog.s_data,  8, oCatalog.b_reversed);
+	UINT_32 iMasteridx = ReadMOData(oCatalog.s_data, 12, oCatalog.b_reversed);
+	UINT_32 iTransidx  = ReadMOData(oCatalog.s_data, 16, oCatalog.b_reversed);
+
+	const UINT_32 iTableSize = 2 * sizeof(UINT_32);
+	if (iMsgCount > iLength / iTableSize ||
+	    iMasteridx > iLength - iMsgCount * iTableSize ||
+	    iTransidx  > iLength - iMsgCount * iTableSize)
+	{
+		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': corrupted MO file";
+		throw CTPPGetTextError(sMsg.c_str());
+	}
+
+	// Index load factor is kept at or below 1/2
+	UINT_32 iSlots = 2;
+	while (iSlots < 2 * iMsgCount) { iSlots <<= 1; }
+
+	CTPP2Message oEmpty = { (UINT_32)-1, 0, 0, 0, 0 };
+	oCatalog.v_messages.assign(iSlots, oEmpty);
+
+	for (UINT_32 iI = 0; iI < iMsgCount; ++iI)
+	{
+		ExtractMessage(oCatalog, iMasteridx, iTransidx);
+		iMasteridx += iTableSize;
+		iTransidx  += iTableSize;
+	}
+}
+
 //
 // Parse line of metadata from .mo file
 //
-void CTPP2GetText::ParseMetadataLine(const STLW::string & sLine, STLW::string & sLastKey)
+void CTPP2GetText::ParseMetadataLine(const STLW::string & sLine, STLW::string & sLastKey, CTPP2Catalog & oCatalog)
 {
 	STLW::string::size_type iLineDelimPos = sLine.find(":");
 	STLW::string sKey;
@@ -423,12 +500,12 @@ void CTPP2GetText::ParseMetadataLine(const STLW::string & sLine, STLW::string &
 		STLW::transform(sKey.begin(), sKey.end(), sKey.begin(), ::tolower);
 		sValue = sLine.substr(iLineDelimPos + 1);
 		Trim(sValue);
-		mCatalog[sWorkableLang][sWorkableDomain].m_info[sKey] = sValue;
+		oCatalog.m_info[sKey] = sValue;
 		sLastKey = sKey;
 	}
 	else if (!sLastKey.empty())
 	{
-		mCatalog[sWorkableLang][sWorkableDomain].m_info[sLastKey] += "\n" + sLine;
+		oCatalog.m_info[sLastKey] += "\n" + sLine;
 	}
 
 	if (sKey == "content-type")
@@ -436,22 +513,24 @@ void CTPP2GetText::ParseMetadataLine(const STLW::string & sLine, STLW::string &
 		STLW::string::size_type iCharsetPos = sValue.find("charset=");
 		if (iCharsetPos != STLW::string::npos)
 		{
-			mCatalog[sWorkableLang][sWorkableDomain].s_charset = sValue.substr(iCharsetPos + 8);
+			oCatalog.s_charset = sValue.substr(iCharsetPos + 8);
 		}
 	}
 	else if (sKey == "plural-forms")
 	{
-		STLW::vector<STLW::string> vPlurals;
-		Split(sValue, ';', vPlurals);
-		STLW::string sPluralRule = vPlurals[1].substr(vPlurals[1].find("plural=") + 7);
-		GeneratePluralRule(sPluralRule);
+		STLW::string::size_type iRulePos = sValue.find("plural=");
+		if (iRulePos != STLW::string::npos)
+		{
+			iRulePos += 7;
+			GeneratePluralRule(sValue.substr(iRulePos, sValue.find(';', iRulePos) - iRulePos), oCatalog);
+		}
 	}
 }
 
 //
 // Parse metadata from .mo file
 //
-void CTPP2GetText::ParseMetadata(const STLW::string & sMeta)
+void CTPP2GetText::ParseMetadata(const STLW::string & sMeta, CTPP2Catalog & oCatalog)
 {
 	STLW::string sLastKey;
 
@@ -461,509 +540,255 @@ void CTPP2GetText::ParseMetadata(const STLW::string & sMeta)
 	for (; itvMetaLine != vMetaLines.end(); ++itvMetaLine)
 	{
 		Trim(*itvMetaLine);
-		if (!itvMetaLine -> empty()) { ParseMetadataLine(*itvMetaLine, sLastKey); }
+		if (!itvMetaLine -> empty()) { ParseMetadataLine(*itvMetaLine, sLastKey, oCatalog); }
 	}
 }
 
 //
-// Read .mo data by 4 bytes
+// Add message to catalog index
 //
-UINT_32 CTPP2GetText::ReadMOData(UCCHAR_P pData, INT_32 iOffset)
+void CTPP2GetText::ExtractMessage(CTPP2Catalog & oCatalog, UINT_32 iMasteridx, UINT_32 iTransidx)
 {
-	const UINT_32 *p = reinterpret_cast<const UINT_32 *>(pData + iOffset);
+	const STLW::string & sData = oCatalog.s_data;
+	const UINT_32 iLength = sData.size();
 
-	if (mCatalog[sWorkableLang][sWorkableDomain].b_reversed)
+	UINT_32 iMsgLen      = ReadMOData(sData, iMasteridx, oCatalog.b_reversed);
+	UINT_32 iMsgOffset   = ReadMOData(sData, iMasteridx + sizeof(UINT_32), oCatalog.b_reversed);
+	UINT_32 iTransLen    = ReadMOData(sData, iTransidx, oCatalog.b_reversed);
+	UINT_32 iTransOffset = ReadMOData(sData, iTransidx + sizeof(UINT_32), oCatalog.b_reversed);
+	if (iMsgOffset >= iLength || iMsgLen >= iLength - iMsgOffset || iTransOffset >= iLength || iTransLen >= iLength - iTransOffset)
 	{
-		UINT_32 i0 = (*p >>  0) & 0xFF;
-		UINT_32 i1 = (*p >>  8) & 0xFF;
-		UINT_32 i2 = (*p >> 16) & 0xFF;
-		UINT_32 i3 = (*p >> 24) & 0xFF;
-
-		return (i0 << 24) | (i1 << 16) | (i2 << 8) | i3;
-	}
-
-	return *p;
-}
-
-//
-// Read .mo file
-//
-UCHAR_P CTPP2GetText::ReadFile(CCHAR_P szFileName, UINT_32 &iLength)
-{
-    FILE * pFile = ::fopen(szFileName, "rb");
-    if (!pFile)
-	{
-		STLW::string sMsg = STLW::string(szFileName) + ": " + strerror(errno);
+		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': corrupted MO file";
 		throw CTPPGetTextError(sMsg.c_str());
 	}
 
-    struct stat st;
-    if (::fstat(fileno(pFile), &st) == -1)
-	{
-		STLW::string sMsg = STLW::string(szFileName) + ": fstat failed";
-		::fclose(pFile);
-        throw CTPPGetTextError(sMsg.c_str());
-    }
-
-    ScopeGuard<UCHAR_8> pData(new UCHAR_8[st.st_size], DeleteArrFunc);
+	// Header is also kept as translation of empty message, as in GNU gettext
+	if (iMsgLen == 0) { ParseMetadata(STLW::string(sData.data() + iTransOffset, iTransLen), oCatalog); }
 
-    ::fseek(pFile, 0, SEEK_SET);
+	// Plural messages are keyed by singular form
+	CCHAR_P szMessage = sData.data() + iMsgOffset;
+	CCHAR_P szSep     = (CCHAR_P)memchr(szMessage, '\0', iMsgLen);
+	if (szSep != NULL) { iMsgLen = szSep - szMessage; }
 
-    if (::fread(reinterpret_cast<void *>(pData.Get()), st.st_size, 1, pFile) < 1)
+	const UINT_32 iHash = MessageHash(szMessage, iMsgLen);
+	const UINT_32 iMask = oCatalog.v_messages.size() - 1;
+	for (UINT_32 iPos = iHash & iMask; ; iPos = (iPos + 1) & iMask)
 	{
-		STLW::string sMsg = STLW::string(szFileName) + ": fread failed";
-		::fclose(pFile);
-        throw CTPPGetTextError(sMsg.c_str());
-    }
-
-	iLength = st.st_size;
-	::fclose(pFile);
-    return pData.Release();
+		CTPP2Message & oMessage = oCatalog.v_messages[iPos];
+		if (oMessage.hash == (UINT_32)-1 ||
+		   (oMessage.hash == iHash && oMessage.key_length == iMsgLen &&
+		    memcmp(sData.data() + oMessage.key_offset, szMessage, iMsgLen) == 0))
+		{
+			oMessage.hash         = iHash;
+			oMessage.key_offset   = iMsgOffset;
+			oMessage.key_length   = iMsgLen;
+			oMessage.value_offset = iTransOffset;
+			oMessage.value_length = iTransLen;
+			break;
+		}
+	}
 }
 
+// Expressions for generating plural form rule ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 //
-// Extract message from .mo data
+// Append instruction to compiled rule
 //
-void CTPP2GetText::ExtractMessage(UCCHAR_P pData, UINT_32 iLength, INT_32 iMasteridx, INT_32 iTransidx)
+UINT_32 CTPP2GetText::EmitInstruction(STLW::vector<CTPP2Instruction> & vCode, eCTPP2Instruction eInstruction, UINT_32 iArgument, INT_32 iStackDelta)
 {
-    UINT_32 iMsgLen = ReadMOData(pData, iMasteridx);
-    UINT_32 iMsgOffset = ReadMOData(pData, iMasteridx + sizeof(UINT_32));
-    UINT_32 iTransLen = ReadMOData(pData, iTransidx);
-    UINT_32 iTransOffset = ReadMOData(pData, iTransidx + sizeof(UINT_32));
-    if (iMsgLen + iMsgOffset >= iLength || iTransLen + iTransOffset >= iLength)
-	{
-		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': corrupted MO file";
-        throw CTPPGetTextError(sMsg.c_str());
-    }
-
-    STLW::string sMessage(reinterpret_cast<CCHAR_P>(pData + iMsgOffset), iMsgLen);
-    STLW::string sTMessage(reinterpret_cast<CCHAR_P>(pData + iTransOffset), iTransLen);
-
-    if (iMsgLen == 0) { ParseMetadata(sTMessage); }
-
-	CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-    STLW::string::size_type iPos = sMessage.find("\x00");
-    if (iPos != STLW::string::npos)
+	iWorkableDepth += iStackDelta;
+	if (iWorkableDepth > C_MAX_PLURAL_STACK)
 	{
-        STLW::vector<STLW::string> vMsgIds;
-        Split(sMessage, '\x00', vMsgIds);
+		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule is too complex";
+		throw CTPPGetTextError(sMsg.c_str());
+	}
 
-        STLW::vector<STLW::string> vTMsgIds;
-        Split(sTMessage, '\x00', vTMsgIds);
+	CTPP2Instruction oInstruction = { eInstruction, iArgument };
+	vCode.push_back(oInstruction);
 
-		oCatalog.m_messages[vMsgIds[0]] = vTMsgIds;
-    }
-	else
-	{
-        STLW::vector<STLW::string> vTMsgIds;
-        vTMsgIds.push_back(sTMessage);
-		oCatalog.m_messages[sMessage] = vTMsgIds;
-    }
+return vCode.size() - 1;
 }
 
-// Expressions for generating plural form rule ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
 //
-// Term           = number | "n" | "(" TernaryExpr ")" | TernaryExpr
+// Term           = number | "n" | "(" TernaryExpr ")"
 //
-STLW::string::size_type CTPP2GetText::IsTerm(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsTerm(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsTerm", sData, iPos);
 
-	if (iPos == STLW::string::npos) { return iPos; }
-
-	CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-	if (::isdigit(sData[iPos]))
+	if (iPos < sData.size() && ::isdigit(sData[iPos]))
 	{
-		STLW::string::size_type iDigitPos = iPos;
-		while (::isdigit(sData[iPos])) { ++iPos; }
-		STLW::string sDigit = sData.substr(iDigitPos, iPos - iDigitPos);
-		INT_32 iDigit = atoi(sDigit.c_str());
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "PUSH: %d\n", iDigit);
-#endif
-		oCatalog.v_pl_stack.push_back(CTPP2Data(iDigit));
+		UINT_32 iDigit = 0;
+		while (iPos < sData.size() && ::isdigit(sData[iPos])) { iDigit = iDigit * 10 + (sData[iPos] - '0'); ++iPos; }
+		EmitInstruction(vCode, INS_PUSH, iDigit, 1);
 	}
-	else if (sData[iPos] == 'n')
+	else if (iPos < sData.size() && sData[iPos] == 'n')
 	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "PUSH: n\n");
-#endif
-		oCatalog.v_pl_stack.push_back(CTPP2Data());
+		EmitInstruction(vCode, INS_PUSH_N, 0, 1);
 		++iPos;
 	}
-	else if (sData[iPos] == '(')
+	else if (iPos < sData.size() && sData[iPos] == '(')
 	{
-		++iPos;
-		if (iPos >= sData.size())
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsTerm)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-
-		iPos = IsTernaryExpr(sData, iPos);
+		iPos = IsTernaryExpr(sData, iPos + 1, vCode);
 
-		if (sData[iPos] != ')')
+		if (iPos >= sData.size() || sData[iPos] != ')')
 		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (2 IsTerm)";
+			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsTerm)";
 			throw CTPPGetTextError(sMsg.c_str());
 		}
 		++iPos;
 	}
 	else
 	{
-		UINT_32 iNextPos = IsTernaryExpr(sData, iPos);
-
-		if (iNextPos == iPos)
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (3 IsTerm)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-		iPos = iNextPos;
+		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (2 IsTerm)";
+		throw CTPPGetTextError(sMsg.c_str());
 	}
 
-	return iPos;
+return iPos;
 }
 
 //
 // ModExpr        = Term { "%" Term }
 //
-STLW::string::size_type CTPP2GetText::IsModExpr(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsModExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsModExr", sData, iPos);
 
-	iPos = IsTerm(sData, iPos);
-	if (iPos == STLW::string::npos) { return iPos; }
-
-	if (sData[iPos] == '%')
+	iPos = IsTerm(sData, iPos, vCode);
+	while (iPos < sData.size() && sData[iPos] == '%')
 	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '%%'\n");
-#endif
-		CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-
-		oCatalog.v_pl_instructions.push_back(INS_MOD);
-
-		iPos = IsTerm(sData, iPos + 1);
-		if (iPos == STLW::string::npos)
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (2 IsModExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
+		iPos = IsTerm(sData, iPos + 1, vCode);
+		EmitInstruction(vCode, INS_MOD, 0, -1);
 	}
 
-	return iPos;
+return iPos;
 }
 
 //
 // LtOrGtExpr     = ModExpr { LtOrGtRelation ModExpr }
 //
-STLW::string::size_type CTPP2GetText::IsLtOrGtExpr(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsLtOrGtExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsLtOrGtExpr", sData, iPos);
 
-	iPos = IsModExpr(sData, iPos);
-	if (iPos == STLW::string::npos) { return iPos; }
+	iPos = IsModExpr(sData, iPos, vCode);
 
-	CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-
-	bool bHasRelation = true;
-	if (sData.find(">=", iPos) == iPos)
-	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '>='\n");
-#endif
-		oCatalog.v_pl_instructions.push_back(INS_GE);
-		iPos += 2;
-	}
-	else if (sData.find("<=", iPos) == iPos)
-	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '<='\n");
-#endif
-		oCatalog.v_pl_instructions.push_back(INS_LE);
-		iPos += 2;
-	}
-	else if (sData[iPos] == '<')
-	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '<'\n");
-#endif
-		oCatalog.v_pl_instructions.push_back(INS_LT);
-		++iPos;
-	}
-	else if (sData[iPos] == '>')
-	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '>'\n");
-#endif
-		oCatalog.v_pl_instructions.push_back(INS_GT);
-		++iPos;
-	}
-	else
+	for (;;)
 	{
-		bHasRelation = false;
-	}
+		eCTPP2Instruction eInstruction;
+		if      (sData.compare(iPos, 2, ">=") == 0) { eInstruction = INS_GE; iPos += 2; }
+		else if (sData.compare(iPos, 2, "<=") == 0) { eInstruction = INS_LE; iPos += 2; }
+		else if (sData.compare(iPos, 1, "<")  == 0) { eInstruction = INS_LT; ++iPos;    }
+		else if (sData.compare(iPos, 1, ">")  == 0) { eInstruction = INS_GT; ++iPos;    }
+		else { break; }
 
-	if (bHasRelation)
-	{
-		if (iPos >= sData.size())
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsLtOrGtExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-		iPos = IsModExpr(sData, iPos);
+		iPos = IsModExpr(sData, iPos, vCode);
+		EmitInstruction(vCode, eInstruction, 0, -1);
 	}
 
-	return iPos;
+return iPos;
 }
 
 //
 // EqExpr         = LtOrGtExpr { EqRelation LtOrGtExpr }
 //
-STLW::string::size_type CTPP2GetText::IsEqExpr(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsEqExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsEqExpr", sData, iPos);
 
-	iPos = IsLtOrGtExpr(sData, iPos);
-	if (iPos == STLW::string::npos) { return iPos; }
-
-	CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
+	iPos = IsLtOrGtExpr(sData, iPos, vCode);
 
-	bool bHasRelation = true;
-	if (sData.find("==", iPos) == iPos)
-	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '=='\n");
-#endif
-		oCatalog.v_pl_instructions.push_back(INS_EQ);
-		iPos += 2;
-	}
-	else if (sData.find("!=", iPos) == iPos)
+	for (;;)
 	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> OPERATOR '!='\n");
-#endif
-		oCatalog.v_pl_instructions.push_back(INS_NE);
-		iPos += 2;
-	}
-	else
-	{
-		bHasRelation = false;
-	}
+		eCTPP2Instruction eInstruction;
+		if      (sData.compare(iPos, 2, "==") == 0) { eInstruction = INS_EQ; }
+		else if (sData.compare(iPos, 2, "!=") == 0) { eInstruction = INS_NE; }
+		else { break; }
 
-	if (bHasRelation)
-	{
-		if (iPos >= sData.size())
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsEqExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-		iPos = IsLtOrGtExpr(sData, iPos);
+		iPos = IsLtOrGtExpr(sData, iPos + 2, vCode);
+		EmitInstruction(vCode, eInstruction, 0, -1);
 	}
 
-	return iPos;
+return iPos;
 }
 
 //
-// AndExpr        = EqExpr { "&&" AndExpr }
+// AndExpr        = EqExpr { "&&" EqExpr }
 //
-STLW::string::size_type CTPP2GetText::IsAndExpr(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsAndExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsAndExpr", sData, iPos);
 
-	iPos = IsEqExpr(sData, iPos);
-	if (iPos == STLW::string::npos) { return iPos; }
+	iPos = IsEqExpr(sData, iPos, vCode);
+	if (sData.compare(iPos, 2, "&&") != 0) { return iPos; }
 
-	if (sData.find("&&", iPos) == iPos)
+	// Every jump lands on the final INS_BOOL with false condition on stack
+	STLW::vector<UINT_32> vJumps;
+	while (sData.compare(iPos, 2, "&&") == 0)
 	{
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> JUMP IF '&&'\n");
-#endif
-		CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-		oCatalog.v_pl_instructions.push_back(INS_JLAND);
-
-		oCatalog.v_pl_stack.push_back(0);
-		oCatalog.v_pl_stack.push_back(0);
-		UINT_32 iSIdx = oCatalog.v_pl_stack.size() - 2;
-		UINT_32 iIIdx = oCatalog.v_pl_stack.size() - 1;
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "PUSH: 0 (STACK OFFSET), IDX = %u\n", iSIdx);
-fprintf(stdout, "PUSH: 0 (INSTRUCTION OFFSET), IDX = %u\n", iIIdx);
-#endif
-
-		UINT_32 iPrevStackSize = oCatalog.v_pl_stack.size();
-		UINT_32 iPrevInstrSize = oCatalog.v_pl_instructions.size();
-		if (iPos >= sData.size())
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsAndExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-		iPos = IsAndExpr(sData, iPos + 2);
-
-		UINT_32 iStackSize = oCatalog.v_pl_stack.size();
-		UINT_32 iInstrSize = oCatalog.v_pl_instructions.size();
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "REPLACE: %u (STACK OFFSET), IDX = %u\n", iStackSize - iPrevStackSize, iSIdx);
-fprintf(stdout, "REPLACE: %u (INSTRUCTION OFFSET), IDX = %u\n", iInstrSize - iPrevInstrSize, iIIdx);
-#endif
-
-		oCatalog.v_pl_stack[iSIdx] = iStackSize - iPrevStackSize;
-		oCatalog.v_pl_stack[iIIdx] = iInstrSize - iPrevInstrSize;
+		vJumps.push_back(EmitInstruction(vCode, INS_JLAND, 0, -1));
+		iPos = IsEqExpr(sData, iPos + 2, vCode);
 	}
 
+	const UINT_32 iTarget = EmitInstruction(vCode, INS_BOOL, 0, 0);
+	for (UINT_32 iI = 0; iI < vJumps.size(); ++iI) { vCode[vJumps[iI]].argument = iTarget; }
 
-	return iPos;
+return iPos;
 }
 
 //
-// OrExpr         = AndExpr { "||" OrExpr }
+// OrExpr         = AndExpr { "||" AndExpr }
 //
-STLW::string::size_type CTPP2GetText::IsOrExpr(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsOrExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsOrExpr", sData, iPos);
 
-	iPos = IsAndExpr(sData, iPos);
-	if (iPos == STLW::string::npos) { return iPos; }
+	iPos = IsAndExpr(sData, iPos, vCode);
+	if (sData.compare(iPos, 2, "||") != 0) { return iPos; }
 
-	if (sData.find("||", iPos) == iPos)
+	// Every jump lands on the final INS_BOOL with true condition on stack
+	STLW::vector<UINT_32> vJumps;
+	while (sData.compare(iPos, 2, "||") == 0)
 	{
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> JUMP IF '||'\n");
-#endif
-		CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-		oCatalog.v_pl_instructions.push_back(INS_JLOR);
-
-		oCatalog.v_pl_stack.push_back(0);
-		oCatalog.v_pl_stack.push_back(0);
-		UINT_32 iSIdx = oCatalog.v_pl_stack.size() - 2;
-		UINT_32 iIIdx = oCatalog.v_pl_stack.size() - 1;
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "PUSH: 0 (STACK OFFSET), IDX = %u\n", iSIdx);
-fprintf(stdout, "PUSH: 0 (INSTRUCTION OFFSET), IDX = %u\n", iIIdx);
-#endif
-
-		UINT_32 iPrevStackSize = oCatalog.v_pl_stack.size();
-		UINT_32 iPrevInstrSize = oCatalog.v_pl_instructions.size();
-		if (iPos >= sData.size())
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsOrExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-		iPos = IsOrExpr(sData, iPos + 2);
-
-		UINT_32 iStackSize = oCatalog.v_pl_stack.size();
-		UINT_32 iInstrSize = oCatalog.v_pl_instructions.size();
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "REPLACE: %u (STACK OFFSET), IDX = %u\n", iStackSize - iPrevStackSize, iSIdx);
-fprintf(stdout, "REPLACE: %u (INSTRUCTION OFFSET), IDX = %u\n", iInstrSize - iPrevInstrSize, iIIdx);
-#endif
-
-		oCatalog.v_pl_stack[iSIdx] = iStackSize - iPrevStackSize;
-		oCatalog.v_pl_stack[iIIdx] = iInstrSize - iPrevInstrSize;
+		vJumps.push_back(EmitInstruction(vCode, INS_JLOR, 0, -1));
+		iPos = IsAndExpr(sData, iPos + 2, vCode);
 	}
 
-	return iPos;
+	const UINT_32 iTarget = EmitInstruction(vCode, INS_BOOL, 0, 0);
+	for (UINT_32 iI = 0; iI < vJumps.size(); ++iI) { vCode[vJumps[iI]].argument = iTarget; }
+
+return iPos;
 }
 
 //
-// TernaryExpr    = OrExpr { "?" TernaryExpr ":" TernaryExpr }
+// TernaryExpr    = OrExpr [ "?" TernaryExpr ":" TernaryExpr ]
 //
-STLW::string::size_type CTPP2GetText::IsTernaryExpr(const STLW::string & sData, STLW::string::size_type iPos)
+STLW::string::size_type CTPP2GetText::IsTernaryExpr(const STLW::string & sData, STLW::string::size_type iPos, STLW::vector<CTPP2Instruction> & vCode)
 {
 	REPORTER("IsTernaryExpr", sData, iPos);
 
-	iPos = IsOrExpr(sData, iPos);
-	if (iPos == STLW::string::npos) { return iPos; }
+	iPos = IsOrExpr(sData, iPos, vCode);
+	if (iPos >= sData.size() || sData[iPos] != '?') { return iPos; }
 
-	if (sData[iPos] == '?')
-	{
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> JUMP IF '?:'\n");
-#endif
-		CTPP2Catalog & oCatalog = mCatalog[sWorkableLang][sWorkableDomain];
-		oCatalog.v_pl_instructions.push_back(INS_JN);
-
-		oCatalog.v_pl_stack.push_back(0);
-		oCatalog.v_pl_stack.push_back(0);
-		UINT_32 iJNSIdx = oCatalog.v_pl_stack.size() - 2;
-		UINT_32 iJNIIdx = oCatalog.v_pl_stack.size() - 1;
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "PUSH: 0 (STACK OFFSET), IDX = %u\n", iJNSIdx);
-fprintf(stdout, "PUSH: 0 (INSTRUCTION OFFSET), IDX = %u\n", iJNIIdx);
-#endif
+	const UINT_32 iJZ = EmitInstruction(vCode, INS_JZ, 0, -1);
+	const UINT_32 iDepth = iWorkableDepth;
 
-		UINT_32 iPrevStackSize = oCatalog.v_pl_stack.size();
-		UINT_32 iPrevInstrSize = oCatalog.v_pl_instructions.size();
-		if (iPos >= sData.size())
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsTernaryExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-
-		iPos = IsTernaryExpr(sData, iPos + 1);
-
-		UINT_32 iStackSize = oCatalog.v_pl_stack.size();
-		UINT_32 iInstrSize = oCatalog.v_pl_instructions.size();
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "REPLACE: %u (STACK OFFSET), IDX = %u\n", iStackSize - iPrevStackSize + 2, iJNSIdx);
-fprintf(stdout, "REPLACE: %u (INSTRUCTION OFFSET), IDX = %u\n", iInstrSize - iPrevInstrSize, iJNIIdx);
-#endif
-		oCatalog.v_pl_stack[iJNSIdx] = iStackSize - iPrevStackSize + 2;
-		oCatalog.v_pl_stack[iJNIIdx] = iInstrSize - iPrevInstrSize;
+	iPos = IsTernaryExpr(sData, iPos + 1, vCode);
+	if (iPos >= sData.size() || sData[iPos] != ':')
+	{
+		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (1 IsTernaryExpr)";
+		throw CTPPGetTextError(sMsg.c_str());
+	}
 
-		if (sData[iPos] == ':')
-		{
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "\t --> JUMP\n");
-#endif
-			++iPos;
-			if (iPos >= sData.size())
-			{
-				STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (2 IsTernaryExpr)";
-				throw CTPPGetTextError(sMsg.c_str());
-			}
-
-			oCatalog.v_pl_instructions.push_back(INS_JMP);
-
-			oCatalog.v_pl_stack.push_back(0);
-			oCatalog.v_pl_stack.push_back(0);
-			UINT_32 iJMPSIdx = oCatalog.v_pl_stack.size() - 2;
-			UINT_32 iJMPIIdx = oCatalog.v_pl_stack.size() - 1;
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "PUSH: 0 (STACK OFFSET), IDX = %u\n", iJMPSIdx);
-fprintf(stdout, "PUSH: 0 (INSTRUCTION OFFSET), IDX = %u\n", iJMPIIdx);
-#endif
+	const UINT_32 iJMP = EmitInstruction(vCode, INS_JMP, 0, 0);
+	vCode[iJZ].argument = vCode.size();
 
-			iPrevStackSize = oCatalog.v_pl_stack.size();
-			iPrevInstrSize = oCatalog.v_pl_instructions.size();
-			iPos = IsTernaryExpr(sData, iPos);
-			iStackSize = oCatalog.v_pl_stack.size();
-			iInstrSize = oCatalog.v_pl_instructions.size();
-#ifdef _GETTEXT_PLURAL_DEBUG
-fprintf(stdout, "REPLACE: %u (STACK OFFSET), IDX = %u\n", iStackSize - iPrevStackSize, iJMPSIdx);
-fprintf(stdout, "REPLACE: %u (INSTRUCTION OFFSET), IDX = %u\n", iInstrSize - iPrevInstrSize, iJMPIIdx);
-#endif
-			oCatalog.v_pl_stack[iJMPSIdx] = iStackSize - iPrevStackSize;
-			oCatalog.v_pl_stack[iJMPIIdx] = iInstrSize - iPrevInstrSize;
-		}
-		else
-		{
-			STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error (3 IsTernaryExpr)";
-			throw CTPPGetTextError(sMsg.c_str());
-		}
-	}
+	// Branches are alternatives, "false" one starts at depth of condition
+	iWorkableDepth = iDepth;
+	iPos = IsTernaryExpr(sData, iPos + 1, vCode);
+	vCode[iJMP].argument = vCode.size();
 
-	return iPos;
+return iPos;
 }
 
 // Other stuff ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -971,286 +796,89 @@ fprintf(stdout, "REPLACE: %u (INSTRUCTION OFFSET), IDX = %u\n", iInstrSize - iPr
 //
 // Calculate plural form of message
 //
-UINT_32 CTPP2GetText::CalculatePluralForm(UINT_32 iCount, const STLW::string & sLang, const STLW::string & sDomain)
+UINT_32 CTPP2GetText::CalculatePluralForm(UINT_32 iCount, const CTPP2Catalog & oCatalog)
 {
-	STLW::vector<UINT_32> vStack;
-	CTPP2Catalog & oCatalog = mCatalog[sLang][sDomain];
-	vStack.reserve(oCatalog.v_pl_stack.size());
+	// Germanic rule is default for catalogs without Plural-Forms
+	if (oCatalog.v_plural.empty()) { return iCount != 1 ? 1 : 0; }
 
-	STLW::vector<CTPP2Data>::reverse_iterator itvSrc = oCatalog.v_pl_stack.rbegin();
-	for (; itvSrc != oCatalog.v_pl_stack.rend(); ++itvSrc)
-	{
-		if (itvSrc -> b_variable) { vStack.push_back(iCount);            }
-		else                      { vStack.push_back(itvSrc -> i_value); }
-	}
+	UINT_32 aStack[C_MAX_PLURAL_STACK];
+	UINT_32 iTop = 0;
 
-#ifdef _GETTEXT_PLURAL_DEBUG
-	fprintf(stdout, "==>");
-	for (STLW::vector<eCTPP2Instruction>::iterator it = oCatalog.v_pl_instructions.begin();
-		it != oCatalog.v_pl_instructions.end(); ++it)
-	{
-			fprintf(stdout, " %s", StringifyInstruction(*it));
-	}
-	fprintf(stdout, " <==\n");
-#endif
+	const CTPP2Instruction * aCode = &oCatalog.v_plural[0];
+	const UINT_32            iCodeSize = oCatalog.v_plural.size();
 
-	STLW::vector<eCTPP2Instruction>::iterator itvPluralInstrs = oCatalog.v_pl_instructions.begin();
-	while (itvPluralInstrs != oCatalog.v_pl_instructions.end())
+	UINT_32 iIP = 0;
+	while (iIP < iCodeSize)
 	{
-#ifdef _GETTEXT_PLURAL_DEBUG
-		fprintf(stdout, "\t --> INSTRUCTION: %s\n", StringifyInstruction(*itvPluralInstrs));
-		fprintf(stdout, "\t --> STACK DUMP: ");
-		for (INT_32 iN = vStack.size() - 1; iN >= 0; --iN) { fprintf(stdout, "%u, ", vStack[iN]); }
-		fprintf(stdout, "\n");
-#endif
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-#define CALCULATE_EXPR(N)                                      \
-	do {                                                       \
-		UINT_32 iLeft = vStack.back();                         \
-		fprintf(stdout, "POP: %u (iLeft)\n", iLeft);           \
-		vStack.pop_back();                                     \
-		UINT_32 iRight = vStack.back();                        \
-		fprintf(stdout, "POP: %u (iRight)\n", iRight);         \
-		vStack.pop_back();			                           \
-		vStack.push_back(N);                                   \
-		fprintf(stdout, "PUSH: %u (RESULT OF '%s')\n", N, #N); \
-	} while(0)
-#else
-#define CALCULATE_EXPR(N)                                      \
-	do {                                                       \
-		UINT_32 iLeft = vStack.back();                         \
-		vStack.pop_back();                                     \
-		UINT_32 iRight = vStack.back();                        \
-		vStack.pop_back();			                           \
-		vStack.push_back(N);                                   \
-	} while(0)
-#endif
-
-		switch (*itvPluralInstrs)
+		const CTPP2Instruction & oInstruction = aCode[iIP++];
+		switch (oInstruction.instruction)
 		{
-		case INS_EQ:
-			CALCULATE_EXPR(iLeft == iRight);
-			break;
-		case INS_LE:
-			CALCULATE_EXPR(iLeft <= iRight);
-			break;
-		case INS_GE:
-			CALCULATE_EXPR(iLeft >= iRight);
-			break;
-		case INS_LT:
-			CALCULATE_EXPR(iLeft < iRight);
-			break;
-		case INS_GT:
-			CALCULATE_EXPR(iLeft > iRight);
-			break;
-		case INS_NE:
-			CALCULATE_EXPR(iLeft != iRight);
-			break;
-		case INS_MOD:
-			CALCULATE_EXPR(iLeft % iRight);
-			break;
-#undef CALCULATE_EXPR
-		case INS_JLAND:
-			{
-				UINT_32 iCond = vStack.back();
-				vStack.pop_back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (JLAND CONDITION)\n", iCond);
-#endif
-
-				UINT_32 iStackOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (STACK OFFSET)\n", iStackOffset);
-#endif
-				vStack.pop_back();
-				UINT_32 iInstrOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (INSTRUCTION OFFSET)\n", iInstrOffset);
-#endif
-				vStack.pop_back();
-
-				if (!iCond)
-				{
-#ifdef _GETTEXT_PLURAL_DEBUG
-					STLW::vector<UINT_32>::const_reverse_iterator itvStack = vStack.rbegin();
-					for (INT_32 iN = vStack.size() - iStackOffset; itvStack != vStack.rend() && iN < vStack.size() ; ++iN)
-					{
-						fprintf(stdout, "POP: %d (JLAND UNUSED)\n", *itvStack);
-					}
-#endif
-					vStack.resize(vStack.size() - iStackOffset);
-					for (UINT_32 iI = 0; iI < iInstrOffset; ++iI)
-					{
-#ifdef _GETTEXT_PLURAL_DEBUG
-						assert(itvPluralInstrs != oCatalog.v_pl_instructions.end());
-#endif
-						++itvPluralInstrs;
-#ifdef _GETTEXT_PLURAL_DEBUG
-						fprintf(stdout, "\t --> INSTRUCTION (SKIP): %s\n",
-						        StringifyInstruction(*itvPluralInstrs));
-#endif
-					}
-#ifdef _GETTEXT_PLURAL_DEBUG
-					fprintf(stdout, "PUSH: %u (JLAND CONDITION)\n", iCond);
-#endif
-					vStack.push_back(iCond);
-				}
-			}
-			break;
-		case INS_JLOR:
-			{
-				UINT_32 iCond = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (JLOR CONDITION)\n", iCond);
-#endif
-				vStack.pop_back();
-
-				UINT_32 iStackOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (STACK OFFSET)\n", iStackOffset);
-#endif
-				vStack.pop_back();
-				UINT_32 iInstrOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (INSTRUCTION OFFSET)\n", iInstrOffset);
-#endif
-				vStack.pop_back();
-
-				if (iCond)
-				{
-#ifdef _GETTEXT_PLURAL_DEBUG
-					STLW::vector<UINT_32>::const_reverse_iterator itvStack = vStack.rbegin();
-					for (INT_32 iN = vStack.size() - iStackOffset; itvStack != vStack.rend() && iN < vStack.size() ; ++iN)
-					{
-						fprintf(stdout, "POP: %d (JLOR UNUSED)\n", *itvStack);
-					}
-#endif
-					vStack.resize(vStack.size() - iStackOffset);
-					for (UINT_32 iI = 0; iI < iInstrOffset; ++iI)
-					{
-#ifdef _GETTEXT_PLURAL_DEBUG
-						assert(itvPluralInstrs != oCatalog.v_pl_instructions.end());
-#endif
-						++itvPluralInstrs;
-#ifdef _GETTEXT_PLURAL_DEBUG
-						fprintf(stdout, "\t --> INSTRUCTION (SKIP): %s\n", StringifyInstruction(*itvPluralInstrs));
-#endif
-					}
-#ifdef _GETTEXT_PLURAL_DEBUG
-					fprintf(stdout, "PUSH: %u (JLAND CONDITION)\n", iCond);
-#endif
-					vStack.push_back(iCond);
-				}
-			}
-			break;
-		case INS_JN:
-			{
-				UINT_32 iCond = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (JN CONDITION)\n", iCond);
-#endif
-				vStack.pop_back();
-
-				UINT_32 iStackOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (STACK OFFSET)\n", iStackOffset);
-#endif
-				vStack.pop_back();
-				UINT_32 iInstrOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (INSTRUCTION OFFSET)\n", iInstrOffset);
-#endif
-				vStack.pop_back();
-
-				if (!iCond)
-				{
-#ifdef _GETTEXT_PLURAL_DEBUG
-					STLW::vector<UINT_32>::const_reverse_iterator itvStack = vStack.rbegin();
-					for (INT_32 iN = vStack.size() - iStackOffset; itvStack != vStack.rend() && iN < vStack.size() ; ++iN)
-					{
-						fprintf(stdout, "POP: %d (JN UNUSED)\n", *itvStack);
-					}
-#endif
-					vStack.resize(vStack.size() - iStackOffset);
-					for (UINT_32 iI = 0; iI < iInstrOffset + 1; ++iI)
-					{
-#ifdef _GETTEXT_PLURAL_DEBUG
-						assert(itvPluralInstrs != oCatalog.v_pl_instructions.end());
-#endif
-						++itvPluralInstrs;
-#ifdef _GETTEXT_PLURAL_DEBUG
-						fprintf(stdout, "\t --> INSTRUCTION (SKIP): %s\n", StringifyInstruction(*itvPluralInstrs));
-#endif
-					}
-				}
-			}
-			break;
-		case INS_JMP:
-			{
-				INT_32 iLastValue = vStack.back();
-				vStack.pop_back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (LAST VALUE)\n", iLastValue);
-#endif
-
-				UINT_32 iStackOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (STACK OFFSET)\n", iStackOffset);
-#endif
-				vStack.pop_back();
-				UINT_32 iInstrOffset = vStack.back();
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "POP: %u (INSTRUCTION OFFSET)\n", iInstrOffset);
-#endif
-				vStack.pop_back();
-
-#ifdef _GETTEXT_PLURAL_DEBUG
-				STLW::vector<UINT_32>::const_reverse_iterator itvStack = vStack.rbegin();
-				for (INT_32 iN = vStack.size() - iStackOffset; itvStack != vStack.rend() && iN < vStack.size() ; ++iN)
-				{
-					fprintf(stdout, "POP: %d (JMP UNUSED)\n", *itvStack);
-				}
-#endif
-				vStack.resize(vStack.size() - iStackOffset);
-				for (UINT_32 iI = 0; iI < iInstrOffset; ++iI)
-				{
-#ifdef _GETTEXT_PLURAL_DEBUG
-					assert(itvPluralInstrs != oCatalog.v_pl_instructions.end());
-#endif
-					++itvPluralInstrs;
-#ifdef _GETTEXT_PLURAL_DEBUG
-					fprintf(stdout, "\t --> INSTRUCTION (SKIP): %s\n", StringifyInstruction(*itvPluralInstrs));
-#endif
-				}
-#ifdef _GETTEXT_PLURAL_DEBUG
-				fprintf(stdout, "PUSH: %u (LAST VALUE)\n", iLastValue);
-#endif
-				vStack.push_back(iLastValue);
-			}
-			break;
-		default:
-			break;
+			case INS_PUSH_N:
+				aStack[iTop++] = iCount;
+				break;
+			case INS_PUSH:
+				aStack[iTop++] = oInstruction.argument;
+				break;
+			case INS_EQ:
+				--iTop; aStack[iTop - 1] = aStack[iTop - 1] == aStack[iTop];
+				break;
+			case INS_NE:
+				--iTop; aStack[iTop - 1] = aStack[iTop - 1] != aStack[iTop];
+				break;
+			case INS_LE:
+				--iTop; aStack[iTop - 1] = aStack[iTop - 1] <= aStack[iTop];
+				break;
+			case INS_LT:
+				--iTop; aStack[iTop - 1] = aStack[iTop - 1] <  aStack[iTop];
+				break;
+			case INS_GE:
+				--iTop; aStack[iTop - 1] = aStack[iTop - 1] >= aStack[iTop];
+				break;
+			case INS_GT:
+				--iTop; aStack[iTop - 1] = aStack[iTop - 1] >  aStack[iTop];
+				break;
+			case INS_MOD:
+				--iTop; aStack[iTop - 1] = aStack[iTop] == 0 ? 0 : aStack[iTop - 1] % aStack[iTop];
+				break;
+			case INS_BOOL:
+				aStack[iTop - 1] = aStack[iTop - 1] != 0;
+				break;
+			case INS_JZ:
+				if (aStack[--iTop] == 0) { iIP = oInstruction.argument; }
+				break;
+			case INS_JMP:
+				iIP = oInstruction.argument;
+				break;
+			case INS_JLAND:
+				if (aStack[iTop - 1] == 0) { iIP = oInstruction.argument; }
+				else                       { --iTop;                      }
+				break;
+			case INS_JLOR:
+				if (aStack[iTop - 1] != 0) { iIP = oInstruction.argument; }
+				else                       { --iTop;                      }
+				break;
 		}
-		++itvPluralInstrs;
 	}
 
-#ifdef _GETTEXT_PLURAL_DEBUG
-	fprintf(stdout, "Stack size: %u\n", vStack.size());
-	for (UINT_32 idx = 0; idx < vStack.size(); ++idx) { fprintf(stdout, "--> %u\n", vStack[idx]); }
-#endif
-	return vStack.back();
+return aStack[0];
 }
 
 //
 // Generate plural form rule
 //
-void CTPP2GetText::GeneratePluralRule(const STLW::string & sPluralRule)
+void CTPP2GetText::GeneratePluralRule(const STLW::string & sPluralRule, CTPP2Catalog & oCatalog)
 {
 	STLW::string s = sPluralRule;
 	s.erase(STLW::remove_if(s.begin(), s.end(), ::isspace), s.end());
-	IsTernaryExpr(s, 0);
-	mCatalog[sWorkableLang][sWorkableDomain].v_pl_instructions.push_back(INS_NONE);
+
+	STLW::vector<CTPP2Instruction> vCode;
+	iWorkableDepth = 0;
+	if (IsTernaryExpr(s, 0, vCode) != s.size())
+	{
+		STLW::string sMsg = STLW::string("i18n domain '") + sWorkableDomain + "': plural rule parser error: " + sPluralRule;
+		throw CTPPGetTextError(sMsg.c_str());
+	}
+	oCatalog.v_plural.swap(vCode);
 }
 
 //
@@ -1260,6 +888,10 @@ CCHAR_P CTPP2GetText::StringifyInstruction(eCTPP2Instruction eType)
 {
 	switch (eType)
 	{
+	case INS_PUSH_N:
+		return "N";
+	case INS_PUSH:
+		return "PUSH";
 	case INS_EQ:
 		return "'=='";
 	case INS_LE:
@@ -1274,16 +906,16 @@ CCHAR_P CTPP2GetText::StringifyInstruction(eCTPP2Instruction eType)
 		return "'!='";
 	case INS_MOD:
 		return "'%'";
-	case INS_JN:
-		return "JN";
+	case INS_BOOL:
+		return "BOOL";
+	case INS_JZ:
+		return "JZ";
 	case INS_JMP:
 		return "JMP";
 	case INS_JLAND:
 		return "JLAND";
 	case INS_JLOR:
 		return "JLOR";
-	case INS_NONE:
-		return "NONE";
 	default:
 		return "UNKNOWN";
 	}
@@ -0,0 +1,1005 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2JSONFastParser.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2JSONFastParser.hpp"
+
+#include "CTPP2Util.hpp"
+
+#include <stdlib.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+// Max. nesting level; deeper documents are left to CTPP2JSONParser
+#define C_JSON_MAX_DEPTH 1024
+
+namespace CTPP // C++ Template Engine
+{
+
+// Character classes
+#define C_JSON_QUOTE       0x01
+#define C_JSON_BACKSLASH   0x02
+#define C_JSON_STRUCTURAL  0x04
+#define C_JSON_WHITESPACE  0x08
+
+//
+// Get character class
+//
+static inline UINT_32 CharClass(const UCHAR_8 iChar)
+{
+	switch (iChar)
+	{
+		case '"':
+			return C_JSON_QUOTE;
+		case '\\':
+			return C_JSON_BACKSLASH;
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ',':
+		case ':':
+			return C_JSON_STRUCTURAL;
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+			return C_JSON_WHITESPACE;
+		default:
+			;;
+	}
+
+return 0;
+}
+
+//
+// Exact powers of 10
+//
+static const W_FLOAT aPowersOf10[] = { 1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,
+                                       1E8,  1E9,  1E10, 1E11, 1E12, 1E13, 1E14, 1E15,
+                                       1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22 };
+
+//
+// Classify 64 bytes
+//
+static inline void ClassifyBlock(const UCHAR_8  * pBlock,
+                                 UINT_64        & iQuotes,
+                                 UINT_64        & iBackslashes,
+                                 UINT_64        & iStructurals,
+                                 UINT_64        & iWhiteSpaces)
+{
+#if defined(__SSE2__)
+	const __m128i oQuote      = _mm_set1_epi8('"');
+	const __m128i oBackslash  = _mm_set1_epi8('\\');
+	const __m128i oCaseBit    = _mm_set1_epi8(0x20);
+	const __m128i oOpenBrace  = _mm_set1_epi8('{');
+	const __m128i oCloseBrace = _mm_set1_epi8('}');
+	const __m128i oComma      = _mm_set1_epi8(',');
+	const __m128i oColon      = _mm_set1_epi8(':');
+	const __m128i oSpace      = _mm_set1_epi8(' ');
+	const __m128i oTab        = _mm_set1_epi8('\t');
+	const __m128i oCR         = _mm_set1_epi8('\r');
+	const __m128i oLF         = _mm_set1_epi8('\n');
+
+	iQuotes = iBackslashes = iStructurals = iWhiteSpaces = 0;
+	for (UINT_32 iI = 0; iI < 4; ++iI)
+	{
+		const __m128i oChunk = _mm_loadu_si128((const __m128i *)(pBlock + iI * 16));
+		// '[' | 0x20 == '{', ']' | 0x20 == '}'
+		const __m128i oFolded = _mm_or_si128(oChunk, oCaseBit);
+
+		const __m128i oStructural = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(oFolded, oOpenBrace), _mm_cmpeq_epi8(oFolded, oCloseBrace)),
+		                                         _mm_or_si128(_mm_cmpeq_epi8(oChunk,  oComma),     _mm_cmpeq_epi8(oChunk,  oColon)));
+
+		const __m128i oWhiteSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(oChunk, oSpace), _mm_cmpeq_epi8(oChunk, oTab)),
+		                                         _mm_or_si128(_mm_cmpeq_epi8(oChunk, oCR),    _mm_cmpeq_epi8(oChunk, oLF)));
+
+		const UINT_32 iShift = iI * 16;
+		iQuotes      |= UINT_64(UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(oChunk, oQuote))))     << iShift;
+		iBackslashes |= UINT_64(UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(oChunk, oBackslash)))) << iShift;
+		iStructurals |= UINT_64(UINT_32(_mm_movemask_epi8(oStructural)))                        << iShift;
+		iWhiteSpaces |= UINT_64(UINT_32(_mm_movemask_epi8(oWhiteSpace)))                        << iShift;
+	}
+#else
+	iQuotes = iBackslashes = iStructurals = iWhiteSpaces = 0;
+	for (UINT_32 iI = 0; iI < 64; ++iI)
+	{
+		const UINT_64 iBit   = UINT_64(1) << iI;
+		const UINT_32 iClass = CharClass(pBlock[iI]);
+
+		if (iClass & C_JSON_QUOTE)      { iQuotes      |= iBit; }
+		if (iClass & C_JSON_BACKSLASH)  { iBackslashes |= iBit; }
+		if (iClass & C_JSON_STRUCTURAL) { iStructurals |= iBit; }
+		if (iClass & C_JSON_WHITESPACE) { iWhiteSpaces |= iBit; }
+	}
+#endif
+}
+
+//
+// Every bit is XOR of itself and all lower bits
+//
+static inline UINT_64 PrefixXor(UINT_64 iMask)
+{
+#if defined(__PCLMUL__)
+	const __m128i oResult = _mm_clmulepi64_si128(_mm_set_epi64x(0, INT_64(iMask)), _mm_set1_epi8(char(0xFF)), 0);
+
+return UINT_64(_mm_cvtsi128_si64(oResult));
+#else
+	iMask ^= iMask << 1;
+	iMask ^= iMask << 2;
+	iMask ^= iMask << 4;
+	iMask ^= iMask << 8;
+	iMask ^= iMask << 16;
+	iMask ^= iMask << 32;
+
+return iMask;
+#endif
+}
+
+//
+// Find characters escaped by backslash
+//
+static inline UINT_64 FindEscaped(UINT_64 iBackslashes, UINT_64 & iPrevEscaped)
+{
+	if (iBackslashes == 0 && iPrevEscaped == 0) { return 0; }
+
+	static const UINT_64 iEvenBits = 0x5555555555555555ULL;
+
+	// Backslash escaped by previous block is not an escape character
+	iBackslashes &= ~iPrevEscaped;
+	const UINT_64 iFollowsEscape = (iBackslashes << 1) | iPrevEscaped;
+
+	// Sequences of backslashes starting on odd position
+	const UINT_64 iOddStarts = iBackslashes & ~iEvenBits & ~iFollowsEscape;
+
+	// Adding sequence start to sequence carries the bit to the character after it
+	const UINT_64 iEvenStarts = iOddStarts + iBackslashes;
+	iPrevEscaped = (iEvenStarts < iOddStarts) ? 1 : 0;
+
+	const UINT_64 iInvertMask = iEvenStarts << 1;
+
+return (iEvenBits ^ iInvertMask) & iFollowsEscape;
+}
+
+//
+// Position of lowest set bit
+//
+static inline UINT_32 LowestBit(const UINT_64 iMask)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(iMask);
+#else
+	UINT_32 iPos = 0;
+	while (((iMask >> iPos) & 1) == 0) { ++iPos; }
+
+return iPos;
+#endif
+}
+
+//
+// White space or structural character
+//
+static inline bool IsDelimiter(const CHAR_8 chData)
+{
+	return (CharClass(UCHAR_8(chData)) & (C_JSON_STRUCTURAL | C_JSON_WHITESPACE)) != 0;
+}
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class CTPP2JSONLazyContainer
+//
+
+/**
+  @class CTPP2JSONLazyContainer
+  @brief Lazy ARRAY or HASH over indexed JSON data; elements are located on first access
+*/
+class CTPP2JSONLazyContainer:
+  public CDT::DataProvider
+{
+public:
+	/**
+	  @brief Constructor
+	  @param pIParser - parser
+	  @param iIOpenToken - token of opening bracket
+	*/
+	CTPP2JSONLazyContainer(CTPP2JSONFastParser  * pIParser,
+	                       const UINT_32          iIOpenToken);
+
+	/**
+	  @brief Get container type
+	*/
+	CDT::eValType GetType() const;
+
+	/**
+	  @brief Fetch hash element
+	*/
+	bool GetKey(const STLW::string & sKey, CDT & oValue);
+
+	/**
+	  @brief Fetch array element
+	*/
+	bool GetIndex(const UINT_32 iPos, CDT & oValue);
+
+	/**
+	  @brief Get number of elements
+	*/
+	UINT_32 Size();
+
+	/**
+	  @brief Pass all elements to visitor
+	*/
+	void Iterate(Visitor & oVisitor);
+
+	/**
+	  @brief A destructor
+	*/
+	~CTPP2JSONLazyContainer() throw();
+private:
+	/** Parser                        */
+	CTPP2JSONFastParser             * pParser;
+	/** Token of opening bracket      */
+	UINT_32                           iOpenToken;
+	/** Container type                */
+	CDT::eValType                     eType;
+	/** Elements are located          */
+	bool                              bIndexed;
+	/** Array: tokens of elements     */
+	STLW::vector<UINT_32>             vElements;
+	/** Hash: tokens of values        */
+	STLW::map<STLW::string, UINT_32>  mElements;
+
+	/**
+	  @brief Locate elements
+	*/
+	void Index();
+
+	/**
+	  @brief Skip value
+	  @param iValueToken - first token of value
+	  @return token after value
+	*/
+	UINT_32 SkipValue(const UINT_32 iValueToken) const;
+};
+
+//
+// Constructor
+//
+CTPP2JSONLazyContainer::CTPP2JSONLazyContainer(CTPP2JSONFastParser  * pIParser,
+                                               const UINT_32          iIOpenToken): pParser(pIParser),
+                                                                                    iOpenToken(iIOpenToken),
+                                                                                    bIndexed(false)
+{
+	eType = pParser -> szData[pParser -> vIndex[iOpenToken]] == '{' ? CDT::HASH_VAL : CDT::ARRAY_VAL;
+}
+
+//
+// Get container type
+//
+CDT::eValType CTPP2JSONLazyContainer::GetType() const { return eType; }
+
+//
+// Fetch hash element
+//
+bool CTPP2JSONLazyContainer::GetKey(const STLW::string & sKey, CDT & oValue)
+{
+	if (eType != CDT::HASH_VAL) { return false; }
+
+	Index();
+
+	STLW::map<STLW::string, UINT_32>::const_iterator itmElements = mElements.find(sKey);
+	if (itmElements == mElements.end()) { return false; }
+
+	pParser -> BuildLazyValue(itmElements -> second, oValue);
+
+return true;
+}
+
+//
+// Fetch array element
+//
+bool CTPP2JSONLazyContainer::GetIndex(const UINT_32 iPos, CDT & oValue)
+{
+	if (eType != CDT::ARRAY_VAL) { return false; }
+
+	Index();
+	if (iPos >= vElements.size()) { return false; }
+
+	pParser -> BuildLazyValue(vElements[iPos], oValue);
+
+return true;
+}
+
+//
+// Get number of elements
+//
+UINT_32 CTPP2JSONLazyContainer::Size()
+{
+	Index();
+
+return eType == CDT::ARRAY_VAL ? vElements.size() : mElements.size();
+}
+
+//
+// Pass all elements to visitor
+//
+void CTPP2JSONLazyContainer::Iterate(Visitor & oVisitor)
+{
+	Index();
+
+	if (eType == CDT::ARRAY_VAL)
+	{
+		for (UINT_32 iPos = 0; iPos < vElements.size(); ++iPos)
+		{
+			CDT oValue;
+			pParser -> BuildLazyValue(vElements[iPos], oValue);
+			oVisitor.VisitElement(oValue);
+		}
+		return;
+	}
+
+	STLW::map<STLW::string, UINT_32>::const_iterator itmElements = mElements.begin();
+	while (itmElements != mElements.end())
+	{
+		CDT oValue;
+		pParser -> BuildLazyValue(itmElements -> second, oValue);
+		oVisitor.VisitKey(itmElements -> first, oValue);
+		++itmElements;
+	}
+}
+
+//
+// Skip value
+//
+UINT_32 CTPP2JSONLazyContainer::SkipValue(const UINT_32 iValueToken) const
+{
+	switch (pParser -> szData[pParser -> vIndex[iValueToken]])
+	{
+		case '{':
+		case '[':
+			return pParser -> vSkip[iValueToken];
+
+		// Opening and closing quotes
+		case '"':
+			return iValueToken + 2;
+
+		default:
+			;;
+	}
+
+return iValueToken + 1;
+}
+
+//
+// Locate elements; data is already validated
+//
+void CTPP2JSONLazyContainer::Index()
+{
+	if (bIndexed) { return; }
+	bIndexed = true;
+
+	CCHAR_P                       szData = pParser -> szData;
+	const STLW::vector<UINT_32> & vIndex = pParser -> vIndex;
+
+	UINT_32 iToken = iOpenToken + 1;
+	const CHAR_8 chClose = (eType == CDT::HASH_VAL) ? '}' : ']';
+	if (szData[vIndex[iToken]] == chClose) { return; }
+
+	for (;;)
+	{
+		if (eType == CDT::HASH_VAL)
+		{
+			// Key, delimiter; last of duplicate keys wins
+			STLW::string sKey;
+			pParser -> ParseString(iToken, sKey);
+			iToken += 3;
+			mElements[sKey] = iToken;
+		}
+		else
+		{
+			vElements.push_back(iToken);
+		}
+
+		iToken = SkipValue(iToken);
+		if (szData[vIndex[iToken]] == chClose) { return; }
+		// Comma
+		++iToken;
+	}
+}
+
+//
+// A destructor
+//
+CTPP2JSONLazyContainer::~CTPP2JSONLazyContainer() throw() { ;; }
+
+// ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class CTPP2JSONFastParser
+//
+
+//
+// Constructor
+//
+CTPP2JSONFastParser::CTPP2JSONFastParser(CDT & oICDT): oCDT(oICDT), szData(NULL), iLength(0), iToken(0)
+{
+	;;
+}
+
+//
+// Build structural index
+//
+bool CTPP2JSONFastParser::BuildIndex()
+{
+	vIndex.clear();
+
+	UINT_64 iPrevEscaped  = 0;
+	UINT_64 iPrevInString = 0;
+	UINT_64 iPrevScalar   = 0;
+
+	UCHAR_8 aTail[64];
+	for (UINT_32 iOffset = 0; iOffset < iLength; iOffset += 64)
+	{
+		const UCHAR_8 * pBlock = (const UCHAR_8 *)szData + iOffset;
+		// Pad last block with spaces
+		if (iLength - iOffset < 64)
+		{
+			memset(aTail, ' ', 64);
+			memcpy(aTail, pBlock, iLength - iOffset);
+			pBlock = aTail;
+		}
+
+		UINT_64 iQuotes      = 0;
+		UINT_64 iBackslashes = 0;
+		UINT_64 iStructurals = 0;
+		UINT_64 iWhiteSpaces = 0;
+		ClassifyBlock(pBlock, iQuotes, iBackslashes, iStructurals, iWhiteSpaces);
+
+		iQuotes &= ~FindEscaped(iBackslashes, iPrevEscaped);
+
+		// Opening quote and string body are set, closing quote is not
+		const UINT_64 iInString = PrefixXor(iQuotes) ^ iPrevInString;
+		iPrevInString = UINT_64(INT_64(iInString) >> 63);
+
+		// Numbers, literals and garbage; only first character of each is indexed
+		const UINT_64 iScalars      = ~(iStructurals | iWhiteSpaces | iQuotes);
+		const UINT_64 iScalarStarts = iScalars & ~((iScalars << 1) | iPrevScalar);
+		iPrevScalar = iScalars >> 63;
+
+		UINT_64 iTokens = ((iStructurals | iScalarStarts) & ~iInString) | iQuotes;
+		while (iTokens != 0)
+		{
+			vIndex.push_back(iOffset + LowestBit(iTokens));
+			iTokens &= iTokens - 1;
+		}
+	}
+
+return iPrevInString == 0;
+}
+
+//
+// JSON value
+//
+bool CTPP2JSONFastParser::ParseValue(CDT & oValue, const UINT_32 iDepth)
+{
+	if (iToken == vIndex.size()) { return false; }
+
+	const UINT_32 iPos = vIndex[iToken++];
+	switch (szData[iPos])
+	{
+		case '{':
+			return ParseObject(oValue, iDepth);
+
+		case '[':
+			return ParseArray(oValue, iDepth);
+
+		case '"':
+			if (!ParseString(iToken - 1, sTMPBuf)) { return false; }
+			++iToken;
+			oValue = sTMPBuf;
+			return true;
+
+		case 't':
+			if (!ParseLiteral(iPos, "true", 4))  { return false; }
+			oValue = 1;
+			return true;
+
+		case 'f':
+			if (!ParseLiteral(iPos, "false", 5)) { return false; }
+			oValue = 0;
+			return true;
+
+		case 'n':
+			if (!ParseLiteral(iPos, "null", 4))  { return false; }
+			oValue = CDT(CDT::UNDEF);
+			return true;
+
+		default:
+			;;
+	}
+
+return ParseNumber(iPos, oValue);
+}
+
+//
+// JSON object
+//
+bool CTPP2JSONFastParser::ParseObject(CDT & oValue, const UINT_32 iDepth)
+{
+	if (iDepth == C_JSON_MAX_DEPTH) { return false; }
+
+	oValue = CDT(CDT::HASH_VAL);
+
+	if (iToken == vIndex.size()) { return false; }
+	if (szData[vIndex[iToken]] == '}') { ++iToken; return true; }
+
+	for (;;)
+	{
+		// Key
+		if (iToken == vIndex.size() || szData[vIndex[iToken]] != '"') { return false; }
+		if (!ParseString(iToken, sKey))                               { return false; }
+		iToken += 2;
+
+		// Delimiter
+		if (iToken == vIndex.size() || szData[vIndex[iToken]] != ':') { return false; }
+		++iToken;
+
+		// Value; last of duplicate keys wins
+		if (!ParseValue(oValue[sKey], iDepth + 1)) { return false; }
+
+		// Next key : value pair or end of object
+		if (iToken == vIndex.size()) { return false; }
+
+		const CHAR_8 chNext = szData[vIndex[iToken++]];
+		if (chNext == '}') { return true;  }
+		if (chNext != ',') { return false; }
+	}
+
+// This should *never* happened
+return false;
+}
+
+//
+// JSON array
+//
+bool CTPP2JSONFastParser::ParseArray(CDT & oValue, const UINT_32 iDepth)
+{
+	if (iDepth == C_JSON_MAX_DEPTH) { return false; }
+
+	oValue = CDT(CDT::ARRAY_VAL);
+
+	if (iToken == vIndex.size()) { return false; }
+	if (szData[vIndex[iToken]] == ']') { ++iToken; return true; }
+
+	for (UINT_32 iArrayIndex = 0; ; ++iArrayIndex)
+	{
+		if (!ParseValue(oValue[iArrayIndex], iDepth + 1)) { return false; }
+
+		// Next element or end of array
+		if (iToken == vIndex.size()) { return false; }
+
+		const CHAR_8 chNext = szData[vIndex[iToken++]];
+		if (chNext == ']') { return true;  }
+		if (chNext != ',') { return false; }
+	}
+
+// This should *never* happened
+return false;
+}
+
+//
+// Validate JSON value, remember ends of ARRAYs and HASHes
+//
+bool CTPP2JSONFastParser::IndexValue(const UINT_32 iDepth)
+{
+	if (iToken == vIndex.size()) { return false; }
+
+	const UINT_32 iValueToken = iToken;
+	const UINT_32 iPos        = vIndex[iToken++];
+	const CHAR_8  chOpen      = szData[iPos];
+	switch (chOpen)
+	{
+		case '{':
+		case '[':
+			{
+				if (iDepth == C_JSON_MAX_DEPTH) { return false; }
+
+				const CHAR_8 chClose = (chOpen == '{') ? '}' : ']';
+				if (iToken == vIndex.size()) { return false; }
+				if (szData[vIndex[iToken]] == chClose) { vSkip[iValueToken] = ++iToken; return true; }
+
+				for (;;)
+				{
+					if (chOpen == '{')
+					{
+						// Key
+						if (iToken == vIndex.size() || szData[vIndex[iToken]] != '"') { return false; }
+						if (!CheckString(iToken))                                     { return false; }
+						iToken += 2;
+
+						// Delimiter
+						if (iToken == vIndex.size() || szData[vIndex[iToken]] != ':') { return false; }
+						++iToken;
+					}
+
+					if (!IndexValue(iDepth + 1)) { return false; }
+
+					// Next element or end of container
+					if (iToken == vIndex.size()) { return false; }
+
+					const CHAR_8 chNext = szData[vIndex[iToken++]];
+					if (chNext == chClose) { vSkip[iValueToken] = iToken; return true; }
+					if (chNext != ',')     { return false; }
+				}
+			}
+
+		case '"':
+			if (!CheckString(iValueToken)) { return false; }
+			++iToken;
+			return true;
+
+		case 't':
+			return ParseLiteral(iPos, "true", 4);
+
+		case 'f':
+			return ParseLiteral(iPos, "false", 5);
+
+		case 'n':
+			return ParseLiteral(iPos, "null", 4);
+
+		default:
+			;;
+	}
+
+	CDT oNumber;
+
+return ParseNumber(iPos, oNumber);
+}
+
+//
+// Build value of given token
+//
+void CTPP2JSONFastParser::BuildLazyValue(const UINT_32 iValueToken, CDT & oValue)
+{
+	const UINT_32 iPos = vIndex[iValueToken];
+	switch (szData[iPos])
+	{
+		case '{':
+		case '[':
+			{
+				STLW::map<UINT_32, CTPP2JSONLazyContainer *>::iterator itmContainers = mContainers.find(iValueToken);
+				if (itmContainers == mContainers.end())
+				{
+					itmContainers = mContainers.insert(STLW::pair<const UINT_32, CTPP2JSONLazyContainer *>(iValueToken, new CTPP2JSONLazyContainer(this, iValueToken))).first;
+				}
+				oValue = CDT(itmContainers -> second);
+			}
+			return;
+
+		case '"':
+			ParseString(iValueToken, sTMPBuf);
+			oValue = sTMPBuf;
+			return;
+
+		case 't':
+			oValue = 1;
+			return;
+
+		case 'f':
+			oValue = 0;
+			return;
+
+		case 'n':
+			oValue = CDT(CDT::UNDEF);
+			return;
+
+		default:
+			;;
+	}
+
+	ParseNumber(iPos, oValue);
+}
+
+//
+// JSON string
+//
+bool CTPP2JSONFastParser::ParseString(const UINT_32 iStringToken, STLW::string & sValue)
+{
+	// Closing quote is always next token
+	if (iStringToken + 1 >= vIndex.size()) { return false; }
+
+	CCHAR_P szStart = szData + vIndex[iStringToken] + 1;
+	CCHAR_P szStop  = szData + vIndex[iStringToken + 1];
+
+	sValue.erase();
+	for (;;)
+	{
+		CCHAR_P szEscape = (CCHAR_P)memchr(szStart, '\\', szStop - szStart);
+		if (szEscape == NULL)
+		{
+			sValue.append(szStart, szStop - szStart);
+			return true;
+		}
+
+		sValue.append(szStart, szEscape - szStart);
+
+		// Closing quote is never escaped, so escaped character is before it
+		szStart = szEscape + 2;
+		switch (szEscape[1])
+		{
+			// man ascii
+			case 'a': sValue += '\a'; break;
+			case 'b': sValue += '\b'; break;
+			case 't': sValue += '\t'; break;
+			case 'n': sValue += '\n'; break;
+			case 'v': sValue += '\v'; break;
+			case 'f': sValue += '\f'; break;
+			case 'r': sValue += '\r'; break;
+			// Unicode + 4 digits
+			case 'u':
+				{
+					if (szStop - szStart < 4) { return false; }
+
+					UINT_32 iUCS = 0;
+					for (UINT_32 iI = 0; iI < 4; ++iI)
+					{
+						const CHAR_8 chDigit = szStart[iI];
+						iUCS <<= 4;
+						if      (chDigit >= '0' && chDigit <= '9') { iUCS += chDigit - '0';      }
+						// CTPP2JSONParser does not accept uppercase hex digits
+						else if (chDigit >= 'a' && chDigit <= 'f') { iUCS += chDigit - 'a' + 10; }
+						else                                       { return false;               }
+					}
+					szStart += 4;
+
+					UCHAR_8 aBuffer[6];
+					const INT_32 iCharLength = UnicodeToUTF8(iUCS, aBuffer);
+					sValue.append((CCHAR_P)aBuffer, iCharLength);
+				}
+				break;
+			default:
+				sValue += szEscape[1];
+		}
+	}
+
+// This should *never* happened
+return false;
+}
+
+//
+// Check JSON string escapes
+//
+bool CTPP2JSONFastParser::CheckString(const UINT_32 iStringToken) const
+{
+	if (iStringToken + 1 >= vIndex.size()) { return false; }
+
+	CCHAR_P szStart = szData + vIndex[iStringToken] + 1;
+	CCHAR_P szStop  = szData + vIndex[iStringToken + 1];
+	for (;;)
+	{
+		CCHAR_P szEscape = (CCHAR_P)memchr(szStart, '\\', szStop - szStart);
+		if (szEscape == NULL) { return true; }
+
+		szStart = szEscape + 2;
+		if (szEscape[1] != 'u') { continue; }
+
+		if (szStop - szStart < 4) { return false; }
+		for (UINT_32 iI = 0; iI < 4; ++iI)
+		{
+			const CHAR_8 chDigit = szStart[iI];
+			if (!((chDigit >= '0' && chDigit <= '9') || (chDigit >= 'a' && chDigit <= 'f'))) { return false; }
+		}
+		szStart += 4;
+	}
+
+// This should *never* happened
+return false;
+}
+
+//
+// JSON number -?(0|[1-9][0-9]*)(.[0-9]+([eE][+-]?[0-9]+)?)?
+//
+bool CTPP2JSONFastParser::ParseNumber(const UINT_32 iPos, CDT & oValue)
+{
+	CCHAR_P szStart = szData + iPos;
+	CCHAR_P szEnd   = szData + iLength;
+	CCHAR_P szPos   = szStart;
+
+	bool bNegative = false;
+	if (*szPos == '-') { bNegative = true; ++szPos; }
+
+	if (szPos == szEnd || *szPos < '0' || *szPos > '9') { return false; }
+	// CTPP2JSONParser reads leading zero as octal number
+	if (*szPos == '0' && szPos + 1 != szEnd && szPos[1] >= '0' && szPos[1] <= '9') { return false; }
+
+	UINT_64 iMantissa  = 0;
+	CCHAR_P szDigits   = szPos;
+	while (szPos != szEnd && *szPos >= '0' && *szPos <= '9')
+	{
+		iMantissa = iMantissa * 10 + (*szPos - '0');
+		++szPos;
+	}
+	const INT_32 iIntDigits = szPos - szDigits;
+
+	// Integer
+	if (szPos == szEnd || *szPos != '.')
+	{
+		// Too long or followed by exponent, garbage, comment, etc.
+		if (iIntDigits > 18 || (szPos != szEnd && !IsDelimiter(*szPos))) { return false; }
+
+		oValue = bNegative ? -INT_64(iMantissa) : INT_64(iMantissa);
+		return true;
+	}
+	++szPos;
+
+	// Fraction
+	szDigits = szPos;
+	while (szPos != szEnd && *szPos >= '0' && *szPos <= '9')
+	{
+		iMantissa = iMantissa * 10 + (*szPos - '0');
+		++szPos;
+	}
+	const INT_32 iFractionDigits = szPos - szDigits;
+	if (iFractionDigits == 0) { return false; }
+
+	// Exponent
+	INT_32 iExponent = 0;
+	if (szPos != szEnd && (*szPos == 'e' || *szPos == 'E'))
+	{
+		++szPos;
+
+		bool bNegativeExponent = false;
+		if (szPos != szEnd && (*szPos == '-' || *szPos == '+')) { bNegativeExponent = (*szPos == '-'); ++szPos; }
+
+		if (szPos == szEnd || *szPos < '0' || *szPos > '9') { return false; }
+		while (szPos != szEnd && *szPos >= '0' && *szPos <= '9')
+		{
+			if (iExponent < 100000) { iExponent = iExponent * 10 + (*szPos - '0'); }
+			++szPos;
+		}
+		if (bNegativeExponent) { iExponent = -iExponent; }
+	}
+
+	if (szPos != szEnd && !IsDelimiter(*szPos)) { return false; }
+
+	// Mantissa and power of 10 are exact, so is the result of one multiplication or division
+	const INT_32 iScale = iExponent - iFractionDigits;
+	if (iIntDigits + iFractionDigits <= 15 && iScale >= -22 && iScale <= 22)
+	{
+		W_FLOAT dValue = W_FLOAT(iMantissa);
+		if (iScale < 0) { dValue /= aPowersOf10[-iScale]; }
+		else            { dValue *= aPowersOf10[iScale];  }
+
+		oValue = bNegative ? -dValue : dValue;
+		return true;
+	}
+
+	sTMPBuf.assign(szStart, szPos - szStart);
+	oValue = W_FLOAT(strtod(sTMPBuf.c_str(), NULL));
+
+return true;
+}
+
+//
+// JSON literal
+//
+bool CTPP2JSONFastParser::ParseLiteral(const UINT_32 iPos, CCHAR_P szLiteral, const UINT_32 iLiteralLength)
+{
+	// CTPP2JSONParser does not accept literal at the very end of data
+	if (iLength - iPos <= iLiteralLength || memcmp(szData + iPos, szLiteral, iLiteralLength) != 0) { return false; }
+
+return IsDelimiter(szData[iPos + iLiteralLength]);
+}
+
+//
+// Parse JSON data
+//
+bool CTPP2JSONFastParser::Parse(CCHAR_P szIData, CCHAR_P szIEnd)
+{
+	ClearContainers();
+
+	szData  = szIData;
+	iLength = szIEnd - szIData;
+	iToken  = 0;
+
+	if (!BuildIndex() || vIndex.empty()) { return false; }
+
+	CDT oResult;
+	if (!ParseValue(oResult, 0) || iToken != vIndex.size()) { return false; }
+
+	oCDT = oResult;
+
+return true;
+}
+
+//
+// Validate and index JSON data
+//
+bool CTPP2JSONFastParser::ParseLazy(CCHAR_P szIData, CCHAR_P szIEnd)
+{
+	ClearContainers();
+
+	szData  = szIData;
+	iLength = szIEnd - szIData;
+	iToken  = 0;
+
+	if (!BuildIndex() || vIndex.empty()) { return false; }
+
+	vSkip.assign(vIndex.size(), 0);
+	if (!IndexValue(0) || iToken != vIndex.size()) { return false; }
+
+	BuildLazyValue(0, oCDT);
+
+return true;
+}
+
+//
+// Delete lazy containers
+//
+void CTPP2JSONFastParser::ClearContainers()
+{
+	if (mContainers.empty()) { return; }
+
+	// Data collector refers to containers of previous call
+	oCDT = CDT(CDT::UNDEF);
+
+	STLW::map<UINT_32, CTPP2JSONLazyContainer *>::iterator itmContainers = mContainers.begin();
+	while (itmContainers != mContainers.end())
+	{
+		delete itmContainers -> second;
+		++itmContainers;
+	}
+	mContainers.clear();
+}
+
+//
+// A destructor
+//
+CTPP2JSONFastParser::~CTPP2JSONFastParser() throw()
+{
+	STLW::map<UINT_32, CTPP2JSONLazyContainer *>::iterator itmContainers = mContainers.begin();
+	while (itmContainers != mContainers.end())
+	{
+		delete itmContainers -> second;
+		++itmContainers;
+	}
+}
+
+} // namespace CTPP
+// End.
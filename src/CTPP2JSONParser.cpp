@@ -32,6 +32,7 @@
 
 #include "CTPP2JSONParser.hpp"
 
+#include "CTPP2JSONFastParser.hpp"
 #include "CTPP2ParserException.hpp"
 #include "CTPP2Util.hpp"
 
@@ -51,7 +52,7 @@ namespace CTPP // C++ Template Engine
 //
 // Constructor
 //
-CTPP2JSONParser::CTPP2JSONParser(CDT & oICDT): oCDT(oICDT)
+CTPP2JSONParser::CTPP2JSONParser(CDT & oICDT, const bool & bIUseFastParser): oCDT(oICDT), bUseFastParser(bIUseFastParser)
 {
 	;;
 }
@@ -598,6 +599,13 @@ return NULL;
 //
 INT_32 CTPP2JSONParser::Parse(CCharIterator szData, CCharIterator szEnd)
 {
+	// Strict JSON
+	if (bUseFastParser)
+	{
+		CTPP2JSONFastParser oFastParser(oCDT);
+		if (oFastParser.Parse(szData(), szEnd())) { return 0; }
+	}
+
 	// Skip white space
 	szData = IsWhiteSpace(szData, szEnd, 0);
 	// Unexpected EOD?
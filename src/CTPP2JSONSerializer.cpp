@@ -0,0 +1,332 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2JSONSerializer.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2JSONSerializer.hpp"
+
+#include "CDT.hpp"
+#include "CTPP2NumberFormat.hpp"
+#include "CTPP2OutputCollector.hpp"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+// Escape classes
+#define C_JSON_ESCAPE_ALWAYS  0x01
+#define C_JSON_ESCAPE_ECMA    0x02
+#define C_JSON_ESCAPE_HTML    0x04
+
+//
+// Characters that should be escaped: control characters, '"', '\\', '/',
+// first byte of U+2028 and U+2029 (0xE2), '\'' in ECMA-262 mode, '<' and '>' in HTML-safe mode
+//
+static const UCHAR_8 aJSONEscape[256] =
+{
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	0, 0, 1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 1,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 4, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const CHAR_8 aHexChars[] = "0123456789abcdef";
+
+#if defined(__SSE2__)
+//
+// Position of lowest set bit
+//
+static inline UINT_32 LowestBit(const UINT_32 iMask)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(iMask);
+#else
+	UINT_32 iPos = 0;
+	while (((iMask >> iPos) & 1) == 0) { ++iPos; }
+
+return iPos;
+#endif
+}
+#endif
+
+//
+// Constructor
+//
+CTPP2JSONSerializer::CTPP2JSONSerializer(OutputCollector  & oICollector,
+                                         const bool       & bIECMAConventions,
+                                         const bool       & bIHTMLSafe): oCollector(oICollector),
+                                                                         iEscapeMask(C_JSON_ESCAPE_ALWAYS),
+                                                                         bECMAConventions(bIECMAConventions),
+                                                                         iBufferLength(0)
+{
+	if (bECMAConventions) { iEscapeMask |= C_JSON_ESCAPE_ECMA; }
+	if (bIHTMLSafe)       { iEscapeMask |= C_JSON_ESCAPE_HTML; }
+}
+
+//
+// Write CDT as JSON value
+//
+void CTPP2JSONSerializer::WriteCDT(const CDT & oCDT)
+{
+	switch (oCDT.GetType())
+	{
+		case CDT::UNDEF:
+			Write("null", 4);
+			break;
+
+		case CDT::INT_VAL:
+			{
+				CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+				Write(szBuf, FormatInteger(oCDT.GetInt(), szBuf));
+			}
+			break;
+
+		case CDT::REAL_VAL:
+			{
+				CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+				Write(szBuf, FormatFloat(oCDT.GetFloat(), CTPP_FLOAT_PRECISION, szBuf));
+			}
+			break;
+
+		case CDT::STRING_INT_VAL:
+		case CDT::STRING_REAL_VAL:
+			{
+				UINT_32 iLength = 0;
+				CCHAR_P szData  = oCDT.GetStringData(iLength);
+				Write(szData, iLength);
+			}
+			break;
+
+		case CDT::STRING_VAL:
+			{
+				UINT_32 iLength = 0;
+				CCHAR_P szData  = oCDT.GetStringData(iLength);
+				Write("\"", 1);
+				WriteString(szData, iLength);
+				Write("\"", 1);
+			}
+			break;
+
+		case CDT::ARRAY_VAL:
+			{
+				Write("[", 1);
+				const UINT_32 iSize = oCDT.Size();
+				for (UINT_32 iPos = 0; iPos < iSize; ++iPos)
+				{
+					if (iPos != 0) { Write(",", 1); }
+					WriteCDT(oCDT.GetCDT(iPos));
+				}
+				Write("]", 1);
+			}
+			break;
+
+		case CDT::HASH_VAL:
+			{
+				Write("{", 1);
+				CDT::ConstIterator itCDTCHash = oCDT.Begin();
+				while (itCDTCHash != oCDT.End())
+				{
+					if (itCDTCHash != oCDT.Begin()) { Write(",", 1); }
+
+					Write("\"", 1);
+					WriteString(itCDTCHash -> first.data(), itCDTCHash -> first.size());
+					Write("\":", 2);
+
+					WriteCDT(itCDTCHash -> second);
+					++itCDTCHash;
+				}
+				Write("}", 1);
+			}
+			break;
+
+		// POINTER_VAL and others
+		default:
+			{
+				const STLW::string sTMP = oCDT.GetString();
+				Write(sTMP.data(), sTMP.size());
+			}
+	}
+}
+
+//
+// Find next character that should be escaped
+//
+CCHAR_P CTPP2JSONSerializer::FindEscape(CCHAR_P szData, CCHAR_P szEnd) const
+{
+#if defined(__SSE2__)
+	const __m128i vControl = _mm_set1_epi8(0x1F);
+	const __m128i vQuote   = _mm_set1_epi8('"');
+	const __m128i vSlash   = _mm_set1_epi8('\\');
+	const __m128i vSolidus = _mm_set1_epi8('/');
+	const __m128i vLSPS    = _mm_set1_epi8(CHAR_8(0xE2));
+	// Characters of optional classes are replaced with '"' when class is not checked
+	const __m128i vApos    = _mm_set1_epi8((iEscapeMask & C_JSON_ESCAPE_ECMA) ? '\'' : '"');
+	const __m128i vLess    = _mm_set1_epi8((iEscapeMask & C_JSON_ESCAPE_HTML) ? '<'  : '"');
+	const __m128i vGreater = _mm_set1_epi8((iEscapeMask & C_JSON_ESCAPE_HTML) ? '>'  : '"');
+
+	while (szEnd - szData >= 16)
+	{
+		const __m128i vBlock = _mm_loadu_si128((const __m128i *)szData);
+
+		__m128i vMatch = _mm_cmpeq_epi8(_mm_max_epu8(vBlock, vControl), vControl);
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vQuote));
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vSlash));
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vSolidus));
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vLSPS));
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vApos));
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vLess));
+		vMatch = _mm_or_si128(vMatch, _mm_cmpeq_epi8(vBlock, vGreater));
+
+		const UINT_32 iMask = _mm_movemask_epi8(vMatch);
+		if (iMask != 0) { return szData + LowestBit(iMask); }
+
+		szData += 16;
+	}
+#endif
+	while (szData != szEnd && (aJSONEscape[UCHAR_8(*szData)] & iEscapeMask) == 0) { ++szData; }
+
+return szData;
+}
+
+//
+// Write escaped string, without quotes
+//
+void CTPP2JSONSerializer::WriteString(CCHAR_P szData, const UINT_32 iDataLength)
+{
+	CCHAR_P szEnd = szData + iDataLength;
+	for (;;)
+	{
+		CCHAR_P szEscape = FindEscape(szData, szEnd);
+		if (szEscape != szData) { Write(szData, szEscape - szData); }
+		if (szEscape == szEnd)  { return; }
+
+		szData = szEscape + 1;
+
+		const UCHAR_8 uCH = *szEscape;
+		switch (uCH)
+		{
+			case '"':  Write("\\\"", 2); continue;
+			case '\\': Write("\\\\", 2); continue;
+			case '/':  Write("\\/",  2); continue;
+			case '\b': Write("\\b",  2); continue;
+			case '\f': Write("\\f",  2); continue;
+			case '\n': Write("\\n",  2); continue;
+			case '\r': Write("\\r",  2); continue;
+			case '\t': Write("\\t",  2); continue;
+			// Checked in ECMA-262 mode only
+			case '\'': Write("\\'",  2); continue;
+
+			case '\v':
+				if (bECMAConventions) { Write("\\v", 2); continue; }
+				break;
+
+			case '\0':
+				if (bECMAConventions) { Write("\\0", 2); continue; }
+				break;
+
+			// U+2028 line separator and U+2029 paragraph separator are not allowed in JavaScript strings
+			case 0xE2:
+				if (szEnd - szEscape >= 3 && UCHAR_8(szEscape[1]) == 0x80 && (UCHAR_8(szEscape[2]) == 0xA8 || UCHAR_8(szEscape[2]) == 0xA9))
+				{
+					Write(UCHAR_8(szEscape[2]) == 0xA8 ? "\\u2028" : "\\u2029", 6);
+					szData = szEscape + 3;
+				}
+				else
+				{
+					Write(szEscape, 1);
+				}
+				continue;
+
+			default:
+				;;
+		}
+
+		// Other control characters, '<' and '>'
+		const CHAR_8 aUnicode[6] = { '\\', 'u', '0', '0', aHexChars[uCH >> 4], aHexChars[uCH & 0xF] };
+		Write(aUnicode, 6);
+	}
+}
+
+//
+// Write data as is
+//
+void CTPP2JSONSerializer::Write(CCHAR_P szData, const UINT_32 iDataLength)
+{
+	if (iBufferLength + iDataLength > C_JSON_SERIALIZER_BUFFER_LEN)
+	{
+		Flush();
+		// Long chunk, do not copy it
+		if (iDataLength >= C_JSON_SERIALIZER_BUFFER_LEN) { oCollector.Collect(szData, iDataLength); return; }
+	}
+
+	memcpy(aBuffer + iBufferLength, szData, iDataLength);
+	iBufferLength += iDataLength;
+}
+
+//
+// Pass buffered data to output collector
+//
+void CTPP2JSONSerializer::Flush()
+{
+	if (iBufferLength == 0) { return; }
+
+	oCollector.Collect(aBuffer, iBufferLength);
+	iBufferLength = 0;
+}
+
+//
+// A destructor
+//
+CTPP2JSONSerializer::~CTPP2JSONSerializer() throw()
+{
+	try { Flush(); } catch (...) { ;; }
+}
+
+} // namespace CTPP
+// End.
@@ -0,0 +1,539 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2JSONStreamParser.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2JSONStreamParser.hpp"
+
+#include "CTPP2ParserException.hpp"
+#include "CTPP2Util.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef HAVE_STRINGS_H
+#include <strings.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+//
+// Constructor
+//
+CTPP2JSONStreamParser::CTPP2JSONStreamParser(CDT & oICDT): oCDT(oICDT),
+                                                           eExpected(VALUE),
+                                                           eCurrentToken(NONE),
+                                                           bKeyToken(false),
+                                                           chQuote('"'),
+                                                           iNumberPhase(0),
+                                                           iUnicodeDigits(0),
+                                                           iUnicode(0),
+                                                           iChunkOffset(0),
+                                                           iLineOffset(0),
+                                                           iLine(1),
+                                                           szChunk(NULL)
+{
+	;;
+}
+
+//
+// Throw syntax error at given position of current chunk
+//
+void CTPP2JSONStreamParser::SyntaxError(CCHAR_P szReason, CCHAR_P szPos) const
+{
+	const UINT_64 iOffset = iChunkOffset + (szPos - szChunk);
+
+	throw CTPPParserSyntaxError(szReason, iLine, UINT_32(iOffset - iLineOffset + 1));
+}
+
+//
+// Throw error describing expected token
+//
+void CTPP2JSONStreamParser::UnexpectedToken(CCHAR_P szPos) const
+{
+	switch (eExpected)
+	{
+		case VALUE:
+			if (vStack.empty())         { SyntaxError("not an JSON object", szPos);       }
+			if (vStack.back().is_hash)  { SyntaxError("expected value after ':'", szPos); }
+			SyntaxError("expected value after ','", szPos);
+
+		case VALUE_OR_CLOSE:
+			SyntaxError("expected value or ']'", szPos);
+
+		case KEY:
+			SyntaxError("expected key after ','", szPos);
+
+		case KEY_OR_CLOSE:
+			SyntaxError("expected key or '}'", szPos);
+
+		case COLON:
+			SyntaxError("expected ':' after key", szPos);
+
+		case COMMA_OR_CLOSE:
+			if (vStack.back().is_hash)  { SyntaxError("',' or '}' expected", szPos); }
+			SyntaxError("',' or ']' expected", szPos);
+
+		default:
+			SyntaxError("syntax error", szPos);
+	}
+}
+
+//
+// Register line feed
+//
+void CTPP2JSONStreamParser::LineFeed(CCHAR_P szPos)
+{
+	++iLine;
+	iLineOffset = iChunkOffset + (szPos - szChunk) + 1;
+}
+
+//
+// Get slot for new value
+//
+CDT & CTPP2JSONStreamParser::ValueSlot()
+{
+	if (vStack.empty()) { return oCDT; }
+
+	Frame & oFrame = vStack.back();
+	if (oFrame.is_hash) { return (*oFrame.container)[sKey]; }
+
+return (*oFrame.container)[oFrame.index];
+}
+
+//
+// Finish value
+//
+void CTPP2JSONStreamParser::ValueDone()
+{
+	eExpected = vStack.empty() ? NOTHING : COMMA_OR_CLOSE;
+}
+
+//
+// Open ARRAY or HASH
+//
+void CTPP2JSONStreamParser::OpenContainer(const bool bIsHash)
+{
+	CDT & oContainer = ValueSlot();
+	oContainer = CDT(bIsHash ? CDT::HASH_VAL : CDT::ARRAY_VAL);
+
+	// Parent does not change until this container is closed, so pointer stays valid
+	Frame oFrame = { &oContainer, 0, bIsHash };
+	vStack.push_back(oFrame);
+
+	eExpected = bIsHash ? KEY_OR_CLOSE : VALUE_OR_CLOSE;
+}
+
+//
+// Finish string token
+//
+void CTPP2JSONStreamParser::StringDone()
+{
+	eCurrentToken = NONE;
+
+	if (bKeyToken)
+	{
+		sKey.swap(sTMPBuf);
+		eExpected = COLON;
+		return;
+	}
+
+	ValueSlot() = sTMPBuf;
+	ValueDone();
+}
+
+//
+// Finish number token
+//
+void CTPP2JSONStreamParser::NumberDone()
+{
+	eCurrentToken = NONE;
+
+	// Numeric key is used as is
+	if (bKeyToken)
+	{
+		sKey.swap(sTMPBuf);
+		eExpected = COLON;
+		return;
+	}
+
+	CDT & oValue = ValueSlot();
+	if (iNumberPhase == 0)
+	{
+		CCHAR_P szDigits = sTMPBuf.data();
+		CCHAR_P szEnd    = szDigits + sTMPBuf.size();
+
+		bool bNegative = false;
+		if (*szDigits == '-' || *szDigits == '+') { bNegative = (*szDigits == '-'); ++szDigits; }
+
+		// Plain decimal number; sign only, leading zeros (octal) and too long numbers are read by sscanf
+		if (szDigits != szEnd && szEnd - szDigits <= 18 && (*szDigits != '0' || szEnd - szDigits == 1))
+		{
+			INT_64 iValue = 0;
+			for (; szDigits != szEnd; ++szDigits) { iValue = iValue * 10 + (*szDigits - '0'); }
+
+			oValue = bNegative ? -iValue : iValue;
+		}
+		else
+		{
+			long long iLL = 0;
+			sscanf(sTMPBuf.c_str(), "%lli", &iLL);
+
+			oValue = INT_64(iLL);
+		}
+	}
+	else
+	{
+		oValue = W_FLOAT(strtod(sTMPBuf.c_str(), NULL));
+	}
+
+	ValueDone();
+}
+
+//
+// Finish bare word token
+//
+void CTPP2JSONStreamParser::WordDone(CCHAR_P szPos)
+{
+	eCurrentToken = NONE;
+
+	CDT & oValue = ValueSlot();
+	if      (strcasecmp("null",  sTMPBuf.c_str()) == 0) { oValue = CDT(CDT::UNDEF); }
+	else if (strcasecmp("false", sTMPBuf.c_str()) == 0) { oValue = 0; }
+	else if (strcasecmp("true",  sTMPBuf.c_str()) == 0) { oValue = 1; }
+	// Unexpected data found
+	else { UnexpectedToken(szPos); }
+
+	ValueDone();
+}
+
+//
+// Parse token start or structural character
+//
+void CTPP2JSONStreamParser::ParseStructural(CCHAR_P szPos)
+{
+	const CHAR_8 chData = *szPos;
+
+	switch (eExpected)
+	{
+		case VALUE_OR_CLOSE:
+			if (chData == ']') { vStack.pop_back(); ValueDone(); return; }
+			// No break here
+
+		case VALUE:
+			if      (chData == '{') { OpenContainer(true);  }
+			else if (chData == '[') { OpenContainer(false); }
+			else if (chData == '"' || chData == '\'')
+			{
+				sTMPBuf.erase();
+				bKeyToken     = false;
+				chQuote       = chData;
+				eCurrentToken = STRING;
+			}
+			else if ((chData >= '0' && chData <= '9') || chData == '-' || chData == '+')
+			{
+				sTMPBuf.assign(1, chData);
+				bKeyToken     = false;
+				iNumberPhase  = 0;
+				eCurrentToken = NUMBER;
+			}
+			else if ((chData >= 'a' && chData <= 'z') || (chData >= 'A' && chData <= 'Z'))
+			{
+				sTMPBuf.assign(1, chData);
+				eCurrentToken = WORD;
+			}
+			else { UnexpectedToken(szPos); }
+			return;
+
+		case KEY_OR_CLOSE:
+			if (chData == '}') { vStack.pop_back(); ValueDone(); return; }
+			// No break here
+
+		case KEY:
+			if (chData == '"' || chData == '\'')
+			{
+				sTMPBuf.erase();
+				bKeyToken     = true;
+				chQuote       = chData;
+				eCurrentToken = STRING;
+			}
+			else if ((chData >= '0' && chData <= '9') || chData == '-' || chData == '+')
+			{
+				sTMPBuf.assign(1, chData);
+				bKeyToken     = true;
+				iNumberPhase  = 0;
+				eCurrentToken = NUMBER;
+			}
+			else { UnexpectedToken(szPos); }
+			return;
+
+		case COLON:
+			if (chData != ':') { UnexpectedToken(szPos); }
+			eExpected = VALUE;
+			return;
+
+		case COMMA_OR_CLOSE:
+			{
+				Frame & oFrame = vStack.back();
+				if (chData == ',')
+				{
+					if (oFrame.is_hash) { eExpected = KEY; }
+					else
+					{
+						++oFrame.index;
+						eExpected = VALUE;
+					}
+				}
+				else if ((chData == '}' && oFrame.is_hash) || (chData == ']' && !oFrame.is_hash))
+				{
+					vStack.pop_back();
+					ValueDone();
+				}
+				else { UnexpectedToken(szPos); }
+			}
+			return;
+
+		default:
+			UnexpectedToken(szPos);
+	}
+}
+
+//
+// Parse next chunk of JSON data
+//
+INT_32 CTPP2JSONStreamParser::Parse(CCHAR_P szData, CCHAR_P szEnd)
+{
+	szChunk = szData;
+
+	CCHAR_P szPos = szData;
+	while (szPos != szEnd)
+	{
+		const CHAR_8 chData = *szPos;
+		switch (eCurrentToken)
+		{
+			case NONE:
+				if      (chData == ' ' || chData == '\t' || chData == '\r') { ;; }
+				else if (chData == '\n') { LineFeed(szPos);         }
+				else if (chData == '/')  { eCurrentToken = SLASH;   }
+				else                     { ParseStructural(szPos);  }
+				break;
+
+			case STRING:
+				{
+					// Copy run of plain characters at once
+					CCHAR_P szRun = szPos;
+					while (szPos != szEnd && *szPos != chQuote && *szPos != '\\')
+					{
+						if (*szPos == '\n') { LineFeed(szPos); }
+						++szPos;
+					}
+					sTMPBuf.append(szRun, szPos - szRun);
+
+					if (szPos == szEnd) { continue; }
+
+					if (*szPos == '\\') { eCurrentToken = STRING_ESCAPE; }
+					else                { StringDone();                  }
+				}
+				break;
+
+			case STRING_ESCAPE:
+				eCurrentToken = STRING;
+				switch (chData)
+				{
+					// man ascii
+					case 'a': sTMPBuf += '\a'; break;
+					case 'b': sTMPBuf += '\b'; break;
+					case 't': sTMPBuf += '\t'; break;
+					case 'n': sTMPBuf += '\n'; break;
+					case 'v': sTMPBuf += '\v'; break;
+					case 'f': sTMPBuf += '\f'; break;
+					case 'r': sTMPBuf += '\r'; break;
+					// Unicode + 4 digits
+					case 'u':
+						iUnicode       = 0;
+						iUnicodeDigits = 0;
+						eCurrentToken  = STRING_UNICODE;
+						break;
+					case '\n':
+						LineFeed(szPos);
+						// No break here
+					default:
+						sTMPBuf += chData;
+				}
+				break;
+
+			case STRING_UNICODE:
+				{
+					iUnicode <<= 4;
+					if      (chData >= '0' && chData <= '9') { iUnicode += chData - '0';      }
+					else if (chData >= 'a' && chData <= 'f') { iUnicode += chData - 'a' + 10; }
+					else if (chData >= 'A' && chData <= 'F') { iUnicode += chData - 'A' + 10; }
+					else { SyntaxError("invalid unicode escape sequence", szPos); }
+
+					if (++iUnicodeDigits == 4)
+					{
+						UCHAR_8 aBuffer[6];
+						const INT_32 iCharLength = UnicodeToUTF8(iUnicode, aBuffer);
+						sTMPBuf.append((CCHAR_P)aBuffer, iCharLength);
+
+						eCurrentToken = STRING;
+					}
+				}
+				break;
+
+			case NUMBER:
+				{
+					// [+-]digits[.digits[(e|E)[+-]digits]]
+					const bool bDigit = (chData >= '0' && chData <= '9');
+					bool bConsumed = true;
+					switch (iNumberPhase)
+					{
+						case 0:
+							if      (chData == '.') { iNumberPhase = 1; }
+							else if (!bDigit)       { bConsumed = false; }
+							break;
+						case 1:
+							if      (chData == 'e' || chData == 'E') { iNumberPhase = 2;  }
+							else if (!bDigit)                        { bConsumed = false; }
+							break;
+						case 2:
+							if      (chData == '-' || chData == '+') { iNumberPhase = 3; }
+							else if (bDigit)                         { iNumberPhase = 4; }
+							else { SyntaxError("exponent has no digits", szPos); }
+							break;
+						case 3:
+							if (!bDigit) { SyntaxError("exponent has no digits", szPos); }
+							iNumberPhase = 4;
+							break;
+						default:
+							if (!bDigit) { bConsumed = false; }
+					}
+
+					if (bConsumed) { sTMPBuf += chData; break; }
+
+					// Character after number is parsed as usual
+					NumberDone();
+				}
+				continue;
+
+			case WORD:
+				if ((chData >= 'a' && chData <= 'z') || (chData >= 'A' && chData <= 'Z')) { sTMPBuf += chData; break; }
+
+				// Character after word is parsed as usual
+				WordDone(szPos);
+				continue;
+
+			case SLASH:
+				if      (chData == '*') { eCurrentToken = BLOCK_COMMENT; }
+				else if (chData == '/') { eCurrentToken = LINE_COMMENT;  }
+				else                    { UnexpectedToken(szPos);        }
+				break;
+
+			case LINE_COMMENT:
+				if (chData == '\n')
+				{
+					LineFeed(szPos);
+					eCurrentToken = NONE;
+				}
+				break;
+
+			case BLOCK_COMMENT:
+				if      (chData == '*')  { eCurrentToken = BLOCK_COMMENT_STAR; }
+				else if (chData == '\n') { LineFeed(szPos);                    }
+				break;
+
+			case BLOCK_COMMENT_STAR:
+				if      (chData == '/')  { eCurrentToken = NONE;          }
+				else if (chData != '*')  { eCurrentToken = BLOCK_COMMENT; }
+				if      (chData == '\n') { LineFeed(szPos);               }
+				break;
+		}
+		++szPos;
+	}
+
+	iChunkOffset += szEnd - szData;
+
+return 0;
+}
+
+//
+// Finish parsing
+//
+INT_32 CTPP2JSONStreamParser::Finish()
+{
+	// Errors are reported at the end of data
+	szChunk = NULL;
+
+	switch (eCurrentToken)
+	{
+		case STRING:
+		case STRING_ESCAPE:
+			SyntaxError("expected terminating character but end of JSON object found", NULL);
+
+		case STRING_UNICODE:
+			SyntaxError("invalid unicode escape sequence", NULL);
+
+		case NUMBER:
+			if (iNumberPhase == 2 || iNumberPhase == 3) { SyntaxError("exponent has no digits", NULL); }
+			NumberDone();
+			break;
+
+		case WORD:
+			WordDone(NULL);
+			break;
+
+		case SLASH:
+			UnexpectedToken(NULL);
+
+		default:
+			eCurrentToken = NONE;
+	}
+
+	if (eExpected != NOTHING)
+	{
+		if (eExpected == VALUE && vStack.empty()) { SyntaxError("empty JSON object", NULL); }
+
+		SyntaxError("unexpected end of JSON object", NULL);
+	}
+
+return 0;
+}
+
+//
+// A destructor
+//
+CTPP2JSONStreamParser::~CTPP2JSONStreamParser() throw()
+{
+	;;
+}
+
+} // namespace CTPP
+// End.
@@ -0,0 +1,273 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2NumberFormat.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2NumberFormat.hpp"
+#include "CTPP2DTOA.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace CTPP // C++ Template Engine
+{
+
+/** Pairs of decimal digits, 00 .. 99 */
+static const CHAR_8 aDigitPairs[] = "00010203040506070809"
+                                    "10111213141516171819"
+                                    "20212223242526272829"
+                                    "30313233343536373839"
+                                    "40414243444546474849"
+                                    "50515253545556575859"
+                                    "60616263646566676869"
+                                    "70717273747576777879"
+                                    "80818283848586878889"
+                                    "90919293949596979899";
+
+/** Powers of 10 exactly representable as double */
+static const W_FLOAT aPowersOf10[] = { 1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,
+                                       1E8,  1E9,  1E10, 1E11, 1E12, 1E13, 1E14, 1E15,
+                                       1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22 };
+
+/** Max. exact power of 10 */
+#define C_MAX_EXACT_POW10 22
+
+//
+// Write unsigned value to the end of buffer
+//
+static CHAR_P FormatUnsigned(UINT_64 iValue, CHAR_P szEnd)
+{
+	while (iValue >= 100)
+	{
+		const UINT_32 iPair = UINT_32(iValue % 100) * 2;
+		iValue /= 100;
+		*--szEnd = aDigitPairs[iPair + 1];
+		*--szEnd = aDigitPairs[iPair];
+	}
+
+	if (iValue >= 10)
+	{
+		const UINT_32 iPair = UINT_32(iValue) * 2;
+		*--szEnd = aDigitPairs[iPair + 1];
+		*--szEnd = aDigitPairs[iPair];
+	}
+	else
+	{
+		*--szEnd = CHAR_8('0' + iValue);
+	}
+
+return szEnd;
+}
+
+//
+// Get significant digits of value rounded to iPrecision digits without libc or bignum arithmetic
+//
+static bool FastDigits(const W_FLOAT   dValue,
+                       const INT_32    iPrecision,
+                       CHAR_P          szDigits,
+                       INT_32        & iDigits,
+                       INT_32        & iExponent)
+{
+	INT_32 iExp = INT_32(floor(log10(dValue)));
+
+	// Scale value to [10^(P-1), 10^P)
+	for (INT_32 iTry = 0; iTry < 2; ++iTry)
+	{
+		const INT_32 iScale = iPrecision - 1 - iExp;
+		if (iScale > C_MAX_EXACT_POW10 || -iScale > C_MAX_EXACT_POW10) { return false; }
+
+		// Multiplication and division by exact power of 10 are correctly rounded
+		const W_FLOAT dScaled = iScale >= 0 ? dValue * aPowersOf10[iScale] : dValue / aPowersOf10[-iScale];
+
+		if      (dScaled <  aPowersOf10[iPrecision - 1]) { --iExp; continue; }
+		else if (dScaled >= aPowersOf10[iPrecision])     { ++iExp; continue; }
+
+		W_FLOAT dInteger = floor(dScaled);
+		const W_FLOAT dFraction = dScaled - dInteger;
+
+		// Scaling error is at most half of ulp; too close to half-way, rounding direction is not known
+		if (fabs(dFraction - 0.5) <= nextafter(dScaled, HUGE_VAL) - dScaled) { return false; }
+
+		if (dFraction > 0.5) { dInteger += 1; }
+
+		UINT_64 iMantissa = UINT_64(dInteger);
+		// 9.99..95 -> 10.0
+		if (iMantissa == UINT_64(aPowersOf10[iPrecision]))
+		{
+			iMantissa /= 10;
+			++iExp;
+		}
+
+		// Drop trailing zeroes
+		iDigits = iPrecision;
+		while (iDigits > 1 && iMantissa % 10 == 0)
+		{
+			iMantissa /= 10;
+			--iDigits;
+		}
+
+		FormatUnsigned(iMantissa, szDigits + iDigits);
+		iExponent = iExp;
+		return true;
+	}
+
+return false;
+}
+
+//
+// Format integer
+//
+UINT_32 FormatInteger(const INT_64 iValue, CHAR_P szBuffer)
+{
+	CHAR_8 szTMP[24];
+	CHAR_P szEnd = szTMP + sizeof(szTMP);
+
+	// Two's complement magnitude, works for INT_64 minimum too
+	const UINT_64 iMagnitude = iValue < 0 ? ~UINT_64(iValue) + 1 : UINT_64(iValue);
+
+	CHAR_P szStart = FormatUnsigned(iMagnitude, szEnd);
+	if (iValue < 0) { *--szStart = '-'; }
+
+	const UINT_32 iLength = UINT_32(szEnd - szStart);
+	memcpy(szBuffer, szStart, iLength);
+
+return iLength;
+}
+
+//
+// Format floating point value
+//
+UINT_32 FormatFloat(const W_FLOAT dValue, const INT_32 iPrecision, CHAR_P szBuffer)
+{
+	// Infinity, NaN and unusual precision
+	if (dValue != dValue || dValue - dValue != 0 || iPrecision < 1 || iPrecision > 17)
+	{
+		CHAR_8 szTMP[64];
+		const INT_32 iLength = snprintf(szTMP, sizeof(szTMP), "%.*G", iPrecision, dValue);
+		memcpy(szBuffer, szTMP, iLength);
+		return iLength;
+	}
+
+	CHAR_P szPos = szBuffer;
+	if (signbit(dValue)) { *szPos++ = '-'; }
+
+	const W_FLOAT dMagnitude = fabs(dValue);
+	if (dMagnitude == 0)
+	{
+		*szPos++ = '0';
+		return UINT_32(szPos - szBuffer);
+	}
+
+	// Integer value
+	if (dMagnitude < aPowersOf10[iPrecision] && dMagnitude == floor(dMagnitude))
+	{
+		return UINT_32(szPos - szBuffer) + FormatInteger(INT_64(dMagnitude), szPos);
+	}
+
+	CHAR_8  szDigits[32];
+	INT_32  iDigits   = 0;
+	INT_32  iExponent = 0;
+	if (!FastDigits(dMagnitude, iPrecision, szDigits, iDigits, iExponent))
+	{
+		// Exact conversion
+		Bigint * aFreeList[Kmax + 1];
+		for (UINT_32 iPos = 0; iPos <= Kmax; ++iPos) { aFreeList[iPos] = NULL; }
+		AllocatedBlock * aBlocks = NULL;
+
+		INT_32 iSign  = 0;
+		CHAR_P szEnd  = NULL;
+		CHAR_P szDTOA = ctpp_dtoa(&aBlocks, aFreeList, dMagnitude, 2, iPrecision, &iExponent, &iSign, &szEnd);
+
+		iDigits = INT_32(szEnd - szDTOA);
+		memcpy(szDigits, szDTOA, iDigits);
+		freedtoa(&aBlocks);
+
+		// Trailing zeroes are left after rounding of ties
+		while (iDigits > 1 && szDigits[iDigits - 1] == '0') { --iDigits; }
+
+		--iExponent;
+	}
+
+	// Exponential notation, d.dddE+XX
+	if (iExponent < -4 || iExponent >= iPrecision)
+	{
+		*szPos++ = szDigits[0];
+		if (iDigits > 1)
+		{
+			*szPos++ = '.';
+			memcpy(szPos, szDigits + 1, iDigits - 1);
+			szPos += iDigits - 1;
+		}
+
+		*szPos++ = 'E';
+		*szPos++ = iExponent < 0 ? '-' : '+';
+
+		const UINT_32 iAbsExponent = iExponent < 0 ? -iExponent : iExponent;
+		// At least 2 digits
+		if (iAbsExponent < 10) { *szPos++ = '0'; }
+		szPos += FormatInteger(iAbsExponent, szPos);
+	}
+	// Fixed notation, integer part
+	else if (iExponent >= 0)
+	{
+		const INT_32 iIntegerDigits = iExponent + 1;
+		if (iDigits <= iIntegerDigits)
+		{
+			memcpy(szPos, szDigits, iDigits);
+			szPos += iDigits;
+			memset(szPos, '0', iIntegerDigits - iDigits);
+			szPos += iIntegerDigits - iDigits;
+		}
+		else
+		{
+			memcpy(szPos, szDigits, iIntegerDigits);
+			szPos += iIntegerDigits;
+			*szPos++ = '.';
+			memcpy(szPos, szDigits + iIntegerDigits, iDigits - iIntegerDigits);
+			szPos += iDigits - iIntegerDigits;
+		}
+	}
+	// Fixed notation, 0.000ddd
+	else
+	{
+		*szPos++ = '0';
+		*szPos++ = '.';
+		memset(szPos, '0', -iExponent - 1);
+		szPos += -iExponent - 1;
+		memcpy(szPos, szDigits, iDigits);
+		szPos += iDigits;
+	}
+
+return UINT_32(szPos - szBuffer);
+}
+
+} // namespace CTPP
+// End.
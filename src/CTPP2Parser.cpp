@@ -31,10 +31,16 @@
  */
 
 #include "CTPP2Parser.hpp"
+#include "CTPP2GetText.hpp"
 
+#include "CTPP2Logger.hpp"
 #include "CTPP2ParserException.hpp"
 #include "CTPP2SourceLoader.hpp"
+#include "CTPP2Sprintf.hpp"
+#include "CTPP2SyscallContext.hpp"
+#include "CTPP2SyscallFactory.hpp"
 #include "CTPP2Util.hpp"
+#include "CTPP2VMSyscall.hpp"
 
 #include <stdio.h>
 
@@ -199,6 +205,106 @@ ForeachFlagLocker::~ForeachFlagLocker() throw()
 	bInForeach = bOldInForeach;
 }
 
+//
+// Compare name with lowercase keyword, case-insensitive
+//
+static bool IsKeyword(CCHAR_P szName, const UINT_32 iNameLength, CCHAR_P szKeyword)
+{
+	for (UINT_32 iPos = 0; iPos < iNameLength; ++iPos)
+	{
+		CHAR_8 chTMP = szName[iPos];
+		if (chTMP >= 'A' && chTMP <= 'Z') { chTMP |= 0x20; }
+
+		if (szKeyword[iPos] == '\0' || chTMP != szKeyword[iPos]) { return false; }
+	}
+
+return szKeyword[iNameLength] == '\0';
+}
+
+//
+// Escaping rules of <TMPL_escape "name">
+//
+static bool GetEscapeType(const STLW::string & sName, eCTPP2EscapeType & eEscapeType)
+{
+	static CCHAR_P          aNames[] = { "html",      "xml",      "wml",      "url",      "uri",      "none",      NULL };
+	static eCTPP2EscapeType aTypes[] = { ESCAPE_HTML, ESCAPE_XML, ESCAPE_WML, ESCAPE_URL, ESCAPE_URI, ESCAPE_NONE       };
+
+	for (UINT_32 iPos = 0; aNames[iPos] != NULL; ++iPos)
+	{
+		if (IsKeyword(sName.data(), sName.size(), aNames[iPos]))
+		{
+			eEscapeType = aTypes[iPos];
+			return true;
+		}
+	}
+
+return false;
+}
+
+//
+// Messages of functions evaluated at compile time are dropped, errors are reported at run time
+//
+class SilentLogger:
+  public Logger
+{
+public:
+	INT_32 WriteLog(const UINT_32  iPriority,
+	                CCHAR_P        szString,
+	                const UINT_32  iStringLen) { return 0; }
+
+	~SilentLogger() throw() { ;; }
+};
+
+//
+// Functions which result is already escaped, and escaping rules it satisfies
+//
+struct EscapingFunction
+{
+	/** Function name, lowercase    */
+	CCHAR_P             name;
+	/** Escaping rules of result    */
+	eCTPP2EscapeType    type;
+};
+
+static const EscapingFunction aEscapingFunctions[] =
+{
+	{ "htmlescape", ESCAPE_HTML }, { "xmlescape",  ESCAPE_XML  }, { "wmlescape",  ESCAPE_WML  },
+	{ "urlescape",  ESCAPE_URL  }, { "urlescape",  ESCAPE_URI  },
+	{ "uriescape",  ESCAPE_URL  }, { "uriescape",  ESCAPE_URI  },
+	// URL-escaped parameters joined with "&amp;" and hidden form field with HTML-escaped attributes
+	{ "href_param", ESCAPE_HTML }, { "href_param", ESCAPE_XML  },
+	{ "form_param", ESCAPE_HTML }, { "form_param", ESCAPE_XML  },
+	{ NULL,         ESCAPE_NONE }
+};
+
+//
+// Check that expression is a call of function which result is already escaped with given rules;
+// JSON() and JSONESCAPE() results are safe in JavaScript only, so they are always escaped
+//
+static bool IsEscapingCall(const STLW::string & sExpr, const eCTPP2EscapeType eEscapeType)
+{
+	// Function name
+	STLW::string::size_type iNameLength = 0;
+	while (iNameLength < sExpr.size())
+	{
+		const CHAR_8 chTMP = sExpr[iNameLength];
+		if (!((chTMP >= 'a' && chTMP <= 'z') || (chTMP >= 'A' && chTMP <= 'Z') || (chTMP >= '0' && chTMP <= '9') || chTMP == '_')) { break; }
+		++iNameLength;
+	}
+
+	// Function call only, "(" follows name
+	STLW::string::size_type iPos = iNameLength;
+	while (iPos < sExpr.size() && (sExpr[iPos] == ' ' || sExpr[iPos] == '\t' || sExpr[iPos] == '\r' || sExpr[iPos] == '\n')) { ++iPos; }
+	if (iNameLength == 0 || iPos == sExpr.size() || sExpr[iPos] != '(') { return false; }
+
+	for (const EscapingFunction * pFunction = aEscapingFunctions; pFunction -> name != NULL; ++pFunction)
+	{
+		if (pFunction -> type == eEscapeType && IsKeyword(sExpr.data(), iNameLength, pFunction -> name)) { return true; }
+	}
+
+return false;
+}
+
 //
 // CTPP2 reserved words
 //
@@ -238,6 +344,8 @@ CTPP2Parser::CTPP2Keyword CTPP2Parser::aKeywords [] =
 	{ TMPL_BREAK_TOK,   sizeof(TMPL_BREAK_TOK),   TMPL_break   },
 	{ TMPL_BLOCK_TOK,   sizeof(TMPL_BLOCK_TOK),   TMPL_block   },
 	{ TMPL_VERBOSE_TOK, sizeof(TMPL_VERBOSE_TOK), TMPL_verbose },
+	{ TMPL_CACHE_TOK,   sizeof(TMPL_CACHE_TOK),   TMPL_cache   },
+	{ TMPL_ESCAPE_TOK,  sizeof(TMPL_ESCAPE_TOK),  TMPL_escape  },
 	// Terminator
 	{ NULL,             0, UNDEF }
 };
@@ -255,11 +363,18 @@ CTPP2Parser::CTPP2Parser(CTPP2SourceLoader   * pISourceLoader,
                                                                   oStaticData(pCTPP2Compiler -> oStaticData),
                                                                   oStaticText(pCTPP2Compiler -> oStaticText),
                                                                   sSourceName(sISourceName),
+                                                                  iSourceHash(0),
                                                                   bInForeach(bIInForeach),
                                                                   iRecursionLevel(iIRecursionLevel),
                                                                   bInsideComplexVariable(false),
                                                                   bVerboseMode(false),
-                                                                  bInBlock(false)
+                                                                  bInBlock(false),
+                                                                  iCacheLoopLevel(0),
+                                                                  eEscapeMode(ESCAPE_NONE),
+                                                                  pGetText(NULL),
+                                                                  pSyscallFactory(NULL),
+                                                                  iLastCallIP(0),
+                                                                  iLastCallEndIP(0)
 {
 	iSourceNameId = pCTPP2Compiler -> StoreSourceName(sSourceName.c_str(), sSourceName.size());
 }
@@ -275,6 +390,13 @@ INT_32 CTPP2Parser::Compile(const UINT_32 & iHalt)
 	// Impossible happened.
 	if (szData == NULL) { return -1; }
 
+	// FNV-1a hash of source, part of names of cached fragments
+	iSourceHash = 2166136261U;
+	for (UINT_32 iPos = 0; iPos < iTemplateSize; ++iPos)
+	{
+		iSourceHash = (iSourceHash ^ UCHAR_8(szData()[iPos])) * 16777619U;
+	}
+
 	CCharIterator szEnd = szData() + iTemplateSize;
 	CCharIterator sTMP = Parse(szData, szEnd);
 
@@ -317,6 +439,25 @@ void CTPP2Parser::SetBlockArgSizeMap(const CTPP2Parser::BlockArgSizeMapType & mI
 //
 CTPP2Parser::BlockArgSizeMapType CTPP2Parser::GetBlockArgSizeMap() const { return mBlockArgSizes; }
 
+//
+// Set default escaping of TMPL_var
+//
+void CTPP2Parser::SetEscapeMode(const eCTPP2EscapeType eIEscapeMode) { eEscapeMode = eIEscapeMode; }
+
+//
+// Set catalogs for compile-time translation
+//
+void CTPP2Parser::SetGetText(const CTPP2GetText * pIGetText, const STLW::string & sILanguage)
+{
+	pGetText  = pIGetText;
+	sLanguage = sILanguage;
+}
+
+//
+// Set functions for compile-time evaluation
+//
+void CTPP2Parser::SetSyscallFactory(const SyscallFactory * pISyscallFactory) { pSyscallFactory = pISyscallFactory; }
+
 // Simple tokens: open and close tags, operators, variables, strings and numbers //////////////////////////////////////////////////////////////////////////////////
 
 //
@@ -396,9 +537,21 @@ return NULL;
 // Function [a-zA-Z_][a-zA-Z0-9_]( Expr [, Expr2 ... ] )
 //
 CCharIterator CTPP2Parser::IsFunc(CCharIterator szData, CCharIterator szEnd, CCharIterator & sFuncEnd, UINT_32 & iFunctionParams)
+{
+	STLW::vector<CDT> vConstArgs;
+
+return IsFunc(szData, szEnd, sFuncEnd, iFunctionParams, vConstArgs);
+}
+
+//
+// Function [a-zA-Z_][a-zA-Z0-9_]( Expr [, Expr2 ... ] ), collect values of literal arguments
+//
+CCharIterator CTPP2Parser::IsFunc(CCharIterator szData, CCharIterator szEnd, CCharIterator & sFuncEnd, UINT_32 & iFunctionParams, STLW::vector<CDT> & vConstArgs)
 {
 	REPORTER("IsFunc", szData());
 
+	bool bConstArgs = true;
+
 	eCTPP2ExprOperator eResultOperator = EXPR_UNDEF;
 	CCharIterator sTMP = IsFuncName(szData, szEnd);
 
@@ -423,12 +576,26 @@ CCharIterator CTPP2Parser::IsFunc(CCharIterator szData, CCharIterator szEnd, CCh
 		for(;;)
 		{
 			szData = sTMP;
+			const UINT_32 iArgIP = pCTPP2Compiler -> GetCodeSize();
 			// Expression
 			sTMP = LogicalOrExpr(szData, szEnd, eResultOperator);
 			// Cannot parse expression or variable name after ',' token
 			if (sTMP == NULL) { throw CTPPParserSyntaxError("expected expression after ','", szData.GetLine(), szData.GetLinePos()); }
 
 			++iFunctionParams;
+
+			// Literal is compiled to single PUSH
+			if (bConstArgs && pCTPP2Compiler -> GetCodeSize() == iArgIP + 1)
+			{
+				if      (eResultOperator == EXPR_STRING_VALUE) { vConstArgs.push_back(sTMPBuf);  }
+				else if (eResultOperator == EXPR_INT_VALUE)    { vConstArgs.push_back(iIntData); }
+				else                                           { bConstArgs = false;             }
+			}
+			else
+			{
+				bConstArgs = false;
+			}
+
 			// Skip white space
 			sTMP = IsWhiteSpace(sTMP, szEnd, 0);
 
@@ -436,12 +603,70 @@ CCharIterator CTPP2Parser::IsFunc(CCharIterator szData, CCharIterator szEnd, CCh
 			if      (*sTMP == ',') { ++sTMP; }
 			else if (*sTMP == ')') { ++sTMP; break; }
 		}
+
 		return sTMP;
 	}
 
 return NULL;
 }
 
+//
+// Translate call of GETTEXT or _ with literal arguments at compile time
+//
+bool CTPP2Parser::TranslateCall(const STLW::string & sFuncName, const STLW::vector<CDT> & vArgs, STLW::string & sResult) const
+{
+	if (!IsKeyword(sFuncName.data(), sFuncName.size(), "gettext") && !IsKeyword(sFuncName.data(), sFuncName.size(), "_")) { return false; }
+
+	// _(msgid[, msgid_plural, n][, domain])
+	const UINT_32 iArgNum = vArgs.size();
+	const bool    bPlural = iArgNum >= 3;
+	if (iArgNum > 4 || vArgs[0].GetType() != CDT::STRING_VAL) { return false; }
+	if (bPlural && (vArgs[1].GetType() != CDT::STRING_VAL || vArgs[2].GetType() != CDT::INT_VAL)) { return false; }
+
+	STLW::string sDomain;
+	if (iArgNum == 2 || iArgNum == 4)
+	{
+		if (vArgs[iArgNum - 1].GetType() != CDT::STRING_VAL) { return false; }
+		sDomain = vArgs[iArgNum - 1].GetString();
+	}
+
+	// Catalog may be given at run time only
+	if (!pGetText -> HasTranslation(sLanguage, sDomain)) { return false; }
+
+	try
+	{
+		if (bPlural) { sResult = pGetText -> FindPluralMessage(sLanguage, vArgs[0].GetString(), vArgs[1].GetString(), (UINT_32)vArgs[2].GetInt(), sDomain); }
+		else         { sResult = pGetText -> FindMessage(sLanguage, vArgs[0].GetString(), sDomain);                                                  }
+	}
+	// Broken plural form is reported at run time
+	catch(CTPPGetTextError & e) { return false; }
+
+return true;
+}
+
+//
+// Evaluate call of pure function with literal arguments at compile time
+//
+bool CTPP2Parser::EvaluateCall(const STLW::string & sFuncName, const STLW::vector<CDT> & vArgs, CDT & oResult) const
+{
+	SyscallHandler * pHandler = pSyscallFactory -> GetHandlerByName(sFuncName.c_str());
+	if (pHandler == NULL || (pHandler -> GetCapabilities() & CTPP2_SYSCALL_PURE) == 0) { return false; }
+
+	// Arguments in stack frame are in reverse order
+	STLW::vector<CDT> vFrame(vArgs.rbegin(), vArgs.rend());
+
+	SyscallContext oContext;
+	SilentLogger   oLogger;
+	try
+	{
+		if (pHandler -> ContextHandler(vFrame.empty() ? NULL : &vFrame[0], vFrame.size(), oResult, oContext, oLogger) != 0) { return false; }
+	}
+	// Error is reported at run time
+	catch(...) { return false; }
+
+return oResult.GetType() == CDT::STRING_VAL || oResult.GetType() == CDT::INT_VAL;
+}
+
 //
 // CTPP2 function a-zA-Z_[a-zA-Z0-9_]
 //
@@ -1391,12 +1616,65 @@ CCharIterator CTPP2Parser::IsFactor(CCharIterator szData, CCharIterator szEnd, e
 	CCharIterator sFuncEnd = NULL;
 
 	UINT_32 iFunctionParams = 0;
+	STLW::vector<CDT> vConstArgs;
+	const UINT_32 iCallIP = pCTPP2Compiler -> GetCodeSize();
 	// Check function
-	CCharIterator sTMP = IsFunc(szData, szEnd, sFuncEnd, iFunctionParams);
+	CCharIterator sTMP = IsFunc(szData, szEnd, sFuncEnd, iFunctionParams, vConstArgs);
 	if (sTMP != NULL)
 	{
+		// Translation of literal message is known at compile time
+		if (pGetText != NULL && iFunctionParams != 0 && vConstArgs.size() == iFunctionParams &&
+		    TranslateCall(STLW::string(szData(), sFuncEnd() - szData()), vConstArgs, sTMPBuf))
+		{
+			for (UINT_32 iI = 0; iI < iFunctionParams; ++iI) { pCTPP2Compiler -> RemoveInstruction(); }
+
+			pCTPP2Compiler -> PushString(sTMPBuf.c_str(), sTMPBuf.size(), VM_DEBUG(szData));
+			eResultOperator = EXPR_STRING_VALUE;
+			return sTMP;
+		}
+
+		// Result of pure function with literal arguments is known at compile time, even inside of TMPL_foreach
+		CDT oResult;
+		if (pSyscallFactory != NULL && vConstArgs.size() == iFunctionParams &&
+		    EvaluateCall(STLW::string(szData(), sFuncEnd() - szData()), vConstArgs, oResult))
+		{
+			for (UINT_32 iI = 0; iI < iFunctionParams; ++iI) { pCTPP2Compiler -> RemoveInstruction(); }
+
+			if (oResult.GetType() == CDT::STRING_VAL)
+			{
+				sTMPBuf = oResult.GetString();
+				pCTPP2Compiler -> PushString(sTMPBuf.c_str(), sTMPBuf.size(), VM_DEBUG(szData));
+				eResultOperator = EXPR_STRING_VALUE;
+			}
+			else
+			{
+				iIntData = oResult.GetInt();
+				pCTPP2Compiler -> PushInt(iIntData, VM_DEBUG(szData));
+				eResultOperator = EXPR_INT_VALUE;
+			}
+			return sTMP;
+		}
+
+		// Literal format string of SPRINTF is parsed at compile time
+		if (!vConstArgs.empty() && vConstArgs[0].GetType() == CDT::STRING_VAL && IsKeyword(szData(), sFuncEnd() - szData(), "sprintf"))
+		{
+			STLW::string sDescriptor;
+			CompileFormatString(vConstArgs[0].GetString(), sDescriptor);
+
+			if (pCTPP2Compiler -> ChangeString(iCallIP, sDescriptor.data(), sDescriptor.size()) != -1)
+			{
+				pCTPP2Compiler -> ExecuteSyscall(CTPP2_INT_HANDLER_PREFIX "_sprintf", sizeof(CTPP2_INT_HANDLER_PREFIX "_sprintf") - 1, iFunctionParams, VM_DEBUG(szData));
+				iLastCallIP    = iCallIP;
+				iLastCallEndIP = pCTPP2Compiler -> GetCodeSize();
+				eResultOperator = EXPR_VARIABLE;
+				return sTMP;
+			}
+		}
+
 		// Push syscall
 		pCTPP2Compiler -> ExecuteSyscall(szData(), sFuncEnd() - szData(), iFunctionParams, VM_DEBUG(szData));
+		iLastCallIP    = iCallIP;
+		iLastCallEndIP = pCTPP2Compiler -> GetCodeSize();
 		eResultOperator = EXPR_VARIABLE;
 		return sTMP;
 	}
@@ -1747,6 +2025,7 @@ CCharIterator CTPP2Parser::VarOperator(CCharIterator szData, CCharIterator szEnd
 	if (sTMP == NULL) { throw CTPPParserSyntaxError("expected at least one space symbol", szData.GetLine(), szData.GetLinePos()); }
 	szData = sTMP;
 
+	const UINT_32 iExprIP = pCTPP2Compiler -> GetCodeSize();
 	sTMP = IsExpr(szData, szEnd, eResultOperator);
 	STLW::string sExprDebug(szData(), sTMP() - szData());
 
@@ -1754,9 +2033,28 @@ CCharIterator CTPP2Parser::VarOperator(CCharIterator szData, CCharIterator szEnd
 	if (sTMP == NULL) { throw CTPPParserSyntaxError("expected variable or expression", szData.GetLine(), szData.GetLinePos()); }
 	szData = sTMP;
 
+	// Expression is single function call, result may be written by handler
+	const bool bSingleCall = eResultOperator == EXPR_VARIABLE && iLastCallIP == iExprIP && iLastCallEndIP == pCTPP2Compiler -> GetCodeSize();
+
+	// String literal, message translated or pure function evaluated at compile time is written as static text
+	const bool bStaticText = eResultOperator == EXPR_STRING_VALUE && pCTPP2Compiler -> GetCodeSize() == iExprIP + 1;
+	STLW::string sStaticText;
+	if (bStaticText) { sStaticText.swap(sTMPBuf); }
+
 	// Skip white space
 	szData = IsWhiteSpace(szData, szEnd, 0);
 	if (szData == szEnd) { throw CTPPParserSyntaxError("unexpected end of file found", szData.GetLine(), szData.GetLinePos()); }
+
+	// Check "raw output" flag
+	bool bRawOutput = false;
+	sTMP = IsRawFlag(szData, szEnd);
+	if (sTMP != NULL)
+	{
+		bRawOutput = true;
+		szData = IsWhiteSpace(sTMP, szEnd, 0);
+		if (szData == szEnd) { throw CTPPParserSyntaxError("unexpected end of file found", szData.GetLine(), szData.GetLinePos()); }
+	}
+
 	// Check "remove trailing newline flag"
 	const bool bRemoveTrailingNewLine = CheckTrailingFlag(szData, szEnd);
 
@@ -1766,8 +2064,31 @@ CCharIterator CTPP2Parser::VarOperator(CCharIterator szData, CCharIterator szEnd
 	// Remove trailing newline(s), if need
 	if (bRemoveTrailingNewLine || bVerboseMode) { RemoveTrailingNewLines(szData, szEnd); }
 
-	// Output variable
-	pCTPP2Compiler -> OutputVariable(VM_DEBUG(szData));
+	if (bStaticText)
+	{
+		pCTPP2Compiler -> RemoveInstruction();
+		// Result of escaping function may be evaluated at compile time
+		if (eEscapeMode == ESCAPE_NONE || bRawOutput || IsEscapingCall(sExprDebug, eEscapeMode))
+		{
+			pCTPP2Compiler -> OutputStaticData(sStaticText.data(), sStaticText.size(), VM_DEBUG(szData));
+		}
+		else
+		{
+			STLW::string sEscaped;
+			EscapeData(eEscapeMode, sStaticText.data(), sStaticText.size(), sEscaped);
+			pCTPP2Compiler -> OutputStaticData(sEscaped.data(), sEscaped.size(), VM_DEBUG(szData));
+		}
+	}
+	// Output variable; result of escaping function is not escaped twice
+	else if (eEscapeMode == ESCAPE_NONE || bRawOutput || IsEscapingCall(sExprDebug, eEscapeMode))
+	{
+		if (bSingleCall) { pCTPP2Compiler -> OutputCallResult(VM_DEBUG(szData)); }
+		else             { pCTPP2Compiler -> OutputVariable(VM_DEBUG(szData));   }
+	}
+	else
+	{
+		pCTPP2Compiler -> OutputEscapedVariable(eEscapeMode, VM_DEBUG(szData));
+	}
 
 return szData;
 }
@@ -2135,6 +2456,9 @@ CCharIterator CTPP2Parser::IncludeOperator(CCharIterator szData, CCharIterator s
 		// Create parser
 		CTPP2Parser oTMPParser(pTMPSourceLoader, pCTPP2Compiler, sIncludeFilename, bInForeach, iRecursionLevel + 1);
 		oTMPParser.SetBlockArgSizeMap(mBlockArgSizes);
+		oTMPParser.SetEscapeMode(eEscapeMode);
+		oTMPParser.SetGetText(pGetText, sLanguage);
+		oTMPParser.SetSyscallFactory(pSyscallFactory);
 		// No HLT at end of code
 		oTMPParser.Compile(0);
 		mBlockArgSizes = oTMPParser.GetBlockArgSizeMap();
@@ -2414,6 +2738,120 @@ CCharIterator CTPP2Parser::VerboseOperator(CCharIterator szData, CCharIterator s
 return sTMP;
 }
 
+//
+// Cached fragment <TMPL_cache key(Expr, ...) ttl(Expr)> ..... </TMPL_cache>
+//
+CCharIterator CTPP2Parser::CacheOperator(CCharIterator szData, CCharIterator szEnd)
+{
+	CCharIterator sStart = szData;
+
+	// Fragment name: source name, hash of source and position of tag
+	CHAR_8 szFragmentId[128];
+	const INT_32 iFragmentIdLength = snprintf(szFragmentId, 128, ":%08X:%d:%d", iSourceHash, sStart.GetLine(), sStart.GetLinePos());
+	STLW::string sFragmentName(sSourceName);
+	sFragmentName.append(szFragmentId, iFragmentIdLength);
+
+	pCTPP2Compiler -> PushString(sFragmentName.data(), sFragmentName.size(), VM_DEBUG(sStart));
+
+	// Skip white space
+	szData = IsWhiteSpace(szData, szEnd, 0);
+
+	// Fragment keys
+	UINT_32 iKeyCount = 0;
+	CCharIterator sTMP = ExprList(szData, szEnd, "key", iKeyCount);
+	if (sTMP != NULL) { szData = IsWhiteSpace(sTMP, szEnd, 0); }
+
+	// Time to live, seconds; 0 - until fragment is evicted
+	UINT_32 iTTLCount = 0;
+	sTMP = ExprList(szData, szEnd, "ttl", iTTLCount);
+	if (sTMP == NULL) { pCTPP2Compiler -> PushInt(0, VM_DEBUG(sStart)); }
+	else
+	{
+		if (iTTLCount != 1) { throw CTPPParserSyntaxError("ttl() needs exactly one argument", szData.GetLine(), szData.GetLinePos()); }
+		szData = IsWhiteSpace(sTMP, szEnd, 0);
+	}
+
+	// Check "remove trailing newline flag"
+	const bool bRemoveTrailingNewLine = CheckTrailingFlag(szData, szEnd);
+
+	// '>'
+	if (*szData != TMPL_CLOSE_SYMBOL) { throw CTPPParserSyntaxError("expected '>'", szData.GetLine(), szData.GetLinePos()); }
+	++szData;
+
+	// Remove trailing newline(s), if need
+	if (bRemoveTrailingNewLine || bVerboseMode) { RemoveTrailingNewLines(szData, szEnd); }
+
+	const UINT_32 iJumpIP = pCTPP2Compiler -> StartCache(iKeyCount + 2, VM_DEBUG(sStart));
+
+	// TMPL_break must not leave fragment, output capturing should be finished by CACHEPUT
+	const UINT_32 iOldCacheLoopLevel = iCacheLoopLevel;
+	iCacheLoopLevel = vBreakJMPPoints.size();
+
+	// Recursive descend
+	sTMP = Parse(szData, szEnd);
+
+	iCacheLoopLevel = iOldCacheLoopLevel;
+
+	// This should *never* happened
+	if (sTMP == NULL) { throw "Ouch!"; }
+
+	if (eBreakFound != TMPL_cache) { throw CTPPParserOperatorsMismatch("</TMPL_cache>", GetOperatorName(eBreakFound), sTMP.GetLine(), sTMP.GetLinePos()); }
+	eBreakFound = UNDEF;
+
+	pCTPP2Compiler -> EndCache(VM_DEBUG(sTMP));
+
+	VMInstruction * pInstruction = pCTPP2Compiler -> GetInstruction(iJumpIP);
+	pInstruction -> argument = pCTPP2Compiler -> GetCodeSize();
+
+return sTMP;
+}
+
+//
+// Default escaping of TMPL_var <TMPL_escape "html"> ..... </TMPL_escape>
+//
+CCharIterator CTPP2Parser::EscapeOperator(CCharIterator szData, CCharIterator szEnd)
+{
+	CCharIterator sTMP = IsWhiteSpace(szData, szEnd);
+	if (sTMP == NULL) { throw CTPPParserSyntaxError("expected at least one space symbol", szData.GetLine(), szData.GetLinePos()); }
+	szData = sTMP;
+
+	// Escaping rules
+	eCTPP2EscapeType eNewEscapeMode = ESCAPE_NONE;
+	sTMP = IsString(szData, szEnd);
+	if (sTMP == NULL || !GetEscapeType(sTMPBuf, eNewEscapeMode))
+	{
+		throw CTPPParserSyntaxError("expected \"html\", \"xml\", \"wml\", \"url\", \"uri\" or \"none\"", szData.GetLine(), szData.GetLinePos());
+	}
+
+	// Skip white space
+	szData = IsWhiteSpace(sTMP, szEnd, 0);
+	// Check "remove trailing newline flag"
+	const bool bRemoveTrailingNewLine = CheckTrailingFlag(szData, szEnd);
+
+	// '>'
+	if (*szData != TMPL_CLOSE_SYMBOL) { throw CTPPParserSyntaxError("expected '>'", szData.GetLine(), szData.GetLinePos()); }
+	++szData;
+
+	// Remove trailing newline(s), if need
+	if (bRemoveTrailingNewLine || bVerboseMode) { RemoveTrailingNewLines(szData, szEnd); }
+
+	const eCTPP2EscapeType eOldEscapeMode = eEscapeMode;
+	eEscapeMode = eNewEscapeMode;
+
+	// Recursive descend
+	sTMP = Parse(szData, szEnd);
+
+	eEscapeMode = eOldEscapeMode;
+
+	// This should *never* happened
+	if (sTMP == NULL) { throw "Ouch!"; }
+
+	if (eBreakFound != TMPL_escape) { throw CTPPParserOperatorsMismatch("</TMPL_escape>", GetOperatorName(eBreakFound), sTMP.GetLine(), sTMP.GetLinePos()); }
+	eBreakFound = UNDEF;
+
+return sTMP;
+}
+
 // Other stuff ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 //
@@ -2535,6 +2973,7 @@ CCharIterator CTPP2Parser::Parse(CCharIterator szData, CCharIterator szEnd)
 				// Break
 				case TMPL_break:
 					if (!bInForeach) { throw CTPPParserSyntaxError("TMPL_break outside loop", szIter.GetLine(), szIter.GetLinePos()); }
+					if (vBreakJMPPoints.size() == iCacheLoopLevel) { throw CTPPParserSyntaxError("TMPL_break leaves TMPL_cache", szIter.GetLine(), szIter.GetLinePos()); }
 					szIter = BreakOperator(szIter, szEnd);
 					break;
 
@@ -2552,6 +2991,18 @@ CCharIterator CTPP2Parser::Parse(CCharIterator szData, CCharIterator szEnd)
 					szIter = VerboseOperator(szIter, szEnd);
 					break;
 
+				// Cached fragment
+				case TMPL_cache:
+					eBreakFound = TMPL_cache;
+					szIter = CacheOperator(szIter, szEnd);
+					break;
+
+				// Default escaping
+				case TMPL_escape:
+					eBreakFound = TMPL_escape;
+					szIter = EscapeOperator(szIter, szEnd);
+					break;
+
 				// Error!
 				default:
 					throw CTPPParserSyntaxError("impossible happened", szIter.GetLine(), szIter.GetLinePos());
@@ -2687,6 +3138,34 @@ CCharIterator CTPP2Parser::Parse(CCharIterator szData, CCharIterator szEnd)
 							eBreakFound = TMPL_verbose;
 							return szIter;
 						}
+					// Cached fragment
+					case TMPL_cache:
+						{
+							szIter = IsWhiteSpace(szIter, szEnd, 0);
+							const bool bRemoveTrailingNewLine = CheckTrailingFlag(szIter, szEnd);
+
+							if (*szIter != TMPL_CLOSE_SYMBOL) { throw CTPPParserSyntaxError("expected '>'", szIter.GetLine(), szIter.GetLinePos()); }
+							++szIter;
+
+							if (bRemoveTrailingNewLine || bVerboseMode) { RemoveTrailingNewLines(szIter, szEnd); }
+
+							eBreakFound = TMPL_cache;
+							return szIter;
+						}
+					// Default escaping
+					case TMPL_escape:
+						{
+							szIter = IsWhiteSpace(szIter, szEnd, 0);
+							const bool bRemoveTrailingNewLine = CheckTrailingFlag(szIter, szEnd);
+
+							if (*szIter != TMPL_CLOSE_SYMBOL) { throw CTPPParserSyntaxError("expected '>'", szIter.GetLine(), szIter.GetLinePos()); }
+							++szIter;
+
+							if (bRemoveTrailingNewLine || bVerboseMode) { RemoveTrailingNewLines(szIter, szEnd); }
+
+							eBreakFound = TMPL_escape;
+							return szIter;
+						}
 					default:
 						throw "UndefOperator";
 				}
@@ -2867,6 +3346,8 @@ CCHAR_P CTPP2Parser::GetOperatorName(const eCTPP2Operator & oOperator)
 		case TMPL_break:   return "TMPL_break";
 		case TMPL_block:   return "TMPL_block";
 		case TMPL_call:    return "TMPL_call";
+		case TMPL_cache:   return "TMPL_cache";
+		case TMPL_escape:  return "TMPL_escape";
 		default:
 			 return "*UNDEF*";
 	}
@@ -2889,6 +3370,24 @@ bool CTPP2Parser::CheckTrailingFlag(CCharIterator & szData, CCharIterator szEnd)
 return bRemoveTrailingNewLine;
 }
 
+//
+// Check "raw output" flag of TMPL_var
+//
+CCharIterator CTPP2Parser::IsRawFlag(CCharIterator szData, CCharIterator szEnd)
+{
+	CCHAR_P szFlag = TMPL_RAW_FLAG;
+	while (*szFlag != '\0')
+	{
+		if (szData == szEnd || (*szData | 0x20) != *szFlag) { return NULL; }
+		++szData; ++szFlag;
+	}
+
+	// Flag is a separate word
+	if (szData == szEnd || (*szData != TMPL_CLOSE_SYMBOL && *szData != '-' && *szData != ' ' && *szData != '\t' && *szData != '\r' && *szData != '\n')) { return NULL; }
+
+return szData;
+}
+
 //
 // Remove trailing newline(s)
 //
@@ -2966,10 +3465,17 @@ return ++szData;
 // CTPP2 call args: args (a, b, c)
 //
 CCharIterator CTPP2Parser::CallArgs(CCharIterator szData, CCharIterator szEnd, UINT_32 & iArgCount)
+{
+	return ExprList(szData, szEnd, "args", iArgCount);
+}
+
+//
+// List of expressions: name (a, b, c)
+//
+CCharIterator CTPP2Parser::ExprList(CCharIterator szData, CCharIterator szEnd, CCHAR_P szName, UINT_32 & iArgCount)
 {
 	iArgCount = 0;
 
-	static CCHAR_P szName = "args";
 	CCharIterator szIter2 = szName;
 	while (szData != szEnd)
 	{
@@ -2984,7 +3490,13 @@ CCharIterator CTPP2Parser::CallArgs(CCharIterator szData, CCharIterator szEnd, U
 	// Skip white space
 	szData = IsWhiteSpace(szData, szEnd, 0);
 	// Check open tag
-	if (szData == szEnd || *szData != '(') { throw CTPPParserSyntaxError("need '(' token after \"args\"", szData.GetLine(), szData.GetLinePos()); }
+	if (szData == szEnd || *szData != '(')
+	{
+		STLW::string sError("need '(' token after \"");
+		sError.append(szName);
+		sError.append("\"");
+		throw CTPPParserSyntaxError(sError.c_str(), szData.GetLine(), szData.GetLinePos());
+	}
 	++szData;
 
 	for (;;)
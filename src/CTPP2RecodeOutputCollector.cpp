@@ -0,0 +1,631 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2RecodeOutputCollector.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2RecodeOutputCollector.hpp"
+#include "CTPP2Exception.hpp"
+
+#include <errno.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+//
+// Upper halves of built-in charsets, Unicode code points of bytes 0x80 .. 0xFF; 0 - no character
+//
+// CP1251, 0x80 .. 0xFF
+static const UINT_32 aCP1251[128] =
+{
+	0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+	0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x0000, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+	0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+	0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+	0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+	0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+	0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+	0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+	0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+	0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+	0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+	0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+	0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+	0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F
+};
+
+// CP1252, 0x80 .. 0xFF
+static const UINT_32 aCP1252[128] =
+{
+	0x20AC, 0x0000, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x0000, 0x017D, 0x0000,
+	0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x0000, 0x017E, 0x0178,
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+};
+
+// KOI8R, 0x80 .. 0xFF
+static const UINT_32 aKOI8R[128] =
+{
+	0x2500, 0x2502, 0x250C, 0x2510, 0x2514, 0x2518, 0x251C, 0x2524,
+	0x252C, 0x2534, 0x253C, 0x2580, 0x2584, 0x2588, 0x258C, 0x2590,
+	0x2591, 0x2592, 0x2593, 0x2320, 0x25A0, 0x2219, 0x221A, 0x2248,
+	0x2264, 0x2265, 0x00A0, 0x2321, 0x00B0, 0x00B2, 0x00B7, 0x00F7,
+	0x2550, 0x2551, 0x2552, 0x0451, 0x2553, 0x2554, 0x2555, 0x2556,
+	0x2557, 0x2558, 0x2559, 0x255A, 0x255B, 0x255C, 0x255D, 0x255E,
+	0x255F, 0x2560, 0x2561, 0x0401, 0x2562, 0x2563, 0x2564, 0x2565,
+	0x2566, 0x2567, 0x2568, 0x2569, 0x256A, 0x256B, 0x256C, 0x00A9,
+	0x044E, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+	0x0445, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E,
+	0x043F, 0x044F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+	0x044C, 0x044B, 0x0437, 0x0448, 0x044D, 0x0449, 0x0447, 0x044A,
+	0x042E, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+	0x0425, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E,
+	0x041F, 0x042F, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+	0x042C, 0x042B, 0x0417, 0x0428, 0x042D, 0x0429, 0x0427, 0x042A
+};
+
+// CP866, 0x80 .. 0xFF
+static const UINT_32 aCP866[128] =
+{
+	0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+	0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+	0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+	0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+	0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+	0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+	0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+	0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+	0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F,
+	0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+	0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,
+	0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+	0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+	0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+	0x0401, 0x0451, 0x0404, 0x0454, 0x0407, 0x0457, 0x040E, 0x045E,
+	0x00B0, 0x2219, 0x00B7, 0x221A, 0x2116, 0x00A4, 0x25A0, 0x00A0
+};
+
+// ISO88595, 0x80 .. 0xFF
+static const UINT_32 aISO88595[128] =
+{
+	0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+	0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+	0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+	0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+	0x00A0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407,
+	0x0408, 0x0409, 0x040A, 0x040B, 0x040C, 0x00AD, 0x040E, 0x040F,
+	0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+	0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+	0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+	0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+	0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+	0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+	0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+	0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+	0x2116, 0x0451, 0x0452, 0x0453, 0x0454, 0x0455, 0x0456, 0x0457,
+	0x0458, 0x0459, 0x045A, 0x045B, 0x045C, 0x00A7, 0x045E, 0x045F
+};
+
+// ISO88591, 0x80 .. 0xFF
+static const UINT_32 aISO88591[128] =
+{
+	0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+	0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+	0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+	0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+};
+
+//
+// Built-in charset
+//
+struct RecodeCharsetTable
+{
+	/** Normalized charset name  */
+	CCHAR_P            szName;
+	/** Upper half of charset, NULL for US-ASCII */
+	const UINT_32    * aChars;
+};
+
+//
+// Charset names are compared in upper case, without punctuation
+//
+static const RecodeCharsetTable aCharsets[] =
+{
+	{ "CP1251",      aCP1251   },
+	{ "WINDOWS1251", aCP1251   },
+	{ "MSCP1251",    aCP1251   },
+	{ "KOI8R",       aKOI8R    },
+	{ "CSKOI8R",     aKOI8R    },
+	{ "CP866",       aCP866    },
+	{ "IBM866",      aCP866    },
+	{ "866",         aCP866    },
+	{ "ISO88595",    aISO88595 },
+	{ "CYRILLIC",    aISO88595 },
+	{ "ISO88591",    aISO88591 },
+	{ "LATIN1",      aISO88591 },
+	{ "L1",          aISO88591 },
+	{ "CP1252",      aCP1252   },
+	{ "WINDOWS1252", aCP1252   },
+	{ "USASCII",     NULL      },
+	{ "ASCII",       NULL      },
+	{ NULL,          NULL      }
+};
+
+//
+// Transliteration of characters missing in destination charset, sorted by code point
+//
+struct RecodeTranslit
+{
+	/** Unicode code point       */
+	UINT_32    ucs;
+	/** Replacement, US-ASCII    */
+	CCHAR_P    szText;
+};
+
+static const RecodeTranslit aTranslit[] =
+{
+	{ 0x00A0, " "    }, { 0x00A9, "(C)"  }, { 0x00AB, "<<"   }, { 0x00AE, "(R)"  },
+	{ 0x00B1, "+-"   }, { 0x00B7, "."    }, { 0x00BB, ">>"   }, { 0x00D7, "x"    },
+	{ 0x2002, " "    }, { 0x2003, " "    }, { 0x2009, " "    }, { 0x2010, "-"    },
+	{ 0x2011, "-"    }, { 0x2012, "-"    }, { 0x2013, "-"    }, { 0x2014, "-"    },
+	{ 0x2015, "-"    }, { 0x2018, "'"    }, { 0x2019, "'"    }, { 0x201A, "'"    },
+	{ 0x201B, "'"    }, { 0x201C, "\""   }, { 0x201D, "\""   }, { 0x201E, "\""   },
+	{ 0x201F, "\""   }, { 0x2022, "o"    }, { 0x2026, "..."  }, { 0x2039, "<"    },
+	{ 0x203A, ">"    }, { 0x20AC, "EUR"  }, { 0x2116, "No"   }, { 0x2122, "(TM)" },
+	{ 0x2212, "-"    }
+};
+
+//
+// Normalize charset name; returns empty string if name has iconv suffixes like "//TRANSLIT"
+//
+static STLW::string NormalizeCharset(const STLW::string & sCharset)
+{
+	STLW::string sResult;
+	STLW::string::const_iterator itsCharset = sCharset.begin();
+	while (itsCharset != sCharset.end())
+	{
+		CHAR_8 chTMP = *itsCharset;
+		if (chTMP == '/') { return ""; }
+
+		if      (chTMP >= 'a' && chTMP <= 'z') { sResult.append(1, chTMP - 'a' + 'A'); }
+		else if ((chTMP >= 'A' && chTMP <= 'Z') || (chTMP >= '0' && chTMP <= '9')) { sResult.append(1, chTMP); }
+		++itsCharset;
+	}
+return sResult;
+}
+
+//
+// Decode UTF-8 character; returns length of sequence, 0 if sequence is incomplete, -1 if invalid
+//
+static INT_32 DecodeUTF8(const UCHAR_8  * sData,
+                         const UCHAR_8  * sEnd,
+                         UINT_32        & iUCS)
+{
+	const UCHAR_8 ucTMP = *sData;
+	INT_32  iLength;
+	UINT_32 iMinUCS;
+
+	if      (ucTMP < 0xC2) { return -1; }
+	else if (ucTMP < 0xE0) { iLength = 2; iMinUCS = 0x00080; iUCS = ucTMP & 0x1F; }
+	else if (ucTMP < 0xF0) { iLength = 3; iMinUCS = 0x00800; iUCS = ucTMP & 0x0F; }
+	else if (ucTMP < 0xF5) { iLength = 4; iMinUCS = 0x10000; iUCS = ucTMP & 0x07; }
+	else                   { return -1; }
+
+	for (INT_32 iPos = 1; iPos < iLength; ++iPos)
+	{
+		if (sData + iPos == sEnd) { return 0; }
+
+		const UCHAR_8 ucNext = sData[iPos];
+		if ((ucNext & 0xC0) != 0x80) { return -1; }
+
+		iUCS = (iUCS << 6) | (ucNext & 0x3F);
+	}
+
+	// Overlong sequences, surrogates
+	if (iUCS < iMinUCS || iUCS > 0x10FFFF || (iUCS >= 0xD800 && iUCS <= 0xDFFF)) { return -1; }
+
+return iLength;
+}
+
+//
+// Constructor
+//
+RecodeOutputCollector::RecodeOutputCollector(OutputCollector     & oITarget,
+                                             const STLW::string  & sISrcEnc,
+                                             const STLW::string  & sIDstEnc,
+                                             const UINT_32         iIFlags,
+                                             const UINT_32         iIBlockSize): oTarget(oITarget),
+                                                                                 sSrcEnc(sISrcEnc),
+                                                                                 sDstEnc(sIDstEnc),
+                                                                                 iFlags(iIFlags),
+                                                                                 iBlockSize(iIBlockSize),
+                                                                                 szOutBuffer(NULL),
+                                                                                 iOutUsed(0),
+                                                                                 pTable(NULL),
+                                                                                 iHighNum(0),
+                                                                                 iTailLength(0),
+                                                                                 szInBuffer(NULL),
+                                                                                 iInUsed(0)
+{
+	// Room for longest transliteration
+	if (iBlockSize < 16) { iBlockSize = 16; }
+
+	const STLW::string sSrcName = NormalizeCharset(sSrcEnc);
+	if (sSrcName == "UTF8")
+	{
+		const STLW::string sDstName = NormalizeCharset(sDstEnc);
+		for (const RecodeCharsetTable * pCharset = aCharsets; pCharset -> szName != NULL; ++pCharset)
+		{
+			if (sDstName == pCharset -> szName) { pTable = pCharset; break; }
+		}
+	}
+
+	if (pTable != NULL)
+	{
+		// Reverse mapping
+		memset(aDirect, 0, sizeof(aDirect));
+		for (UINT_32 iPos = 0; pTable -> aChars != NULL && iPos < 128; ++iPos)
+		{
+			const UINT_32 iUCS = pTable -> aChars[iPos];
+			if (iUCS == 0) { continue; }
+
+			if (iUCS < 0x0800) { aDirect[iUCS] = 0x80 + iPos; continue; }
+
+			// Insertion sort, 128 elements at most
+			UINT_32 iInsert = iHighNum++;
+			while (iInsert > 0 && aHigh[iInsert - 1].ucs > iUCS)
+			{
+				aHigh[iInsert] = aHigh[iInsert - 1];
+				--iInsert;
+			}
+			aHigh[iInsert].ucs = iUCS;
+			aHigh[iInsert].ch  = 0x80 + iPos;
+		}
+	}
+	else
+	{
+#ifdef ICONV_SUPPORT
+		STLW::string sIconvDstEnc(sDstEnc);
+#if (_LIBICONV_VERSION < 0x0108)
+		// No iconvctl; ask iconv for transliteration by charset name
+		if (iFlags & C_ICONV_TRANSLITERATE) { sIconvDstEnc.append("//TRANSLIT"); }
+#endif
+		oIconv = iconv_open(sIconvDstEnc.c_str(), sSrcEnc.c_str());
+		// Check error
+		if (oIconv == (iconv_t)(-1))
+		{
+			throw CTPPCharsetRecodeException(sSrcEnc.c_str(), sDstEnc.c_str());
+		}
+
+#if (_LIBICONV_VERSION >= 0x0108)
+		int iFlag = 1;
+		// Discard illegal characters
+		if (iFlags & C_ICONV_DISCARD_ILSEQ) { iconvctl(oIconv, ICONV_SET_DISCARD_ILSEQ, &iFlag); }
+
+		// Enable transliteration in the conversion
+		if (iFlags & C_ICONV_TRANSLITERATE) { iconvctl(oIconv, ICONV_SET_TRANSLITERATE, &iFlag); }
+#endif
+		szInBuffer = new CHAR_8[iBlockSize];
+#else
+		throw CTPPCharsetRecodeException(sSrcEnc.c_str(), sDstEnc.c_str());
+#endif // ICONV_SUPPORT
+	}
+
+	szOutBuffer = new CHAR_8[iBlockSize];
+}
+
+//
+// Check whether charsets are recoded with built-in tables
+//
+bool RecodeOutputCollector::IsTableDriven() const { return pTable != NULL; }
+
+//
+// Pass output buffer to target collector
+//
+INT_32 RecodeOutputCollector::FlushOutput()
+{
+	if (iOutUsed == 0) { return 0; }
+
+	const INT_32 iRC = oTarget.Collect(szOutBuffer, iOutUsed);
+	iOutUsed = 0;
+
+return iRC;
+}
+
+//
+// Write recoded character to output buffer
+//
+void RecodeOutputCollector::PutChar(const UINT_32 iUCS)
+{
+	UCHAR_8 ucTMP = 0;
+	if      (iUCS < 0x0080) { ucTMP = iUCS;          }
+	else if (iUCS < 0x0800) { ucTMP = aDirect[iUCS]; }
+	else
+	{
+		UINT_32 iBegin = 0;
+		UINT_32 iEnd   = iHighNum;
+		while (iBegin < iEnd)
+		{
+			const UINT_32 iMiddle = (iBegin + iEnd) / 2;
+			if      (aHigh[iMiddle].ucs < iUCS) { iBegin = iMiddle + 1; }
+			else if (aHigh[iMiddle].ucs > iUCS) { iEnd   = iMiddle;     }
+			else { ucTMP = aHigh[iMiddle].ch; break; }
+		}
+	}
+
+	if (ucTMP != 0) { szOutBuffer[iOutUsed++] = ucTMP; return; }
+
+	// Character cannot be represented; discarded unless transliteration is enabled
+	if ((iFlags & C_ICONV_TRANSLITERATE) == 0) { return; }
+
+	UINT_32 iBegin = 0;
+	UINT_32 iEnd   = sizeof(aTranslit) / sizeof(aTranslit[0]);
+	while (iBegin < iEnd)
+	{
+		const UINT_32 iMiddle = (iBegin + iEnd) / 2;
+		if      (aTranslit[iMiddle].ucs < iUCS) { iBegin = iMiddle + 1; }
+		else if (aTranslit[iMiddle].ucs > iUCS) { iEnd   = iMiddle;     }
+		else
+		{
+			for (CCHAR_P szText = aTranslit[iMiddle].szText; *szText != '\0'; ++szText) { szOutBuffer[iOutUsed++] = *szText; }
+			return;
+		}
+	}
+
+	szOutBuffer[iOutUsed++] = '?';
+}
+
+//
+// Recode UTF-8 data with built-in table
+//
+INT_32 RecodeOutputCollector::RecodeTable(CCHAR_P sData, CCHAR_P sEnd)
+{
+	const UCHAR_8 * sPos    = (const UCHAR_8 *)sData;
+	const UCHAR_8 * sEndPos = (const UCHAR_8 *)sEnd;
+	UINT_32         iUCS    = 0;
+
+	// Complete sequence started by previous call
+	while (iTailLength != 0 && sPos != sEndPos)
+	{
+		aTail[iTailLength++] = *sPos++;
+
+		const INT_32 iLength = DecodeUTF8(aTail, aTail + iTailLength, iUCS);
+		if (iLength == 0) { continue; }
+
+		if (iLength > 0)
+		{
+			if (iBlockSize - iOutUsed < 4 && FlushOutput() == -1) { return -1; }
+			PutChar(iUCS);
+		}
+		// Invalid sequence; last byte may start a new one
+		else
+		{
+			--sPos;
+		}
+		iTailLength = 0;
+	}
+
+	while (sPos != sEndPos)
+	{
+		if (*sPos < 0x80)
+		{
+			if (iOutUsed == iBlockSize && FlushOutput() == -1) { return -1; }
+
+			const UINT_32   iFree   = iBlockSize - iOutUsed;
+			const UCHAR_8 * sRunEnd = (UINT_32(sEndPos - sPos) > iFree) ? sPos + iFree : sEndPos;
+			const UCHAR_8 * sRun    = sPos;
+
+			// 8 bytes at once
+			while (sRunEnd - sRun >= 8)
+			{
+				UINT_64 iWord;
+				memcpy(&iWord, sRun, sizeof(iWord));
+				if ((iWord & 0x8080808080808080ULL) != 0) { break; }
+				sRun += 8;
+			}
+			while (sRun != sRunEnd && *sRun < 0x80) { ++sRun; }
+
+			memcpy(szOutBuffer + iOutUsed, sPos, sRun - sPos);
+			iOutUsed += sRun - sPos;
+			sPos = sRun;
+			continue;
+		}
+
+		const INT_32 iLength = DecodeUTF8(sPos, sEndPos, iUCS);
+		// Incomplete sequence at end of data
+		if (iLength == 0)
+		{
+			iTailLength = sEndPos - sPos;
+			memcpy(aTail, sPos, iTailLength);
+			break;
+		}
+
+		// Invalid sequence, skip one byte
+		if (iLength < 0) { ++sPos; continue; }
+
+		if (iBlockSize - iOutUsed < 4 && FlushOutput() == -1) { return -1; }
+		PutChar(iUCS);
+		sPos += iLength;
+	}
+
+return 0;
+}
+
+//
+// Recode input buffer with iconv
+//
+INT_32 RecodeOutputCollector::RecodeIconv(const bool bFinal)
+{
+	INT_32 iRC = 0;
+#ifdef ICONV_SUPPORT
+	size_t iSrcLength = iInUsed;
+#if defined(linux) || defined(__APPLE__)
+	char       * aSrcData = szInBuffer;
+#else
+	const char * aSrcData = szInBuffer;
+#endif
+
+	while (iSrcLength != 0)
+	{
+		char * aDstData   = szOutBuffer + iOutUsed;
+		size_t iDstLength = iBlockSize - iOutUsed;
+		size_t iResult    = iconv(oIconv, &aSrcData, &iSrcLength, &aDstData, &iDstLength);
+		iOutUsed = aDstData - szOutBuffer;
+
+		// All data converted?
+		if (iResult != (size_t)-1) { break; }
+
+		// Output buffer is full
+		if (errno == E2BIG)
+		{
+			if (FlushOutput() == -1) { iRC = -1; }
+		}
+		// Incomplete character at end of buffer
+		else if (errno == EINVAL)
+		{
+			if (bFinal) { iSrcLength = 0; }
+			break;
+		}
+		// Illegal character
+		else
+		{
+			++aSrcData;
+			--iSrcLength;
+		}
+	}
+
+	if (iSrcLength != 0) { memmove(szInBuffer, aSrcData, iSrcLength); }
+	iInUsed = iSrcLength;
+
+	// Return to initial shift state
+	if (bFinal)
+	{
+		char * aDstData   = szOutBuffer + iOutUsed;
+		size_t iDstLength = iBlockSize - iOutUsed;
+		if (iconv(oIconv, NULL, NULL, &aDstData, &iDstLength) == (size_t)-1 && errno == E2BIG)
+		{
+			if (FlushOutput() == -1) { iRC = -1; }
+			aDstData   = szOutBuffer;
+			iDstLength = iBlockSize;
+			iconv(oIconv, NULL, NULL, &aDstData, &iDstLength);
+		}
+		iOutUsed = aDstData - szOutBuffer;
+	}
+#endif // ICONV_SUPPORT
+return iRC;
+}
+
+//
+// Collect data
+//
+INT_32 RecodeOutputCollector::Collect(const void     * vData,
+                                      const UINT_32    iDataLength)
+{
+	CCHAR_P sData = (CCHAR_P)vData;
+	if (pTable != NULL) { return RecodeTable(sData, sData + iDataLength); }
+
+	INT_32  iRC         = 0;
+	UINT_32 iDataLeft   = iDataLength;
+	while (iDataLeft != 0)
+	{
+		UINT_32 iFree = iBlockSize - iInUsed;
+		if (iFree > iDataLeft) { iFree = iDataLeft; }
+
+		memcpy(szInBuffer + iInUsed, sData, iFree);
+		iInUsed   += iFree;
+		sData     += iFree;
+		iDataLeft -= iFree;
+
+		if (iInUsed == iBlockSize && RecodeIconv(false) == -1) { iRC = -1; }
+	}
+
+return iRC;
+}
+
+//
+// Recode buffered data and pass it to target collector
+//
+INT_32 RecodeOutputCollector::Flush()
+{
+	INT_32 iRC = 0;
+	if (pTable == NULL && RecodeIconv(false) == -1) { iRC = -1; }
+	if (FlushOutput() == -1) { iRC = -1; }
+
+return iRC;
+}
+
+//
+// A destructor
+//
+RecodeOutputCollector::~RecodeOutputCollector() throw()
+{
+	// Incomplete character at end of data is discarded
+	if (pTable == NULL) { RecodeIconv(true); }
+	FlushOutput();
+
+#ifdef ICONV_SUPPORT
+	if (pTable == NULL) { iconv_close(oIconv); }
+#endif // ICONV_SUPPORT
+
+	delete [] szInBuffer;
+	delete [] szOutBuffer;
+}
+
+} // namespace CTPP
+// End.
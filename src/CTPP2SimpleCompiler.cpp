@@ -90,7 +90,8 @@ SimpleCompiler::_SimpleCompiler::~_SimpleCompiler() throw()
 //
 // Constructor
 //
-SimpleCompiler::SimpleCompiler(const std::string & sSourceFile)
+SimpleCompiler::SimpleCompiler(const std::string       & sSourceFile,
+                               const eCTPP2EscapeType    eEscapeMode)
 {
 	VMOpcodeCollector  oVMOpcodeCollector;
 	StaticText         oSyscalls;
@@ -105,6 +106,7 @@ SimpleCompiler::SimpleCompiler(const std::string & sSourceFile)
 
 	// Create template parser
 	CTPP2Parser oCTPP2Parser(&oSourceLoader, &oCompiler, sSourceFile);
+	oCTPP2Parser.SetEscapeMode(eEscapeMode);
 
 	// Compile template
 	oCTPP2Parser.Compile();
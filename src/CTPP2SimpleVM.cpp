@@ -38,6 +38,7 @@
 #include "CTPP2SyscallFactory.hpp"
 #include "CTPP2VM.hpp"
 #include "CTPP2VMLoader.hpp"
+#include "CTPP2VMMemoryCore.hpp"
 
 namespace CTPP // C++ Template Engine
 {
@@ -99,9 +100,9 @@ SimpleVM::SimpleVM(const UINT_32  & iIMaxFunctions,
 //
 UINT_32 SimpleVM::Run(CDT & oData, const VMLoader & oLoader, std::string & sResult, Logger & oLogger)
 {
-	StringOutputCollector oOutputCollector(sResult);
+	const VMMemoryCore * pCore = oLoader.GetCore();
 
-return Run(oData, oLoader, oOutputCollector, oLogger);
+return Run(oData, pCore, sResult, oLogger);
 }
 
 //
@@ -129,9 +130,18 @@ return Run(oData, pCore, oCollector, oLogger);
 //
 UINT_32 SimpleVM::Run(CDT & oData, const VMMemoryCore * pCore, std::string & sResult, Logger & oLogger)
 {
+	// Presize result by size of previous renders of this template
+	const STLW::string::size_type iOffset = sResult.size();
+	const UINT_32 iOutputSizeHint = pCore -> GetOutputSizeHint();
+	if (sResult.capacity() < iOffset + iOutputSizeHint) { sResult.reserve(iOffset + iOutputSizeHint); }
+
 	StringOutputCollector oOutputCollector(sResult);
 
-return Run(oData, pCore, oOutputCollector, oLogger);
+	const UINT_32 iIP = Run(oData, pCore, oOutputCollector, oLogger);
+
+	pCore -> UpdateOutputSize(sResult.size() - iOffset);
+
+return iIP;
 }
 
 //
@@ -157,6 +167,30 @@ UINT_32 SimpleVM::Run(CDT & oData, const VMMemoryCore * pCore, OutputCollector &
 return iIP;
 }
 
+//
+// Set storage of cached fragments
+//
+void SimpleVM::SetFragmentCache(FragmentCache * pFragmentCache)
+{
+	pSimpleVM -> vm.SetFragmentCache(pFragmentCache);
+}
+
+//
+// Set per-render context of system calls
+//
+void SimpleVM::SetContext(const SyscallContext * pContext)
+{
+	pSimpleVM -> vm.SetContext(pContext);
+}
+
+//
+// Enable or disable reuse of results of pure calls
+//
+void SimpleVM::SetMemoization(const bool bMemoize)
+{
+	pSimpleVM -> vm.SetMemoization(bMemoize);
+}
+
 //
 // A destructor
 //
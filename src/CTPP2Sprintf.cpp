@@ -40,6 +40,14 @@ namespace CTPP // C++ Template Engine
 #define F_FORCE_SIGN  0x00000002
 #define F_SIGN_SPACE  0x00000004
 #define F_HASH_SIGN   0x00000008
+// Width and precision are given as arguments
+#define F_WIDTH_ARG     0x00000010
+#define F_PRECISION_ARG 0x00000020
+
+// Version of parsed format string
+#define C_FORMAT_DESCRIPTOR_VERSION 1
+// Specifier, flags, length, padding, width and precision
+#define C_FIELD_RECORD_LEN 12
 
 enum eFmtLengths   { F_NONE      = 0,
                      F_SHORT     = 1,
@@ -64,6 +72,12 @@ enum eFmtSpecifierCase { FM_UPPER = 0,
 enum eParserState { C_INITIAL_STATE = 0,
                     C_START_FOUND   = 1};
 
+// Records of parsed format string
+enum eFmtRecord { FR_TEXT  = 'T',
+                  FR_FIELD = 'F',
+                  FR_SKIP  = 'S',
+                  FR_ERROR = 'E'};
+
 static CCHAR_P szDigitsUc = "0123456789ABCDEFX";
 static CCHAR_P szDigitsLc = "0123456789abcdefx";
 #define C_INT_BUFFER_LEN 128
@@ -159,20 +173,29 @@ static void FmtString(StringBuffer   & oBuffer,
                       const INT_32     iMaxChars,
                       CHAR_8           chPadSymbol)
 {
-	const STLW::string sTMP    = oCurrentArgument.GetString();
+	// Strings are used in place
+	STLW::string sTMP;
+	UINT_32 iDataLength = 0;
+	CCHAR_P szData      = oCurrentArgument.GetStringData(iDataLength);
+	if (szData == NULL)
+	{
+		sTMP        = oCurrentArgument.GetString();
+		szData      = sTMP.data();
+		iDataLength = sTMP.size();
+	}
 
-	INT_32 iFormatSize = sTMP.size();
+	INT_32 iFormatSize = iDataLength;
 	if (iFormatSize > iMaxChars && iMaxChars > 0) { iFormatSize = iMaxChars; }
 
 	if (iFmtFlags & F_LEFT_ALIGN)
 	{
-		oBuffer.Append(sTMP.data(), iFormatSize);
+		oBuffer.Append(szData, iFormatSize);
 		if (iWidth > iFormatSize) { oBuffer.Append(iWidth - iFormatSize, chPadSymbol); }
 	}
 	else
 	{
 		if (iWidth > iFormatSize) { oBuffer.Append(iWidth - iFormatSize, chPadSymbol); }
-		oBuffer.Append(sTMP.data(), iFormatSize);
+		oBuffer.Append(szData, iFormatSize);
 	}
 }
 
@@ -351,7 +374,9 @@ static void FmtSci(StringBuffer       & oBuffer,
 	 *     the value is zero, the exponent is 00.
 	 */
 
-	if (iPrecision == -1) { iPrecision = 6; }
+	if      (iPrecision < 0)  { iPrecision = 6; }
+	// At least one digit of mantissa
+	else if (iPrecision == 0) { iPrecision = 1; }
 	if (iWidth == -1)     { iWidth     = 6; }
 
 	const INT_32   iMode     = 2;
@@ -661,24 +686,145 @@ static void FmtFloat(StringBuffer            & oBuffer,
 }
 
 //
+// Arguments stored in CDT array
 //
+class FormatArrayArgs
+{
+public:
+	FormatArrayArgs(const CDT & oIArgs): oArgs(oIArgs) { ;; }
+
+	const CDT & Get(const UINT_32 iPos) const { return oArgs.GetCDT(iPos); }
+private:
+	const CDT  & oArgs;
+};
+
 //
-INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult, const CDT & oArgs)
+// Arguments of syscall, stored in reverse order
+//
+class FormatFrameArgs
 {
-	using namespace CTPP;
-	StringBuffer oBuffer(sResult);
+public:
+	FormatFrameArgs(const CDT * aIArgs, const UINT_32 iIArgNum): aArgs(aIArgs), iArgNum(iIArgNum) { ;; }
+
+	const CDT & Get(const UINT_32 iPos) const
+	{
+		if (iPos >= iArgNum) { throw CDTRangeException(); }
+		return aArgs[iArgNum - iPos - 1];
+	}
+private:
+	const CDT      * aArgs;
+	const UINT_32    iArgNum;
+};
+
+//
+// Store 32-bit value, little-endian
+//
+static void EncodeInt(CHAR_P szBuffer, const INT_32 iValue)
+{
+	const UINT_32 iData = UINT_32(iValue);
+	szBuffer[0] = CHAR_8( iData        & 0xFF);
+	szBuffer[1] = CHAR_8((iData >>  8) & 0xFF);
+	szBuffer[2] = CHAR_8((iData >> 16) & 0xFF);
+	szBuffer[3] = CHAR_8((iData >> 24) & 0xFF);
+}
+
+//
+// Load 32-bit value, little-endian
+//
+static INT_32 DecodeInt(CCHAR_P szBuffer)
+{
+	const UCHAR_8 * szData = (const UCHAR_8 *)szBuffer;
+
+return INT_32(UINT_32(szData[0]) | (UINT_32(szData[1]) << 8) | (UINT_32(szData[2]) << 16) | (UINT_32(szData[3]) << 24));
+}
+
+//
+// Literal text; adjacent chunks are merged into one record
+//
+static void WriteText(STLW::string  & sDescriptor,
+                      INT_32        & iTextRecord,
+                      CCHAR_P         sStart,
+                      CCHAR_P         sEnd)
+{
+	if (sStart == sEnd) { return; }
+
+	CHAR_8 szLength[4];
+	const UINT_32 iLength = sEnd - sStart;
+	if (iTextRecord == -1)
+	{
+		sDescriptor.push_back(CHAR_8(FR_TEXT));
+		iTextRecord = sDescriptor.size();
+		EncodeInt(szLength, iLength);
+		sDescriptor.append(szLength, 4);
+	}
+	else
+	{
+		EncodeInt(szLength, DecodeInt(sDescriptor.data() + iTextRecord) + iLength);
+		sDescriptor.replace(iTextRecord, 4, szLength, 4);
+	}
+	sDescriptor.append(sStart, iLength);
+}
+
+//
+// Formatted field
+//
+static void WriteField(STLW::string       & sDescriptor,
+                       INT_32             & iTextRecord,
+                       const CHAR_8         chSpecifier,
+                       const UINT_32        iFmtFlags,
+                       const eFmtLengths    oFmtLengths,
+                       const CHAR_8         chPadSymbol,
+                       const INT_32         iWidth,
+                       const INT_32         iPrecision)
+{
+	CHAR_8 szRecord[C_FIELD_RECORD_LEN + 1];
+	szRecord[0] = CHAR_8(FR_FIELD);
+	szRecord[1] = chSpecifier;
+	szRecord[2] = CHAR_8(iFmtFlags);
+	szRecord[3] = CHAR_8(oFmtLengths);
+	szRecord[4] = chPadSymbol;
+	EncodeInt(szRecord + 5, iWidth);
+	EncodeInt(szRecord + 9, iPrecision);
+
+	sDescriptor.append(szRecord, C_FIELD_RECORD_LEN + 1);
+	iTextRecord = -1;
+}
+
+//
+// Invalid format; arguments taken before error are still fetched
+//
+static INT_32 WriteError(STLW::string   & sDescriptor,
+                         const UINT_32    iSkipArgs)
+{
+	if (iSkipArgs != 0)
+	{
+		sDescriptor.push_back(CHAR_8(FR_SKIP));
+		sDescriptor.push_back(CHAR_8(iSkipArgs));
+	}
+	sDescriptor.push_back(CHAR_8(FR_ERROR));
+
+return -1;
+}
+
+//
+// Parse format string
+//
+INT_32 CompileFormatString(const STLW::string & sFormatString, STLW::string & sDescriptor)
+{
+	sDescriptor.assign(1, CHAR_8(C_FORMAT_DESCRIPTOR_VERSION));
 
 	CCHAR_P sPos = sFormatString.data();
 	CCHAR_P sEnd = sFormatString.data() + sFormatString.size();
 	CCHAR_P sEndSave = sPos;
 
-	UINT_32 iPos = 0;
+	INT_32 iTextRecord = -1;
 	for(;;)
 	{
 		INT_32   iWidth            = -1;
 		INT_32   iPrecision        = -1;
 		CHAR_8   chPadSymbol       = ' ';
 		UINT_32  iFmtFlags         = 0;
+		UINT_32  iFieldArgs        = 0;
 		eFmtLengths   oFmtLengths  = F_NONE;
 		eParserState  oParserState = C_INITIAL_STATE;
 		// Find "%" at start of token
@@ -691,13 +837,13 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 			}
 			++sPos;
 		}
-		oBuffer.Append(sEndSave, sPos);
+		WriteText(sDescriptor, iTextRecord, sEndSave, sPos);
 
 		if (oParserState == C_START_FOUND)
 		{
 			++sPos;
 			// Check end of string
-			if (sPos == sEnd) { return -1; }
+			if (sPos == sEnd) { return WriteError(sDescriptor, iFieldArgs); }
 
 			bool bEndCycle = false;
 			while (!bEndCycle)
@@ -747,7 +893,7 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 				}
 
 				// Check end of string
-				if (sPos == sEnd) { return -1; }
+				if (sPos == sEnd) { return WriteError(sDescriptor, iFieldArgs); }
 			}
 
 			/* Width
@@ -769,19 +915,19 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 			 */
 			else if (*sPos == '*')
 			{
-				iWidth = (INT_32)oArgs.GetCDT(iPos).GetInt();
-				++iPos;
+				iFmtFlags |= F_WIDTH_ARG;
+				++iFieldArgs;
 				++sPos;
 			}
 
 			// Check end of string
-			if (sPos == sEnd) { return -1; }
+			if (sPos == sEnd) { return WriteError(sDescriptor, iFieldArgs); }
 
 			// .precision
 			if (*sPos == '.')
 			{
 				++sPos;
-				if (sPos == sEnd) { return -1; }
+				if (sPos == sEnd) { return WriteError(sDescriptor, iFieldArgs); }
 
 				iPrecision = 0;
 				if (*sPos >= '0' && *sPos <= '9')
@@ -794,8 +940,8 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 				}
 				else if (*sPos == '*')
 				{
-					iPrecision = (INT_32)oArgs.GetCDT(iPos).GetInt();
-					++iPos;
+					iFmtFlags |= F_PRECISION_ARG;
+					++iFieldArgs;
 					++sPos;
 				}
 			}
@@ -815,7 +961,7 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 					{
 						oFmtLengths = F_LONG;
 						++sPos;
-						if (sPos == sEnd) { return -1; }
+						if (sPos == sEnd) { return WriteError(sDescriptor, iFieldArgs); }
 						if (*sPos == 'l' || *sPos == 'L')
 						{
 							oFmtLengths = F_LONG_LONG;
@@ -826,76 +972,32 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 			}
 
 			// Check end of string
-			if (sPos == sEnd) { return -1; }
+			if (sPos == sEnd) { return WriteError(sDescriptor, iFieldArgs); }
 
 			// Specifiers
-			//  A % followed by another % character will write % to the string.
-			if (*sPos == '%') { oBuffer.Append(sPos, 1); }
+			//  A % followed by another % character will write % to the string; "%" is a start of next token
+			if (*sPos == '%')
+			{
+				if (iFieldArgs != 0)
+				{
+					sDescriptor.push_back(CHAR_8(FR_SKIP));
+					sDescriptor.push_back(CHAR_8(iFieldArgs));
+					iTextRecord = -1;
+				}
+				WriteText(sDescriptor, iTextRecord, sPos, sPos + 1);
+			}
 			else
 			{
-				const CDT oCurrentArgument = oArgs.GetCDT(iPos);
-				++iPos;
-
 				switch(*sPos)
 				{
-					//  Character 'a'
-					case 'c':
-						FmtChar(oBuffer, oCurrentArgument, iFmtFlags, iWidth, chPadSymbol);
-						break;
-					// 'd' or 'i' Signed decimal integer '392'
-					case 'd':
-					case 'i':
-						FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_DECIMAL, 10, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Scientific notation (mantise/exponent) using e character '3.9265e+2'
-					case 'e':
-						FmtSci(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'e', iWidth, iPrecision, chPadSymbol);
-						break;
-					// Scientific notation (mantise/exponent) using E character '3.9265E+2'
-					case 'E':
-						FmtSci(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'E', iWidth, iPrecision, chPadSymbol);
-						break;
-					// Decimal floating point '392.65'
-					case 'f':
-						FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'e', F_FLOAT_F, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Use the shorter of %e or %f '392.65'
-					case 'g':
-						FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'e', F_FLOAT_G, iWidth, iPrecision, chPadSymbol);
-						break;
-					case 'F':
-						FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'E', F_FLOAT_F, iWidth, iPrecision, chPadSymbol);
-						break;
-					case 'G':
-						FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'E', F_FLOAT_G, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Signed octal '610'
-					case 'o':
-						FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_OCTAL, 8, iWidth, iPrecision, chPadSymbol);
-						break;
-					// String of characters 'sample'
-					case 's':
-						FmtString(oBuffer, oCurrentArgument, iFmtFlags, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Unsigned decimal integer '7235'
-					case 'u':
-						FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_UNSIGNED, 10, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Unsigned hexadecimal integer '7fa'
-					case 'x':
-						FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_HEX, 16, iWidth, iPrecision, chPadSymbol);
+					case 'c': case 'd': case 'i': case 'e': case 'E':
+					case 'f': case 'g': case 'F': case 'G': case 'o':
+					case 's': case 'u': case 'x': case 'X': case 'p':
+						WriteField(sDescriptor, iTextRecord, *sPos, iFmtFlags, oFmtLengths, chPadSymbol, iWidth, iPrecision);
 						break;
-					// Unsigned hexadecimal integer (capital letters) 7FA
-					case 'X':
-						FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsUc, F_HEX, 16, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Pointer address 1a2b3c4e
-					case 'p':
-						FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_POINTER, 16, iWidth, iPrecision, chPadSymbol);
-						break;
-					// Invalid format; return error code
+					// Invalid format; argument is fetched anyway
 					default:
-						return -1;
+						return WriteError(sDescriptor, iFieldArgs + 1);
 				}
 				++sPos;
 			}
@@ -905,10 +1007,203 @@ INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult,
 
 		if (sPos == sEnd) { break; }
 	}
-	oBuffer.Flush();
 
 return 0;
 }
 
+//
+// Format field
+//
+static INT_32 FormatField(StringBuffer       & oBuffer,
+                          const CDT          & oCurrentArgument,
+                          const CHAR_8         chSpecifier,
+                          const UINT_32        iFmtFlags,
+                          const eFmtLengths    oFmtLengths,
+                          const INT_32         iWidth,
+                          const INT_32         iPrecision,
+                          const CHAR_8         chPadSymbol)
+{
+	switch(chSpecifier)
+	{
+		//  Character 'a'
+		case 'c':
+			FmtChar(oBuffer, oCurrentArgument, iFmtFlags, iWidth, chPadSymbol);
+			break;
+		// 'd' or 'i' Signed decimal integer '392'
+		case 'd':
+		case 'i':
+			FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_DECIMAL, 10, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Scientific notation (mantise/exponent) using e character '3.9265e+2'
+		case 'e':
+			FmtSci(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'e', iWidth, iPrecision, chPadSymbol);
+			break;
+		// Scientific notation (mantise/exponent) using E character '3.9265E+2'
+		case 'E':
+			FmtSci(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'E', iWidth, iPrecision, chPadSymbol);
+			break;
+		// Decimal floating point '392.65'
+		case 'f':
+			FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'e', F_FLOAT_F, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Use the shorter of %e or %f '392.65'
+		case 'g':
+			FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'e', F_FLOAT_G, iWidth, iPrecision, chPadSymbol);
+			break;
+		case 'F':
+			FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'E', F_FLOAT_F, iWidth, iPrecision, chPadSymbol);
+			break;
+		case 'G':
+			FmtFloat(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, 'E', F_FLOAT_G, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Signed octal '610'
+		case 'o':
+			FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_OCTAL, 8, iWidth, iPrecision, chPadSymbol);
+			break;
+		// String of characters 'sample'
+		case 's':
+			FmtString(oBuffer, oCurrentArgument, iFmtFlags, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Unsigned decimal integer '7235'
+		case 'u':
+			FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_UNSIGNED, 10, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Unsigned hexadecimal integer '7fa'
+		case 'x':
+			FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_HEX, 16, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Unsigned hexadecimal integer (capital letters) 7FA
+		case 'X':
+			FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsUc, F_HEX, 16, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Pointer address 1a2b3c4e
+		case 'p':
+			FmtInt(oBuffer, oCurrentArgument, iFmtFlags, oFmtLengths, szDigitsLc, F_POINTER, 16, iWidth, iPrecision, chPadSymbol);
+			break;
+		// Broken descriptor
+		default:
+			return -1;
+	}
+
+return 0;
+}
+
+//
+// Format arguments with parsed format string
+//
+template <typename T>static INT_32 ExecuteFormat(StringBuffer  & oBuffer,
+                                                 CCHAR_P         sPos,
+                                                 CCHAR_P         sEnd,
+                                                 const T       & oArgs)
+{
+	if (sPos == sEnd || UCHAR_8(*sPos) != C_FORMAT_DESCRIPTOR_VERSION) { return -1; }
+	++sPos;
+
+	UINT_32 iPos = 0;
+	while (sPos != sEnd)
+	{
+		switch(*sPos++)
+		{
+			case FR_TEXT:
+				{
+					if (sEnd - sPos < 4) { return -1; }
+					const UINT_32 iLength = DecodeInt(sPos);
+					sPos += 4;
+
+					if (UINT_32(sEnd - sPos) < iLength) { return -1; }
+					oBuffer.Append(sPos, iLength);
+					sPos += iLength;
+				}
+				break;
+
+			case FR_FIELD:
+				{
+					if (sEnd - sPos < C_FIELD_RECORD_LEN) { return -1; }
+					const CHAR_8       chSpecifier = sPos[0];
+					const UINT_32      iFmtFlags   = UCHAR_8(sPos[1]);
+					const eFmtLengths  oFmtLengths = eFmtLengths(UCHAR_8(sPos[2]) & 0x03);
+					const CHAR_8       chPadSymbol = sPos[3];
+					INT_32             iWidth      = DecodeInt(sPos + 4);
+					INT_32             iPrecision  = DecodeInt(sPos + 8);
+					sPos += C_FIELD_RECORD_LEN;
+
+					if (iFmtFlags & F_WIDTH_ARG)
+					{
+						iWidth = (INT_32)oArgs.Get(iPos).GetInt();
+						++iPos;
+					}
+
+					if (iFmtFlags & F_PRECISION_ARG)
+					{
+						iPrecision = (INT_32)oArgs.Get(iPos).GetInt();
+						++iPos;
+					}
+
+					const CDT & oCurrentArgument = oArgs.Get(iPos);
+					++iPos;
+
+					if (FormatField(oBuffer, oCurrentArgument, chSpecifier, iFmtFlags & ~(F_WIDTH_ARG | F_PRECISION_ARG), oFmtLengths, iWidth, iPrecision, chPadSymbol) == -1) { return -1; }
+				}
+				break;
+
+			case FR_SKIP:
+				{
+					if (sPos == sEnd) { return -1; }
+					UINT_32 iSkipArgs = UCHAR_8(*sPos++);
+					while (iSkipArgs-- != 0)
+					{
+						oArgs.Get(iPos);
+						++iPos;
+					}
+				}
+				break;
+
+			// Invalid format string or broken descriptor
+			default:
+				return -1;
+		}
+	}
+
+return 0;
+}
+
+//
+// Format arguments stored in CDT array
+//
+INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult, const CDT & oArgs)
+{
+	STLW::string sDescriptor;
+	CompileFormatString(sFormatString, sDescriptor);
+
+	StringBuffer oBuffer(sResult);
+	const INT_32 iRC = ExecuteFormat(oBuffer, sDescriptor.data(), sDescriptor.data() + sDescriptor.size(), FormatArrayArgs(oArgs));
+	oBuffer.Flush();
+
+return iRC;
+}
+
+//
+// Format arguments of syscall
+//
+INT_32 FormatString(const STLW::string & sFormatString, STLW::string & sResult, const CDT * aArguments, const UINT_32 iArgNum)
+{
+	STLW::string sDescriptor;
+	CompileFormatString(sFormatString, sDescriptor);
+
+return FormatCompiled(sDescriptor.data(), sDescriptor.size(), sResult, aArguments, iArgNum);
+}
+
+//
+// Format arguments of syscall with parsed format string
+//
+INT_32 FormatCompiled(CCHAR_P szDescriptor, const UINT_32 iDescriptorLength, STLW::string & sResult, const CDT * aArguments, const UINT_32 iArgNum)
+{
+	StringBuffer oBuffer(sResult);
+	const INT_32 iRC = ExecuteFormat(oBuffer, szDescriptor, szDescriptor + iDescriptorLength, FormatFrameArgs(aArguments, iArgNum));
+	oBuffer.Flush();
+
+return iRC;
+}
+
 } // namespace CTPP
 // End.
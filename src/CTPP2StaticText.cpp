@@ -45,9 +45,14 @@ ReducedStaticText::ReducedStaticText(CCHAR_P                sIData,
                                      const UINT_32          iIUsedDataOffsetsSize,
                                      const TextDataIndex  * aIDataOffsets): sData(sIData),
                                                                             iUsedDataOffsetsSize(iIUsedDataOffsetsSize),
-                                                                            aDataOffsets(aIDataOffsets)
+                                                                            aDataOffsets(aIDataOffsets),
+                                                                            iDataSize(0)
 {
-	;;
+	for (UINT_32 iI = 0; iI < iUsedDataOffsetsSize; ++iI)
+	{
+		const UINT_32 iDataEnd = aDataOffsets[iI].offset + aDataOffsets[iI].length;
+		if (iDataEnd > iDataSize) { iDataSize = iDataEnd; }
+	}
 }
 
 //
@@ -68,6 +73,16 @@ return &sData[aDataOffsets[iDataId].offset];
 //
 UINT_32 ReducedStaticText::GetRecordsNum() const { return iUsedDataOffsetsSize; }
 
+//
+// Get whole text segment
+//
+CCHAR_P ReducedStaticText::GetRawData(UINT_32 & iIDataSize) const
+{
+	iIDataSize = iDataSize;
+
+return sData;
+}
+
 //
 // A destructor
 //
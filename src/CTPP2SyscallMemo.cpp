@@ -0,0 +1,153 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2SyscallMemo.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2SyscallMemo.hpp"
+
+namespace CTPP // C++ Template Engine
+{
+
+//
+// Append plain value to key
+//
+template <typename T>static void AppendValue(STLW::string & sKey, const T & oValue)
+{
+	sKey.append((CCHAR_P)&oValue, sizeof(oValue));
+}
+
+//
+// Constructor
+//
+SyscallMemo::SyscallMemo(): oArguments(CDT::UNDEF),
+                            bKeyValid(false)
+{
+	;;
+}
+
+//
+// Find result of call
+//
+bool SyscallMemo::Find(const UINT_32    iCallNum,
+                       const CDT      * aArguments,
+                       const UINT_32    iArgNum,
+                       CDT            & oResult)
+{
+	bKeyValid = false;
+	oArguments = CDT(CDT::UNDEF);
+
+	sKey.assign((CCHAR_P)&iCallNum, sizeof(iCallNum));
+	for (UINT_32 iPos = 0; iPos < iArgNum; ++iPos)
+	{
+		const CDT & oArgument = aArguments[iPos];
+		const CDT::eValType eType = oArgument.GetType();
+		sKey.append(1, CHAR_8(eType));
+
+		switch (eType)
+		{
+			case CDT::UNDEF:
+				break;
+
+			case CDT::INT_VAL:
+				AppendValue(sKey, oArgument.GetInt());
+				break;
+
+			case CDT::REAL_VAL:
+				AppendValue(sKey, oArgument.GetFloat());
+				break;
+
+			case CDT::STRING_VAL:
+			case CDT::STRING_INT_VAL:
+			case CDT::STRING_REAL_VAL:
+				{
+					UINT_32 iLength = 0;
+					CCHAR_P szData  = oArgument.GetStringData(iLength);
+					AppendValue(sKey, iLength);
+					sKey.append(szData, iLength);
+				}
+				break;
+
+			// Containers are compared by identity and kept with result
+			case CDT::ARRAY_VAL:
+			case CDT::HASH_VAL:
+				AppendValue(sKey, oArgument.GetIdentity());
+				oArguments.PushBack(oArgument);
+				break;
+
+			default:
+				return false;
+		}
+	}
+	bKeyValid = true;
+
+	STLW::map<STLW::string, MemoRecord>::const_iterator itmResults = mResults.find(sKey);
+	if (itmResults == mResults.end()) { return false; }
+
+	oResult = itmResults -> second.result;
+	oArguments = CDT(CDT::UNDEF);
+	bKeyValid = false;
+
+return true;
+}
+
+//
+// Store result of call
+//
+void SyscallMemo::Store(const CDT & oResult)
+{
+	if (!bKeyValid) { return; }
+
+	if (mResults.size() >= C_MAX_MEMOIZED_CALLS) { mResults.clear(); }
+
+	MemoRecord & oRecord = mResults[sKey];
+	oRecord.result    = oResult;
+	oRecord.arguments = oArguments;
+
+	oArguments = CDT(CDT::UNDEF);
+	bKeyValid = false;
+}
+
+//
+// Remove all results
+//
+void SyscallMemo::Clear()
+{
+	mResults.clear();
+	oArguments = CDT(CDT::UNDEF);
+	bKeyValid = false;
+}
+
+//
+// A destructor
+//
+SyscallMemo::~SyscallMemo() throw() { ;; }
+
+} // namespace CTPP
+// End.
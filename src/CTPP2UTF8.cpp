@@ -0,0 +1,228 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2UTF8.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CTPP2UTF8.hpp"
+
+#include "CTPP2Util.hpp"
+
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define C_UTF8_BLOCK_LEN 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define C_UTF8_BLOCK_LEN 16
+#else
+#define C_UTF8_BLOCK_LEN 8
+#endif
+
+namespace CTPP // C++ Template Engine
+{
+
+#if defined(__SSE2__)
+//
+// Number of set bits
+//
+static inline UINT_32 PopCount(UINT_32 iMask)
+{
+#if defined(__GNUC__)
+	return __builtin_popcount(iMask);
+#else
+	UINT_32 iCount = 0;
+	while (iMask != 0) { iMask &= iMask - 1; ++iCount; }
+
+return iCount;
+#endif
+}
+
+//
+// Position of highest set bit
+//
+static inline UINT_32 HighestBit(const UINT_32 iMask)
+{
+#if defined(__GNUC__)
+	return 31 - __builtin_clz(iMask);
+#else
+	UINT_32 iPos = 31;
+	while (((iMask >> iPos) & 1) == 0) { --iPos; }
+
+return iPos;
+#endif
+}
+
+//
+// Prefix of block that consists of whole well-formed sequences; one bit per byte in masks
+//
+static inline UINT_32 WellFormedPrefix(const UINT_32    iCont,
+                                       const UINT_32    iLead2,
+                                       const UINT_32    iLead3,
+                                       const UINT_32    iLead4,
+                                       const UINT_32    iInvalid,
+                                       UINT_32        & iChars)
+{
+	const UINT_64 iBlockMask = (UINT_64(1) << C_UTF8_BLOCK_LEN) - 1;
+	const UINT_32 iLeads     = iLead2 | iLead3 | iLead4;
+	// Continuation bytes required by lead bytes
+	const UINT_64 iExpected  = (UINT_64(iLeads) << 1) | (UINT_64(iLead3 | iLead4) << 2) | (UINT_64(iLead4) << 3);
+
+	// Broken sequence, or continuation byte at the start of block; leave it to utf_charlen
+	if (iInvalid != 0 || (iExpected & iBlockMask) != iCont) { return 0; }
+
+	// Last sequence ends in next block
+	UINT_32 iLength = C_UTF8_BLOCK_LEN;
+	if ((iExpected >> C_UTF8_BLOCK_LEN) != 0) { iLength = HighestBit(iLeads); }
+
+	iChars = iLength - PopCount(UINT_32(iCont & ((UINT_64(1) << iLength) - 1)));
+
+return iLength;
+}
+#endif
+
+//
+// Prefix of block that consists of whole characters
+//
+static inline UINT_32 ScanBlock(CCHAR_P szString, UINT_32 & iChars)
+{
+#if defined(__AVX2__)
+	const __m256i vBlock = _mm256_loadu_si256((const __m256i *)szString);
+	// Pure ASCII
+	if (_mm256_movemask_epi8(vBlock) == 0) { iChars = C_UTF8_BLOCK_LEN; return C_UTF8_BLOCK_LEN; }
+
+	const __m256i vF8 = _mm256_set1_epi8(CHAR_8(0xF8));
+	const __m256i vF0 = _mm256_set1_epi8(CHAR_8(0xF0));
+	const __m256i vE0 = _mm256_set1_epi8(CHAR_8(0xE0));
+	const __m256i vC0 = _mm256_set1_epi8(CHAR_8(0xC0));
+
+	return WellFormedPrefix(UINT_32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(vBlock, vC0), _mm256_set1_epi8(CHAR_8(0x80))))),
+	                        UINT_32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(vBlock, vE0), vC0))),
+	                        UINT_32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(vBlock, vF0), vE0))),
+	                        UINT_32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(vBlock, vF8), vF0))),
+	                        UINT_32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(vBlock, vF8), vF8))),
+	                        iChars);
+#elif defined(__SSE2__)
+	const __m128i vBlock = _mm_loadu_si128((const __m128i *)szString);
+	// Pure ASCII
+	if (_mm_movemask_epi8(vBlock) == 0) { iChars = C_UTF8_BLOCK_LEN; return C_UTF8_BLOCK_LEN; }
+
+	const __m128i vF8 = _mm_set1_epi8(CHAR_8(0xF8));
+	const __m128i vF0 = _mm_set1_epi8(CHAR_8(0xF0));
+	const __m128i vE0 = _mm_set1_epi8(CHAR_8(0xE0));
+	const __m128i vC0 = _mm_set1_epi8(CHAR_8(0xC0));
+
+	return WellFormedPrefix(UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vBlock, vC0), _mm_set1_epi8(CHAR_8(0x80))))),
+	                        UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vBlock, vE0), vC0))),
+	                        UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vBlock, vF0), vE0))),
+	                        UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vBlock, vF8), vF0))),
+	                        UINT_32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vBlock, vF8), vF8))),
+	                        iChars);
+#else
+	// Pure ASCII only
+	UINT_64 iWord;
+	memcpy(&iWord, szString, sizeof(iWord));
+	if ((iWord & 0x8080808080808080ull) != 0) { return 0; }
+
+	iChars = C_UTF8_BLOCK_LEN;
+return C_UTF8_BLOCK_LEN;
+#endif
+}
+
+//
+// Count characters, stop after iMaxChars characters
+//
+static CCHAR_P ScanString(CCHAR_P          szString,
+                          CCHAR_P          szStringEnd,
+                          const UINT_32    iMaxChars,
+                          const bool       bCountBroken,
+                          UINT_32        & iChars)
+{
+	iChars = 0;
+	while (iChars != iMaxChars)
+	{
+		// Whole characters in block; take them if limit is not reached
+		if (szStringEnd - szString >= C_UTF8_BLOCK_LEN)
+		{
+			UINT_32 iBlockChars = 0;
+			const UINT_32 iBlockLen = ScanBlock(szString, iBlockChars);
+			if (iBlockLen != 0 && iMaxChars - iChars >= iBlockChars)
+			{
+				iChars   += iBlockChars;
+				szString += iBlockLen;
+				continue;
+			}
+		}
+
+		INT_32 iCharLen = utf_charlen(szString, szStringEnd);
+		// End of string, or incomplete sequence
+		if (iCharLen == -3) { break; }
+
+		// Broken sequence
+		if (iCharLen < 0)
+		{
+			iCharLen = 1;
+			if (bCountBroken) { ++iChars; }
+		}
+		else
+		{
+			++iChars;
+		}
+		szString += iCharLen;
+	}
+
+return szString;
+}
+
+//
+// Number of characters in UTF-8 string
+//
+UINT_32 UTF8Length(CCHAR_P   szString,
+                   CCHAR_P   szStringEnd)
+{
+	UINT_32 iChars = 0;
+	ScanString(szString, szStringEnd, UINT_32(-1), true, iChars);
+
+return iChars;
+}
+
+//
+// Skip characters of UTF-8 string
+//
+CCHAR_P UTF8Skip(CCHAR_P          szString,
+                 CCHAR_P          szStringEnd,
+                 const UINT_32    iChars,
+                 UINT_32        & iSkipped)
+{
+	return ScanString(szString, szStringEnd, iChars, false, iSkipped);
+}
+
+} // namespace CTPP
+// End.
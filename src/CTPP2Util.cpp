@@ -30,7 +30,11 @@
  * $CTPP$
  */
 #include "CTPP2Util.hpp"
+#include "CTPP2Escape.hpp"
 #include "CTPP2Exception.hpp"
+#include "CTPP2JSONSerializer.hpp"
+#include "CTPP2OutputCollector.hpp"
+#include "CTPP2StringOutputCollector.hpp"
 
 #include "CDT.hpp"
 
@@ -126,49 +130,10 @@ return u.ul;
 //
 STLW::string URLEscape(const STLW::string  & sData)
 {
-	static const CHAR_8 * szEscape = "0123456789ABCDEF";
+	STLW::string sRetVal;
+	sRetVal.reserve(sData.size());
 
-	CHAR_8 sBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
-
-	STLW::string sRetVal = "";
-
-	UINT_32 iBufferPointer = 0;
-
-	// Get string to escape
-	STLW::string::const_iterator itsData = sData.begin();
-	while (itsData != sData.end())
-	{
-		UCHAR_8 chTMP = (UCHAR_8)(*itsData);
-
-		if ((chTMP >= 'a' && chTMP <= 'z') ||
-		    (chTMP >= 'A' && chTMP <= 'Z') ||
-		    (chTMP >= '0' && chTMP <= '9') ||
-		     chTMP == '/' || chTMP == '.' || chTMP == '-' || chTMP == '_')
-		{
-			sBuffer[iBufferPointer++] = *itsData;
-		}
-//		else if (chTMP == ' ') { sBuffer[iBufferPointer++] = '+'; }
-		else
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 3))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-			sBuffer[iBufferPointer++] = '%';
-			sBuffer[iBufferPointer++] = szEscape[((chTMP >> 4) & 0x0F)];
-			sBuffer[iBufferPointer++] = szEscape[(chTMP & 0x0F)];
-		}
-
-		if (iBufferPointer == CTPP_ESCAPE_BUFFER_LEN)
-		{
-			sRetVal.append(sBuffer, iBufferPointer);
-			iBufferPointer = 0;
-		}
-		++itsData;
-	}
-
-	if (iBufferPointer != 0) { sRetVal.append(sBuffer, iBufferPointer); }
+	EscapeData(ESCAPE_URL, sData.data(), sData.size(), sRetVal);
 
 return sRetVal;
 }
@@ -178,48 +143,10 @@ return sRetVal;
 //
 STLW::string URIEscape(const STLW::string  & sData)
 {
-	static const CHAR_8 * szEscape = "0123456789ABCDEF";
-
-	CHAR_8 sBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
+	STLW::string sRetVal;
+	sRetVal.reserve(sData.size());
 
-	STLW::string sRetVal = "";
-
-	UINT_32 iBufferPointer = 0;
-
-	// Get string to escape
-	STLW::string::const_iterator itsData = sData.begin();
-	while (itsData != sData.end())
-	{
-		UCHAR_8 chTMP = (UCHAR_8)(*itsData);
-
-		if ((chTMP >= 'a' && chTMP <= 'z') ||
-		    (chTMP >= 'A' && chTMP <= 'Z') ||
-		    (chTMP >= '0' && chTMP <= '9') ||
-		     chTMP == '/' || chTMP == '.' || chTMP == '-' || chTMP == '_')
-		{
-			sBuffer[iBufferPointer++] = *itsData;
-		}
-		else
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 3))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-			sBuffer[iBufferPointer++] = '%';
-			sBuffer[iBufferPointer++] = szEscape[((chTMP >> 4) & 0x0F)];
-			sBuffer[iBufferPointer++] = szEscape[(chTMP & 0x0F)];
-		}
-
-		if (iBufferPointer == CTPP_ESCAPE_BUFFER_LEN)
-		{
-			sRetVal.append(sBuffer, iBufferPointer);
-			iBufferPointer = 0;
-		}
-		++itsData;
-	}
-
-	if (iBufferPointer != 0) { sRetVal.append(sBuffer, iBufferPointer); }
+	EscapeData(ESCAPE_URI, sData.data(), sData.size(), sRetVal);
 
 return sRetVal;
 }
@@ -229,101 +156,10 @@ return sRetVal;
 //
 STLW::string HTMLEscape(const STLW::string  & sData)
 {
-	CHAR_8 sBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
-
-	STLW::string sRetVal = "";
+	STLW::string sRetVal;
+	sRetVal.reserve(sData.size());
 
-	UINT_32 iBufferPointer = 0;
-
-	// Get string to escape
-	STLW::string::const_iterator itsData = sData.begin();
-	while (itsData != sData.end())
-	{
-		UCHAR_8 chTMP = (UCHAR_8)(*itsData);
-
-		if (chTMP == '"')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 6))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'q';
-			sBuffer[iBufferPointer++] = 'u';
-			sBuffer[iBufferPointer++] = 'o';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '\'')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 5))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = '#';
-			sBuffer[iBufferPointer++] = '3';
-			sBuffer[iBufferPointer++] = '9';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '<')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 4))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'l';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '>')
-		{
-			if (iBufferPointer >= CTPP_ESCAPE_BUFFER_LEN - 4)
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'g';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '&')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 5))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'a';
-			sBuffer[iBufferPointer++] = 'm';
-			sBuffer[iBufferPointer++] = 'p';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else
-		{
-			sBuffer[iBufferPointer++] = *itsData;
-		}
-
-		if (iBufferPointer == CTPP_ESCAPE_BUFFER_LEN)
-		{
-			sRetVal.append(sBuffer, iBufferPointer);
-			iBufferPointer = 0;
-		}
-		++itsData;
-	}
-
-	if (iBufferPointer != 0) { sRetVal.append(sBuffer, iBufferPointer); }
+	EscapeData(ESCAPE_HTML, sData.data(), sData.size(), sRetVal);
 
 return sRetVal;
 }
@@ -333,102 +169,10 @@ return sRetVal;
 //
 STLW::string XMLEscape(const STLW::string  & sData)
 {
-	CHAR_8 sBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
-
-	STLW::string sRetVal = "";
+	STLW::string sRetVal;
+	sRetVal.reserve(sData.size());
 
-	UINT_32 iBufferPointer = 0;
-
-	// Get string to escape
-	STLW::string::const_iterator itsData = sData.begin();
-	while (itsData != sData.end())
-	{
-		UCHAR_8 chTMP = (UCHAR_8)(*itsData);
-
-		if (chTMP == '"')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 6))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'q';
-			sBuffer[iBufferPointer++] = 'u';
-			sBuffer[iBufferPointer++] = 'o';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '\'')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 6))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'a';
-			sBuffer[iBufferPointer++] = 'p';
-			sBuffer[iBufferPointer++] = 'o';
-			sBuffer[iBufferPointer++] = 's';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '<')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 4))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'l';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '>')
-		{
-			if (iBufferPointer >= CTPP_ESCAPE_BUFFER_LEN - 4)
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'g';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '&')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 5))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'a';
-			sBuffer[iBufferPointer++] = 'm';
-			sBuffer[iBufferPointer++] = 'p';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else
-		{
-			sBuffer[iBufferPointer++] = *itsData;
-		}
-
-		if (iBufferPointer == CTPP_ESCAPE_BUFFER_LEN)
-		{
-			sRetVal.append(sBuffer, iBufferPointer);
-			iBufferPointer = 0;
-		}
-		++itsData;
-	}
-
-	if (iBufferPointer != 0) { sRetVal.append(sBuffer, iBufferPointer); }
+	EscapeData(ESCAPE_XML, sData.data(), sData.size(), sRetVal);
 
 return sRetVal;
 }
@@ -438,250 +182,71 @@ return sRetVal;
 //
 STLW::string WMLEscape(const STLW::string  & sData)
 {
-	CHAR_8 sBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
-
-	STLW::string sRetVal = "";
+	STLW::string sRetVal;
+	sRetVal.reserve(sData.size());
 
-	UINT_32 iBufferPointer = 0;
+	EscapeData(ESCAPE_WML, sData.data(), sData.size(), sRetVal);
 
-	// Get string to escape
-	STLW::string::const_iterator itsData = sData.begin();
-	while (itsData != sData.end())
-	{
-		UCHAR_8 chTMP = (UCHAR_8)(*itsData);
+return sRetVal;
+}
 
-		if (chTMP < ' ')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 6))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-			snprintf(sBuffer + iBufferPointer, 6, "\\u%04d", chTMP);
-		}
-		else if (chTMP == '"')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 6))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'q';
-			sBuffer[iBufferPointer++] = 'u';
-			sBuffer[iBufferPointer++] = 'o';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '\'')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 6))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'a';
-			sBuffer[iBufferPointer++] = 'p';
-			sBuffer[iBufferPointer++] = 'o';
-			sBuffer[iBufferPointer++] = 's';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '<')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 4))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'l';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '>')
-		{
-			if (iBufferPointer >= CTPP_ESCAPE_BUFFER_LEN - 4)
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'g';
-			sBuffer[iBufferPointer++] = 't';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '&')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 5))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '&';
-			sBuffer[iBufferPointer++] = 'a';
-			sBuffer[iBufferPointer++] = 'm';
-			sBuffer[iBufferPointer++] = 'p';
-			sBuffer[iBufferPointer++] = ';';
-		}
-		else if (chTMP == '$')
-		{
-			if (iBufferPointer >= (CTPP_ESCAPE_BUFFER_LEN - 4))
-			{
-				sRetVal.append(sBuffer, iBufferPointer);
-				iBufferPointer = 0;
-			}
-
-			sBuffer[iBufferPointer++] = '$';
-			sBuffer[iBufferPointer++] = '$';
-		}
-		else
-		{
-			sBuffer[iBufferPointer++] = *itsData;
-		}
 
-		if (iBufferPointer == CTPP_ESCAPE_BUFFER_LEN)
-		{
-			sRetVal.append(sBuffer, iBufferPointer);
-			iBufferPointer = 0;
-		}
-		++itsData;
+//
+// Output collector for DumpBuffer
+//
+class DumpBufferOutputCollector:
+  public OutputCollector
+{
+public:
+	/**
+	  @brief Constructor
+	  @param oIBuffer - buffer
+	*/
+	DumpBufferOutputCollector(DumpBuffer & oIBuffer): oBuffer(oIBuffer) { ;; }
+
+	/**
+	  @brief Collect data
+	*/
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength)
+	{
+		oBuffer.Write((CCHAR_P)vData, iDataLength);
+		return 0;
 	}
 
-	if (iBufferPointer != 0) { sRetVal.append(sBuffer, iBufferPointer); }
-
-return sRetVal;
-}
-
+	/**
+	  @brief A destructor
+	*/
+	~DumpBufferOutputCollector() throw() { ;; }
+private:
+	/** Buffer */
+	DumpBuffer  & oBuffer;
+};
 
 //
 // Escape string, if need
 //
 STLW::string EscapeJSONString(const STLW::string & sSource, const bool & bECMAConventions, const bool & bHTMLSafe)
 {
-    DumpBuffer oBuff;
-    DumpJSONString(oBuff, sSource, bECMAConventions, bHTMLSafe);
-    return STLW::string(oBuff.Data(), oBuff.Size());
-}
+	STLW::string sResult;
+	StringOutputCollector oCollector(sResult);
+	{
+		CTPP2JSONSerializer oSerializer(oCollector, bECMAConventions, bHTMLSafe);
+		oSerializer.WriteString(sSource.data(), sSource.size());
+	}
 
+return sResult;
+}
 
 //
 // Escape and dump string to buffer
 //
-DumpBuffer & DumpJSONString(DumpBuffer & sResult, const STLW::string & sSource, const bool & bECMAConventions, const bool & bHTMLSafe)
+DumpBuffer & DumpJSONString(DumpBuffer & oBuffer, const STLW::string & sSource, const bool & bECMAConventions, const bool & bHTMLSafe)
 {
-    INT_32 iPos = 0;
-    INT_32 iSize = sSource.size();
-    INT_32 iOffset = 0;
-
-    static unsigned char mask[] = {192, 224, 240}; 
-
-    //JSON works with utf8 only!
-    while (iSize--)
-    {
-        const UCHAR_8 uCH = sSource[iPos];
-        const CHAR_8 * sEscaped = NULL;
-        bool bFound = false;
-	UCHAR_8 c_bytes[4]; 
-	UINT_32 unicode;
-	int utf_size;
-	utf_size = (uCH & mask[2])==mask[2] ? 4 : (uCH & mask[1]) == mask[1] ? 3 : (uCH & mask[0]) == mask[0] ?  2  : 1;
-	unicode  = utf_size == 1 ? uCH : utf_size == 2 ? (uCH & 31) : utf_size == 3 ? (uCH & 15 ) : ( uCH & 7 );
-	//single_byte chars
-        switch (uCH)
-        {
-            case '"':
-                sEscaped = "\\\"";
-                bFound = true;
-                break;
-            case '\\':
-                sEscaped = "\\\\";
-                bFound = true;
-                break;
-            case '/':
-                sEscaped = "\\/";
-                bFound = true;
-                break;
-            case '\b':
-                sEscaped = "\\b";
-                bFound = true;
-                break;
-            case '\f':
-                sEscaped = "\\f";
-                bFound = true;
-                break;
-            case '\n':
-                sEscaped = "\\n";
-                bFound = true;
-                break;
-            case '\r':
-                sEscaped = "\\r";
-                bFound = true;
-                break;
-            case '\t':
-                sEscaped = "\\t";
-                bFound = true;
-                break;
-            case '\'':
-                sEscaped = "\\'";
-                if (bECMAConventions) { bFound = true; }
-                break;
-            case '\v':
-                sEscaped = "\\v";
-                if (bECMAConventions) { bFound = true; }
-                break;
-            case '\0':
-                sEscaped = "\\0";
-                if (bECMAConventions) { bFound = true; }
-                break;
-            default:
-                break;
-        }
-
-        if (bFound)
-        {
-            if (iPos - iOffset > 0) { sResult.Write(sSource.c_str() + iOffset, iPos - iOffset); }
-            sResult.Write(sEscaped, strlen(sEscaped));
-            iOffset = iPos + 1;
-        }
-        else if (uCH < ' ' || (bHTMLSafe && (uCH == '<' || uCH == '>')))
-        {
-            if (iPos - iOffset > 0) { sResult.Write(sSource.c_str() + iOffset, iPos - iOffset); }
-            CHAR_8 szBuffer[7] = { '\0' };
-            const CHAR_8 *szHexChars = "0123456789abcdef";
-			snprintf(szBuffer, 7, "\\u00%c%c", szHexChars[uCH >> 4], szHexChars[uCH & 0xF]);
-			sResult.Write(szBuffer, 6);
-            iOffset = iPos + 1;
-        }
-	else if (utf_size > 1 ) { 
-	    int i;
-            memset(c_bytes, 0, 4);
-	    c_bytes[0] = uCH;
-	    for (i=1; i < utf_size; i++) { 
-		if(iSize-- == 0) { break; } // broken UTF-8 string; what to do? simply return now 
-                c_bytes[i] = sSource[++iPos];
-		if(!c_bytes[i] || (c_bytes[i] & 0xC0) != 0x80) { break; }  // malformed utf-8
-		unicode = (unicode << 6) | (c_bytes[i] & 0x3F);
-            }
-	    if(c_bytes[0] == 0xE2 && c_bytes[1] == 0x80 && (c_bytes[2] == 0xA8 || c_bytes[2] == 0xA9)) { //2028 unicode line separator, 29 paragraph separator
-		CHAR_8 szBuffer[7] = { '\0' };
-		if (iPos - iOffset > 0) { sResult.Write(sSource.c_str() + iOffset, iPos - 2 - iOffset); }
-		snprintf(szBuffer, 7, "\\u%04x",  unicode);
-		sResult.Write(szBuffer, 6);
-		iOffset = iPos + 1;
-	    }
-	}
-        ++iPos;
-    }
-
-    if (iPos - iOffset > 0) { sResult.Write(sSource.c_str() + iOffset, iPos - iOffset); }
+	DumpBufferOutputCollector oCollector(oBuffer);
+	CTPP2JSONSerializer oSerializer(oCollector, bECMAConventions, bHTMLSafe);
+	oSerializer.WriteString(sSource.data(), sSource.size());
 
-return sResult;
+return oBuffer;
 }
 
 //
@@ -689,9 +254,9 @@ return sResult;
 //
 void CDT2JSON(const CTPP::CDT & oCDT, STLW::string & sData)
 {
-    DumpBuffer oBuff;
-    DumpCDT2JSON(oCDT, oBuff);
-    sData.append(oBuff.Data(), oBuff.Size());
+	StringOutputCollector oCollector(sData);
+	CTPP2JSONSerializer oSerializer(oCollector);
+	oSerializer.WriteCDT(oCDT);
 }
 
 DumpBuffer::~DumpBuffer()
@@ -732,69 +297,15 @@ void DumpBuffer::Write(CCHAR_P pStr, DumpBuffer::StreamSize iN) {
 }
 
 //
-// Escape and dump string to buffer
+// Dump CDT to JSON
 //
-DumpBuffer & DumpCDT2JSON(const CTPP::CDT & oCDT, DumpBuffer & oResult)
+DumpBuffer & DumpCDT2JSON(const CTPP::CDT & oCDT, DumpBuffer & oBuffer)
 {
-	using namespace CTPP;
-	switch (oCDT.GetType())
-	{
-		case CDT::UNDEF:
-			oResult.Write("null", 4);
-			break;
-
-		case CDT::INT_VAL:
-		case CDT::REAL_VAL:
-		case CDT::POINTER_VAL:
-		case CDT::STRING_INT_VAL:
-		case CDT::STRING_REAL_VAL:
-            {
-				STLW::string tmp = oCDT.GetString();
-				oResult.Write(tmp.data(), tmp.size());
-			}
-			break;
-
-		case CDT::STRING_VAL:
-			oResult.Write("\"", 1);
-			DumpJSONString(oResult, oCDT.GetString(), false);
-			oResult.Write("\"", 1);
-			break;
-
-		case CDT::ARRAY_VAL:
-			{
-				oResult.Write("[", 1);
-				UINT_32 iJ = 0;
-				while (iJ < oCDT.Size())
-				{
-					DumpCDT2JSON(oCDT.GetCDT(iJ), oResult);
-					++iJ;
-					if (iJ != oCDT.Size()) { oResult.Write(",", 1); }
-				}
-				oResult.Write("]", 1);
-			}
-			break;
-
-		case CDT::HASH_VAL:
-			{
-				oResult.Write("{", 1);
-				CDT::ConstIterator itCDTCArray = oCDT.Begin();
-				while (itCDTCArray != oCDT.End())
-				{
-					oResult.Write("\"", 1);
-					DumpJSONString(oResult, itCDTCArray -> first, false);
-					oResult.Write("\":", 2);
-
-					DumpCDT2JSON(itCDTCArray -> second, oResult);
-
-					++itCDTCArray;
-					if (itCDTCArray != oCDT.End()) { oResult.Write(",", 1); }
-				}
-				oResult.Write("}", 1);
-			}
-			break;
-	}
+	DumpBufferOutputCollector oCollector(oBuffer);
+	CTPP2JSONSerializer oSerializer(oCollector);
+	oSerializer.WriteCDT(oCDT);
 
-return oResult;
+return oBuffer;
 }
 
 //
@@ -32,6 +32,9 @@
 
 #include "CTPP2VM.hpp"
 
+#include "CTPP2Escape.hpp"
+#include "CTPP2FragmentCache.hpp"
+#include "CTPP2SyscallContext.hpp"
 #include "CTPP2OutputCollector.hpp"
 #include "CTPP2SyscallFactory.hpp"
 #include "CTPP2VMMemoryCore.hpp"
@@ -41,6 +44,8 @@
 #include "CTPP2VMException.hpp"
 #include "CTPP2VMStackException.hpp"
 #include "CTPP2VMInstruction.hpp"
+#include "CTPP2NumberFormat.hpp"
+#include "CTPP2Util.hpp"
 
 #include <string.h>
 
@@ -98,6 +103,182 @@
 namespace CTPP // C++ Template Engine
 {
 
+// Value of missing element
+static const CDT oUndefCDT;
+
+// Context of system calls if none set
+static const SyscallContext oEmptyContext;
+
+//
+// Get array element without copying or materializing of container
+//
+static const CDT & GetIndexedElement(const CDT & oCDT, const UINT_32 iPos)
+{
+	if (oCDT.GetType() == CDT::ARRAY_VAL)
+	{
+		if (iPos < oCDT.Size()) { return oCDT.GetCDT(iPos); }
+		return oUndefCDT;
+	}
+
+	if (oCDT.GetType() != CDT::UNDEF) { throw CDTAccessException(); }
+
+return oUndefCDT;
+}
+
+//
+// Write value to output collector, numbers are formatted without temporary strings
+//
+static void CollectCDT(OutputCollector * pOutputCollector, const CDT & oData)
+{
+	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+
+	switch (oData.GetType())
+	{
+		case CDT::UNDEF:
+			break;
+
+		case CDT::INT_VAL:
+			pOutputCollector -> Collect(szBuf, FormatInteger(oData.GetInt(), szBuf));
+			break;
+
+		case CDT::REAL_VAL:
+			pOutputCollector -> Collect(szBuf, FormatFloat(oData.GetFloat(), CTPP_FLOAT_PRECISION, szBuf));
+			break;
+
+		default:
+			{
+				const STLW::string sTMP = oData.GetString();
+				pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+			}
+	}
+}
+
+//
+// Escape data and send it to output collector
+//
+static void CollectEscapedCDT(OutputCollector * pOutputCollector, const CDT & oData, const eCTPP2EscapeType eEscapeType)
+{
+	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+
+	switch (oData.GetType())
+	{
+		case CDT::UNDEF:
+			break;
+
+		case CDT::INT_VAL:
+			EscapeData(eEscapeType, szBuf, FormatInteger(oData.GetInt(), szBuf), *pOutputCollector);
+			break;
+
+		case CDT::REAL_VAL:
+			EscapeData(eEscapeType, szBuf, FormatFloat(oData.GetFloat(), CTPP_FLOAT_PRECISION, szBuf), *pOutputCollector);
+			break;
+
+		case CDT::STRING_VAL:
+		case CDT::STRING_INT_VAL:
+		case CDT::STRING_REAL_VAL:
+			{
+				UINT_32 iDataLength = 0;
+				CCHAR_P szData      = oData.GetStringData(iDataLength);
+				EscapeData(eEscapeType, szData, iDataLength, *pOutputCollector);
+			}
+			break;
+
+		default:
+			{
+				const STLW::string sTMP = oData.GetString();
+				EscapeData(eEscapeType, sTMP.data(), sTMP.size(), *pOutputCollector);
+			}
+	}
+}
+
+//
+// Get hash element without copying or materializing of container
+//
+static const CDT & GetKeyedElement(const CDT & oCDT, const STLW::string & sKey)
+{
+	if (oCDT.GetType() == CDT::HASH_VAL) { return oCDT.GetCDT(sKey); }
+
+	if (oCDT.GetType() != CDT::UNDEF) { throw CDTAccessException(); }
+
+return oUndefCDT;
+}
+
+//
+// Output of <TMPL_cache> fragment; data is passed to previous collector and stored for cache
+//
+class FragmentCapture:
+  public OutputCollector
+{
+public:
+	/**
+	  @brief Constructor
+	  @param pITarget - previous output collector
+	  @param sIKey - fragment key
+	  @param iITTL - time to live, seconds
+	*/
+	FragmentCapture(OutputCollector     * pITarget,
+	                const STLW::string  & sIKey,
+	                const UINT_32         iITTL): pTarget(pITarget),
+	                                              sKey(sIKey),
+	                                              iTTL(iITTL)
+	{
+		;;
+	}
+
+	/** Previous output collector */
+	OutputCollector   * pTarget;
+	/** Fragment key              */
+	STLW::string        sKey;
+	/** Fragment output           */
+	STLW::string        sData;
+	/** Time to live, seconds     */
+	UINT_32             iTTL;
+
+	/**
+	  @brief Collect data
+	  @param vData - data to store
+	  @param iDataLength - data length
+	  @return 0 - if success, -1 - if any error occured
+	*/
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength)
+	{
+		sData.append((CCHAR_P)vData, iDataLength);
+
+		return pTarget -> Collect(vData, iDataLength);
+	}
+};
+
+//
+// Append value to fragment key; every value is prefixed with type and length
+//
+static void AppendFragmentKey(STLW::string & sKey, const CDT & oData)
+{
+	STLW::string sValue;
+	CHAR_8       chType = 'S';
+
+	switch (oData.GetType())
+	{
+		case CDT::UNDEF:
+			sKey.append(1, 'U');
+			return;
+
+		case CDT::ARRAY_VAL:
+		case CDT::HASH_VAL:
+			chType = 'J';
+			CDT2JSON(oData, sValue);
+			break;
+
+		default:
+			sValue = oData.GetString();
+	}
+
+	CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+	sKey.append(1, chType);
+	sKey.append(szBuf, FormatInteger(INT_64(sValue.size()), szBuf));
+	sKey.append(1, ':');
+	sKey.append(sValue);
+}
+
 //
 // Constructor
 //
@@ -113,8 +294,12 @@ VM::VM(SyscallFactory  * pISyscallFactory,
                                         iMaxCalls(0),
                                         iMaxUsedCalls(0),
                                         aCallTranslationMap(NULL),
+                                        aCallMemoizable(NULL),
                                         oVMArgStack(iMaxArgStackSize),
-                                        oVMCodeStack(iMaxCodeStackSize)
+                                        oVMCodeStack(iMaxCodeStackSize),
+                                        pFragmentCache(NULL),
+                                        pContext(&oEmptyContext),
+                                        bMemoize(true)
 {
 	;;
 }
@@ -126,13 +311,19 @@ INT_32 VM::Init(const VMMemoryCore  * pMemoryCore,
                 OutputCollector     * pOutputCollector,
                 Logger              * pLogger)
 {
+	// Fragments and results of calls of previous run
+	ClearCaptures();
+	oMemo.Clear();
+
 	// Create syscalls translation map
 	iMaxUsedCalls = pMemoryCore -> syscalls.GetRecordsNum();
 	// Cache
 	if (iMaxUsedCalls >= iMaxCalls)
 	{
 		delete [] aCallTranslationMap;
+		delete [] aCallMemoizable;
 		aCallTranslationMap = new SyscallHandler *[iMaxUsedCalls];
+		aCallMemoizable     = new bool[iMaxUsedCalls];
 		iMaxCalls = iMaxUsedCalls;
 	}
 
@@ -158,6 +349,7 @@ INT_32 VM::Init(const VMMemoryCore  * pMemoryCore,
 
 		// All OK
 		aCallTranslationMap[iCallNum] = pTMP;
+		aCallMemoizable[iCallNum]     = (pTMP -> GetCapabilities() & (CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY)) == (CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY);
 
 		// Initialize syscall handler
 		pTMP -> PreExecuteSetup(*pOutputCollector,
@@ -181,6 +373,9 @@ INT_32 VM::Run(const VMMemoryCore  * pMemoryCore,
                Logger              * pLogger)
 {
 	DR = oCDT;
+	// Resumed after BRK inside of cached fragment
+	if (!vCaptures.empty()) { pOutputCollector = vCaptures.back(); }
+
 	// Get code segment
 	const VMInstruction * aCode = pMemoryCore -> instructions;
 	const UINT_32 iCodeLength   = pMemoryCore -> code_size;
@@ -230,12 +425,18 @@ HL_RST;
 									}
 
 									CDT oResult(CDT::UNDEF);
-									// Invoke handler
-									if (aCallTranslationMap[iCallNum] -> Handler(oVMArgStack.GetStackFrame(), iCallArgNum, oResult, *pLogger) != 0)
+									// Result of same pure call is reused
+									const bool bMemoizable = bMemoize && aCallMemoizable[iCallNum];
+									if (!bMemoizable || !oMemo.Find(iCallNum, oVMArgStack.GetStackFrame(), iCallArgNum, oResult))
 									{
-										UINT_32 iDataSize = 0;
-										CCHAR_P szTMP = pMemoryCore -> static_text.GetData(VMDebugInfo(aCode[iIP].reserved).GetDescrId(), iDataSize);
-										throw InvalidSyscall("*** Internal syscall error ***", iIP, aCode[iIP].reserved, szTMP);
+										// Invoke handler
+										if (aCallTranslationMap[iCallNum] -> ContextHandler(oVMArgStack.GetStackFrame(), iCallArgNum, oResult, *pContext, *pLogger) != 0)
+										{
+											UINT_32 iDataSize = 0;
+											CCHAR_P szTMP = pMemoryCore -> static_text.GetData(VMDebugInfo(aCode[iIP].reserved).GetDescrId(), iDataSize);
+											throw InvalidSyscall("*** Internal syscall error ***", iIP, aCode[iIP].reserved, szTMP);
+										}
+										if (bMemoizable) { oMemo.Store(oResult); }
 									}
 
 									// Clear stack
@@ -248,6 +449,62 @@ HL_RST;
 								}
 								break;
 
+							// OUTCALL
+							case SYSCALL_OPCODE_LO(OUTCALL):
+								{
+									const UINT_32 iCallNum    = (aCode[iIP].argument & 0xFFFF0000) >> 16;
+									const UINT_32 iCallArgNum = (aCode[iIP].argument & 0x0000FFFF);
+#ifdef _DEBUG
+{
+	UINT_32 iCallNameLength = 0;
+	// NULL-terminated string, iCallNameLength not need to use
+	CCHAR_P sCallName = pMemoryCore -> syscalls.GetData(iCallNum, iCallNameLength);
+	HL_CODE(YELLOW);
+	fprintf(stderr, "0x%08X OUTCALL   0x%08X %s(ARGS: %d)\n", iIP, iCallNum, sCallName, iCallArgNum);
+	HL_RST;
+}
+#endif
+									// Check call number
+									if (iCallNum > iMaxUsedCalls)
+									{
+										UINT_32 iDataSize = 0;
+										CCHAR_P szTMP = pMemoryCore -> static_text.GetData(VMDebugInfo(aCode[iIP].reserved).GetDescrId(), iDataSize);
+										throw InvalidSyscall("*** CORRUPTED ***", iIP, aCode[iIP].reserved, szTMP);
+									}
+
+									// Handler writes result to output collector, such results are not stored for reuse
+									SyscallHandler * pHandler = aCallTranslationMap[iCallNum];
+									INT_32 iRC = 0;
+									if (pHandler -> GetVersion() >= CTPP2_SYSCALL_API_OUTPUT)
+									{
+										iRC = pHandler -> OutputHandler(oVMArgStack.GetStackFrame(), iCallArgNum, *pOutputCollector, *pContext, *pLogger);
+									}
+									else
+									{
+										CDT oResult(CDT::UNDEF);
+										const bool bMemoizable = bMemoize && aCallMemoizable[iCallNum];
+										if (!bMemoizable || !oMemo.Find(iCallNum, oVMArgStack.GetStackFrame(), iCallArgNum, oResult))
+										{
+											iRC = pHandler -> ContextHandler(oVMArgStack.GetStackFrame(), iCallArgNum, oResult, *pContext, *pLogger);
+											if (iRC == 0 && bMemoizable) { oMemo.Store(oResult); }
+										}
+										if (iRC == 0) { CollectCDT(pOutputCollector, oResult); }
+									}
+
+									if (iRC != 0)
+									{
+										UINT_32 iDataSize = 0;
+										CCHAR_P szTMP = pMemoryCore -> static_text.GetData(VMDebugInfo(aCode[iIP].reserved).GetDescrId(), iDataSize);
+										throw InvalidSyscall("*** Internal syscall error ***", iIP, aCode[iIP].reserved, szTMP);
+									}
+
+									// Clear stack
+									oVMArgStack.ClearStack(iCallArgNum);
+
+									++iIP;
+								}
+								break;
+
 							// CALLNAME
 							case SYSCALL_OPCODE_LO(CALLNAME):
 								{
@@ -1422,21 +1679,6 @@ fprintf(stderr, "0x%08X MOVIREG   %cR, %cR[%cR] ", iIP, CHAR_8((iDstReg >> 8) +
 #endif
                                             const INT_32 iIdx = oRegs[iArgNum].GetInt();
                                             CDT oItVal(CDT::HASH_VAL);
-                                            if (iIdx == 0)
-                                            {
-                                                oItVal["__first__"] = 1;
-                                            }
-                                            if (UINT_32(iIdx + 1) == oRegs[iSrcReg].Size() )
-                                            {
-                                                oItVal["__last__"] = 1;
-                                            }
-                                            else if (iIdx > 0) 
-                                            {
-                                                oItVal["__inner__"] = 1;
-                                            }
-
-                                            if ((iIdx + 1) % 2 == 1) { oItVal["__odd__"] = 1; }
-                                            else                     { oItVal["__even__"] = 1; }
 
                                             if (oRegs[iSrcReg].GetType() == CDT::HASH_VAL)
                                             {
@@ -1448,18 +1690,35 @@ HL_RST;
 #endif
                                                 oItVal["__value__"] = it->second;
                                                 oItVal["__key__"] = it->first;
-                                                oRegs[iDstReg >> 8] = oItVal;
                                             }
                                             else
                                             {
+                                                // Fetch element before size check: generators know size only one element ahead
+                                                oItVal["__value__"] = oRegs[iSrcReg].GetCDT(iIdx);
+                                                oItVal["__index__"] = iIdx;
 #ifdef _DEBUG
-fprintf(stderr, "(%d): %s\n", iIdx, oRegs[iSrcReg][iIdx].GetString().c_str());
+fprintf(stderr, "(%d): %s\n", iIdx, oItVal["__value__"].GetString().c_str());
 HL_RST;
 #endif
-                                                oItVal["__value__"] = oRegs[iSrcReg][iIdx];
-                                                oItVal["__index__"] = iIdx;
-                                                oRegs[iDstReg >> 8] = oItVal;
                                             }
+
+                                            if (iIdx == 0)
+                                            {
+                                                oItVal["__first__"] = 1;
+                                            }
+                                            if (UINT_32(iIdx + 1) == oRegs[iSrcReg].Size() )
+                                            {
+                                                oItVal["__last__"] = 1;
+                                            }
+                                            else if (iIdx > 0) 
+                                            {
+                                                oItVal["__inner__"] = 1;
+                                            }
+
+                                            if ((iIdx + 1) % 2 == 1) { oItVal["__odd__"] = 1; }
+                                            else                     { oItVal["__even__"] = 1; }
+
+                                            oRegs[iDstReg >> 8] = oItVal;
 										}
 										// Illegal Opcode?
 										else
@@ -1500,11 +1759,12 @@ HL_RST;
 											}
 #ifdef _DEBUG
 HL_CODE(GREEN);
-fprintf(stderr, "0x%08X MOVIREGS   %cR, %cR{%cR} (%s): %s\n", iIP, CHAR_8((iDstReg >> 8) + 'A'), CHAR_8(iSrcReg + 'A'), CHAR_8(iArgNum + 'A'), oRegs[iArgNum].GetString().c_str(), oRegs[iSrcReg][oRegs[iArgNum].GetString()].GetString().c_str());
+fprintf(stderr, "0x%08X MOVIREGS   %cR, %cR{%cR} (%s): %s\n", iIP, CHAR_8((iDstReg >> 8) + 'A'), CHAR_8(iSrcReg + 'A'), CHAR_8(iArgNum + 'A'), oRegs[iArgNum].GetString().c_str(), oRegs[iSrcReg].GetCDT(oRegs[iArgNum].GetString()).GetString().c_str());
 HL_RST;
 #endif
 											// AR <- CR[BR]
-											oRegs[iDstReg >> 8] = oRegs[iSrcReg][oRegs[iArgNum].GetString()];
+											if (oRegs[iSrcReg].GetType() == CDT::HASH_VAL) { oRegs[iDstReg >> 8] = oRegs[iSrcReg].GetCDT(oRegs[iArgNum].GetString()); }
+											else                                           { oRegs[iDstReg >> 8] = oRegs[iSrcReg][oRegs[iArgNum].GetString()]; }
 										}
 										// Illegal Opcode?
 										else
@@ -1523,6 +1783,34 @@ HL_RST;
 									}
 								}
 								break;
+
+							// MOVREST, Get number of elements left after current one
+							case SYSCALL_OPCODE_LO(MOVREST):
+								{
+									const UINT_32 iSrcReg = SYSCALL_REG_SRC(iOpCode);
+									const UINT_32 iDstReg = SYSCALL_REG_DST(iOpCode);
+									const UINT_32 iArgNum = aCode[iIP].argument;
+
+									// Register-to-register
+									if (iDstReg <= ARG_DST_LASTREG && iSrcReg <= ARG_SRC_LASTREG && iArgNum <= ARG_SRC_LASTREG)
+									{
+#ifdef _DEBUG
+HL_CODE(GREEN);
+fprintf(stderr, "0x%08X MOVREST   %cR, %cR.Size() - %cR (%d)\n", iIP, CHAR_8((iDstReg >> 8) + 'A'), CHAR_8(iSrcReg + 'A'), CHAR_8(iArgNum + 'A'), INT_32(oRegs[iSrcReg].Size() - oRegs[iArgNum].GetInt()));
+HL_RST;
+#endif
+										// AR <- CR.Size() - BR
+										oRegs[iDstReg >> 8] = INT_64(oRegs[iSrcReg].Size()) - oRegs[iArgNum].GetInt();
+									}
+									// Illegal Opcode?
+									else
+									{
+										UINT_32 iDataSize = 0;
+										CCHAR_P szTMP     = pMemoryCore -> static_text.GetData(VMDebugInfo(aCode[iIP].reserved).GetDescrId(), iDataSize);
+										throw IllegalOpcode(iIP, iOpCode, aCode[iIP].reserved, szTMP);
+									}
+								}
+								break;
 							// Illegal Opcode?
 							default:
 							{
@@ -1813,8 +2101,7 @@ fprintf(stderr, "0x%08X OUTPUT    ", iIP);
 fprintf(stderr, "STACK[%d](`%s`)\n", aCode[iIP].argument, oVMArgStack.GetTopElement(aCode[iIP].argument).GetString().c_str());
 HL_RST;
 #endif
-										const STLW::string sTMP = oVMArgStack.GetTopElement(0).GetString();
-										pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+										CollectCDT(pOutputCollector, oVMArgStack.GetTopElement(0));
 										oVMArgStack.ClearStack(1);
 									}
 									// From static text segment
@@ -1835,9 +2122,8 @@ HL_RST;
 fprintf(stderr, "INT POS: %d (VAL: %d)\n", aCode[iIP].argument, INT_32(pMemoryCore -> static_data.GetInt(aCode[iIP].argument)));
 HL_RST;
 #endif
-										const CDT oTMP(pMemoryCore -> static_data.GetInt(aCode[iIP].argument));
-										const STLW::string sTMP = oTMP.GetString();
-										pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+										CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+										pOutputCollector -> Collect(szBuf, FormatInteger(pMemoryCore -> static_data.GetInt(aCode[iIP].argument), szBuf));
 									}
 									// From static data segment (float value)
 									else if (iSrcReg == ARG_SRC_FLOAT)
@@ -1846,9 +2132,8 @@ HL_RST;
 fprintf(stderr, "FLOAT POS: %d (VAL: %f)\n", aCode[iIP].argument, pMemoryCore -> static_data.GetFloat(aCode[iIP].argument));
 HL_RST;
 #endif
-										const CDT oTMP(pMemoryCore -> static_data.GetFloat(aCode[iIP].argument));
-										STLW::string sTMP = oTMP.GetString();
-										pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+										CHAR_8 szBuf[C_MAX_SPRINTF_LENGTH + 1];
+										pOutputCollector -> Collect(szBuf, FormatFloat(pMemoryCore -> static_data.GetFloat(aCode[iIP].argument), CTPP_FLOAT_PRECISION, szBuf));
 									}
 									// From register
 									else if (iSrcReg <= ARG_SRC_LASTREG)
@@ -1857,8 +2142,7 @@ HL_RST;
 fprintf(stderr, "%cR\n", CHAR_8(iSrcReg + 'A'));
 HL_RST;
 #endif
-										const STLW::string sTMP = oRegs[iSrcReg].GetString();
-										pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+										CollectCDT(pOutputCollector, oRegs[iSrcReg]);
 									}
 									// Indirect operations works ONLY with registers
 									else if (iSrcReg == ARG_SRC_IND_VAL)
@@ -1870,8 +2154,7 @@ HL_RST;
 #endif
 										if (iDstReg <= ARG_DST_LASTREG)
 										{
-											const STLW::string sTMP = oRegs[iDstReg >> 8].GetCDT(aCode[iIP].argument).GetString();
-											pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+											CollectCDT(pOutputCollector, oRegs[iDstReg >> 8].GetCDT(aCode[iIP].argument));
 										}
 										// Illegal Opcode?
 										else
@@ -1894,8 +2177,7 @@ HL_RST;
 #endif
 										if (iDstReg <= ARG_DST_LASTREG)
 										{
-											STLW::string sTMP = oRegs[iDstReg >> 8].GetCDT(STLW::string(szTMP, iDataSize)).GetString();
-											pOutputCollector -> Collect(sTMP.c_str(), sTMP.size());
+											CollectCDT(pOutputCollector, oRegs[iDstReg >> 8].GetCDT(STLW::string(szTMP, iDataSize)));
 										}
 										// Illegal Opcode?
 										else
@@ -2059,7 +2341,7 @@ fprintf(stderr, "0x%08X REPLINT   ", iIP);
 fprintf(stderr, "STACK[%d](%d)\n", aCode[iIP].argument, INT_32(oVMArgStack.GetTopElement(aCode[iIP].argument).GetInt()));
 HL_RST;
 #endif
-										oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oVMArgStack.GetTopElement(aCode[iIP].argument).GetInt()];
+										oVMArgStack.GetTopElement(0) = GetIndexedElement(oVMArgStack.GetTopElement(0), UINT_32(oVMArgStack.GetTopElement(aCode[iIP].argument).GetInt()));
 									}
 									else if (iSrcReg <= ARG_SRC_LASTREG)
 									{
@@ -2067,7 +2349,7 @@ HL_RST;
 fprintf(stderr, "%cR (%d)\n", CHAR_8(iSrcReg + 'A'), INT_32(oRegs[iSrcReg].GetInt()));
 HL_RST;
 #endif
-										oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oRegs[iSrcReg].GetInt()];
+										oVMArgStack.GetTopElement(0) = GetIndexedElement(oVMArgStack.GetTopElement(0), UINT_32(oRegs[iSrcReg].GetInt()));
 									}
 									// Illegal Opcode?
 									else
@@ -2093,7 +2375,7 @@ fprintf(stderr, "0x%08X REPLSTR   ", iIP);
 fprintf(stderr, "STACK[%d](`%s`)\n", aCode[iIP].argument, oVMArgStack.GetTopElement(aCode[iIP].argument).GetString().c_str());
 HL_RST;
 #endif
-										oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oVMArgStack.GetTopElement(aCode[iIP].argument).GetString()];
+										oVMArgStack.GetTopElement(0) = GetKeyedElement(oVMArgStack.GetTopElement(0), oVMArgStack.GetTopElement(aCode[iIP].argument).GetString());
 									}
 									else if (iSrcReg <= ARG_SRC_LASTREG)
 									{
@@ -2101,7 +2383,7 @@ HL_RST;
 fprintf(stderr, "%cR (`%s`)\n", CHAR_8(iSrcReg + 'A'), oRegs[iSrcReg].GetString().c_str());
 HL_RST;
 #endif
-										oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oRegs[iSrcReg].GetString()];
+										oVMArgStack.GetTopElement(0) = GetKeyedElement(oVMArgStack.GetTopElement(0), oRegs[iSrcReg].GetString());
 									}
 									// Illegal Opcode?
 									else
@@ -2131,7 +2413,7 @@ fprintf(stderr, "0x%08X REPLIND   ", iIP);
 fprintf(stderr, "STACK[%d](%d)\n", aCode[iIP].argument, INT_32(oVMArgStack.GetTopElement(aCode[iIP].argument).GetInt()));
 HL_RST;
 #endif
-											oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oVMArgStack.GetTopElement(aCode[iIP].argument).GetInt()];
+											oVMArgStack.GetTopElement(0) = GetIndexedElement(oVMArgStack.GetTopElement(0), UINT_32(oVMArgStack.GetTopElement(aCode[iIP].argument).GetInt()));
 											break;
 										case CDT::STRING_VAL:
 										case CDT::STRING_INT_VAL:
@@ -2140,7 +2422,7 @@ HL_RST;
 fprintf(stderr, "STACK[%d](`%s`)\n", aCode[iIP].argument, oVMArgStack.GetTopElement(aCode[iIP].argument).GetString().c_str());
 HL_RST;
 #endif
-											oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oVMArgStack.GetTopElement(aCode[iIP].argument).GetString()];
+											oVMArgStack.GetTopElement(0) = GetKeyedElement(oVMArgStack.GetTopElement(0), oVMArgStack.GetTopElement(aCode[iIP].argument).GetString());
 											break;
 										default:
 #ifdef _DEBUG
@@ -2162,7 +2444,7 @@ HL_RST;
 fprintf(stderr, "%cR (%d)\n", CHAR_8(iSrcReg + 'A'), INT_32(oRegs[iSrcReg].GetInt()));
 HL_RST;
 #endif
-											oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oRegs[iSrcReg].GetInt()];
+											oVMArgStack.GetTopElement(0) = GetIndexedElement(oVMArgStack.GetTopElement(0), UINT_32(oRegs[iSrcReg].GetInt()));
 											break;
 										case CDT::STRING_VAL:
 										case CDT::STRING_INT_VAL:
@@ -2171,7 +2453,7 @@ HL_RST;
 fprintf(stderr, "%cR (`%s`)\n", CHAR_8(iSrcReg + 'A'), oRegs[iSrcReg].GetString().c_str());
 HL_RST;
 #endif
-											oVMArgStack.GetTopElement(0) = oVMArgStack.GetTopElement(0)[oRegs[iSrcReg].GetString()];
+											oVMArgStack.GetTopElement(0) = GetKeyedElement(oVMArgStack.GetTopElement(0), oRegs[iSrcReg].GetString());
 											break;
 										default:
 #ifdef _DEBUG
@@ -2300,6 +2582,93 @@ fprintf(stderr, "0x%08X RESTBP\n", iIP);
 									oVMArgStack.RestoreBasePointer();
 								}
 								break;
+							// CACHEGET, output cached fragment or start capturing of fragment output
+							case SYSCALL_OPCODE_LO(CACHEGET):
+								{
+									// Fragment name, keys and TTL
+									const UINT_32 iArgNum = aCode[iIP].argument;
+#ifdef _DEBUG
+HL_CODE(GREEN);
+fprintf(stderr, "0x%08X CACHEGET  (ARGS: %d)\n", iIP, iArgNum);
+HL_RST;
+#endif
+									bool bCacheHit = false;
+									if (pFragmentCache != NULL)
+									{
+										STLW::string sKey;
+										for (UINT_32 iPos = iArgNum - 1; iPos > 0; --iPos) { AppendFragmentKey(sKey, oVMArgStack.GetTopElement(iPos)); }
+
+										const INT_64 iTTL = oVMArgStack.GetTopElement(0).GetInt();
+
+										STLW::string sData;
+										if (pFragmentCache -> Get(sKey, sData))
+										{
+											pOutputCollector -> Collect(sData.data(), sData.size());
+											bCacheHit = true;
+										}
+										else
+										{
+											FragmentCapture * pCapture = new FragmentCapture(pOutputCollector, sKey, iTTL > 0 ? UINT_32(iTTL) : 0);
+											vCaptures.push_back(pCapture);
+											pOutputCollector = pCapture;
+										}
+									}
+
+									oVMArgStack.ClearStack(iArgNum);
+
+									// Next instruction jumps over fragment code
+									if (!bCacheHit) { ++iIP; }
+								}
+								break;
+							// CACHEPUT, store captured fragment output
+							case SYSCALL_OPCODE_LO(CACHEPUT):
+								{
+#ifdef _DEBUG
+HL_CODE(GREEN);
+fprintf(stderr, "0x%08X CACHEPUT\n", iIP);
+HL_RST;
+#endif
+									// No capture without fragment storage
+									if (!vCaptures.empty())
+									{
+										FragmentCapture * pCapture = vCaptures.back();
+										vCaptures.pop_back();
+
+										pOutputCollector = pCapture -> pTarget;
+										try
+										{
+											pFragmentCache -> Put(pCapture -> sKey, pCapture -> sData, pCapture -> iTTL);
+										}
+										catch(...)
+										{
+											delete pCapture;
+											throw;
+										}
+										delete pCapture;
+									}
+								}
+								break;
+							// OUTPUTESC, escape value and output it
+							case SYSCALL_OPCODE_LO(OUTPUTESC):
+								{
+									const UINT_32 iEscapeType = aCode[iIP].argument;
+#ifdef _DEBUG
+HL_CODE(YELLOW);
+fprintf(stderr, "0x%08X OUTPUTESC (TYPE: %d) STACK[0](`%s`)\n", iIP, iEscapeType, oVMArgStack.GetTopElement(0).GetString().c_str());
+HL_RST;
+#endif
+									// Only stack is allowed as source
+									if (SYSCALL_REG_SRC(iOpCode) != ARG_SRC_STACK || iEscapeType > ESCAPE_NONE)
+									{
+										UINT_32 iDataSize = 0;
+										CCHAR_P szTMP     = pMemoryCore -> static_text.GetData(VMDebugInfo(aCode[iIP].reserved).GetDescrId(), iDataSize);
+										throw IllegalOpcode(iIP, iOpCode, aCode[iIP].reserved, szTMP);
+									}
+
+									CollectEscapedCDT(pOutputCollector, oVMArgStack.GetTopElement(0), eCTPP2EscapeType(iEscapeType));
+									oVMArgStack.ClearStack(1);
+								}
+								break;
 							// Illegal Opcode?
 							default:
 							{
@@ -2409,9 +2778,41 @@ INT_32 VM::Reset()
 	oVMArgStack.Reset();
 	oVMCodeStack.Reset();
 
+	ClearCaptures();
+	oMemo.Clear();
+
 return 0;
 }
 
+//
+// Set storage of cached fragments
+//
+void VM::SetFragmentCache(FragmentCache * pIFragmentCache) { pFragmentCache = pIFragmentCache; }
+
+//
+// Set per-render context of system calls
+//
+void VM::SetContext(const SyscallContext * pIContext) { pContext = (pIContext == NULL) ? &oEmptyContext : pIContext; }
+
+//
+// Enable or disable reuse of results of pure calls
+//
+void VM::SetMemoization(const bool bIMemoize) { bMemoize = bIMemoize; }
+
+//
+// Discard unfinished fragment captures
+//
+void VM::ClearCaptures()
+{
+	STLW::vector<FragmentCapture *>::iterator itvCaptures = vCaptures.begin();
+	while (itvCaptures != vCaptures.end())
+	{
+		delete *itvCaptures;
+		++itvCaptures;
+	}
+	vCaptures.clear();
+}
+
 //
 //
 //
@@ -2431,6 +2832,9 @@ void VM::CheckStackOnlyRegs(const UINT_32 iSrcReg, const UINT_32 iDstReg, const
 VM::~VM() throw()
 {
 	if (aCallTranslationMap != 0) { delete [] aCallTranslationMap; }
+	if (aCallMemoizable != 0)     { delete [] aCallMemoizable;     }
+
+	ClearCaptures();
 
 }
 
@@ -57,10 +57,49 @@ VMMemoryCore::VMMemoryCore(const VMExecutable  * pVMExecutable): code_size(pVMEx
                                                                  bit_index(VMExecutable::GetStaticDataBitIndex(pVMExecutable)),
                                                                  // hash table
                                                                  calls_table(VMExecutable::GetCallsTable(pVMExecutable),
-                                                                             VMExecutable::GetCallsTablePower(pVMExecutable))
+                                                                             VMExecutable::GetCallsTablePower(pVMExecutable)),
+                                                                 // Output size estimate
+                                                                 output_size(0)
 {
 	;;
 }
 
+//
+// Relaxed atomic access to output size estimate; it is only a hint, so no ordering is required
+//
+#ifdef __ATOMIC_RELAXED
+    #define C_LOAD_OUTPUT_SIZE(vValue)           __atomic_load_n(&(vValue), __ATOMIC_RELAXED)
+    #define C_STORE_OUTPUT_SIZE(vValue, iSize)   __atomic_store_n(&(vValue), (iSize), __ATOMIC_RELAXED)
+#else
+    #define C_LOAD_OUTPUT_SIZE(vValue)           (*(volatile UINT_32 *)&(vValue))
+    #define C_STORE_OUTPUT_SIZE(vValue, iSize)   (*(volatile UINT_32 *)&(vValue) = (iSize))
+#endif
+
+//
+// Get expected size of template output
+//
+UINT_32 VMMemoryCore::GetOutputSizeHint() const
+{
+	const UINT_32 iOutputSize = C_LOAD_OUTPUT_SIZE(output_size);
+
+// 1/8 of headroom covers usual variation of output between renders
+return iOutputSize + (iOutputSize >> 3);
+}
+
+//
+// Account size of rendered output
+//
+void VMMemoryCore::UpdateOutputSize(const UINT_32  iOutputSize) const
+{
+	const UINT_32 iEstimate = C_LOAD_OUTPUT_SIZE(output_size);
+
+	// First render sets estimate; then it moves by 1/8 of difference both ways, so single outlier does not
+	// inflate reserved size of following renders. Load and store are not one atomic operation: a concurrent
+	// update may be lost, which is harmless for a hint
+	if      (iEstimate == 0)           { C_STORE_OUTPUT_SIZE(output_size, iOutputSize);                                    }
+	else if (iOutputSize >= iEstimate) { C_STORE_OUTPUT_SIZE(output_size, iEstimate + ((iOutputSize - iEstimate) >> 3)); }
+	else                               { C_STORE_OUTPUT_SIZE(output_size, iEstimate - ((iEstimate - iOutputSize) >> 3)); }
+}
+
 } // namespace CTPP
 // End.
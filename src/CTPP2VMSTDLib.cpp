@@ -109,6 +109,7 @@ CCHAR_P * STDLibInitializer::GetFnList() { return aSTDFNList; }
 SyscallHandler * STDLibInitializer::CreateHandler(CCHAR_P szHandler)
 {
 	if      (strcasecmp(CTPP2_INT_HANDLER_PREFIX "_emitter",      szHandler) == 0) { return new FnEmitter();      }
+	else if (strcasecmp(CTPP2_INT_HANDLER_PREFIX "_sprintf",      szHandler) == 0) { return new FnSprintfCompiled(); }
 	else if (strcasecmp("attr_in_array",                          szHandler) == 0) { return new FnAttrInArray();  }
 	else if (strcasecmp("avg",                                    szHandler) == 0) { return new FnAvg();          }
 	else if (strcasecmp("base64_encode",                          szHandler) == 0) { return new FnBase64Encode(); }
@@ -192,6 +193,7 @@ void STDLibInitializer::DestroyHandler(SyscallHandler * pHandler) { delete pHand
 CCHAR_P STDLibInitializer::aSTDFNList[] =
 {
 	CTPP2_INT_HANDLER_PREFIX "_emitter",
+	CTPP2_INT_HANDLER_PREFIX "_sprintf",
 	"avg",
 	"attr_in_array",
 	"base64_encode",
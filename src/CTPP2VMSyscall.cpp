@@ -31,6 +31,10 @@
  */
 #include "CTPP2VMSyscall.hpp"
 
+#include "CDT.hpp"
+#include "CTPP2CDTOutputCollector.hpp"
+#include "CTPP2OutputCollector.hpp"
+
 namespace CTPP // C++ Template Engine
 {
 
@@ -49,10 +53,48 @@ INT_32 SyscallHandler::PreExecuteSetup(OutputCollector          & oCollector,
 //
 INT_32 SyscallHandler::InitHandler(CDT & oCDT) { return 0; }
 
+//
+// Handler with per-render context
+//
+INT_32 SyscallHandler::ContextHandler(CDT                   * aArguments,
+                                      const UINT_32           iArgNum,
+                                      CDT                   & oCDTRetVal,
+                                      const SyscallContext  & oContext,
+                                      Logger                & oLogger)
+{
+	return Handler(aArguments, iArgNum, oCDTRetVal, oLogger);
+}
+
+//
+// Handler with output to collector
+//
+INT_32 SyscallHandler::OutputHandler(CDT                   * aArguments,
+                                     const UINT_32           iArgNum,
+                                     OutputCollector       & oCollector,
+                                     const SyscallContext  & oContext,
+                                     Logger                & oLogger)
+{
+	CDT oResult(CDT::UNDEF);
+	if (ContextHandler(aArguments, iArgNum, oResult, oContext, oLogger) != 0) { return -1; }
+
+	if (oResult.GetType() != CDT::UNDEF)
+	{
+		const STLW::string sResult = oResult.GetString();
+		oCollector.Collect(sResult.data(), sResult.size());
+	}
+
+return 0;
+}
+
 //
 // Get API version
 //
-INT_32 SyscallHandler::GetVersion() const { return 0; }
+INT_32 SyscallHandler::GetVersion() const { return CTPP2_SYSCALL_API_BASE; }
+
+//
+// Get capabilities of function
+//
+UINT_32 SyscallHandler::GetCapabilities() const { return 0; }
 
 //
 // Handler resources destructor
@@ -64,5 +106,45 @@ INT_32 SyscallHandler::DestroyHandler(CDT & oCDT) throw() { return 0; }
 //
 SyscallHandler::~SyscallHandler() throw() { ;; }
 
+// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Class SyscallWriter
+//
+
+//
+// Handler
+//
+INT_32 SyscallWriter::Handler(CDT            * aArguments,
+                              const UINT_32    iArgNum,
+                              CDT            & oCDTRetVal,
+                              Logger         & oLogger)
+{
+	CDTOutputCollector oCollector(oCDTRetVal);
+
+return Write(aArguments, iArgNum, oCollector, oLogger);
+}
+
+//
+// Handler with output to collector
+//
+INT_32 SyscallWriter::OutputHandler(CDT                   * aArguments,
+                                    const UINT_32           iArgNum,
+                                    OutputCollector       & oCollector,
+                                    const SyscallContext  & oContext,
+                                    Logger                & oLogger)
+{
+	return Write(aArguments, iArgNum, oCollector, oLogger);
+}
+
+//
+// Get API version
+//
+INT_32 SyscallWriter::GetVersion() const { return CTPP2_SYSCALL_API_OUTPUT; }
+
+//
+// A destructor
+//
+SyscallWriter::~SyscallWriter() throw() { ;; }
+
 } // namespace CTPP
 // End.
@@ -75,12 +75,12 @@ INT_32 FnAttrInArray::Handler(CDT            * aArguments,
 	INT_32 iSize = aArguments[1].Size();
 	for (INT_32 iI = 0; iI < iSize; ++iI)
 	{
-		if(aArguments[1][iI].GetType() != CDT::HASH_VAL) { 
+		if(aArguments[1].GetCDT(iI).GetType() != CDT::HASH_VAL) { 
 			oLogger.Error("Second argument MUST be ARRAY of HASHes");
 			return -1;
 		}
 
-		if (aArguments[2].Equal( aArguments[1][iI][ aArguments[0].GetString() ] ))
+		if (aArguments[2].Equal( aArguments[1].GetCDT(iI).GetCDT(aArguments[0].GetString()) ))
 		{
 			oCDTRetVal = 1;
 			return 0;
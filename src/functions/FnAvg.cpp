@@ -141,6 +141,11 @@ return 0;
 //
 CCHAR_P FnAvg::GetName() const { return "avg"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnAvg::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -71,6 +71,11 @@ return 0;
 //
 CCHAR_P FnBase64Decode::GetName() const { return "base64_decode"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnBase64Decode::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -71,6 +71,11 @@ return 0;
 //
 CCHAR_P FnBase64Encode::GetName() const { return "base64_encode"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnBase64Encode::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -70,6 +70,11 @@ return 0;
 //
 CCHAR_P FnConcat::GetName() const { return "concat"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnConcat::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
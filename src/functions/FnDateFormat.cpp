@@ -32,10 +32,14 @@
 
 #include "CDT.hpp"
 #include "CTPP2Logger.hpp"
+#include "CTPP2OutputCollector.hpp"
 #include "FnDateFormat.hpp"
 
 #include <time.h>
 
+// Maximum length of formatted date
+#define C_MAX_DATE_LENGTH 65536
+
 namespace CTPP // C++ Template Engine
 {
 
@@ -48,12 +52,12 @@ FnDateFormat::FnDateFormat()
 }
 
 //
-// Handler
+// Write result to output collector
 //
-INT_32 FnDateFormat::Handler(CDT            * aArguments,
-                             const UINT_32    iArgNum,
-                             CDT            & oCDTRetVal,
-                             Logger         & oLogger)
+INT_32 FnDateFormat::Write(CDT              * aArguments,
+                           const UINT_32      iArgNum,
+                           OutputCollector  & oCollector,
+                           Logger           & oLogger)
 {
 	// Only 2 arguments
 	if (iArgNum != 2)
@@ -62,20 +66,94 @@ INT_32 FnDateFormat::Handler(CDT            * aArguments,
 		return -1;
 	}
 
+	time_t iTime = aArguments[1].GetInt();
+
+	struct tm oTM;
+	// Format string is used in place
+	STLW::string sFormat;
+	UINT_32 iFormatLength = 0;
+	CCHAR_P szFormat      = aArguments[0].GetStringData(iFormatLength);
+	if (szFormat == NULL)
+	{
+		sFormat  = aArguments[0].GetString();
+		szFormat = sFormat.c_str();
+	}
+
 	// Temp
 	CHAR_8 szBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
+	size_t iLength = 0;
+	if (LocalTime(iTime, oTM) == 0)
+	{
+		iLength = strftime(szBuffer, CTPP_ESCAPE_BUFFER_LEN, szFormat, &oTM);
+		if (iLength != 0) { oCollector.Collect(szBuffer, iLength); }
+		// Formatted date is too long for buffer
+		else if (*szFormat != '\0')
+		{
+			STLW::string sBuffer;
+			for (size_t iBufferLength = CTPP_ESCAPE_BUFFER_LEN * 4; iLength == 0 && iBufferLength <= C_MAX_DATE_LENGTH; iBufferLength *= 4)
+			{
+				sBuffer.resize(iBufferLength);
+				iLength = strftime(&sBuffer[0], iBufferLength, szFormat, &oTM);
+			}
+			if (iLength != 0)
+			{
+				oCollector.Collect(sBuffer.data(), iLength);
+			}
+		}
+	}
 
-	time_t iTime = aArguments[1].GetInt();
+	if (iLength == 0)
+	{
+		oLogger.Error("Can't format: DATE_FORMAT(%s, '%s')", aArguments[1].GetString().c_str(), szFormat);
+		return -1;
+	}
 
-	const struct tm * pTM = localtime(&iTime);
+return 0;
+}
 
-	if (strftime(szBuffer, CTPP_ESCAPE_BUFFER_LEN, aArguments[0].GetString().c_str(), pTM) == 0)
+//
+// Reentrant localtime
+//
+static INT_32 LocalTimeR(const time_t iTime, struct tm & oTM)
+{
+#ifdef WIN32
+	if (localtime_s(&oTM, &iTime) != 0) { return -1; }
+#else
+	if (localtime_r(&iTime, &oTM) == NULL) { return -1; }
+#endif
+
+return 0;
+}
+
+//
+// Convert time to broken-down local time
+//
+INT_32 FnDateFormat::LocalTime(const time_t iTime, struct tm & oTM)
+{
+	// Same hour as in previous call; without thread-specific data cache lives for one call
+	TimeCache   oCallCache;
+	TimeCache * pThreadCache = oTimeCache.Get();
+	TimeCache & oCache = (pThreadCache != NULL) ? *pThreadCache : oCallCache;
+	const time_t iOffset = iTime - oCache.hour_start;
+	if (oCache.hour_start != -1 && iOffset >= 0 && iOffset < 3600)
 	{
-		oLogger.Error("Can't format: DATE_FORMAT(%s, '%s')", aArguments[1].GetString().c_str(), aArguments[0].GetString().c_str());
-		return -1;
+		oTM        = oCache.hour_tm;
+		oTM.tm_min = INT_32(iOffset / 60);
+		oTM.tm_sec = INT_32(iOffset % 60);
+		return 0;
 	}
 
-	oCDTRetVal = szBuffer;
+	if (LocalTimeR(iTime, oTM) == -1) { return -1; }
+
+	// Hour is cached only if offset of time zone does not change inside of it
+	const time_t iHourStart = iTime - oTM.tm_min * 60 - oTM.tm_sec;
+	struct tm oStartTM;
+	struct tm oEndTM;
+	if (LocalTimeR(iHourStart,        oStartTM) == -1 || oStartTM.tm_hour != oTM.tm_hour || oStartTM.tm_min != 0  || oStartTM.tm_sec != 0 ||
+	    LocalTimeR(iHourStart + 3599, oEndTM)   == -1 || oEndTM.tm_hour   != oTM.tm_hour || oEndTM.tm_min   != 59 || oEndTM.tm_sec   != 59) { return 0; }
+
+	oCache.hour_start = iHourStart;
+	oCache.hour_tm    = oStartTM;
 
 return 0;
 }
@@ -85,6 +85,9 @@ INT_32 FnEnglishSpellOut::Handler(CTPP::CDT          * aArguments,
 // Имя функции
 const CCHAR_8* FnEnglishSpellOut::GetName() const { return "english_spellout"; }
 
+// Свойства функции
+UINT_32 FnEnglishSpellOut::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 
 } // namespace 
 
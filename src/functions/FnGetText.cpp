@@ -32,6 +32,7 @@
 
 #include "CDT.hpp"
 #include "CTPP2Logger.hpp"
+#include "CTPP2SyscallContext.hpp"
 #include "FnGetText.hpp"
 
 #ifdef WIN32
@@ -59,6 +60,32 @@ INT_32 FnGetText::Handler(CDT            * aArguments,
                           const UINT_32    iArgNum,
                           CDT            & oCDTRetVal,
                           Logger         & oLogger)
+{
+	return Translate(aArguments, iArgNum, oCDTRetVal, sLanguage, "", oLogger);
+}
+
+//
+// Handler with per-render context
+//
+INT_32 FnGetText::ContextHandler(CDT                   * aArguments,
+                                 const UINT_32           iArgNum,
+                                 CDT                   & oCDTRetVal,
+                                 const SyscallContext  & oContext,
+                                 Logger                & oLogger)
+{
+	return Translate(aArguments, iArgNum, oCDTRetVal,
+	                 oContext.language.empty() ? sLanguage : oContext.language, oContext.domain, oLogger);
+}
+
+//
+// Find translation
+//
+INT_32 FnGetText::Translate(CDT                 * aArguments,
+                            const UINT_32         iArgNum,
+                            CDT                 & oCDTRetVal,
+                            const STLW::string  & sLang,
+                            const STLW::string  & sDomain,
+                            Logger              & oLogger) const
 {
 	if (pGetText == NULL)
 	{
@@ -68,23 +95,23 @@ INT_32 FnGetText::Handler(CDT            * aArguments,
 
 	if (iArgNum == 1)
 	{
-		oCDTRetVal = pGetText -> FindMessage(sLanguage, aArguments[0].GetString());
+		oCDTRetVal = pGetText -> FindMessage(sLang, aArguments[0].GetString(), sDomain);
 		return 0;
 	}
 	else if (iArgNum == 2)
 	{
-		oCDTRetVal = pGetText -> FindMessage(sLanguage, aArguments[1].GetString(), aArguments[0].GetString());
+		oCDTRetVal = pGetText -> FindMessage(sLang, aArguments[1].GetString(), aArguments[0].GetString());
 		return 0;
 	}
 	else if (iArgNum == 3)
 	{
-		oCDTRetVal = pGetText -> FindPluralMessage(sLanguage, aArguments[2].GetString(),
-		                                     aArguments[1].GetString(), (UINT_32)aArguments[0].GetUInt());
+		oCDTRetVal = pGetText -> FindPluralMessage(sLang, aArguments[2].GetString(),
+		                                     aArguments[1].GetString(), (UINT_32)aArguments[0].GetUInt(), sDomain);
 		return 0;
 	}
 	else if (iArgNum == 4)
 	{
-		oCDTRetVal = pGetText -> FindPluralMessage(sLanguage, aArguments[3].GetString(), aArguments[2].GetString(),
+		oCDTRetVal = pGetText -> FindPluralMessage(sLang, aArguments[3].GetString(), aArguments[2].GetString(),
 		                                     (UINT_32)aArguments[1].GetUInt(), aArguments[0].GetString());
 		return 0;
 	}
@@ -114,7 +141,7 @@ FnGetText::~FnGetText() throw() { free(szFuncName); }
 void FnGetText::SetGetText(CTPP2GetText * pGetText_) { pGetText = pGetText_; }
 
 //
-// Set language of translation
+// Set language of translation if render context has none
 //
 void FnGetText::SetLanguage(const STLW::string & sLang) { sLanguage = sLang; }
 
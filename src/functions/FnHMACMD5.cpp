@@ -298,6 +298,11 @@ return 0;
 //
 CCHAR_P FnHMACMD5::GetName() const { return "hmac_md5"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnHMACMD5::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 //
 // A destructor
 //
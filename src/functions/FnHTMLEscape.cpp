@@ -31,8 +31,8 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2Escape.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
 #include "FnHTMLEscape.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -46,12 +46,12 @@ FnHTMLEscape::FnHTMLEscape()
 }
 
 //
-// Handler
+// Write result to output collector
 //
-INT_32 FnHTMLEscape::Handler(CDT            * aArguments,
-                             const UINT_32    iArgNum,
-                             CDT            & oCDTRetVal,
-                             Logger         & oLogger)
+INT_32 FnHTMLEscape::Write(CDT              * aArguments,
+                           const UINT_32      iArgNum,
+                           OutputCollector  & oCollector,
+                           Logger           & oLogger)
 {
 	if (iArgNum < 1)
 	{
@@ -59,10 +59,18 @@ INT_32 FnHTMLEscape::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	STLW::string sResult;
-	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos) { sResult.append(aArguments[iPos].GetString()); }
-
-	oCDTRetVal = HTMLEscape(sResult);
+	// Escape arguments one by one
+	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos)
+	{
+		UINT_32 iLength = 0;
+		CCHAR_P szData  = aArguments[iPos].GetStringData(iLength);
+		if (szData != NULL) { EscapeData(ESCAPE_HTML, szData, iLength, oCollector); }
+		else
+		{
+			const STLW::string sTMP = aArguments[iPos].GetString();
+			EscapeData(ESCAPE_HTML, sTMP.data(), sTMP.size(), oCollector);
+		}
+	}
 
 return 0;
 }
@@ -72,6 +80,11 @@ return 0;
 //
 CCHAR_P FnHTMLEscape::GetName() const { return "htmlescape"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnHTMLEscape::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
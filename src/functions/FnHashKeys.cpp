@@ -77,6 +77,11 @@ return 0;
 //
 CCHAR_P FnHashKeys::GetName() const { return "hash_keys"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnHashKeys::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 //
 // A destructor
 //
@@ -12,41 +12,121 @@ namespace CTPP
 
 FnICUFormatDate::FnICUFormatDate() 
 { 
+	;;
+}
+
+// Деструктор
+FnICUFormatDate::~FnICUFormatDate() throw() { ;; }
+
+// Maximum number of cached formatters per thread
+#define C_MAX_ICU_FORMATTERS 64
+
+//
+// Parsers of ISO dates
+//
+FnICUFormatDate::FormatterCache::FormatterCache()
+{
     UErrorCode err = U_ZERO_ERROR;
 //	parser = new SimpleDateFormat(UnicodeString("yyyy-MM-dd' 'hh:mm:ssZZZZZ")	, err);
 	tparser = new icu::SimpleDateFormat(icu::UnicodeString("yyyy-MM-dd' 'HH:mm:ss")	, err);
 	dparser = new icu::SimpleDateFormat(icu::UnicodeString("yyyy-MM-dd")	, err);
 }
 
-// Деструктор
-FnICUFormatDate::~FnICUFormatDate() throw() { 
+//
+// A destructor
+//
+FnICUFormatDate::FormatterCache::~FormatterCache() throw()
+{
 	delete tparser;
 	delete dparser;
+
+	STLW::map<STLW::string, icu::SimpleDateFormat *>::iterator itmFormatters = formatters.begin();
+	while (itmFormatters != formatters.end())
+	{
+		delete itmFormatters -> second;
+		++itmFormatters;
+	}
 }
 
+//
+// Get formatter for pattern and locale; construction of formatter is expensive
+//
+icu::SimpleDateFormat * FnICUFormatDate::GetFormatter(FormatterCache      & oCache,
+                                                      const STLW::string  & sPattern,
+                                                      const CDT           * pLanguage,
+                                                      const CDT           * pCountry)
+{
+	STLW::string sKey(sPattern);
+	if (pLanguage != NULL)
+	{
+		sKey.append(1, '\0');
+		sKey.append(pLanguage -> GetString());
+		sKey.append(1, '\0');
+		sKey.append(pCountry -> GetString());
+	}
+
+	STLW::map<STLW::string, icu::SimpleDateFormat *>::iterator itmFormatters = oCache.formatters.find(sKey);
+	if (itmFormatters != oCache.formatters.end()) { return itmFormatters -> second; }
+
+	// Too many patterns, start again
+	if (oCache.formatters.size() == C_MAX_ICU_FORMATTERS)
+	{
+		for (itmFormatters = oCache.formatters.begin(); itmFormatters != oCache.formatters.end(); ++itmFormatters) { delete itmFormatters -> second; }
+		oCache.formatters.clear();
+	}
+
+	UErrorCode err = U_ZERO_ERROR;
+	icu::SimpleDateFormat * pFormatter = NULL;
+	if (pLanguage != NULL)
+	{
+		const icu::Locale oLocale(pLanguage -> GetString().c_str(), pCountry -> GetString().c_str());
+		pFormatter = new icu::SimpleDateFormat(icu::UnicodeString(sPattern.c_str()), oLocale, err);
+	}
+	else
+	{
+		pFormatter = new icu::SimpleDateFormat(icu::UnicodeString(sPattern.c_str()), err);
+	}
+
+	oCache.formatters[sKey] = pFormatter;
+
+return pFormatter;
+}
 
 // Обработчик
 INT_32 FnICUFormatDate::Handler(CTPP::CDT          * aArguments,
                             const UINT_32 iArgNum,
                             CTPP::CDT           & oCDTRetVal,
 			    CTPP::Logger& logger)
+{
+	FormatterCache * pThreadCache = oCache.Get();
+	if (pThreadCache != NULL) { return FormatDate(*pThreadCache, aArguments, iArgNum, oCDTRetVal, logger); }
+
+	// Without thread-specific data parsers and formatters live for one call
+	FormatterCache oCallCache;
+return FormatDate(oCallCache, aArguments, iArgNum, oCDTRetVal, logger);
+}
+
+//
+// Format date with parsers and formatters of cache
+//
+INT_32 FnICUFormatDate::FormatDate(FormatterCache      & oThreadCache,
+                                   CTPP::CDT           * aArguments,
+                                   const UINT_32         iArgNum,
+                                   CTPP::CDT           & oCDTRetVal,
+                                   CTPP::Logger        & logger)
 {
 	UDate date;
 	// Наша функция принимает один или два агрумента
 	if (iArgNum != 2 && iArgNum !=1 && iArgNum !=4 ) { return -1; }
 	int iFormat;       // номер аргумента с форматной строкой (в CTPP аргументы считаются сзади)
-	icu::Locale * locale = NULL;
 	if( iArgNum==1) {  // один аргумент - берем текущее время
 		iFormat = 0;
 		date = 1000* (double)time(NULL);
 	} else if(iArgNum==2 || iArgNum==4 ) {           // 2 или 4 аргумента
 		iFormat  = iArgNum-1;
 		int iVal = iArgNum-2;
-		if (iArgNum==4) { 
-			locale = new icu::Locale(aArguments[1].GetString().c_str(), aArguments[0].GetString().c_str());
-		}
-		if(int v = aArguments[iVal].GetInt()) {
-			date = v * 1000;
+		if(INT_64 v = aArguments[iVal].GetInt()) {
+			date = UDate(v) * 1000;
 		} else {
 			std::string isodate = aArguments[iVal].GetString();
 // does not work in gc < 4.9 
@@ -62,10 +142,10 @@ INT_32 FnICUFormatDate::Handler(CTPP::CDT          * aArguments,
 			}
 //
 			icu::ParsePosition pp(0);
-			date = tparser->parse(icu::UnicodeString(isodate.c_str()), pp);
+			date = oThreadCache.tparser->parse(icu::UnicodeString(isodate.c_str()), pp);
 			if(!date) { 
 				pp=0;
-				date = dparser->parse(icu::UnicodeString(isodate.c_str()), pp);
+				date = oThreadCache.dparser->parse(icu::UnicodeString(isodate.c_str()), pp);
 			}
 		}
 	} else { 
@@ -73,21 +153,12 @@ INT_32 FnICUFormatDate::Handler(CTPP::CDT          * aArguments,
 		return -1; 
 	}
 
-	UErrorCode err = U_ZERO_ERROR;	
-	if(locale) { 
-		icu::SimpleDateFormat formatter(icu::UnicodeString(aArguments[iFormat].GetString().c_str())	, *locale, err);
-		icu::UnicodeString myus;
-		std::string s;
-		formatter.format (date, myus).toUTF8String<std::string> (s) ;
-		oCDTRetVal = s.c_str();
-		delete locale;
-	} else { 
-		icu::SimpleDateFormat formatter(icu::UnicodeString(aArguments[iFormat].GetString().c_str())	, err);
-		icu::UnicodeString myus;
-		std::string s;
-		formatter.format (date, myus).toUTF8String<std::string> (s) ;
-		oCDTRetVal = s.c_str();
-	}
+	icu::SimpleDateFormat * formatter = (iArgNum == 4) ? GetFormatter(oThreadCache, aArguments[iFormat].GetString(), &aArguments[1], &aArguments[0])
+	                                                   : GetFormatter(oThreadCache, aArguments[iFormat].GetString(), NULL, NULL);
+	icu::UnicodeString myus;
+	std::string s;
+	formatter->format (date, myus).toUTF8String<std::string> (s) ;
+	oCDTRetVal = s;
 	return 0;
 }
 
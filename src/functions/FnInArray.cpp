@@ -75,7 +75,7 @@ INT_32 FnInArray::Handler(CDT            * aArguments,
 	INT_32 iSize = aArguments[0].Size();
 	for (INT_32 iI = 0; iI < iSize; ++iI)
 	{
-		if (aArguments[1].Equal(aArguments[0][iI]))
+		if (aArguments[1].Equal(aArguments[0].GetCDT(iI)))
 		{
 			oCDTRetVal = 1;
 			return 0;
@@ -91,6 +91,11 @@ return 0;
 //
 CCHAR_P FnInArray::GetName() const { return "in_array"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnInArray::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -82,6 +82,11 @@ return 0;
 //
 CCHAR_P FnInSet::GetName() const { return "in_set"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnInSet::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
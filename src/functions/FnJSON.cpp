@@ -31,8 +31,8 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2JSONSerializer.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
 #include "FnJSON.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -47,12 +47,12 @@ FnJSON::FnJSON()
 }
 
 //
-// Handler
+// Write result to output collector
 //
-INT_32 FnJSON::Handler(CDT            * aArguments,
-                       const UINT_32    iArgNum,
-                       CDT            & oCDTRetVal,
-                       Logger         & oLogger)
+INT_32 FnJSON::Write(CDT              * aArguments,
+                     const UINT_32      iArgNum,
+                     OutputCollector  & oCollector,
+                     Logger           & oLogger)
 {
 	if (iArgNum != 1)
 	{
@@ -60,11 +60,8 @@ INT_32 FnJSON::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	STLW::string sData;
-
-	CDT2JSON(aArguments[0], sData);
-
-	oCDTRetVal = sData;
+	CTPP2JSONSerializer oSerializer(oCollector);
+	oSerializer.WriteCDT(aArguments[0]);
 
 return 0;
 }
@@ -74,6 +71,11 @@ return 0;
 //
 CCHAR_P FnJSON::GetName() const { return "json"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnJSON::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 //
 // A destructor
 //
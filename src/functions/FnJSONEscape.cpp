@@ -31,8 +31,9 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2CDTOutputCollector.hpp"
+#include "CTPP2JSONSerializer.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
 #include "FnJSONEscape.hpp"
 
 #include <math.h>
@@ -62,25 +63,27 @@ INT_32 FnJSONEscape::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	STLW::string sResult;
+	CDTOutputCollector  oCollector(oCDTRetVal);
+	CTPP2JSONSerializer oSerializer(oCollector, true, false);
 	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos)
 	{
 		switch (aArguments[iPos].GetType())
 		{
 			case CDT::UNDEF:
-				sResult.append("null", 4);
-				break;
-
 			case CDT::INT_VAL:
 			case CDT::REAL_VAL:
 			case CDT::POINTER_VAL:
 			case CDT::STRING_INT_VAL:
 			case CDT::STRING_REAL_VAL:
-				sResult.append(aArguments[iPos].GetString());
+				oSerializer.WriteCDT(aArguments[iPos]);
 				break;
 
 			case CDT::STRING_VAL:
-				sResult.append(EscapeJSONString(aArguments[iPos].GetString(), true, false));
+				{
+					UINT_32 iLength = 0;
+					CCHAR_P szData  = aArguments[iPos].GetStringData(iLength);
+					oSerializer.WriteString(szData, iLength);
+				}
 				break;
 
 			default:
@@ -88,7 +91,6 @@ INT_32 FnJSONEscape::Handler(CDT            * aArguments,
 				return -1;
 		}
 	}
-	oCDTRetVal = sResult;
 return 0;
 }
 
@@ -97,6 +99,11 @@ return 0;
 //
 CCHAR_P FnJSONEscape::GetName() const { return "jsonescape"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnJSONEscape::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
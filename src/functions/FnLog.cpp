@@ -83,6 +83,11 @@ return -1;
 //
 CCHAR_P FnLog::GetName() const { return "log"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnLog::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
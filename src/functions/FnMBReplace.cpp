@@ -59,10 +59,10 @@ INT_32 FnMBReplace::Handler(CDT            * aArguments,
 	if (iArgNum == 3)
 	{
 
-		const icu::UnicodeString sReplacement(aArguments[0].GetString().c_str());
-		const icu::UnicodeString sSearch     (aArguments[1].GetString().c_str());
-		      icu::UnicodeString sSrc  	    (aArguments[2].GetString().c_str());
-	
+		const icu::UnicodeString sReplacement(icu::UnicodeString::fromUTF8(aArguments[0].GetString()));
+		const icu::UnicodeString sSearch     (icu::UnicodeString::fromUTF8(aArguments[1].GetString()));
+		      icu::UnicodeString sSrc        (icu::UnicodeString::fromUTF8(aArguments[2].GetString()));
+
 		icu::UnicodeString res = 
 			sSrc.findAndReplace(  0, sSrc.length(), 
 					sSearch,      0, sSearch.length(),
@@ -71,7 +71,7 @@ INT_32 FnMBReplace::Handler(CDT            * aArguments,
 
 		STLW::string s;
 		res.toUTF8String<STLW::string>(s);
-		oCDTRetVal =  s.c_str();
+		oCDTRetVal = s;
 		return 0;
 
 	}
@@ -85,6 +85,11 @@ return -1;
 //
 CCHAR_P FnMBReplace::GetName() const { return "mb_replace"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMBReplace::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 //
 // A destructor
 //
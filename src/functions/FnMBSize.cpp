@@ -32,7 +32,7 @@
 
 #include "CDT.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
+#include "CTPP2UTF8.hpp"
 #include "FnMBSize.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -63,24 +63,11 @@ INT_32 FnMBSize::Handler(CDT            * aArguments,
 	if (aArguments[0].GetType() != CDT::STRING_VAL) { oCDTRetVal = aArguments[0].Size(); }
 	else
 	{
-		const STLW::string sData = aArguments[0].GetString();
+		// String is used in place
+		UINT_32 iDataLength = 0;
+		CCHAR_P szData      = aArguments[0].GetStringData(iDataLength);
 
-		CCHAR_P  szStart  = sData.data();
-		CCHAR_P  szEnd    = szStart + sData.size();
-		INT_32   iPos     = 0;
-		UINT_32  iCharPos = 0;
-		for(;;)
-		{
-			INT_32 iCharLen = utf_charlen(szStart + iPos, szEnd);
-			if (iCharLen == -3) { break; }
-
-			// Check character length
-			if (iCharLen < 0) { iCharLen = 1; }
-
-			++iCharPos;
-			iPos += iCharLen;
-		}
-		oCDTRetVal = iCharPos;
+		oCDTRetVal = UTF8Length(szData, szData + iDataLength);
 	}
 
 return 0;
@@ -91,6 +78,11 @@ return 0;
 //
 CCHAR_P FnMBSize::GetName() const { return "mb_size"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMBSize::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
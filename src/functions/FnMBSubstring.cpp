@@ -32,12 +32,29 @@
 
 #include "CDT.hpp"
 #include "CTPP2Logger.hpp"
+#include "CTPP2UTF8.hpp"
 #include "CTPP2Util.hpp"
 #include "FnMBSubstring.hpp"
 
 namespace CTPP // C++ Template Engine
 {
 
+//
+// Skip bytes of broken sequences; they belong to character before them
+//
+static CCHAR_P SkipBroken(CCHAR_P szString, CCHAR_P szStringEnd)
+{
+	for (;;)
+	{
+		const INT_32 iCharLen = utf_charlen(szString, szStringEnd);
+		if (iCharLen != -1 && iCharLen != -2) { break; }
+
+		++szString;
+	}
+
+return szString;
+}
+
 //
 // Constructor
 //
@@ -57,107 +74,64 @@ INT_32 FnMBSubstring::Handler(CDT            * aArguments,
 	// Check number of parameters
 	if (iArgNum == 0) { oCDTRetVal = ""; return 0; }
 
+	// String is used in place
+	STLW::string sTMP;
+	UINT_32 iDataLength = 0;
+	CCHAR_P szData      = aArguments[iArgNum - 1].GetStringData(iDataLength);
+	if (szData == NULL)
+	{
+		sTMP        = aArguments[iArgNum - 1].GetString();
+		szData      = sTMP.data();
+		iDataLength = sTMP.size();
+	}
+	CCHAR_P szDataEnd = szData + iDataLength;
+
 	// substr('foobar', 2) -> 'obar'
 	if (iArgNum == 2)
 	{
-		const UINT_32       iOffset = UINT_32(aArguments[0].GetInt());
-		const STLW::string  sResult = aArguments[1].GetString();
-
-		CCHAR_P  szStart  = sResult.data();
-		CCHAR_P  szEnd    = sResult.data() + sResult.size();
-		INT_32   iPos     = 0;
-		UINT_32  iCharPos = 0;
-		for(;;)
-		{
-			INT_32 iCharLen = utf_charlen(szStart + iPos, szEnd);
+		const UINT_32  iOffset  = UINT_32(aArguments[0].GetInt());
 
-			if (iCharLen == -3) { break; }
+		UINT_32  iSkipped = 0;
+		CCHAR_P  szStart  = UTF8Skip(szData, szDataEnd, iOffset, iSkipped);
 
-			// Check character length
-			if (iCharLen < 0) { iCharLen = 1; }
-			// Skip errors
-			else              { ++iCharPos;   }
-			iPos += iCharLen;
-
-			if (iCharPos >= iOffset) { break; }
-		}
-
-		if (iCharPos < iOffset) { oCDTRetVal = ""; }
-		else                    { oCDTRetVal = sResult.substr(iPos); }
+		if (iSkipped < iOffset) { oCDTRetVal = ""; }
+		else                    { oCDTRetVal = STLW::string(szStart, szDataEnd - szStart); }
 
 		return 0;
 	}
 	// substr('foobar', 2, 3) -> 'oba'
 	if (iArgNum == 3)
 	{
-		const UINT_32       iBytes  = UINT_32(aArguments[0].GetInt());
-		const UINT_32       iOffset = UINT_32(aArguments[1].GetInt());
-		const STLW::string  sResult = aArguments[2].GetString();
-
-		CCHAR_P  szStart  = sResult.data();
-		CCHAR_P  szEnd    = sResult.data() + sResult.size();
-		INT_32   iPos     = 0;
-		UINT_32  iCharOffset = 0;
-		UINT_32  iCharPos = 0;
-		for(;;)
-		{
-			INT_32 iCharLen = utf_charlen(szStart + iPos, szEnd);
-
-			if (iCharLen == -3) { break; }
+		const UINT_32  iBytes   = UINT_32(aArguments[0].GetInt());
+		const UINT_32  iOffset  = UINT_32(aArguments[1].GetInt());
 
-			// Check character length
-			if (iCharLen < 0) { iCharLen = 1; }
-			// Skip errors
-			else              { ++iCharPos;   }
-			iPos += iCharLen;
+		UINT_32  iSkipped = 0;
+		CCHAR_P  szStart  = UTF8Skip(szData, szDataEnd, iOffset, iSkipped);
+		if (iSkipped < iOffset) { oCDTRetVal = ""; return 0; }
+		szStart = SkipBroken(szStart, szDataEnd);
 
-			if (iCharPos == iOffset)          { iCharOffset = iPos; }
-
-			if (iCharPos == iOffset + iBytes) { break; }
-		}
-
-		if (sResult.size() < iCharOffset) { oCDTRetVal = ""; }
-		else                              { oCDTRetVal = sResult.substr(iCharOffset, iPos - iCharOffset); }
+		CCHAR_P  szEnd    = UTF8Skip(szStart, szDataEnd, iBytes, iSkipped);
 
+		oCDTRetVal = STLW::string(szStart, szEnd - szStart);
 		return 0;
 	}
 	// substr('foobar', 2, 3, '1234567') -> 'fo1234567r'
 	if (iArgNum == 4)
 	{
-		STLW::string        sReplacement = aArguments[0].GetString();
-		const UINT_32       iBytes       = UINT_32(aArguments[1].GetInt());
-		const UINT_32       iOffset      = UINT_32(aArguments[2].GetInt());
-		const STLW::string  sTMP         = aArguments[3].GetString();
-
-		CCHAR_P  szStart  = sTMP.data();
-		CCHAR_P  szEnd    = sTMP.data() + sTMP.size();
-		UINT_32  iPos     = 0;
-		UINT_32  iCharOffset = 0;
-		UINT_32  iCharPos = 0;
-		for(;;)
-		{
-			INT_32 iCharLen = utf_charlen(szStart + iPos, szEnd);
+		const UINT_32  iBytes   = UINT_32(aArguments[1].GetInt());
+		const UINT_32  iOffset  = UINT_32(aArguments[2].GetInt());
 
-			if (iCharLen == -3) { break; }
+		UINT_32  iSkipped = 0;
+		CCHAR_P  szStart  = UTF8Skip(szData, szDataEnd, iOffset, iSkipped);
+		if (iSkipped < iOffset) { oCDTRetVal = ""; return 0; }
+		szStart = SkipBroken(szStart, szDataEnd);
 
-			// Check character length
-			if (iCharLen < 0) { iCharLen = 1; }
-			// Skip errors
-			else              { ++iCharPos;   }
-			iPos += iCharLen;
+		CCHAR_P  szEnd    = UTF8Skip(szStart, szDataEnd, iBytes, iSkipped);
 
-			if (iCharPos == iOffset)          { iCharOffset = iPos; }
+		STLW::string  sResult(szData, szStart - szData);
+		sResult.append(aArguments[0].GetString());
+		sResult.append(szEnd, szDataEnd - szEnd);
 
-			if (iCharPos == iOffset + iBytes) { break; }
-		}
-		if (sTMP.size() < iCharOffset) { oCDTRetVal = ""; return 0; }
-
-		STLW::string  sResult(sTMP, 0, iCharOffset);
-		sResult.append(sReplacement);
-
-		if (iPos == sTMP.size()) { oCDTRetVal = sResult; return 0; }
-
-		sResult.append(sTMP, iPos, STLW::string::npos);
 		oCDTRetVal = sResult;
 		return 0;
 	}
@@ -171,6 +145,11 @@ return -1;
 //
 CCHAR_P FnMBSubstring::GetName() const { return "mb_substr"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMBSubstring::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
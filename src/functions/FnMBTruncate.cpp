@@ -32,7 +32,7 @@
 
 #include "CDT.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
+#include "CTPP2UTF8.hpp"
 #include "FnMBTruncate.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -54,64 +54,36 @@ INT_32 FnMBTruncate::Handler(CDT            * aArguments,
                              CDT            & oCDTRetVal,
                              Logger         & oLogger)
 {
-	if (iArgNum == 2)
+	if (iArgNum == 2 || iArgNum == 3)
 	{
-		const UINT_32       iMaxLen = UINT_32(aArguments[0].GetInt());
-		const STLW::string  sData   = aArguments[1].GetString();
+		const UINT_32  iMaxLen  = UINT_32(aArguments[iArgNum - 2].GetInt());
 
-		CCHAR_P  szStart  = sData.data();
-		CCHAR_P  szEnd    = sData.data() + sData.size();
-		INT_32   iPos     = 0;
-		UINT_32  iCharPos = 0;
-		for(;;)
+		// String is used in place
+		STLW::string sTMP;
+		UINT_32 iDataLength = 0;
+		CCHAR_P szData      = aArguments[iArgNum - 1].GetStringData(iDataLength);
+		if (szData == NULL)
 		{
-			INT_32 iCharLen = utf_charlen(szStart + iPos, szEnd);
-			if (iCharLen == -3) { break; }
-
-			// Check character length
-			if (iCharLen < 0) { iCharLen = 1; }
-			// Skip errors
-			else              { ++iCharPos;   }
-			iPos += iCharLen;
-
-			if (iCharPos >= iMaxLen) { break; }
+			sTMP        = aArguments[iArgNum - 1].GetString();
+			szData      = sTMP.data();
+			iDataLength = sTMP.size();
 		}
 
-		if (iCharPos == iMaxLen) { oCDTRetVal = STLW::string(sData, 0, iPos); }
-		else                     { oCDTRetVal = sData;                       }
-
-		return 0;
-	}
-	else if (iArgNum == 3)
-	{
-		const UINT_32  iMaxLen = UINT_32(aArguments[1].GetInt());
-		STLW::string   sData   = aArguments[2].GetString();
+		UINT_32  iSkipped = 0;
+		CCHAR_P  szEnd    = UTF8Skip(szData, szData + iDataLength, iMaxLen, iSkipped);
 
-		CCHAR_P  szStart  = sData.data();
-		CCHAR_P  szEnd    = sData.data() + sData.size();
-		INT_32   iPos     = 0;
-		UINT_32  iCharPos = 0;
-		for(;;)
+		// Nothing to truncate; string is shorter or ends with incomplete sequence after less than iMaxLen characters
+		if (szEnd == szData + iDataLength || iSkipped < iMaxLen)
 		{
-			INT_32 iCharLen = utf_charlen(szStart + iPos, szEnd);
-
-			if (iCharLen == -3) { break; }
-
-			// Check character length
-			if (iCharLen < 0) { iCharLen = 1; }
-			// Skip errors
-			else              { ++iCharPos;   }
-			iPos += iCharLen;
-
-			if (iCharPos >= iMaxLen) { break; }
-		}
-		if (iCharPos >= iMaxLen)
-		{
-			sData = STLW::string(sData, 0, iPos);
-			sData.append(aArguments[0].GetString());
+			if (aArguments[iArgNum - 1].GetType() == CDT::STRING_VAL) { oCDTRetVal = aArguments[iArgNum - 1]; }
+			else                                                      { oCDTRetVal = sTMP;                    }
+			return 0;
 		}
 
-		oCDTRetVal = sData;
+		STLW::string sResult(szData, szEnd - szData);
+		if (iArgNum == 3) { sResult.append(aArguments[0].GetString()); }
+
+		oCDTRetVal = sResult;
 		return 0;
 	}
 
@@ -124,6 +96,11 @@ return -1;
 //
 CCHAR_P FnMBTruncate::GetName() const { return "mb_truncate"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMBTruncate::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -201,6 +201,11 @@ return 0;
 //
 CCHAR_P FnMD5::GetName() const { return "md5"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMD5::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 //
 // A destructor
 //
@@ -77,6 +77,11 @@ return 0;
 //
 CCHAR_P FnMax::GetName() const { return "max"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMax::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -77,6 +77,11 @@ return 0;
 //
 CCHAR_P FnMin::GetName() const { return "min"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnMin::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
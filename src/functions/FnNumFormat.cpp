@@ -32,10 +32,9 @@
 
 #include "CDT.hpp"
 #include "CTPP2Logger.hpp"
+#include "CTPP2NumberFormat.hpp"
 #include "FnNumFormat.hpp"
 
-#include <stdio.h>
-
 namespace CTPP // C++ Template Engine
 {
 
@@ -62,7 +61,15 @@ INT_32 FnNumFormat::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	STLW::string sTMP = aArguments[0].GetString();
+	// Separator is used in place
+	STLW::string sTMP;
+	UINT_32 iSeparatorLength = 0;
+	CCHAR_P szSeparator      = aArguments[0].GetStringData(iSeparatorLength);
+	if (szSeparator == NULL)
+	{
+		sTMP        = aArguments[0].GetString();
+		szSeparator = sTMP.c_str();
+	}
 
 	INT_64   iData;
 	W_FLOAT  dData;
@@ -79,14 +86,15 @@ INT_32 FnNumFormat::Handler(CDT            * aArguments,
 		INT_32 iNegative = 0;
 		if (iData < 0) { iData = -iData; iNegative = 1; }
 
-		INT_32 iCharacters = snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%lld", (long long)iData);
+		INT_32 iCharacters = FormatInteger(iData, szBuf);
+		szBuf[iCharacters] = '\0';
 		INT_32 iResPos = C_MAX_SPRINTF_LENGTH - 1;
 
 		INT_32 iPos      = 0;
 		while (iCharacters >= 0)
 		{
 			szRes[iResPos] = szBuf[iCharacters];
-			if (iPos++ % 3 == 0 && iPos != 1) { szRes[--iResPos] = sTMP[0]; }
+			if (iPos++ % 3 == 0 && iPos != 1) { szRes[--iResPos] = szSeparator[0]; }
 			--iCharacters;
 			--iResPos;
 		}
@@ -109,7 +117,8 @@ INT_32 FnNumFormat::Handler(CDT            * aArguments,
 		INT_32 iNegative = 0;
 		if (dData < 0) { dData = -dData; iNegative = 1; }
 
-		INT_32 iCharacters = snprintf(szBuf, C_MAX_SPRINTF_LENGTH, "%.*G", CTPP_FLOAT_PRECISION, dData);
+		INT_32 iCharacters = FormatFloat(dData, CTPP_FLOAT_PRECISION, szBuf);
+		szBuf[iCharacters] = '\0';
 		INT_32 iResPos = C_MAX_SPRINTF_LENGTH - 1;
 
 		INT_32 iTMP = iCharacters;
@@ -129,7 +138,7 @@ INT_32 FnNumFormat::Handler(CDT            * aArguments,
 		while (iCharacters >= 0)
 		{
 			szRes[iResPos] = szBuf[iCharacters];
-			if (iPos++ % 3 == 0 && iPos != 1) { szRes[--iResPos] = sTMP[0]; }
+			if (iPos++ % 3 == 0 && iPos != 1) { szRes[--iResPos] = szSeparator[0]; }
 			--iCharacters;
 			--iResPos;
 		}
@@ -247,6 +256,11 @@ return 0;
 //
 CCHAR_P FnNumFormat::GetName() const { return "num_format"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnNumFormat::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
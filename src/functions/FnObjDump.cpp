@@ -31,6 +31,7 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2OutputCollector.hpp"
 #include "FnObjDump.hpp"
 
 #include <math.h>
@@ -63,30 +64,34 @@ return 0;
 }
 
 //
-// Handler
+// Write result to output collector
 //
-INT_32 FnObjDump::Handler(CDT            * aArguments,
-                          const UINT_32    iArgNum,
-                          CDT            & oCDTRetVal,
-                          Logger         & oLogger)
+INT_32 FnObjDump::Write(CDT              * aArguments,
+                        const UINT_32      iArgNum,
+                        OutputCollector  & oCollector,
+                        Logger           & oLogger)
 {
 	if (iArgNum == 0)
 	{
-		oCDTRetVal = "Global data object:\n";
-		oCDTRetVal.Append(pCDT -> Dump(0, true));
+		static const CHAR_8 szHeader[] = "Global data object:\n";
+		oCollector.Collect(szHeader, sizeof(szHeader) - 1);
+
+		const STLW::string sDump = pCDT -> Dump(0, true);
+		oCollector.Collect(sDump.data(), sDump.size());
 	}
 	else
 	{
-		oCDTRetVal = "";
 		// Temp
 		CHAR_8 szBuffer[CTPP_ESCAPE_BUFFER_LEN + 1];
 
 		INT_32 iI = iArgNum - 1;
 		for (; iI >= 0; --iI)
 		{
-			snprintf(szBuffer, CTPP_ESCAPE_BUFFER_LEN, "Argument %d:\n", iArgNum - iI);
-			oCDTRetVal.Append(szBuffer);
-			oCDTRetVal.Append(aArguments[iI].Dump());
+			const INT_32 iLength = snprintf(szBuffer, CTPP_ESCAPE_BUFFER_LEN, "Argument %d:\n", iArgNum - iI);
+			oCollector.Collect(szBuffer, iLength);
+
+			const STLW::string sDump = aArguments[iI].Dump();
+			oCollector.Collect(sDump.data(), sDump.size());
 		}
 	}
 return 0;
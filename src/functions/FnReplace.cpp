@@ -78,6 +78,11 @@ INT_32 FnReplace::Handler(CDT            * aArguments,
 //
 CCHAR_P FnReplace::GetName() const { return "replace"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnReplace::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -47,6 +47,9 @@ INT_32 FnRussianPlural::Handler(CTPP::CDT          * aArguments,
 // Имя функции
 const CCHAR_8* FnRussianPlural::GetName() const { return "russian_plural"; }
 
+// Свойства функции
+UINT_32 FnRussianPlural::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 
 } // namespace 
 
@@ -109,6 +109,9 @@ INT_32 FnRussianSpellOut::Handler(CTPP::CDT          * aArguments,
 // Имя функции
 const CCHAR_8* FnRussianSpellOut::GetName() const { return "russian_spellout"; }
 
+// Свойства функции
+UINT_32 FnRussianSpellOut::GetCapabilities() const { return CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY; }
+
 
 } // namespace 
 
@@ -70,6 +70,11 @@ return 0;
 //
 CCHAR_P FnSize::GetName() const { return "size"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnSize::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -60,17 +60,8 @@ INT_32 FnSprintf::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	CDT oArgs(CDT::ARRAY_VAL);
-	INT_32 iPos = iArgNum - 2;
-
-	while (iPos >= 0)
-	{
-		oArgs.PushBack(aArguments[iPos]);
-		--iPos;
-	}
-
 	STLW::string sResult;
-	FormatString(aArguments[iArgNum - 1].GetString(), sResult, oArgs);
+	FormatString(aArguments[iArgNum - 1].GetString(), sResult, aArguments, iArgNum - 1);
 	oCDTRetVal = sResult;
 
 return 0;
@@ -81,6 +72,11 @@ return 0;
 //
 CCHAR_P FnSprintf::GetName() const { return "sprintf"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnSprintf::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
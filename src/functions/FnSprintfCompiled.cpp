@@ -0,0 +1,94 @@
+/*-
+ * Copyright (c) 2004 - 2011 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      FnSprintfCompiled.cpp
+ *
+ * $CTPP$
+ */
+
+#include "CDT.hpp"
+#include "CTPP2Logger.hpp"
+#include "CTPP2Sprintf.hpp"
+#include "FnSprintfCompiled.hpp"
+
+namespace CTPP // C++ Template Engine
+{
+
+//
+// Constructor
+//
+FnSprintfCompiled::FnSprintfCompiled()
+{
+	;;
+}
+
+//
+// Handler
+//
+INT_32 FnSprintfCompiled::Handler(CDT            * aArguments,
+                                  const UINT_32    iArgNum,
+                                  CDT            & oCDTRetVal,
+                                  Logger         & oLogger)
+{
+	if (iArgNum == 0)
+	{
+		oLogger.Emerg("Usage: SPRINTF(format, a[, b, ...])");
+		return -1;
+	}
+
+	UINT_32 iDescriptorLength = 0;
+	CCHAR_P szDescriptor = aArguments[iArgNum - 1].GetStringData(iDescriptorLength);
+	if (szDescriptor == NULL)
+	{
+		oLogger.Emerg("SPRINTF: invalid format descriptor");
+		return -1;
+	}
+
+	STLW::string sResult;
+	FormatCompiled(szDescriptor, iDescriptorLength, sResult, aArguments, iArgNum - 1);
+	oCDTRetVal = sResult;
+
+return 0;
+}
+
+//
+// Get function name
+//
+CCHAR_P FnSprintfCompiled::GetName() const { return CTPP2_INT_HANDLER_PREFIX "_sprintf"; }
+
+//
+// Get capabilities of function
+//
+UINT_32 FnSprintfCompiled::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
+//
+// A destructor
+//
+FnSprintfCompiled::~FnSprintfCompiled() throw() { ;; }
+
+} // namespace CTPP
+// End.
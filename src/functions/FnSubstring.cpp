@@ -107,6 +107,11 @@ return -1;
 //
 CCHAR_P FnSubstring::GetName() const { return "substr"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnSubstring::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -87,6 +87,11 @@ return -1;
 //
 CCHAR_P FnTruncate::GetName() const { return "truncate"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnTruncate::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
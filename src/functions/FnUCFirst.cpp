@@ -80,6 +80,11 @@ INT_32 FnUCFirst::Handler(CDT            * aArguments,
 //
 CCHAR_P FnUCFirst::GetName() const { return "ucfirst"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnUCFirst::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -31,8 +31,9 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2CDTOutputCollector.hpp"
+#include "CTPP2Escape.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
 #include "FnURIEscape.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -59,10 +60,19 @@ INT_32 FnURIEscape::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	STLW::string sResult;
-	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos) { sResult.append(aArguments[iPos].GetString()); }
-
-	oCDTRetVal = URIEscape(sResult);
+	// Escape arguments one by one straight into result
+	CDTOutputCollector oCollector(oCDTRetVal);
+	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos)
+	{
+		UINT_32 iLength = 0;
+		CCHAR_P szData  = aArguments[iPos].GetStringData(iLength);
+		if (szData != NULL) { EscapeData(ESCAPE_URI, szData, iLength, oCollector); }
+		else
+		{
+			const STLW::string sTMP = aArguments[iPos].GetString();
+			EscapeData(ESCAPE_URI, sTMP.data(), sTMP.size(), oCollector);
+		}
+	}
 
 return 0;
 }
@@ -72,6 +82,11 @@ return 0;
 //
 CCHAR_P FnURIEscape::GetName() const { return "uriescape"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnURIEscape::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
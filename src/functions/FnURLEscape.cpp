@@ -31,8 +31,9 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2CDTOutputCollector.hpp"
+#include "CTPP2Escape.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
 #include "FnURLEscape.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -60,10 +61,19 @@ INT_32 FnURLEscape::Handler(CDT            * aArguments,
 		return -1;
 	}
 
-	STLW::string sResult;
-	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos) { sResult.append(aArguments[iPos].GetString()); }
-
-	oCDTRetVal = URLEscape(sResult);
+	// Escape arguments one by one straight into result
+	CDTOutputCollector oCollector(oCDTRetVal);
+	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos)
+	{
+		UINT_32 iLength = 0;
+		CCHAR_P szData  = aArguments[iPos].GetStringData(iLength);
+		if (szData != NULL) { EscapeData(ESCAPE_URL, szData, iLength, oCollector); }
+		else
+		{
+			const STLW::string sTMP = aArguments[iPos].GetString();
+			EscapeData(ESCAPE_URL, sTMP.data(), sTMP.size(), oCollector);
+		}
+	}
 
 return 0;
 }
@@ -73,6 +83,11 @@ return 0;
 //
 CCHAR_P FnURLEscape::GetName() const { return "urlescape"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnURLEscape::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
@@ -31,8 +31,9 @@
  */
 
 #include "CDT.hpp"
+#include "CTPP2CDTOutputCollector.hpp"
+#include "CTPP2Escape.hpp"
 #include "CTPP2Logger.hpp"
-#include "CTPP2Util.hpp"
 #include "FnXMLEscape.hpp"
 
 namespace CTPP // C++ Template Engine
@@ -61,10 +62,19 @@ INT_32 FnXMLEscape::Handler(CDT            * aArguments,
 	}
 
 
-	STLW::string sResult;
-	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos) { sResult.append(aArguments[iPos].GetString()); }
-
-	oCDTRetVal = XMLEscape(sResult);
+	// Escape arguments one by one straight into result
+	CDTOutputCollector oCollector(oCDTRetVal);
+	for(INT_32 iPos = iArgNum - 1; iPos >=0; --iPos)
+	{
+		UINT_32 iLength = 0;
+		CCHAR_P szData  = aArguments[iPos].GetStringData(iLength);
+		if (szData != NULL) { EscapeData(ESCAPE_XML, szData, iLength, oCollector); }
+		else
+		{
+			const STLW::string sTMP = aArguments[iPos].GetString();
+			EscapeData(ESCAPE_XML, sTMP.data(), sTMP.size(), oCollector);
+		}
+	}
 
 return 0;
 }
@@ -74,6 +84,11 @@ return 0;
 //
 CCHAR_P FnXMLEscape::GetName() const { return "xmlescape"; }
 
+//
+// Get capabilities of function
+//
+UINT_32 FnXMLEscape::GetCapabilities() const { return CTPP2_SYSCALL_PURE; }
+
 //
 // A destructor
 //
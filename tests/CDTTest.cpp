@@ -31,8 +31,11 @@
  */
 #include <CDT.hpp>
 #include <CDTSortRoutines.hpp>
+#include <CTPP2CDTBinary.hpp>
+#include <CTPP2NumberFormat.hpp>
 
 #include <stdio.h>
+#include <string.h>
 
 #ifdef HAVE_SYSEXITS_H
 #include <sysexits.h>
@@ -40,8 +43,107 @@
 
 using namespace CTPP;
 
+/**
+  @class SquaresProvider
+  @brief Lazy array of squares, counts requests
+*/
+class SquaresProvider:
+  public CDT::DataProvider
+{
+public:
+	SquaresProvider(const UINT_32 iISize): iSize(iISize), iFetches(0) { ;; }
+
+	CDT::eValType GetType() const { return CDT::ARRAY_VAL; }
+
+	bool GetIndex(const UINT_32 iPos, CDT & oValue)
+	{
+		++iFetches;
+		oValue = INT_64(iPos * iPos);
+		return true;
+	}
+
+	UINT_32 Size() { return iSize; }
+
+	void Iterate(Visitor & oVisitor)
+	{
+		for (UINT_32 iPos = 0; iPos < iSize; ++iPos) { oVisitor.VisitElement(INT_64(iPos * iPos)); }
+	}
+
+	UINT_32 iSize;
+	UINT_32 iFetches;
+};
+
+/**
+  @class UserProvider
+  @brief Lazy hash with user profile, counts requests
+*/
+class UserProvider:
+  public CDT::DataProvider
+{
+public:
+	UserProvider(): iFetches(0) { ;; }
+
+	CDT::eValType GetType() const { return CDT::HASH_VAL; }
+
+	bool GetKey(const STLW::string & sKey, CDT & oValue)
+	{
+		++iFetches;
+		if (sKey == "name")  { oValue = "Lebowski"; return true; }
+		if (sKey == "drink") { oValue = "White Russian"; return true; }
+		return false;
+	}
+
+	UINT_32 Size() { return 2; }
+
+	void Iterate(Visitor & oVisitor)
+	{
+		oVisitor.VisitKey("name",  "Lebowski");
+		oVisitor.VisitKey("drink", "White Russian");
+	}
+
+	UINT_32 iFetches;
+};
+
+/**
+  @class CounterGenerator
+  @brief Generates numbers from 1 to N
+*/
+class CounterGenerator:
+  public CDT::Generator
+{
+public:
+	CounterGenerator(const INT_32 iILimit): iLimit(iILimit), iCounter(0) { ;; }
+
+	bool Next(CDT & oValue)
+	{
+		if (iCounter == iLimit) { return false; }
+		oValue = ++iCounter;
+		return true;
+	}
+
+	INT_32 iLimit;
+	INT_32 iCounter;
+};
+
+/**
+  @class PlainComparator
+  @brief Comparator without sorting key
+*/
+class PlainComparator:
+  public CDT::SortingComparator
+{
+public:
+	PlainComparator(const CDT::SortingComparator & oIComparator): oComparator(oIComparator) { ;; }
+
+	bool operator()(const CDT & oX, const CDT & oY) const { return oComparator(oX, oY); }
+
+	const CDT::SortingComparator & oComparator;
+};
+
 int main(void)
 {
+	INT_32 iExitCode = EX_OK;
+
 	CDT oCDT = 10;
 
 	fprintf(stderr, "== INT   ===================================\n");
@@ -763,6 +865,199 @@ $H{'q'} -> [1] -> {"test"} = "passed";
 		oDestination1.MergeCDT(oSource, CDT::DEEP_MERGE);
 		fprintf(stderr, "Merge: `%s`\n", oDestination1.RecursiveDump().c_str());
 	}
+
+	fprintf(stderr, "== Lazy ARRAY & HASH ========================\n");
+	{
+		SquaresProvider oSquares(1000);
+		UserProvider    oUser;
+
+		CDT oData;
+		oData["squares"] = CDT(&oSquares);
+		oData["user"]    = CDT(&oUser);
+
+		const CDT & oConstData = oData;
+		fprintf(stderr, "Size: %d, fetches: %d\n", INT_32(oConstData["squares"].Size()), INT_32(oSquares.iFetches));
+		fprintf(stderr, "squares[12] = %d\n", INT_32(oConstData["squares"][12].GetInt()));
+		fprintf(stderr, "squares[12] = %d\n", INT_32(oConstData["squares"].GetCDT(12).GetInt()));
+		fprintf(stderr, "Fetches: %d\n", INT_32(oSquares.iFetches));
+
+		bool bExist = false;
+		fprintf(stderr, "user.name = `%s`\n", oConstData["user"].GetExistedCDT("name", bExist).GetString().c_str());
+		fprintf(stderr, "user.age exist: %s\n", oConstData["user"].Exists("age") ? "yes" : "no");
+		fprintf(stderr, "user.age exist: %s\n", oConstData["user"].Exists("age") ? "yes" : "no");
+		fprintf(stderr, "user.name = `%s`\n", oConstData["user"].GetExistedCDT("name", bExist).GetString().c_str());
+		fprintf(stderr, "Fetches: %d\n", INT_32(oUser.iFetches));
+
+		// Write access materializes container
+		oData["user"]["age"] = 42;
+		fprintf(stderr, "User: `%s`\n", oData["user"].RecursiveDump().c_str());
+
+		SquaresProvider oFewSquares(5);
+		CDT oFew(&oFewSquares);
+		fprintf(stderr, "few[3] = %d\n", INT_32(oFew.GetCDT(3).GetInt()));
+		oFew.SortArray(SortCompareNum(CDT::SortingComparator::DESC));
+		fprintf(stderr, "Sorted: `%s`\n", oFew.JoinArrayElements(",").c_str());
+
+		try
+		{
+			CDT oBad(&oSquares);
+			oBad.GetCDT(1000);
+		}
+		catch(CDTRangeException & e) { fprintf(stderr, "CDTRangeException: OK\n"); }
+	}
+
+	fprintf(stderr, "== Generator ================================\n");
+	{
+		CounterGenerator oCounter(3);
+		const CDT oStream(&oCounter);
+
+		for (UINT_32 iPos = 0; iPos < oStream.Size(); ++iPos)
+		{
+			const CDT & oValue = oStream.GetCDT(iPos);
+			fprintf(stderr, "%d: %d%s (generated %d)\n", INT_32(iPos), INT_32(oValue.GetInt()), (iPos + 1 == oStream.Size() ? " last" : ""), INT_32(oCounter.iCounter));
+		}
+
+		try { oStream.GetCDT(0); }
+		catch(CDTRangeException & e) { fprintf(stderr, "Rewind: CDTRangeException: OK\n"); }
+
+		CounterGenerator oSmallCounter(4);
+		CDT oSmall(&oSmallCounter);
+		oSmall.SortArray(SortCompareNum(CDT::SortingComparator::DESC));
+		fprintf(stderr, "Sorted: `%s`\n", oSmall.JoinArrayElements(",").c_str());
+	}
+
+	fprintf(stderr, "== Number formatting ========================\n");
+	{
+		const W_FLOAT aValues[] = { 0.0, -0.0, 0.1, 0.30000000000000004, 19.99, -2.5E-7, 1E-5, 0.0001234,
+		                            999999999999.5, 34326306327050.0, 1E100, 5E-324, 3.14159265358979 };
+
+		UINT_32 iMismatches = 0;
+		for (UINT_32 iI = 0; iI < sizeof(aValues) / sizeof(aValues[0]); ++iI)
+		{
+			for (INT_32 iPrecision = 1; iPrecision <= 17; ++iPrecision)
+			{
+				CHAR_8 szExpected[C_MAX_SPRINTF_LENGTH + 1];
+				CHAR_8 szResult[C_MAX_SPRINTF_LENGTH + 1];
+				const INT_32  iExpectedLen = snprintf(szExpected, C_MAX_SPRINTF_LENGTH, "%.*G", iPrecision, aValues[iI]);
+				const UINT_32 iResultLen   = FormatFloat(aValues[iI], iPrecision, szResult);
+				if (UINT_32(iExpectedLen) != iResultLen || strncmp(szExpected, szResult, iResultLen) != 0) { ++iMismatches; }
+			}
+		}
+
+		const INT_64 aIntValues[] = { 0, 7, -10, 99, 100, 1234567890123LL, -9223372036854775807LL - 1 };
+		for (UINT_32 iI = 0; iI < sizeof(aIntValues) / sizeof(aIntValues[0]); ++iI)
+		{
+			CHAR_8 szExpected[C_MAX_SPRINTF_LENGTH + 1];
+			CHAR_8 szResult[C_MAX_SPRINTF_LENGTH + 1];
+			const INT_32  iExpectedLen = snprintf(szExpected, C_MAX_SPRINTF_LENGTH, "%lli", (long long)(aIntValues[iI]));
+			const UINT_32 iResultLen   = FormatInteger(aIntValues[iI], szResult);
+			if (UINT_32(iExpectedLen) != iResultLen || strncmp(szExpected, szResult, iResultLen) != 0) { ++iMismatches; }
+		}
+		fprintf(stderr, "Mismatches with snprintf: %d\n", INT_32(iMismatches));
+
+		CDT oNumber = 0.1;
+		oNumber.Append(W_FLOAT(2.5E-7));
+		oNumber.Append(INT_64(-42));
+		fprintf(stderr, "Append: `%s`\n", oNumber.GetString().c_str());
+	}
+
+	fprintf(stderr, "== Binary serialization =====================\n");
+	{
+		CDT oData;
+		oData["int"]      = INT_64(-1234567890123LL);
+		oData["float"]    = 3.25;
+		oData["string"]   = "The Dude abides";
+		oData["numeric"]  = "042";
+		oData["empty"]    = CDT(CDT::HASH_VAL);
+		oData["list"][0]  = 1;
+		oData["list"][1]  = "two";
+		oData["list"][2]["int"] = 3;
+		oData["list"][4]  = 5.5;
+
+		STLW::string sBinary;
+		CTPP2CDTBinaryWriter oWriter(sBinary);
+		fprintf(stderr, "Serialized: %d bytes\n", INT_32(oWriter.Write(oData)));
+
+		CTPP2CDTBinaryReader oReader(sBinary.data(), sBinary.size());
+		const CDT oView = oReader.GetRoot();
+
+		fprintf(stderr, "list[2].int = %d\n", INT_32(oView.GetCDT("list").GetCDT(2).GetCDT("int").GetInt()));
+		fprintf(stderr, "string = `%s`\n", oView.GetCDT("string").GetString().c_str());
+		fprintf(stderr, "missing exist: %s\n", oView.Exists("missing") ? "yes" : "no");
+		fprintf(stderr, "Equal dumps: %s\n", oView.RecursiveDump() == oData.RecursiveDump() ? "yes" : "no");
+
+		try { CTPP2CDTBinaryReader oBadReader(sBinary.data(), sBinary.size() - 1); }
+		catch(CTPPLogicError & e) { fprintf(stderr, "Truncated: %s\n", e.what()); }
+
+		// Element of one-element array refers to array itself
+		CDT oLoop(CDT::ARRAY_VAL);
+		oLoop.PushBack(1);
+		oWriter.Write(oLoop);
+
+		const UINT_32 iRootOffset = UINT_32(UCHAR_8(sBinary[12])) | (UINT_32(UCHAR_8(sBinary[13])) << 8);
+		// Type, varint size, offset of element
+		for (UINT_32 iI = 0; iI < 4; ++iI) { sBinary[iRootOffset + 2 + iI] = CHAR_8(iRootOffset >> (iI * 8)); }
+
+		try
+		{
+			CTPP2CDTBinaryReader oLoopReader(sBinary.data(), sBinary.size());
+			oLoopReader.GetRoot().RecursiveDump();
+			fprintf(stderr, "Self reference: NOT detected\n");
+			iExitCode = EX_SOFTWARE;
+		}
+		catch(CTPPLogicError & e) { fprintf(stderr, "Self reference: %s\n", e.what()); }
+	}
+	fprintf(stderr, "== Key sorting ==============================\n");
+	{
+		CDT oListing(CDT::ARRAY_VAL);
+		UINT_32 iSeed = 42;
+		for (UINT_32 iI = 0; iI < 100000; ++iI)
+		{
+			iSeed = iSeed * 1103515245 + 12345;
+			CDT & oItem = oListing[iI];
+			oItem["price"] = INT_64((iSeed >> 8) % 5000);
+			oItem["name"]  = CDT(INT_64((iSeed >> 4) % 100000)).GetString() + "x";
+		}
+
+		const SortCompareNumHashElement oByPrice("price", CDT::SortingComparator::DESC);
+		const SortCompareStrHashElement oByName("name");
+
+		CDT oExpected = oListing;
+		oExpected.SortArray(PlainComparator(oByPrice));
+		CDT oSorted = oListing;
+		oSorted.SortArray(oByPrice);
+
+		bool bEqual = true;
+		for (UINT_32 iI = 0; iI < oSorted.Size(); ++iI) { bEqual = bEqual && oSorted[iI]["price"] == oExpected[iI]["price"]; }
+		fprintf(stderr, "Numeric keys (DESC): %s\n", bEqual ? "ordered" : "NOT ordered");
+
+		oExpected.SortArray(PlainComparator(oByName));
+		oSorted.SortArray(oByName);
+
+		bEqual = true;
+		for (UINT_32 iI = 0; iI < oSorted.Size(); ++iI) { bEqual = bEqual && oSorted[iI]["name"].GetString() == oExpected[iI]["name"].GetString(); }
+		fprintf(stderr, "String keys (ASC): %s\n", bEqual ? "ordered" : "NOT ordered");
+
+		// Equal keys keep order
+		CDT oStable(CDT::ARRAY_VAL);
+		oStable[0]["k"] = 2; oStable[0]["v"] = "a";
+		oStable[1]["k"] = 1; oStable[1]["v"] = "b";
+		oStable[2]["k"] = 2; oStable[2]["v"] = "c";
+		oStable[3]["k"] = 1; oStable[3]["v"] = "d";
+		oStable.SortArray(SortCompareNumHashElement("k"));
+		fprintf(stderr, "Stable: `%s%s%s%s`\n", oStable[0]["v"].GetString().c_str(), oStable[1]["v"].GetString().c_str(),
+		                                        oStable[2]["v"].GetString().c_str(), oStable[3]["v"].GetString().c_str());
+
+		// Mixed types are compared by comparator
+		CDT oMixed(CDT::ARRAY_VAL);
+		oMixed.PushBack("b");
+		oMixed.PushBack(10);
+		oMixed.PushBack("a");
+		oMixed.PushBack(2.5);
+		oMixed.SortArray(SortCompareStr());
+		fprintf(stderr, "Mixed: `%s`\n", oMixed.JoinArrayElements(",").c_str());
+	}
+
 	fprintf(stderr, "== END ======================================\n");
 
 	// make valgrind happy
@@ -770,7 +1065,7 @@ $H{'q'} -> [1] -> {"test"} = "passed";
 	fclose(stdout);
 	fclose(stderr);
 
-return EX_OK;
+return iExitCode;
 }
 // End.
 
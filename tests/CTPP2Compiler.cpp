@@ -31,27 +31,33 @@
  */
 #include <CTPP2Parser.hpp>
 #include <CTPP2FileSourceLoader.hpp>
+#include <CTPP2GetText.hpp>
 #include <CTPP2ParserException.hpp>
 #include <CTPP2HashTable.hpp>
+#include <CTPP2SyscallFactory.hpp>
+#include <CTPP2VMSTDLib.hpp>
 #include <CTPP2VMDumper.hpp>
 #include <CTPP2VMOpcodes.h>
+#include <STLFunctional.hpp>
 
 #include <sys/stat.h>
 
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 
 using namespace CTPP;
 
-int main(int argc, char ** argv)
+//
+// Compile template and write program core to file
+//
+static int CompileTemplate(CCHAR_P               szSource,
+                           const STLW::string  & sDestination,
+                           const eCTPP2EscapeType eEscapeMode,
+                           const CTPP2GetText  * pGetText,
+                           const STLW::string  & sLanguage,
+                           const SyscallFactory * pSyscallFactory)
 {
-	if (argc != 3)
-	{
-		fprintf(stdout, "CTPP2 template compiler v" CTPP_VERSION " (" CTPP_IDENT "). Copyright (c) 2004-2011 CTPP Dev. Team.\n\n");
-		fprintf(stderr, "usage: %s source.ctpp2 destination.ct2\n", argv[0]);
-		return EX_USAGE;
-	}
-
 	VMOpcodeCollector  oVMOpcodeCollector;
 	StaticText         oSyscalls;
 	StaticData         oStaticData;
@@ -63,10 +69,13 @@ int main(int argc, char ** argv)
 	{
 		// Load template
 		CTPP2FileSourceLoader oSourceLoader;
-		oSourceLoader.LoadTemplate(argv[1]);
+		oSourceLoader.LoadTemplate(szSource);
 
 		// Create template parser
-		CTPP2Parser oCTPP2Parser(&oSourceLoader, &oCompiler, argv[1]);
+		CTPP2Parser oCTPP2Parser(&oSourceLoader, &oCompiler, szSource);
+		oCTPP2Parser.SetEscapeMode(eEscapeMode);
+		oCTPP2Parser.SetGetText(pGetText, sLanguage);
+		oCTPP2Parser.SetSyscallFactory(pSyscallFactory);
 
 		// Compile template
 		oCTPP2Parser.Compile();
@@ -106,19 +115,145 @@ int main(int argc, char ** argv)
 	const VMExecutable * aProgramCore = oDumper.GetExecutable(iSize);
 
 	// Open file only if compilation is done
-	FILE * FW = fopen(argv[2], "wb");
-	if (FW == NULL) { fprintf(stderr, "ERROR: Cannot open destination file `%s` for writing\n", argv[2]); return EX_SOFTWARE; }
+	FILE * FW = fopen(sDestination.c_str(), "wb");
+	if (FW == NULL) { fprintf(stderr, "ERROR: Cannot open destination file `%s` for writing\n", sDestination.c_str()); return EX_SOFTWARE; }
 
 	// Write to the disc
 	fwrite(aProgramCore, iSize, 1, FW);
 	// All done
 	fclose(FW);
 
+return EX_OK;
+}
+
+//
+// Name of program core for language: page.ct2 -> page.ru.ct2
+//
+static STLW::string LanguageCoreName(const STLW::string & sDestination, const STLW::string & sLanguage)
+{
+	STLW::string::size_type iDotPos   = sDestination.rfind('.');
+	STLW::string::size_type iSlashPos = sDestination.find_last_of("/\\");
+	if (iDotPos == STLW::string::npos || (iSlashPos != STLW::string::npos && iDotPos < iSlashPos)) { iDotPos = sDestination.size(); }
+
+return sDestination.substr(0, iDotPos) + "." + sLanguage + sDestination.substr(iDotPos);
+}
+
+int main(int argc, char ** argv)
+{
+	// Default escaping of <TMPL_var>
+	eCTPP2EscapeType eEscapeMode = ESCAPE_NONE;
+	// Catalogs for compile-time translation
+	CTPP2GetText               oGetText;
+	STLW::vector<STLW::string> vLanguages;
+	// Evaluate pure calls with literal arguments at compile time
+	bool                       bFoldCalls = false;
+	bool                       bUsage = false;
+
+	while (argc >= 4 && argv[1][0] == '-')
+	{
+		// Flag without value
+		if (strcmp(argv[1], "-f") == 0)
+		{
+			bFoldCalls = true;
+			++argv;
+			--argc;
+			continue;
+		}
+
+		if (argc < 5)
+		{
+			bUsage = true;
+			break;
+		}
+
+		if (strcmp(argv[1], "-e") == 0)
+		{
+			static CCHAR_P          aNames[] = { "html",      "xml",      "wml",      "url",      "uri",      "none",      NULL };
+			static eCTPP2EscapeType aTypes[] = { ESCAPE_HTML, ESCAPE_XML, ESCAPE_WML, ESCAPE_URL, ESCAPE_URI, ESCAPE_NONE       };
+
+			UINT_32 iPos = 0;
+			while (aNames[iPos] != NULL && strcasecmp(aNames[iPos], argv[2]) != 0) { ++iPos; }
+			if (aNames[iPos] == NULL) { fprintf(stderr, "ERROR: unknown escaping `%s`\n", argv[2]); return EX_USAGE; }
+
+			eEscapeMode = aTypes[iPos];
+		}
+		// Default i18n domain
+		else if (strcmp(argv[1], "-d") == 0)
+		{
+			oGetText.SetDefaultDomain(argv[2]);
+		}
+		// Catalog lang=path/domain.mo, one program core per language
+		else if (strcmp(argv[1], "-t") == 0)
+		{
+			const STLW::string sArg(argv[2]);
+			const STLW::string::size_type iEqPos = sArg.find('=');
+			if (iEqPos == STLW::string::npos || iEqPos == 0) { fprintf(stderr, "ERROR: expected lang=file.mo, got `%s`\n", argv[2]); return EX_USAGE; }
+
+			const STLW::string sLanguage(sArg, 0, iEqPos);
+			const STLW::string sFileName(sArg, iEqPos + 1);
+
+			// Domain is name of file, as in LC_MESSAGES/domain.mo
+			STLW::string::size_type iNamePos = sFileName.find_last_of("/\\");
+			iNamePos = (iNamePos == STLW::string::npos) ? 0 : iNamePos + 1;
+			STLW::string sDomain(sFileName, iNamePos);
+			if (sDomain.size() > 3 && sDomain.compare(sDomain.size() - 3, 3, ".mo") == 0) { sDomain.erase(sDomain.size() - 3); }
+
+			try
+			{
+				oGetText.AddTranslation(sFileName, sDomain, sLanguage);
+			}
+			catch(CTPPException & e)
+			{
+				fprintf(stderr, "ERROR: %s\n", e.what());
+				return EX_SOFTWARE;
+			}
+
+			if (STLW::find(vLanguages.begin(), vLanguages.end(), sLanguage) == vLanguages.end()) { vLanguages.push_back(sLanguage); }
+		}
+		else
+		{
+			bUsage = true;
+			break;
+		}
+
+		argv += 2;
+		argc -= 2;
+	}
+
+	if (bUsage || argc != 3)
+	{
+		fprintf(stdout, "CTPP2 template compiler v" CTPP_VERSION " (" CTPP_IDENT "). Copyright (c) 2004-2011 CTPP Dev. Team.\n\n");
+		fprintf(stderr, "usage: %s [-f] [-e html|xml|wml|url|uri|none] [-d domain] [-t lang=domain.mo ...] source.ctpp2 destination.ct2\n", argv[0]);
+		return EX_USAGE;
+	}
+
+	// Pure functions of standard library with literal arguments are evaluated at compile time only with -f:
+	// program core then keeps results of standard library, even if application registers its own handler
+	SyscallFactory oSyscallFactory(100);
+	STDLibInitializer::InitLibrary(oSyscallFactory);
+	const SyscallFactory * pSyscallFactory = bFoldCalls ? &oSyscallFactory : NULL;
+
+	int iRetCode = EX_OK;
+	if (vLanguages.empty())
+	{
+		iRetCode = CompileTemplate(argv[1], argv[2], eEscapeMode, NULL, "", pSyscallFactory);
+	}
+	else
+	{
+		// destination.lang.ct2 for every language
+		for (UINT_32 iI = 0; iI < vLanguages.size() && iRetCode == EX_OK; ++iI)
+		{
+			iRetCode = CompileTemplate(argv[1], LanguageCoreName(argv[2], vLanguages[iI]), eEscapeMode, &oGetText, vLanguages[iI], pSyscallFactory);
+		}
+	}
+
+	STDLibInitializer::DestroyLibrary(oSyscallFactory);
+
 	// Make valgrind happy
 	fclose(stdin);
 	fclose(stdout);
 	fclose(stderr);
 
-return EX_OK;
+return iRetCode;
 }
 // End.
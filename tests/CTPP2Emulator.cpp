@@ -30,9 +30,11 @@
  * $CTPP$
  */
 
-#include <CTPP2JSONParser.hpp>
-#include <CTPP2FileOutputCollector.hpp>
+#include <CTPP2JSONStreamParser.hpp>
+#include <CTPP2FDOutputCollector.hpp>
+#include <CTPP2FragmentCache.hpp>
 #include <CTPP2FileLogger.hpp>
+#include <CTPP2SyscallContext.hpp>
 #include <CTPP2SyscallFactory.hpp>
 #include <CTPP2VMDebugInfo.hpp>
 #include <CTPP2VM.hpp>
@@ -41,8 +43,6 @@
 #include <CTPP2VMStackException.hpp>
 #include <CTPP2GetText.hpp>
 
-#include <sys/stat.h>
-
 #ifdef HAVE_SYS_TIME_H
     #include <sys/time.h>
 #endif
@@ -51,11 +51,18 @@
     #include <CTPP2Time.h>
 #endif
 
+#ifdef HAVE_FCNTL_H
+    #include <fcntl.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+    #include <unistd.h>
+#endif
+
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 
-#include <memory>
-
 using namespace CTPP;
 
 int main(int argc, char ** argv)
@@ -74,15 +81,17 @@ int main(int argc, char ** argv)
 	// Load standard library
 	STDLibInitializer::InitLibrary(oSyscallFactory);
 	// Output
-	std::auto_ptr<FileOutputCollector> pOutputCollector(new FileOutputCollector(stdout));
-
-	if (argc >= 4 && strncmp(argv[3], "0", sizeof(argv[3])) != 0) { pOutputCollector.reset(new FileOutputCollector(argv[3], "w+")); }
+	INT_32 iOutputFD = fileno(stdout);
+	if (argc >= 4 && strncmp(argv[3], "0", sizeof(argv[3])) != 0)
+	{
+		iOutputFD = open(argv[3], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (iOutputFD == -1) { fprintf(stderr, "ERROR: Cannot open file `%s` for writing: %s\n", argv[3], strerror(errno)); return EX_CANTCREAT; }
+	}
 
 
 	CTPP2GetText oGetText;
 	if (argc >= 5 && strncmp(argv[4], "0", sizeof(argv[4])) != 0) { oGetText.AddTranslation(argv[4], "test", "unknown"); }
 	oGetText.InitSTDLibFunction(oSyscallFactory);
-	oGetText.SetLanguage(oSyscallFactory, "unknown");
 	oGetText.SetDefaultDomain("test");
 
 	UINT_32 iStepsLimit = 10240;
@@ -105,34 +114,31 @@ int main(int argc, char ** argv)
 		// Load JSON data
 		if(argc >= 3)
 		{
-			struct stat oStat;
-			// Get file size
-			if (stat(argv[2], &oStat) == -1 || oStat.st_size == 0) { fprintf(stderr, "ERROR: Cannot get size of file `%s`\n", argv[2]); return EX_SOFTWARE; }
-
-			// Allocate memory
-			CHAR_8 * szJSONBuffer = (CHAR_8 *)malloc(oStat.st_size + 1);
-			// Read from file
 			FILE * F = fopen(argv[2], "rb");
 			if (F == NULL) { fprintf(stderr, "ERROR: Cannot open file `%s` for reading\n", argv[2]); return EX_SOFTWARE; }
 
-			if (fread(szJSONBuffer, oStat.st_size, 1, F) != 1)
+			// Parse data as it is read
+			CTPP2JSONStreamParser oJSONParser(oHash);
+			CHAR_8 aJSONBuffer[65536];
+			for (;;)
+			{
+				const size_t iReadBytes = fread(aJSONBuffer, 1, sizeof(aJSONBuffer), F);
+				if (iReadBytes == 0) { break; }
+
+				oJSONParser.Parse(aJSONBuffer, aJSONBuffer + iReadBytes);
+			}
+
+			if (ferror(F) != 0)
 			{
 				fprintf(stderr, "ERROR: Cannot read from file `%s`\n", argv[2]);
 				fclose(F);
-				free(szJSONBuffer);
 				return EX_SOFTWARE;
 			}
 
-			szJSONBuffer[oStat.st_size] = '\0';
-
-			CTPP2JSONParser oJSONParser(oHash);
-			CCHAR_P szEnd = szJSONBuffer + oStat.st_size;
-			oJSONParser.Parse(szJSONBuffer, szEnd);
-
 			// All Done
 			fclose(F);
-			// All done with loading
-			free(szJSONBuffer);
+
+			oJSONParser.Finish();
 		}
 		else
 		{
@@ -142,15 +148,27 @@ int main(int argc, char ** argv)
 		// Logger
 		FileLogger oLogger(stderr);
 
+		// Static text of program is written without copying
+		FDOutputCollector oOutputCollector(iOutputFD, pVMMemoryCore);
+
 		// Run program
 		VM oVM(&oSyscallFactory, 10240, 10240, iStepsLimit);
 
+		// Storage of <TMPL_cache> fragments
+		LRUFragmentCache oFragmentCache;
+		oVM.SetFragmentCache(&oFragmentCache);
+
+		// Language of translation is a per-render setting, shared handlers are not touched
+		SyscallContext oContext("unknown");
+		oVM.SetContext(&oContext);
+
 		struct timeval sTimeValLocBegin;
 		gettimeofday(&sTimeValLocBegin, NULL);
 
 		UINT_32 iIP = 0;
-		oVM.Init(pVMMemoryCore, pOutputCollector.get(), &oLogger);
-		oVM.Run(pVMMemoryCore, pOutputCollector.get(), iIP, oHash, &oLogger);
+		oVM.Init(pVMMemoryCore, &oOutputCollector, &oLogger);
+		oVM.Run(pVMMemoryCore, &oOutputCollector, iIP, oHash, &oLogger);
+		oOutputCollector.Flush();
 
 		struct timeval sTimeValLocEnd;
 		gettimeofday(&sTimeValLocEnd, NULL);
@@ -196,6 +214,8 @@ int main(int argc, char ** argv)
 	// Destroy standard library
 	STDLibInitializer::DestroyLibrary(oSyscallFactory);
 
+	if (iOutputFD != fileno(stdout)) { close(iOutputFD); }
+
 	// make valgrind happy
 	fclose(stdin);
 	fclose(stdout);
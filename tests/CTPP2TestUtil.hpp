@@ -0,0 +1,126 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      CTPP2TestUtil.hpp
+ *
+ * $CTPP$
+ */
+#ifndef _CTPP2_TEST_UTIL_HPP__
+#define _CTPP2_TEST_UTIL_HPP__ 1
+
+#include <CTPP2OutputCollector.hpp>
+#include <STLString.hpp>
+#include <STLVector.hpp>
+
+#include <stdio.h>
+
+/**
+  @file CTPP2TestUtil.hpp
+  @brief Helpers shared by unit test programs
+*/
+
+namespace CTPP // C++ Template Engine
+{
+
+/**
+  @class ChunksCollector CTPP2TestUtil.hpp <CTPP2TestUtil.hpp>
+  @brief Stores every collected chunk
+*/
+class ChunksCollector:
+  public OutputCollector
+{
+public:
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength)
+	{
+		vChunks.push_back(STLW::string((CCHAR_P)vData, iDataLength));
+		return 0;
+	}
+
+	/**
+	  @brief Get all collected data
+	*/
+	STLW::string Joined() const
+	{
+		STLW::string sResult;
+		for (UINT_32 iI = 0; iI < vChunks.size(); ++iI) { sResult.append(vChunks[iI]); }
+		return sResult;
+	}
+
+	/**
+	  @brief Get size of longest chunk
+	*/
+	UINT_32 MaxChunkSize() const
+	{
+		UINT_32 iResult = 0;
+		for (UINT_32 iI = 0; iI < vChunks.size(); ++iI)
+		{
+			if (vChunks[iI].size() > iResult) { iResult = vChunks[iI].size(); }
+		}
+		return iResult;
+	}
+
+	/**
+	  @brief Check that no chunk is empty and chunks longer than buffer are passed from source as is
+	  @param sSource - source data
+	  @param iBufferLen - size of buffer of tested collector
+	*/
+	bool PassedThrough(const STLW::string & sSource, const UINT_32 iBufferLen) const
+	{
+		for (UINT_32 iI = 0; iI < vChunks.size(); ++iI)
+		{
+			const STLW::string & sChunk = vChunks[iI];
+			if (sChunk.empty() || (sChunk.size() > iBufferLen && sSource.find(sChunk) == STLW::string::npos)) { return false; }
+		}
+		return true;
+	}
+
+	/** Collected chunks */
+	STLW::vector<STLW::string> vChunks;
+};
+
+//
+// Report result of check
+//
+static inline void Check(const bool bResult, CCHAR_P szName, UINT_32 & iFailed)
+{
+	fprintf(stdout, "%s: %s\n", szName, bResult ? "OK" : "FAILED");
+	if (!bResult) { ++iFailed; }
+}
+
+//
+// Linear congruential generator, same sequence on every platform
+//
+static inline UINT_32 NextRandom(UINT_32 & iSeed)
+{
+	iSeed = iSeed * 1103515245 + 12345;
+
+return (iSeed >> 16) & 0x7FFF;
+}
+
+} // namespace CTPP
+#endif // _CTPP2_TEST_UTIL_HPP__
+// End.
@@ -0,0 +1,148 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      ChunkedOutputCollectorTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CTPP2ChunkedOutputCollector.hpp>
+#include <STLFunctional.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+int main(void)
+{
+	UINT_32 iFailed = 0;
+
+	// Marker split between two calls
+	{
+		ChunksCollector oTarget;
+		ChunkedOutputCollector oCollector(oTarget, 64);
+		oCollector.AddFlushMarker("<!-- flush -->");
+
+		OutputCollector & oOutput = oCollector;
+		oOutput.Collect("abc<!-- fl", 10);
+		Check(oTarget.vChunks.empty(), "No marker yet", iFailed);
+		oOutput.Collect("ush -->def", 10);
+		Check(oTarget.vChunks.size() == 1 && oTarget.vChunks[0] == "abc<!-- flush -->def", "Marker split between calls", iFailed);
+	}
+
+	// Buffer is full in the middle of marker
+	{
+		ChunksCollector oTarget;
+		ChunkedOutputCollector oCollector(oTarget, 8);
+		oCollector.AddFlushMarker("</head>");
+
+		OutputCollector & oOutput = oCollector;
+		oOutput.Collect("12345</h", 8);
+		Check(oTarget.vChunks.size() == 1, "Full buffer is flushed", iFailed);
+		oOutput.Collect("ead>x", 5);
+		Check(oTarget.vChunks.size() == 2 && oTarget.vChunks[1] == "ead>x", "Marker split by full buffer", iFailed);
+	}
+
+	// Marker starts in data passed to target as is
+	{
+		ChunksCollector oTarget;
+		ChunkedOutputCollector oCollector(oTarget, 5);
+		oCollector.AddFlushMarker("</head>");
+
+		OutputCollector & oOutput = oCollector;
+		oOutput.Collect("<html><head></h", 15);
+		oOutput.Collect("e", 1);
+		oOutput.Collect("ad>", 3);
+		Check(oTarget.vChunks.size() == 2 && oTarget.vChunks[1] == "ead>", "Marker split by large chunk", iFailed);
+	}
+
+	// Data written one byte at a time, markers of different length
+	{
+		const STLW::string sPage("<html><head><title>T</title></head><body>Text<!-- flush -->More text, more text</body></html>");
+
+		ChunksCollector oTarget;
+		{
+			ChunkedOutputCollector oCollector(oTarget, 10);
+			oCollector.AddFlushMarker("</head>");
+			oCollector.AddFlushMarker("<!-- flush -->");
+
+			OutputCollector & oOutput = oCollector;
+			for (UINT_32 iPos = 0; iPos < sPage.size(); ++iPos) { oOutput.Collect(sPage.data() + iPos, 1); }
+		}
+
+		// Chunk ends right after every marker
+		STLW::vector<UINT_32> vEnds;
+		UINT_32 iEnd = 0;
+		bool bShortChunks = true;
+		for (UINT_32 iI = 0; iI < oTarget.vChunks.size(); ++iI)
+		{
+			iEnd += oTarget.vChunks[iI].size();
+			vEnds.push_back(iEnd);
+			if (oTarget.vChunks[iI].size() > 10) { bShortChunks = false; }
+		}
+		const UINT_32 iHeadEnd  = sPage.find("</head>") + 7;
+		const UINT_32 iFlushEnd = sPage.find("<!-- flush -->") + 14;
+		const bool bMarkersFlushed = bShortChunks &&
+		                             STLW::find(vEnds.begin(), vEnds.end(), iHeadEnd)  != vEnds.end() &&
+		                             STLW::find(vEnds.begin(), vEnds.end(), iFlushEnd) != vEnds.end();
+		Check(oTarget.Joined() == sPage, "Byte at a time: data", iFailed);
+		Check(bMarkersFlushed, "Byte at a time: markers", iFailed);
+	}
+
+	// No markers, chunks of buffer size
+	{
+		ChunksCollector oTarget;
+		{
+			ChunkedOutputCollector oCollector(oTarget, 4);
+			OutputCollector & oOutput = oCollector;
+			oOutput.Collect("abc", 3);
+			oOutput.Collect("def", 3);
+			oOutput.Collect("ghijklmn", 8);
+			Check(oCollector.GetChunksNum() == 3, "Chunks count", iFailed);
+		}
+		Check(oTarget.Joined() == "abcdefghijklmn", "Data without markers", iFailed);
+	}
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
@@ -0,0 +1,230 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      DeflateOutputCollectorTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CDT.hpp>
+#include <CTPP2DeflateOutputCollector.hpp>
+#include <CTPP2FileLogger.hpp>
+#include <CTPP2SimpleCompiler.hpp>
+#include <CTPP2StringOutputCollector.hpp>
+#include <CTPP2SyscallFactory.hpp>
+#include <CTPP2VM.hpp>
+#include <CTPP2VMMemoryCore.hpp>
+#include <CTPP2VMSTDLib.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+#ifdef ZLIB_SUPPORT
+
+//
+// Inflate whole stream; zlib checks CRC-32 and ISIZE of gzip trailer
+//
+static bool Inflate(const STLW::string & sCompressed, const bool bGzip, STLW::string & sResult)
+{
+	z_stream oStream;
+	memset(&oStream, 0, sizeof(oStream));
+	if (inflateInit2(&oStream, bGzip ? 16 + MAX_WBITS : -MAX_WBITS) != Z_OK) { return false; }
+
+	oStream.next_in  = (Bytef *)sCompressed.data();
+	oStream.avail_in = sCompressed.size();
+
+	Bytef aBuffer[4096];
+	INT_32 iRC = Z_OK;
+	while (iRC == Z_OK)
+	{
+		oStream.next_out  = aBuffer;
+		oStream.avail_out = sizeof(aBuffer);
+		iRC = inflate(&oStream, Z_NO_FLUSH);
+		sResult.append((CCHAR_P)aBuffer, sizeof(aBuffer) - oStream.avail_out);
+	}
+	inflateEnd(&oStream);
+
+return iRC == Z_STREAM_END && oStream.avail_in == 0;
+}
+
+//
+// Render template
+//
+static void Render(const VMMemoryCore * pCore, CDT & oData, OutputCollector & oCollector)
+{
+	SyscallFactory oSyscallFactory(100);
+	STDLibInitializer::InitLibrary(oSyscallFactory);
+	{
+		FileLogger oLogger(stderr);
+		VM         oVM(&oSyscallFactory);
+
+		UINT_32 iIP = 0;
+		oVM.Init(pCore, &oCollector, &oLogger);
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+	}
+	STDLibInitializer::DestroyLibrary(oSyscallFactory);
+}
+
+//
+// Collector that rejects all data
+//
+class FailingCollector:
+  public OutputCollector
+{
+public:
+	INT_32 Collect(const void * vData, const UINT_32 iDataLength) { return -1; }
+	~FailingCollector() throw() { ;; }
+};
+
+//
+// Read little-endian 32-bit value
+//
+static UINT_32 ReadUInt32(const STLW::string & sData, const UINT_32 iPos)
+{
+	UINT_32 iValue = 0;
+	for (UINT_32 iI = 0; iI < 4; ++iI) { iValue |= UINT_32(UCHAR_8(sData[iPos + iI])) << (iI * 8); }
+
+return iValue;
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2) { fprintf(stderr, "usage: %s file.tmpl\n", argv[0]); return EX_USAGE; }
+
+	UINT_32 iFailed = 0;
+
+	SimpleCompiler oCompiler(argv[1]);
+	const VMMemoryCore * pCore = oCompiler.GetCore();
+
+	CDT oData;
+	oData["title"] = "Catalog";
+	for (UINT_32 iI = 0; iI < 50; ++iI)
+	{
+		oData["items"][iI]["name"]  = "Item #" + CDT(iI).GetString();
+		oData["items"][iI]["price"] = 10.5 * iI;
+	}
+
+	STLW::string sPage;
+	StringOutputCollector oPageCollector(sPage);
+	Render(pCore, oData, oPageCollector);
+
+	const DeflateStaticText oStaticText(pCore);
+	Check(oStaticText.GetBlocksNum() == 2, "Static text runs pre-deflated", iFailed);
+
+	for (UINT_32 iGzip = 0; iGzip < 2; ++iGzip)
+	{
+		const bool bGzip = (iGzip == 1);
+		STLW::string sCompressed;
+		{
+			StringOutputCollector oTarget(sCompressed);
+			DeflateOutputCollector oCollector(oTarget, bGzip, Z_DEFAULT_COMPRESSION, &oStaticText);
+			Render(pCore, oData, oCollector);
+		}
+
+		// Every pre-deflated block is copied to output as is
+		bool bSpliced = true;
+		for (UINT_32 iDataId = 0; iDataId < pCore -> static_text.GetRecordsNum(); ++iDataId)
+		{
+			UINT_32 iDataLength = 0;
+			CCHAR_P szData = pCore -> static_text.GetData(iDataId, iDataLength);
+
+			CCHAR_P szBlock      = NULL;
+			UINT_32 iBlockLength = 0;
+			UINT_32 iCRC         = 0;
+			if (oStaticText.Find(szData, iDataLength, szBlock, iBlockLength, iCRC) && sCompressed.find(STLW::string(szBlock, iBlockLength)) == STLW::string::npos) { bSpliced = false; }
+		}
+		Check(bSpliced, bGzip ? "gzip: blocks spliced" : "deflate: blocks spliced", iFailed);
+
+		STLW::string sInflated;
+		const bool bInflated = Inflate(sCompressed, bGzip, sInflated);
+		Check(bInflated && sInflated == sPage, bGzip ? "gzip: round trip" : "deflate: round trip", iFailed);
+
+		if (bGzip)
+		{
+			const UINT_32 iTrailer = sCompressed.size() - 8;
+			const UINT_32 iCRC     = crc32(crc32(0L, Z_NULL, 0), (const Bytef *)sPage.data(), sPage.size());
+			Check(ReadUInt32(sCompressed, iTrailer) == iCRC,               "gzip: CRC-32", iFailed);
+			Check(ReadUInt32(sCompressed, iTrailer + 4) == sPage.size(),  "gzip: ISIZE",  iFailed);
+		}
+	}
+
+	// Dynamic data only
+	{
+		STLW::string sCompressed;
+		{
+			StringOutputCollector oTarget(sCompressed);
+			DeflateOutputCollector oCollector(oTarget);
+			OutputCollector & oOutput = oCollector;
+			oOutput.Collect(sPage.data(), 100);
+			oCollector.Flush();
+			oOutput.Collect(sPage.data() + 100, sPage.size() - 100);
+		}
+
+		STLW::string sInflated;
+		const bool bInflated = Inflate(sCompressed, true, sInflated);
+		Check(bInflated && sInflated == sPage, "gzip without static text", iFailed);
+	}
+
+	// Target rejects gzip header
+	{
+		FailingCollector oTarget;
+		DeflateOutputCollector oCollector(oTarget);
+		OutputCollector & oOutput = oCollector;
+		Check(oOutput.Collect(sPage.data(), sPage.size()) == -1 && oCollector.Flush() == -1 && oCollector.Finish() == -1, "gzip header rejected", iFailed);
+	}
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+
+#else // ZLIB_SUPPORT
+
+int main(void)
+{
+	fprintf(stdout, "zlib support disabled\n");
+
+return EX_OK;
+}
+
+#endif // ZLIB_SUPPORT
+// End.
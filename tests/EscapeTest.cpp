@@ -0,0 +1,201 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      EscapeTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CTPP2Escape.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+//
+// Escape one character at a time
+//
+static STLW::string ReferenceEscape(const eCTPP2EscapeType eType, const STLW::string & sData)
+{
+	static const CHAR_8 aHexChars[] = "0123456789ABCDEF";
+
+	STLW::string sResult;
+	for (UINT_32 iPos = 0; iPos < sData.size(); ++iPos)
+	{
+		const UCHAR_8 uCH = sData[iPos];
+		if (eType == ESCAPE_NONE) { sResult.append(1, uCH); continue; }
+
+		if (eType == ESCAPE_URL || eType == ESCAPE_URI)
+		{
+			if ((uCH >= 'A' && uCH <= 'Z') || (uCH >= 'a' && uCH <= 'z') || (uCH >= '-' && uCH <= '9') || uCH == '_') { sResult.append(1, uCH); }
+			else
+			{
+				sResult.append(1, '%');
+				sResult.append(1, aHexChars[uCH >> 4]);
+				sResult.append(1, aHexChars[uCH & 0x0F]);
+			}
+			continue;
+		}
+
+		switch (uCH)
+		{
+			case '"':  sResult.append("&quot;"); break;
+			case '\'': sResult.append(eType == ESCAPE_HTML ? "&#39;" : "&apos;"); break;
+			case '<':  sResult.append("&lt;");   break;
+			case '>':  sResult.append("&gt;");   break;
+			case '&':  sResult.append("&amp;");  break;
+			default:
+				if (eType == ESCAPE_WML && uCH == '$') { sResult.append("$$"); }
+				// Control characters are removed from WML
+				else if (eType != ESCAPE_WML || uCH >= 0x20) { sResult.append(1, uCH); }
+		}
+	}
+
+return sResult;
+}
+
+//
+// Escape data to collector and to string and compare with reference
+//
+static bool CheckEscape(const eCTPP2EscapeType eType, const STLW::string & sData)
+{
+	const STLW::string sExpected = ReferenceEscape(eType, sData);
+
+	STLW::string sString("prefix");
+	EscapeData(eType, sData.data(), sData.size(), sString);
+
+	ChunksCollector oCollector;
+	EscapeData(eType, sData.data(), sData.size(), oCollector);
+
+	// Pieces shorter than 1/4 of buffer are collected in buffer, longer are passed as is
+return oCollector.PassedThrough(sData, CTPP_ESCAPE_BUFFER_LEN) && sString == "prefix" + sExpected && oCollector.Joined() == sExpected;
+}
+
+int main(void)
+{
+	UINT_32 iFailed = 0;
+
+	const eCTPP2EscapeType aTypes[] = { ESCAPE_HTML, ESCAPE_XML, ESCAPE_WML, ESCAPE_URL, ESCAPE_URI, ESCAPE_NONE };
+	CCHAR_P                aNames[] = { "HTML", "XML", "WML", "URL", "URI", "NONE" };
+
+	// Lengths around vector blocks, 1/4 of buffer, buffer and URL run sizes
+	const UINT_32 aLengths[] = { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 95, 96, 97, 255, 256, 257,
+	                             CTPP_ESCAPE_BUFFER_LEN - 1, CTPP_ESCAPE_BUFFER_LEN, CTPP_ESCAPE_BUFFER_LEN + 1,
+	                             2 * CTPP_ESCAPE_BUFFER_LEN + 7 };
+
+	// Characters to escape, bytes of invalid UTF-8 and control characters
+	const CHAR_8 aSpecial[] = { '"', '\'', '<', '>', '&', '$', '\x01', '\x1F', '\x7F', '\x80', '\xC0', '\xE2', '\xFF', ' ', '%', '~' };
+
+	for (UINT_32 iType = 0; iType < sizeof(aTypes) / sizeof(aTypes[0]); ++iType)
+	{
+		const eCTPP2EscapeType eType = aTypes[iType];
+		STLW::string sName;
+
+		// Nothing to escape
+		bool bResult = true;
+		for (UINT_32 iL = 0; iL < sizeof(aLengths) / sizeof(aLengths[0]); ++iL)
+		{
+			bResult = bResult && CheckEscape(eType, STLW::string(aLengths[iL], 'a'));
+		}
+		sName.assign(aNames[iType]).append(": clean data");
+		Check(bResult, sName.c_str(), iFailed);
+
+		// One special character at every position of block
+		bResult = true;
+		for (UINT_32 iL = 0; iL < sizeof(aLengths) / sizeof(aLengths[0]) && aLengths[iL] <= 257; ++iL)
+		{
+			for (UINT_32 iPos = 0; iPos < aLengths[iL]; ++iPos)
+			{
+				for (UINT_32 iS = 0; iS < sizeof(aSpecial); ++iS)
+				{
+					STLW::string sData(aLengths[iL], 'x');
+					sData[iPos] = aSpecial[iS];
+					bResult = bResult && CheckEscape(eType, sData);
+				}
+			}
+		}
+		sName.assign(aNames[iType]).append(": one special character");
+		Check(bResult, sName.c_str(), iFailed);
+
+		// Special characters only; escaped output does not fit into buffer
+		bResult = true;
+		for (UINT_32 iL = 0; iL < sizeof(aLengths) / sizeof(aLengths[0]); ++iL)
+		{
+			STLW::string sData;
+			for (UINT_32 iPos = 0; iPos < aLengths[iL]; ++iPos) { sData.append(1, aSpecial[iPos % sizeof(aSpecial)]); }
+			bResult = bResult && CheckEscape(eType, sData);
+		}
+		sName.assign(aNames[iType]).append(": special characters only");
+		Check(bResult, sName.c_str(), iFailed);
+
+		// Random bytes, mostly clean text with invalid UTF-8 and runs of characters to escape
+		bResult = true;
+		UINT_32 iSeed = 1;
+		for (UINT_32 iRound = 0; iRound < 200; ++iRound)
+		{
+			const UINT_32 iLength = NextRandom(iSeed) % (3 * CTPP_ESCAPE_BUFFER_LEN);
+			STLW::string sData;
+			for (UINT_32 iPos = 0; iPos < iLength; ++iPos)
+			{
+				const UINT_32 iRandom = NextRandom(iSeed);
+				if (iRandom % 8 == 0) { sData.append(1, CHAR_8(iRandom >> 3)); }
+				else                  { sData.append(1, CHAR_8('a' + iRandom % 26)); }
+			}
+			bResult = bResult && CheckEscape(eType, sData);
+		}
+		sName.assign(aNames[iType]).append(": random data");
+		Check(bResult, sName.c_str(), iFailed);
+	}
+
+	// Known values
+	STLW::string sResult;
+	EscapeData(ESCAPE_HTML, "<a href='x'>&</a>", 17, sResult);
+	Check(sResult == "&lt;a href=&#39;x&#39;&gt;&amp;&lt;/a&gt;", "HTML value", iFailed);
+
+	sResult.erase();
+	EscapeData(ESCAPE_URL, "a b/\xD0\x96\xC0", 7, sResult);
+	Check(sResult == "a%20b/%D0%96%C0", "URL value", iFailed);
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
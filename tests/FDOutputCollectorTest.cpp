@@ -0,0 +1,298 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      FDOutputCollectorTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CTPP2FDOutputCollector.hpp>
+#include <CTPP2SimpleCompiler.hpp>
+#include <CTPP2VMMemoryCore.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+//
+// Size of file
+//
+static UINT_32 FileSize(FILE * F)
+{
+	fflush(F);
+	const long iPos = ftell(F);
+	fseek(F, 0, SEEK_END);
+	const long iSize = ftell(F);
+	fseek(F, iPos, SEEK_SET);
+
+return UINT_32(iSize);
+}
+
+//
+// Contents of file
+//
+static STLW::string FileData(FILE * F)
+{
+	STLW::string sResult;
+	rewind(F);
+
+	CHAR_8 szBuffer[4096];
+	size_t iRead = 0;
+	while ((iRead = fread(szBuffer, 1, sizeof(szBuffer), F)) != 0) { sResult.append(szBuffer, iRead); }
+
+return sResult;
+}
+
+#ifdef HAVE_PTHREAD_H
+/** Number of delivered signals */
+static volatile sig_atomic_t iSignals = 0;
+
+//
+// Interrupts writev(2)
+//
+static void AlarmHandler(int) { ++iSignals; }
+
+/**
+  @struct SlowReader
+  @brief Reads pipe by small pieces with pauses, so writer blocks and writev(2) is interrupted
+*/
+struct SlowReader
+{
+	/** Read end of pipe  */
+	INT_32         fd;
+	/** Read data         */
+	STLW::string   data;
+};
+
+//
+// Read pipe until end of data
+//
+static void * ReadThread(void * vReader)
+{
+	SlowReader * pReader = (SlowReader *)vReader;
+
+	CHAR_8 szBuffer[1000];
+	for (;;)
+	{
+		const ssize_t iRead = read(pReader -> fd, szBuffer, sizeof(szBuffer));
+		if (iRead <= 0) { break; }
+
+		pReader -> data.append(szBuffer, iRead);
+		usleep(20);
+	}
+
+return NULL;
+}
+#endif // HAVE_PTHREAD_H
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2) { fprintf(stderr, "usage: %s file.tmpl\n", argv[0]); return EX_USAGE; }
+
+	UINT_32 iFailed = 0;
+
+	SimpleCompiler oCompiler(argv[1]);
+	const VMMemoryCore * pCore = oCompiler.GetCore();
+
+	UINT_32 iStaticSize = 0;
+	CCHAR_P szStatic = pCore -> static_text.GetRawData(iStaticSize);
+	if (iStaticSize <= C_FD_COLLECTOR_MAX_IOVECS) { fprintf(stderr, "%s: static text is too short\n", argv[1]); return EX_DATAERR; }
+
+	// Pending data is written when threshold is reached
+	{
+		FILE * F = tmpfile();
+		FDOutputCollector oCollector(fileno(F), NULL, 100);
+		OutputCollector & oOutput = oCollector;
+
+		const STLW::string sData(99, 'a');
+		oOutput.Collect(sData.data(), sData.size());
+		Check(FileSize(F) == 0, "Threshold: data below threshold kept", iFailed);
+
+		oOutput.Collect("b", 1);
+		Check(FileSize(F) == 100, "Threshold: data written at threshold", iFailed);
+
+		// Chunk that does not fit into buffer flushes it first
+		oOutput.Collect("0123456789", 10);
+		oOutput.Collect(sData.data(), 45);
+		Check(FileSize(F) == 100, "Threshold: small chunks buffered", iFailed);
+		oOutput.Collect(sData.data(), 46);
+		Check(FileSize(F) == 155, "Threshold: buffer flushed before chunk", iFailed);
+
+		oCollector.Flush();
+		Check(FileData(F) == sData + "b0123456789" + STLW::string(45 + 46, 'a'), "Threshold: data", iFailed);
+		fclose(F);
+	}
+
+	// Chunk longer than half of buffer is written at once with pending data
+	{
+		FILE * F = tmpfile();
+		FDOutputCollector oCollector(fileno(F), NULL, 100);
+		OutputCollector & oOutput = oCollector;
+
+		oOutput.Collect("abc", 3);
+		const STLW::string sLarge(98, 'x');
+		oOutput.Collect(sLarge.data(), sLarge.size());
+		Check(FileSize(F) == 101 && FileData(F) == "abc" + sLarge, "Large chunk written at once", iFailed);
+
+		const STLW::string sHuge(1000, 'y');
+		oOutput.Collect(sHuge.data(), sHuge.size());
+		Check(FileSize(F) == 1101, "Chunk larger than buffer", iFailed);
+		fclose(F);
+	}
+
+	// Static text is referenced; chunks that are not adjacent take one iovec each
+	{
+		FILE * F = tmpfile();
+		STLW::string sExpected;
+		bool bKept = true;
+		{
+			FDOutputCollector oCollector(fileno(F), pCore, 1024 * 1024);
+			OutputCollector & oOutput = oCollector;
+
+			for (UINT_32 iI = 0; iI < C_FD_COLLECTOR_MAX_IOVECS / 2; ++iI)
+			{
+				oOutput.Collect(szStatic + (iI % 32), 16);
+				oOutput.Collect("-", 1);
+				sExpected.append(szStatic + (iI % 32), 16).append("-");
+			}
+			if (FileSize(F) != 0) { bKept = false; }
+
+			// No room for next chunk
+			oOutput.Collect(szStatic, 16);
+			const UINT_32 iFlushed = FileSize(F);
+			Check(bKept && iFlushed == sExpected.size(), "Max. number of chunks", iFailed);
+			sExpected.append(szStatic, 16);
+
+			// Adjacent pieces of static text are merged into one chunk
+			for (UINT_32 iI = 0; iI < iStaticSize; ++iI) { oOutput.Collect(szStatic + iI, 1); }
+			sExpected.append(szStatic, iStaticSize);
+			Check(FileSize(F) == iFlushed, "Adjacent static text merged", iFailed);
+		}
+		Check(FileData(F) == sExpected, "Static text: data", iFailed);
+		fclose(F);
+	}
+
+#ifdef HAVE_PTHREAD_H
+	// Partial writes and writes interrupted by signal
+	{
+		INT_32 aPipe[2];
+		if (pipe(aPipe) != 0) { fprintf(stderr, "pipe: %s\n", strerror(errno)); return EX_OSERR; }
+
+		// Reader does not receive signals
+		sigset_t oSignals;
+		sigemptyset(&oSignals);
+		sigaddset(&oSignals, SIGALRM);
+		pthread_sigmask(SIG_BLOCK, &oSignals, NULL);
+
+		SlowReader oReader;
+		oReader.fd = aPipe[0];
+		pthread_t oThread;
+		pthread_create(&oThread, NULL, ReadThread, &oReader);
+
+		pthread_sigmask(SIG_UNBLOCK, &oSignals, NULL);
+
+		// Signal handler without SA_RESTART interrupts blocked writev(2)
+		struct sigaction oAction;
+		memset(&oAction, 0, sizeof(oAction));
+		oAction.sa_handler = AlarmHandler;
+		sigaction(SIGALRM, &oAction, NULL);
+
+		struct itimerval oTimer;
+		oTimer.it_interval.tv_sec  = 0;
+		oTimer.it_interval.tv_usec = 500;
+		oTimer.it_value            = oTimer.it_interval;
+		setitimer(ITIMER_REAL, &oTimer, NULL);
+
+		STLW::string sExpected;
+		bool bWritten = true;
+		{
+			FDOutputCollector oCollector(aPipe[1], pCore, 256 * 1024);
+			OutputCollector & oOutput = oCollector;
+
+			UINT_32 iSeed = 1;
+			while (sExpected.size() < 4 * 1024 * 1024)
+			{
+				const UINT_32 iRandom = NextRandom(iSeed);
+				// Static text, short dynamic chunks, chunks passed as is
+				if (iRandom % 4 == 0)
+				{
+					const UINT_32 iOffset = iRandom % (iStaticSize - 32);
+					if (oOutput.Collect(szStatic + iOffset, 32) != 0) { bWritten = false; }
+					sExpected.append(szStatic + iOffset, 32);
+				}
+				else
+				{
+					const STLW::string sChunk((iRandom % 8 == 1) ? 200000 : iRandom % 500 + 1, CHAR_8('a' + iRandom % 26));
+					if (oOutput.Collect(sChunk.data(), sChunk.size()) != 0) { bWritten = false; }
+					sExpected.append(sChunk);
+				}
+			}
+			if (oCollector.Flush() != 0) { bWritten = false; }
+		}
+
+		memset(&oTimer, 0, sizeof(oTimer));
+		setitimer(ITIMER_REAL, &oTimer, NULL);
+
+		close(aPipe[1]);
+		pthread_join(oThread, NULL);
+		close(aPipe[0]);
+
+		Check(bWritten && iSignals > 0, "Interrupted writes: no errors", iFailed);
+		Check(oReader.data == sExpected, "Interrupted writes: data", iFailed);
+	}
+#endif // HAVE_PTHREAD_H
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
@@ -0,0 +1,156 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      FragmentCacheTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CTPP2FragmentCache.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+// Stored size of entry with 2-byte key and 10-byte data, see C_FRAGMENT_ENTRY_OVERHEAD
+#define C_TEST_ENTRY_SIZE (2 + 10 + 96)
+
+int main(void)
+{
+	UINT_32 iFailed = 0;
+
+	// Lookups and replacement
+	{
+		LRUFragmentCache oCache(1024 * 1024, 1);
+		STLW::string sData;
+
+		Check(!oCache.Get("k1", sData) && oCache.GetMisses() == 1 && oCache.GetHits() == 0, "Missing key", iFailed);
+
+		oCache.Put("k1", "0123456789", 0);
+		Check(oCache.Get("k1", sData) && sData == "0123456789" && oCache.GetHits() == 1, "Stored key", iFailed);
+		Check(oCache.GetEntriesNum() == 1 && oCache.GetSize() == C_TEST_ENTRY_SIZE, "Size of entry", iFailed);
+
+		oCache.Put("k1", "abc", 0);
+		Check(oCache.Get("k1", sData) && sData == "abc" && oCache.GetEntriesNum() == 1 && oCache.GetSize() == C_TEST_ENTRY_SIZE - 7, "Replaced key", iFailed);
+
+		oCache.Clear();
+		Check(!oCache.Get("k1", sData) && oCache.GetEntriesNum() == 0 && oCache.GetSize() == 0, "Clear", iFailed);
+		Check(oCache.GetHits() == 2 && oCache.GetMisses() == 2, "Hits and misses", iFailed);
+	}
+
+	// Least recently used entries are evicted; room for 3 entries
+	{
+		LRUFragmentCache oCache(3 * C_TEST_ENTRY_SIZE + 10, 1);
+		STLW::string sData;
+
+		oCache.Put("k1", "1111111111", 0);
+		oCache.Put("k2", "2222222222", 0);
+		oCache.Put("k3", "3333333333", 0);
+		Check(oCache.GetEntriesNum() == 3, "Cache full", iFailed);
+
+		// k1 is used, k2 is least recently used
+		oCache.Get("k1", sData);
+		oCache.Put("k4", "4444444444", 0);
+		Check(oCache.GetEntriesNum() == 3 && !oCache.Get("k2", sData), "Least recently used evicted", iFailed);
+		Check(oCache.Get("k1", sData) && oCache.Get("k3", sData) && oCache.Get("k4", sData) && sData == "4444444444", "Recently used kept", iFailed);
+
+		// Replacement makes entry most recently used: order is k3, k1, k4
+		oCache.Put("k3", "3333333333", 0);
+		oCache.Put("k5", "5555555555", 0);
+		Check(!oCache.Get("k1", sData) && oCache.Get("k3", sData) && oCache.Get("k4", sData) && oCache.Get("k5", sData), "Replaced entry kept", iFailed);
+
+		// Entry larger than cache is not stored and removes previous output of key
+		oCache.Put("k4", STLW::string(4 * C_TEST_ENTRY_SIZE, 'x'), 0);
+		Check(!oCache.Get("k4", sData) && oCache.GetEntriesNum() == 2 && oCache.GetSize() == 2 * C_TEST_ENTRY_SIZE, "Too large entry", iFailed);
+		Check(oCache.Get("k3", sData) && oCache.Get("k5", sData), "Too large entry: other entries kept", iFailed);
+	}
+
+	// Keys spread over shards
+	{
+		LRUFragmentCache oCache(1024 * 1024, 16);
+		STLW::string sData;
+
+		for (UINT_32 iI = 0; iI < 100; ++iI)
+		{
+			CHAR_8 szKey[32];
+			snprintf(szKey, sizeof(szKey), "key%u", iI);
+			oCache.Put(szKey, szKey, 0);
+		}
+
+		bool bFound = true;
+		for (UINT_32 iI = 0; iI < 150; ++iI)
+		{
+			CHAR_8 szKey[32];
+			snprintf(szKey, sizeof(szKey), "key%u", iI);
+			if (oCache.Get(szKey, sData) != (iI < 100) || (iI < 100 && sData != szKey)) { bFound = false; }
+		}
+		Check(bFound && oCache.GetEntriesNum() == 100, "Shards: lookups", iFailed);
+		Check(oCache.GetHits() == 100 && oCache.GetMisses() == 50, "Shards: hits and misses", iFailed);
+	}
+
+#ifdef HAVE_UNISTD_H
+	// Expired entries are removed on lookup
+	{
+		LRUFragmentCache oCache(1024 * 1024, 1);
+		STLW::string sData;
+
+		oCache.Put("k1", "1111111111", 1);
+		oCache.Put("k2", "2222222222", 0);
+		Check(oCache.Get("k1", sData), "TTL: before expiration", iFailed);
+
+		sleep(2);
+		Check(!oCache.Get("k1", sData) && oCache.GetEntriesNum() == 1, "TTL: expired", iFailed);
+		Check(oCache.Get("k2", sData), "TTL: without expiration", iFailed);
+
+		// New output of expired key
+		oCache.Put("k1", "abc", 1);
+		Check(oCache.Get("k1", sData) && sData == "abc", "TTL: stored again", iFailed);
+	}
+#endif // HAVE_UNISTD_H
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
@@ -0,0 +1,233 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      JSONSerializerTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CDT.hpp>
+#include <CTPP2JSONSerializer.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+//
+// Escape one character at a time
+//
+static STLW::string ReferenceEscape(const STLW::string & sData, const bool bECMA, const bool bHTMLSafe)
+{
+	static const CHAR_8 aHexChars[] = "0123456789abcdef";
+
+	STLW::string sResult;
+	for (UINT_32 iPos = 0; iPos < sData.size(); ++iPos)
+	{
+		const UCHAR_8 uCH = sData[iPos];
+		switch (uCH)
+		{
+			case '"':  sResult.append("\\\""); continue;
+			case '\\': sResult.append("\\\\"); continue;
+			case '/':  sResult.append("\\/");  continue;
+			case '\b': sResult.append("\\b");  continue;
+			case '\f': sResult.append("\\f");  continue;
+			case '\n': sResult.append("\\n");  continue;
+			case '\r': sResult.append("\\r");  continue;
+			case '\t': sResult.append("\\t");  continue;
+			default:
+				;;
+		}
+
+		if (bECMA && uCH == '\'') { sResult.append("\\'"); continue; }
+		if (bECMA && uCH == '\v') { sResult.append("\\v"); continue; }
+		if (bECMA && uCH == '\0') { sResult.append("\\0"); continue; }
+
+		// Line and paragraph separators; broken sequences are copied as is
+		if (uCH == 0xE2 && iPos + 2 < sData.size() && UCHAR_8(sData[iPos + 1]) == 0x80 && (UCHAR_8(sData[iPos + 2]) == 0xA8 || UCHAR_8(sData[iPos + 2]) == 0xA9))
+		{
+			sResult.append(UCHAR_8(sData[iPos + 2]) == 0xA8 ? "\\u2028" : "\\u2029");
+			iPos += 2;
+			continue;
+		}
+
+		if (uCH < 0x20 || (bHTMLSafe && (uCH == '<' || uCH == '>')))
+		{
+			sResult.append("\\u00");
+			sResult.append(1, aHexChars[uCH >> 4]);
+			sResult.append(1, aHexChars[uCH & 0x0F]);
+			continue;
+		}
+
+		sResult.append(1, uCH);
+	}
+
+return sResult;
+}
+
+//
+// Serialize string to collector and compare with reference
+//
+static bool CheckString(const STLW::string & sData, const bool bECMA, const bool bHTMLSafe)
+{
+	ChunksCollector oCollector;
+	{
+		CTPP2JSONSerializer oSerializer(oCollector, bECMA, bHTMLSafe);
+		oSerializer.Write("[", 1);
+		oSerializer.WriteString(sData.data(), sData.size());
+		oSerializer.Write("]", 1);
+	}
+
+	// Buffered chunks fit into buffer, longer ones are unescaped runs of input
+return oCollector.PassedThrough(sData, C_JSON_SERIALIZER_BUFFER_LEN) && oCollector.Joined() == "[" + ReferenceEscape(sData, bECMA, bHTMLSafe) + "]";
+}
+
+int main(void)
+{
+	UINT_32 iFailed = 0;
+
+	// Lengths around vector block and buffer size
+	const UINT_32 aLengths[] = { 0, 1, 2, 3, 15, 16, 17, 18, 31, 32, 33, 255, 256, 257,
+	                             C_JSON_SERIALIZER_BUFFER_LEN - 2, C_JSON_SERIALIZER_BUFFER_LEN - 1, C_JSON_SERIALIZER_BUFFER_LEN,
+	                             C_JSON_SERIALIZER_BUFFER_LEN + 1, 2 * C_JSON_SERIALIZER_BUFFER_LEN + 5 };
+
+	// Characters to escape and bytes of invalid UTF-8
+	CCHAR_P aSpecial[] = { "\"", "\\", "/", "\b", "\f", "\n", "\r", "\t", "'", "\v", "<", ">", "\x01", "\x1F", "\x7F",
+	                       "\xE2\x80\xA8", "\xE2\x80\xA9", "\xE2\x80\xAA", "\xE2\x80", "\xE2", "\xE2\"", "\x80", "\xC0\"", "\xFF" };
+
+	for (UINT_32 iMode = 0; iMode < 4; ++iMode)
+	{
+		const bool bECMA     = (iMode & 1) != 0;
+		const bool bHTMLSafe = (iMode & 2) != 0;
+		CHAR_8 szMode[64];
+		snprintf(szMode, sizeof(szMode), "ECMA %s, HTML-safe %s", bECMA ? "on" : "off", bHTMLSafe ? "on" : "off");
+		STLW::string sName;
+
+		// Nothing to escape
+		bool bResult = true;
+		for (UINT_32 iL = 0; iL < sizeof(aLengths) / sizeof(aLengths[0]); ++iL)
+		{
+			bResult = bResult && CheckString(STLW::string(aLengths[iL], 'a'), bECMA, bHTMLSafe);
+		}
+		sName.assign(szMode).append(": clean data");
+		Check(bResult, sName.c_str(), iFailed);
+
+		// One special sequence at every position, including sequences cut by end of data
+		bResult = true;
+		for (UINT_32 iL = 0; iL < sizeof(aLengths) / sizeof(aLengths[0]) && aLengths[iL] <= 257; ++iL)
+		{
+			for (UINT_32 iPos = 0; iPos <= aLengths[iL]; ++iPos)
+			{
+				for (UINT_32 iS = 0; iS < sizeof(aSpecial) / sizeof(aSpecial[0]); ++iS)
+				{
+					STLW::string sData(aLengths[iL], 'x');
+					sData.insert(iPos, aSpecial[iS]);
+					bResult = bResult && CheckString(sData, bECMA, bHTMLSafe);
+				}
+			}
+		}
+		{
+			STLW::string sNul("x\0y", 3);
+			bResult = bResult && CheckString(sNul, bECMA, bHTMLSafe);
+		}
+		sName.assign(szMode).append(": one special sequence");
+		Check(bResult, sName.c_str(), iFailed);
+
+		// Escaped output crosses buffer boundary
+		bResult = true;
+		for (UINT_32 iL = 0; iL < sizeof(aLengths) / sizeof(aLengths[0]); ++iL)
+		{
+			STLW::string sData;
+			for (UINT_32 iPos = 0; sData.size() < aLengths[iL]; ++iPos) { sData.append(aSpecial[iPos % (sizeof(aSpecial) / sizeof(aSpecial[0]))]); }
+			bResult = bResult && CheckString(sData, bECMA, bHTMLSafe);
+
+			for (UINT_32 iShift = 0; iShift < 6; ++iShift)
+			{
+				STLW::string sShifted(C_JSON_SERIALIZER_BUFFER_LEN - 8 + iShift, 'a');
+				sShifted.append(aSpecial[iL % (sizeof(aSpecial) / sizeof(aSpecial[0]))]);
+				sShifted.append(aLengths[iL], 'b');
+				bResult = bResult && CheckString(sShifted, bECMA, bHTMLSafe);
+			}
+		}
+		sName.assign(szMode).append(": buffer boundary");
+		Check(bResult, sName.c_str(), iFailed);
+
+		// Random bytes
+		bResult = true;
+		UINT_32 iSeed = 1;
+		for (UINT_32 iRound = 0; iRound < 200; ++iRound)
+		{
+			const UINT_32 iLength = NextRandom(iSeed) % (3 * C_JSON_SERIALIZER_BUFFER_LEN);
+			STLW::string sData;
+			for (UINT_32 iPos = 0; iPos < iLength; ++iPos)
+			{
+				const UINT_32 iRandom = NextRandom(iSeed);
+				if      (iRandom % 16 == 0) { sData.append(1, CHAR_8(iRandom >> 4)); }
+				else if (iRandom % 16 == 1) { sData.append("\xE2\x80\xA8"); }
+				else                        { sData.append(1, CHAR_8('a' + iRandom % 26)); }
+			}
+			bResult = bResult && CheckString(sData, bECMA, bHTMLSafe);
+		}
+		sName.assign(szMode).append(": random data");
+		Check(bResult, sName.c_str(), iFailed);
+	}
+
+	// Whole CDT
+	{
+		CDT oData;
+		oData["k\"ey"] = "</script>";
+		oData["list"][0] = 1;
+		oData["list"][1] = STLW::string(C_JSON_SERIALIZER_BUFFER_LEN, 'z');
+		oData["list"][2] = CDT(CDT::UNDEF);
+
+		ChunksCollector oCollector;
+		{
+			CTPP2JSONSerializer oSerializer(oCollector);
+			oSerializer.WriteCDT(oData);
+		}
+		const STLW::string sExpected = "{\"k\\\"ey\":\"\\u003c\\/script\\u003e\",\"list\":[1,\"" + STLW::string(C_JSON_SERIALIZER_BUFFER_LEN, 'z') + "\",null]}";
+		Check(oCollector.Joined() == sExpected, "CDT", iFailed);
+	}
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
@@ -0,0 +1,329 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      OutputCallTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CDT.hpp>
+#include <CTPP2FileLogger.hpp>
+#include <CTPP2OutputCollector.hpp>
+#include <CTPP2SimpleCompiler.hpp>
+#include <CTPP2StringOutputCollector.hpp>
+#include <CTPP2SyscallFactory.hpp>
+#include <CTPP2VM.hpp>
+#include <CTPP2VMException.hpp>
+#include <CTPP2VMInstruction.hpp>
+#include <CTPP2VMMemoryCore.hpp>
+#include <CTPP2VMOpcodes.h>
+#include <CTPP2VMSTDLib.hpp>
+#include <CTPP2VMSyscall.hpp>
+#include <STLVector.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+/**
+  @class LegacyHandler
+  @brief Wrapper of library function without OutputHandler; VM calls it as SYSCALL followed by OUTPUT
+*/
+class LegacyHandler:
+  public SyscallHandler
+{
+public:
+	LegacyHandler(SyscallHandler * pIHandler): pHandler(pIHandler) { ;; }
+
+	INT_32 PreExecuteSetup(OutputCollector          & oCollector,
+	                       CDT                      & oCDT,
+	                       const ReducedStaticText  & oSyscalls,
+	                       const ReducedStaticData  & oStaticData,
+	                       const ReducedStaticText  & oStaticText,
+	                       Logger                   & oLogger)
+	{
+		return pHandler -> PreExecuteSetup(oCollector, oCDT, oSyscalls, oStaticData, oStaticText, oLogger);
+	}
+
+	INT_32 Handler(CDT * aArguments, const UINT_32 iArgNum, CDT & oCDTRetVal, Logger & oLogger)
+	{
+		return pHandler -> Handler(aArguments, iArgNum, oCDTRetVal, oLogger);
+	}
+
+	INT_32 ContextHandler(CDT * aArguments, const UINT_32 iArgNum, CDT & oCDTRetVal, const SyscallContext & oContext, Logger & oLogger)
+	{
+		return pHandler -> ContextHandler(aArguments, iArgNum, oCDTRetVal, oContext, oLogger);
+	}
+
+	CCHAR_P GetName() const { return pHandler -> GetName(); }
+
+	INT_32 GetVersion() const { return CTPP2_SYSCALL_API_BASE; }
+
+	~LegacyHandler() throw() { ;; }
+private:
+	/** Library function */
+	SyscallHandler  * pHandler;
+};
+
+/**
+  @class TestCall
+  @brief TEST_CALL(x, y): "x/y"; may declare OutputHandler without implementing it, or fail
+*/
+class TestCall:
+  public SyscallHandler
+{
+public:
+	TestCall(const INT_32 iIVersion, const bool bIFail, const bool bIFailOutput): iVersion(iIVersion),
+	                                                                              bFail(bIFail),
+	                                                                              bFailOutput(bIFailOutput),
+	                                                                              iCalls(0),
+	                                                                              iOutputCalls(0) { ;; }
+
+	INT_32 Handler(CDT * aArguments, const UINT_32 iArgNum, CDT & oCDTRetVal, Logger & oLogger)
+	{
+		++iCalls;
+		if (bFail || iArgNum != 2) { return -1; }
+
+		// Arguments are in reverse order
+		oCDTRetVal = aArguments[1].GetString() + "/" + aArguments[0].GetString();
+		return 0;
+	}
+
+	INT_32 OutputHandler(CDT                   * aArguments,
+	                     const UINT_32           iArgNum,
+	                     OutputCollector       & oCollector,
+	                     const SyscallContext  & oContext,
+	                     Logger                & oLogger)
+	{
+		++iOutputCalls;
+		if (bFailOutput) { oCollector.Collect("partial", 7); return -1; }
+
+		// Default implementation calls ContextHandler
+		return SyscallHandler::OutputHandler(aArguments, iArgNum, oCollector, oContext, oLogger);
+	}
+
+	CCHAR_P GetName() const { return "test_call"; }
+
+	INT_32 GetVersion() const { return iVersion; }
+
+	~TestCall() throw() { ;; }
+
+	/** API version              */
+	const INT_32    iVersion;
+	/** Handler fails            */
+	const bool      bFail;
+	/** OutputHandler fails      */
+	const bool      bFailOutput;
+	/** Number of Handler calls  */
+	UINT_32         iCalls;
+	/** Number of OutputHandler calls */
+	UINT_32         iOutputCalls;
+};
+
+//
+// Render template; returns false if VM throws InvalidSyscall
+//
+static bool Render(const VMMemoryCore * pCore, SyscallFactory & oSyscallFactory, CDT & oData, STLW::string & sResult)
+{
+	StringOutputCollector oCollector(sResult);
+	FileLogger            oLogger(stderr);
+	VM                    oVM(&oSyscallFactory);
+
+	try
+	{
+		UINT_32 iIP = 0;
+		oVM.Init(pCore, &oCollector, &oLogger);
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+	}
+	catch (InvalidSyscall & e) { return false; }
+
+return true;
+}
+
+//
+// Render template with library functions and TEST_CALL
+//
+static bool RenderTestCall(const VMMemoryCore * pCore, TestCall & oTestCall, CDT & oData, STLW::string & sResult)
+{
+	SyscallFactory oSyscallFactory(100);
+	STDLibInitializer::InitLibrary(oSyscallFactory);
+	oSyscallFactory.RegisterHandler(&oTestCall);
+
+	const bool bRendered = Render(pCore, oSyscallFactory, oData, sResult);
+
+	oSyscallFactory.RemoveHandler(oTestCall.GetName());
+	STDLibInitializer::DestroyLibrary(oSyscallFactory);
+
+return bRendered;
+}
+
+//
+// Names of functions called with OUTCALL
+//
+static STLW::string OutputCalls(const VMMemoryCore * pCore)
+{
+	STLW::string sResult;
+	for (UINT_32 iIP = 0; iIP < pCore -> code_size; ++iIP)
+	{
+		if (pCore -> instructions[iIP].instruction != OUTCALL) { continue; }
+
+		UINT_32 iNameLength = 0;
+		CCHAR_P szName = pCore -> syscalls.GetData((pCore -> instructions[iIP].argument & 0xFFFF0000) >> 16, iNameLength);
+		sResult.append(szName, iNameLength).append(" ");
+	}
+
+return sResult;
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc != 3) { fprintf(stderr, "usage: %s outcall.tmpl outcall_custom.tmpl\n", argv[0]); return EX_USAGE; }
+
+	UINT_32 iFailed = 0;
+
+	CDT oData;
+	oData["text"]        = "<b>\"R&D\"</b> 'x'";
+	oData["number"]      = 42;
+	oData["real"]        = 3.25;
+	oData["big"]         = 1234567.891;
+	oData["format"]      = "%d:%.2f:%s";
+	oData["timestamp"]   = 1234567890;
+	oData["format_date"] = "%d.%m.%Y";
+	oData["data"]["name"]    = "</script>";
+	oData["data"]["list"][0] = 1000;
+	oData["data"]["list"][1] = 2500000;
+	oData["data"]["list"][2] = "<i>";
+
+	// Library functions: OUTCALL and OutputHandler versus SYSCALL and OUTPUT
+	{
+		SimpleCompiler oCompiler(argv[1]);
+		const VMMemoryCore * pCore = oCompiler.GetCore();
+
+		const STLW::string sCalls = OutputCalls(pCore);
+		Check(sCalls.find("HTMLESCAPE ") != STLW::string::npos && sCalls.find("JSON ")        != STLW::string::npos &&
+		      sCalls.find("OBJ_DUMP ")   != STLW::string::npos && sCalls.find("SPRINTF ")     != STLW::string::npos &&
+		      sCalls.find("NUM_FORMAT ") != STLW::string::npos && sCalls.find("DATE_FORMAT ") != STLW::string::npos &&
+		      sCalls.find(CTPP2_INT_HANDLER_PREFIX "_sprintf ") != STLW::string::npos, "Calls compiled to OUTCALL", iFailed);
+
+		SyscallFactory oSyscallFactory(100);
+		STDLibInitializer::InitLibrary(oSyscallFactory);
+
+		// Functions that build whole result before output use Handler under OUTCALL
+		Check(oSyscallFactory.GetHandlerByName("htmlescape") -> GetVersion() == CTPP2_SYSCALL_API_OUTPUT &&
+		      oSyscallFactory.GetHandlerByName("sprintf")    -> GetVersion() == CTPP2_SYSCALL_API_BASE   &&
+		      oSyscallFactory.GetHandlerByName("num_format") -> GetVersion() == CTPP2_SYSCALL_API_BASE, "API versions", iFailed);
+
+		SyscallFactory oLegacyFactory(100);
+		STLW::vector<LegacyHandler *> vLegacyHandlers;
+		for (UINT_32 iId = 0; oSyscallFactory.GetHandlerById(iId) != NULL; ++iId)
+		{
+			vLegacyHandlers.push_back(new LegacyHandler(oSyscallFactory.GetHandlerById(iId)));
+			oLegacyFactory.RegisterHandler(vLegacyHandlers.back());
+		}
+
+		STLW::string sOutput;
+		STLW::string sLegacyOutput;
+		const bool bRendered       = Render(pCore, oSyscallFactory, oData, sOutput);
+		const bool bLegacyRendered = Render(pCore, oLegacyFactory,  oData, sLegacyOutput);
+
+		Check(bRendered && bLegacyRendered, "Rendered", iFailed);
+		Check(sOutput == sLegacyOutput, "Same output", iFailed);
+		Check(sOutput.find("[&lt;b&gt;&quot;R&amp;D&quot;&lt;/b&gt; &#39;x&#39;]") != STLW::string::npos, "HTMLESCAPE", iFailed);
+		Check(sOutput.find("[00042|3.250|<b>") != STLW::string::npos && sOutput.find("[42:3.25:<b>") != STLW::string::npos, "SPRINTF", iFailed);
+		Check(sOutput.find("[1,234,567.891]") != STLW::string::npos && sOutput.find("|2,500,000]") != STLW::string::npos, "NUM_FORMAT", iFailed);
+		if (sOutput != sLegacyOutput) { fprintf(stderr, "OUTCALL:\n%s\nSYSCALL:\n%s\n", sOutput.c_str(), sLegacyOutput.c_str()); }
+
+		for (UINT_32 iI = 0; iI < vLegacyHandlers.size(); ++iI) { delete vLegacyHandlers[iI]; }
+		STDLibInitializer::DestroyLibrary(oSyscallFactory);
+	}
+
+	// Custom handlers
+	{
+		SimpleCompiler oCompiler(argv[2]);
+		const VMMemoryCore * pCore = oCompiler.GetCore();
+		Check(OutputCalls(pCore) == "TEST_CALL ", "Custom call compiled to OUTCALL", iFailed);
+
+		// API version below CTPP2_SYSCALL_API_OUTPUT: OutputHandler is never called
+		{
+			TestCall oTestCall(CTPP2_SYSCALL_API_BASE, false, true);
+			STLW::string sOutput;
+			const bool bRendered = RenderTestCall(pCore, oTestCall, oData, sOutput);
+			Check(bRendered && sOutput == "[<b>\"R&D\"</b> 'x'/42]\n" && oTestCall.iOutputCalls == 0 && oTestCall.iCalls == 1, "Old API handler", iFailed);
+		}
+
+		// Default OutputHandler writes result of ContextHandler
+		{
+			TestCall oTestCall(CTPP2_SYSCALL_API_OUTPUT, false, false);
+			STLW::string sOutput;
+			const bool bRendered = RenderTestCall(pCore, oTestCall, oData, sOutput);
+			Check(bRendered && sOutput == "[<b>\"R&D\"</b> 'x'/42]\n" && oTestCall.iOutputCalls == 1 && oTestCall.iCalls == 1, "Default OutputHandler", iFailed);
+		}
+
+		// Error in OutputHandler stops render
+		{
+			TestCall oTestCall(CTPP2_SYSCALL_API_OUTPUT, false, true);
+			STLW::string sOutput;
+			const bool bRendered = RenderTestCall(pCore, oTestCall, oData, sOutput);
+			Check(!bRendered && sOutput == "[partial" && oTestCall.iOutputCalls == 1, "OutputHandler error", iFailed);
+		}
+
+		// Error in default OutputHandler: nothing is written
+		{
+			TestCall oTestCall(CTPP2_SYSCALL_API_OUTPUT, true, false);
+			STLW::string sOutput;
+			const bool bRendered = RenderTestCall(pCore, oTestCall, oData, sOutput);
+			Check(!bRendered && sOutput == "[" && oTestCall.iCalls == 1, "Default OutputHandler error", iFailed);
+		}
+
+		// Error in old API handler
+		{
+			TestCall oTestCall(CTPP2_SYSCALL_API_BASE, true, false);
+			STLW::string sOutput;
+			const bool bRendered = RenderTestCall(pCore, oTestCall, oData, sOutput);
+			Check(!bRendered && sOutput == "[" && oTestCall.iCalls == 1 && oTestCall.iOutputCalls == 0, "Old API handler error", iFailed);
+		}
+	}
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
@@ -0,0 +1,194 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      OutputSizeHintTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CDT.hpp>
+#include <CTPP2FileLogger.hpp>
+#include <CTPP2SimpleCompiler.hpp>
+#include <CTPP2SimpleVM.hpp>
+#include <CTPP2VMMemoryCore.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+/**
+  @struct RenderTask
+  @brief Render of shared memory core in separate thread
+*/
+struct RenderTask
+{
+	/** Shared memory core */
+	const VMMemoryCore  * core;
+	/** Template data      */
+	CDT                 * data;
+	/** Render result      */
+	STLW::string          result;
+};
+
+//
+// Render template with own VM
+//
+static void * RenderThread(void * vTask)
+{
+	RenderTask * pTask = (RenderTask *)vTask;
+
+	SimpleVM   oSimpleVM;
+	FileLogger oLogger(stderr);
+	for (UINT_32 iI = 0; iI < 20; ++iI)
+	{
+		pTask -> result.erase();
+		oSimpleVM.Run(*(pTask -> data), pTask -> core, pTask -> result, oLogger);
+	}
+
+return NULL;
+}
+
+//
+// Estimate after render of given size
+//
+static UINT_32 MoveEstimate(const UINT_32 iEstimate, const UINT_32 iOutputSize)
+{
+	if (iOutputSize >= iEstimate) { return iEstimate + ((iOutputSize - iEstimate) >> 3); }
+
+return iEstimate - ((iEstimate - iOutputSize) >> 3);
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2) { fprintf(stderr, "usage: %s file.tmpl\n", argv[0]); return EX_USAGE; }
+
+	UINT_32 iFailed = 0;
+
+	SimpleCompiler oCompiler(argv[1]);
+	const VMMemoryCore * pCore = oCompiler.GetCore();
+
+	CDT oData;
+	oData["title"] = "Catalog";
+	for (UINT_32 iI = 0; iI < 50; ++iI)
+	{
+		oData["items"][iI]["name"]  = "Item #" + CDT(iI).GetString();
+		oData["items"][iI]["price"] = 10.5 * iI;
+	}
+
+	SimpleVM   oSimpleVM;
+	FileLogger oLogger(stderr);
+
+	Check(pCore -> GetOutputSizeHint() == 0, "No hint before first render", iFailed);
+
+	STLW::string sPage;
+	oSimpleVM.Run(oData, pCore, sPage, oLogger);
+	const UINT_32 iHint = pCore -> GetOutputSizeHint();
+	Check(iHint == sPage.size() + (sPage.size() >> 3), "Hint after first render", iFailed);
+
+	// Estimate moves by 1/8 of difference both ways
+	UINT_32 iEstimate = sPage.size();
+	pCore -> UpdateOutputSize(sPage.size() * 2);
+	iEstimate = MoveEstimate(iEstimate, sPage.size() * 2);
+	Check(pCore -> GetOutputSizeHint() == iEstimate + (iEstimate >> 3), "Hint grows by 1/8 of difference", iFailed);
+	pCore -> UpdateOutputSize(sPage.size());
+	iEstimate = MoveEstimate(iEstimate, sPage.size());
+	Check(pCore -> GetOutputSizeHint() == iEstimate + (iEstimate >> 3), "Hint shrinks by 1/8 of difference", iFailed);
+
+	// Single large render does not make following renders reserve its size
+	pCore -> UpdateOutputSize(sPage.size() * 10);
+	iEstimate = MoveEstimate(iEstimate, sPage.size() * 10);
+	Check(pCore -> GetOutputSizeHint() < sPage.size() * 3, "Hint after single large render", iFailed);
+	for (UINT_32 iI = 0; iI < 24; ++iI)
+	{
+		STLW::string sTMP;
+		oSimpleVM.Run(oData, pCore, sTMP, oLogger);
+		iEstimate = MoveEstimate(iEstimate, sPage.size());
+	}
+	Check(pCore -> GetOutputSizeHint() < sPage.size() + (sPage.size() >> 2), "Hint recovers after large render", iFailed);
+
+	// Result is reserved from hint, after data already in string; hint is far above output size,
+	// so capacity cannot reach it by growth of string while rendering
+	for (UINT_32 iI = 0; iI < 64; ++iI)
+	{
+		pCore -> UpdateOutputSize(sPage.size() * 10);
+		iEstimate = MoveEstimate(iEstimate, sPage.size() * 10);
+	}
+	const UINT_32 iLargeHint = pCore -> GetOutputSizeHint();
+	Check(iLargeHint > sPage.size() * 9, "Hint follows large renders", iFailed);
+
+	STLW::string sResult("prefix");
+	oSimpleVM.Run(oData, pCore, sResult, oLogger);
+	Check(sResult == "prefix" + sPage, "Render appended to string", iFailed);
+	Check(sResult.capacity() >= 6 + iLargeHint, "Result reserved from hint", iFailed);
+
+	// Prefix is not counted as output
+	iEstimate = MoveEstimate(iEstimate, sPage.size());
+	Check(pCore -> GetOutputSizeHint() == iEstimate + (iEstimate >> 3), "Hint after render", iFailed);
+
+#ifdef HAVE_PTHREAD_H
+	// One core shared by VMs in several threads
+	RenderTask aTasks[4];
+	pthread_t  aThreads[4];
+	for (UINT_32 iI = 0; iI < 4; ++iI)
+	{
+		aTasks[iI].core = pCore;
+		aTasks[iI].data = &oData;
+		pthread_create(&aThreads[iI], NULL, RenderThread, &aTasks[iI]);
+	}
+
+	bool bSameResult = true;
+	for (UINT_32 iI = 0; iI < 4; ++iI)
+	{
+		pthread_join(aThreads[iI], NULL);
+		if (aTasks[iI].result != sPage) { bSameResult = false; }
+	}
+	Check(bSameResult, "Shared core: results", iFailed);
+	Check(pCore -> GetOutputSizeHint() >= iHint, "Shared core: hint", iFailed);
+#endif // HAVE_PTHREAD_H
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
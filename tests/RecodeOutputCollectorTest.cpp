@@ -0,0 +1,178 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      RecodeOutputCollectorTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CTPP2RecodeOutputCollector.hpp>
+#include <CTPP2Exception.hpp>
+#include <STLVector.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+//
+// Recode text passing it to collector by pieces of given size
+//
+static STLW::string Recode(const STLW::string  & sText,
+                           CCHAR_P               szCharset,
+                           const UINT_32         iPieceSize,
+                           const UINT_32         iFlags = 0,
+                           const UINT_32         iBlockSize = C_RECODE_COLLECTOR_BLOCK_SIZE,
+                           ChunksCollector     * pTarget = NULL)
+{
+	ChunksCollector oTarget;
+	if (pTarget == NULL) { pTarget = &oTarget; }
+	{
+		RecodeOutputCollector oCollector(*pTarget, "UTF-8", szCharset, iFlags, iBlockSize);
+
+		OutputCollector & oOutput = oCollector;
+		for (UINT_32 iPos = 0; iPos < sText.size(); iPos += iPieceSize)
+		{
+			const UINT_32 iLength = (sText.size() - iPos < iPieceSize) ? sText.size() - iPos : iPieceSize;
+			oOutput.Collect(sText.data() + iPos, iLength);
+		}
+	}
+return pTarget -> Joined();
+}
+
+int main(void)
+{
+	UINT_32 iFailed = 0;
+
+	// "Привет, Ёж!" in UTF-8 and in single-byte charsets
+	const STLW::string sText("\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, \xD0\x81\xD0\xB6!");
+	const STLW::string sCP1251("\xCF\xF0\xE8\xE2\xE5\xF2, \xA8\xE6!");
+	const STLW::string sKOI8R("\xF0\xD2\xC9\xD7\xC5\xD4, \xB3\xD6!");
+	const STLW::string sCP866("\x8F\xE0\xA8\xA2\xA5\xE2, \xF0\xA6!");
+
+	// Table-driven conversion, whole text and sequences split across calls
+	{
+		ChunksCollector oTarget;
+		RecodeOutputCollector oCollector(oTarget, "utf-8", "Windows-1251");
+		Check(oCollector.IsTableDriven(), "Table for CP1251", iFailed);
+	}
+	Check(Recode(sText, "CP1251", sText.size()) == sCP1251, "UTF-8 -> CP1251", iFailed);
+	Check(Recode(sText, "CP1251", 1)            == sCP1251, "UTF-8 -> CP1251, byte at a time", iFailed);
+	Check(Recode(sText, "CP1251", 3)            == sCP1251, "UTF-8 -> CP1251, split sequences", iFailed);
+	Check(Recode(sText, "KOI8-R", sText.size()) == sKOI8R,  "UTF-8 -> KOI8-R", iFailed);
+	Check(Recode(sText, "KOI8-R", 1)            == sKOI8R,  "UTF-8 -> KOI8-R, byte at a time", iFailed);
+	Check(Recode(sText, "koi8r",  5)            == sKOI8R,  "UTF-8 -> KOI8-R, split sequences", iFailed);
+	Check(Recode(sText, "CP866",  sText.size()) == sCP866,  "UTF-8 -> CP866", iFailed);
+	Check(Recode(sText, "IBM866", 1)            == sCP866,  "UTF-8 -> CP866, byte at a time", iFailed);
+	Check(Recode(sText, "CP866",  7)            == sCP866,  "UTF-8 -> CP866, split sequences", iFailed);
+
+	// Three- and four-byte sequences split across calls: "€", "中", U+1F600
+	const STLW::string sWide("\xE2\x82\xAC\xE4\xB8\xAD\xF0\x9F\x98\x80");
+	Check(Recode(sWide, "CP1251", 1) == "\x88", "Unmappable characters are discarded", iFailed);
+	Check(Recode(sWide, "CP1251", 1, C_ICONV_TRANSLITERATE) == "\x88??", "Unknown characters are replaced", iFailed);
+	Check(Recode(sWide, "KOI8-R", 2, C_ICONV_TRANSLITERATE) == "EUR??", "Transliteration, split sequences", iFailed);
+
+	// Invalid UTF-8 is skipped, valid sequence after it is recoded
+	Check(Recode(STLW::string("a\xD0" "b\xC0\xAF" "c\xED\xA0\x80\xD0\x96", 11), "CP1251", 1) == "abc\xC6", "Invalid sequences", iFailed);
+
+	// Transliteration never overflows block: "(TM)" is 4 bytes long
+	{
+		STLW::string sMarks;
+		STLW::string sExpected;
+		for (UINT_32 iI = 0; iI < 37; ++iI)
+		{
+			sMarks.append("x\xE2\x84\xA2");
+			sExpected.append("x(TM)");
+		}
+
+		ChunksCollector oTarget;
+		Check(Recode(sMarks, "KOI8-R", 3, C_ICONV_TRANSLITERATE, 16, &oTarget) == sExpected, "Transliteration: data", iFailed);
+		Check(oTarget.vChunks.size() > 1 && oTarget.MaxChunkSize() <= 16, "Transliteration: block size", iFailed);
+	}
+
+	// ASCII runs longer than block
+	{
+		STLW::string sLong;
+		for (UINT_32 iI = 0; iI < 100; ++iI) { sLong.append("0123456789"); }
+		sLong.append("\xD0\x96");
+
+		ChunksCollector oTarget;
+		Check(Recode(sLong, "CP1251", 333, 0, 64, &oTarget) == sLong.substr(0, 1000) + "\xC6", "Long ASCII run: data", iFailed);
+		Check(oTarget.MaxChunkSize() <= 64, "Long ASCII run: block size", iFailed);
+	}
+
+	// Charset without table is recoded with iconv
+#ifdef ICONV_SUPPORT
+	{
+		ChunksCollector oTarget;
+		RecodeOutputCollector oCollector(oTarget, "UTF-8", "UTF-16BE");
+		Check(!oCollector.IsTableDriven(), "No table for UTF-16BE", iFailed);
+	}
+	{
+		ChunksCollector oTarget;
+		RecodeOutputCollector oCollector(oTarget, "UTF-8", "CP1251//TRANSLIT");
+		Check(!oCollector.IsTableDriven(), "No table for iconv suffixes", iFailed);
+	}
+
+	const STLW::string sUTF16("\x04\x1F\x04\x40\x04\x38\x04\x32\x04\x35\x04\x42\x00\x2C\x00\x20\x04\x01\x04\x36\x00\x21", 22);
+	Check(Recode(sText, "UTF-16BE", sText.size()) == sUTF16, "UTF-8 -> UTF-16BE", iFailed);
+	Check(Recode(sText, "UTF-16BE", 1)            == sUTF16, "UTF-8 -> UTF-16BE, byte at a time", iFailed);
+	Check(Recode(sText, "UTF-16BE", 3, 0, 16)     == sUTF16, "UTF-8 -> UTF-16BE, small block", iFailed);
+	Check(Recode(sText, "KOI8-U",   1, 0, 16)     == sKOI8R, "UTF-8 -> KOI8-U", iFailed);
+
+	// Incomplete sequence at end of data is discarded
+	Check(Recode(STLW::string("\xD0\x9F\xD1"), "UTF-16BE", 1) == STLW::string("\x04\x1F", 2), "Incomplete sequence at end", iFailed);
+#endif // ICONV_SUPPORT
+
+	// Unknown charset
+	bool bThrown = false;
+	try
+	{
+		ChunksCollector oTarget;
+		RecodeOutputCollector oCollector(oTarget, "UTF-8", "NO-SUCH-CHARSET");
+	}
+	catch (CTPPCharsetRecodeException & e) { bThrown = true; }
+	Check(bThrown, "Unknown charset", iFailed);
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
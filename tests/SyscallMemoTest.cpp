@@ -0,0 +1,237 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      SyscallMemoTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CDT.hpp>
+#include <CTPP2FileLogger.hpp>
+#include <CTPP2SimpleCompiler.hpp>
+#include <CTPP2StringOutputCollector.hpp>
+#include <CTPP2SyscallFactory.hpp>
+#include <CTPP2SyscallMemo.hpp>
+#include <CTPP2VM.hpp>
+#include <CTPP2VMMemoryCore.hpp>
+#include <CTPP2VMSTDLib.hpp>
+#include <CTPP2VMSyscall.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+/**
+  @class CountCall
+  @brief COUNT_CALL(x): "x#N", where N is number of call; arrays and hashes are printed as "H"
+*/
+class CountCall:
+  public SyscallHandler
+{
+public:
+	CountCall(const UINT_32 iICapabilities): iCapabilities(iICapabilities), iCalls(0) { ;; }
+
+	INT_32 Handler(CDT * aArguments, const UINT_32 iArgNum, CDT & oCDTRetVal, Logger & oLogger)
+	{
+		if (iArgNum != 1) { return -1; }
+
+		++iCalls;
+		CHAR_8 szCall[32];
+		snprintf(szCall, 32, "#%u", iCalls);
+
+		const bool bContainer = aArguments[0].GetType() == CDT::ARRAY_VAL || aArguments[0].GetType() == CDT::HASH_VAL;
+		oCDTRetVal = (bContainer ? STLW::string("H") : aArguments[0].GetString()) + szCall;
+		return 0;
+	}
+
+	CCHAR_P GetName() const { return "count_call"; }
+
+	UINT_32 GetCapabilities() const { return iCapabilities; }
+
+	~CountCall() throw() { ;; }
+
+	/** Capabilities of function */
+	const UINT_32   iCapabilities;
+	/** Number of calls          */
+	UINT_32         iCalls;
+};
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2) { fprintf(stderr, "usage: %s memo.tmpl\n", argv[0]); return EX_USAGE; }
+
+	UINT_32 iFailed = 0;
+
+	// Stored results
+	{
+		SyscallMemo oMemo;
+		CDT aArguments[2];
+		aArguments[0] = "abc";
+		aArguments[1] = 42;
+
+		CDT oResult;
+		Check(!oMemo.Find(1, aArguments, 2, oResult), "Empty storage", iFailed);
+		oMemo.Store("result");
+		Check(oMemo.Find(1, aArguments, 2, oResult) && oResult.GetString() == "result", "Same call found", iFailed);
+
+		CDT aOtherArguments[2];
+		aOtherArguments[0] = "abc";
+		aOtherArguments[1] = 42.0;
+		Check(!oMemo.Find(1, aOtherArguments, 2, oResult), "Types of arguments compared", iFailed);
+		Check(!oMemo.Find(2, aArguments,      2, oResult), "Numbers of calls compared", iFailed);
+		Check(!oMemo.Find(1, aArguments,      1, oResult), "Numbers of arguments compared", iFailed);
+
+		// Store without preceding failed Find is ignored
+		oMemo.Store("other");
+		Check(oMemo.Find(1, aArguments, 2, oResult) && oResult.GetString() == "result", "Store after successful Find ignored", iFailed);
+
+		CDT aPointer[1];
+		aPointer[0] = CDT((void *)&oMemo);
+		Check(!oMemo.Find(3, aPointer, 1, oResult), "Pointer not compared", iFailed);
+		oMemo.Store("pointer");
+		Check(!oMemo.Find(3, aPointer, 1, oResult), "Pointer not stored", iFailed);
+
+		oMemo.Clear();
+		Check(!oMemo.Find(1, aArguments, 2, oResult), "Clear", iFailed);
+	}
+
+	// Arrays and hashes are compared by identity
+	{
+		SyscallMemo oMemo;
+		CDT aArguments[1];
+		aArguments[0]["key"] = "value";
+
+		CDT oResult;
+		oMemo.Find(1, aArguments, 1, oResult);
+		oMemo.Store("hash");
+
+		CDT aCopy[1];
+		aCopy[0] = aArguments[0];
+		Check(oMemo.Find(1, aCopy, 1, oResult) && oResult.GetString() == "hash", "Copy of hash found", iFailed);
+
+		CDT aEqual[1];
+		aEqual[0]["key"] = "value";
+		Check(!oMemo.Find(1, aEqual, 1, oResult), "Equal hash not found", iFailed);
+		oMemo.Store("equal hash");
+
+		// Changed copy gets own data
+		aCopy[0]["key"] = "changed";
+		Check(!oMemo.Find(1, aCopy, 1, oResult), "Changed hash not found", iFailed);
+		oMemo.Store("changed hash");
+		Check(oMemo.Find(1, aArguments, 1, oResult) && oResult.GetString() == "hash", "Original hash found", iFailed);
+	}
+
+	SimpleCompiler oCompiler(argv[1]);
+	const VMMemoryCore * pCore = oCompiler.GetCore();
+
+	CDT oData;
+	oData["number"]           = 42;
+	oData["text"]             = "x";
+	oData["data"]["key"]      = "value";
+	oData["other"]["key"]     = "value";
+
+	SyscallFactory oSyscallFactory(100);
+	STDLibInitializer::InitLibrary(oSyscallFactory);
+
+	// Results of pure costly calls are reused during render
+	{
+		CountCall oCountCall(CTPP2_SYSCALL_PURE | CTPP2_SYSCALL_COSTLY);
+		oSyscallFactory.RegisterHandler(&oCountCall);
+
+		STLW::string sResult;
+		StringOutputCollector oCollector(sResult);
+		FileLogger            oLogger(stderr);
+		VM                    oVM(&oSyscallFactory);
+
+		UINT_32 iIP = 0;
+		oVM.Init(pCore, &oCollector, &oLogger);
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+		Check(sResult == "[42#1|42#1|x#2|H#3|H#3|H#4|42#1#5]\n" && oCountCall.iCalls == 5, "Repeated calls", iFailed);
+
+		// Init clears stored results
+		sResult.erase();
+		iIP = 0;
+		oVM.Init(pCore, &oCollector, &oLogger);
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+		Check(sResult == "[42#6|42#6|x#7|H#8|H#8|H#9|42#6#10]\n", "Init clears results", iFailed);
+
+		// Reset clears stored results
+		sResult.erase();
+		iIP = 0;
+		oVM.Reset();
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+		Check(sResult == "[42#11|42#11|x#12|H#13|H#13|H#14|42#11#15]\n", "Reset clears results", iFailed);
+
+		// Disabled reuse
+		sResult.erase();
+		iIP = 0;
+		oVM.SetMemoization(false);
+		oVM.Init(pCore, &oCollector, &oLogger);
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+		Check(sResult == "[42#16|42#17|x#18|H#19|H#20|H#21|42#22#23]\n", "SetMemoization(false)", iFailed);
+
+		oSyscallFactory.RemoveHandler(oCountCall.GetName());
+	}
+
+	// Results of calls that are not costly are not stored
+	{
+		CountCall oCountCall(CTPP2_SYSCALL_PURE);
+		oSyscallFactory.RegisterHandler(&oCountCall);
+
+		STLW::string sResult;
+		StringOutputCollector oCollector(sResult);
+		FileLogger            oLogger(stderr);
+		VM                    oVM(&oSyscallFactory);
+
+		UINT_32 iIP = 0;
+		oVM.Init(pCore, &oCollector, &oLogger);
+		oVM.Run(pCore, &oCollector, iIP, oData, &oLogger);
+		Check(oCountCall.iCalls == 8, "Pure call not stored", iFailed);
+
+		oSyscallFactory.RemoveHandler(oCountCall.GetName());
+	}
+
+	STDLibInitializer::DestroyLibrary(oSyscallFactory);
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.
@@ -0,0 +1,211 @@
+/*-
+ * Copyright (c) 2006, 2007 CTPP Team
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 4. Neither the name of the CTPP Team nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *      ThreadLocalTest.cpp
+ *
+ * $CTPP$
+ */
+#include <CTPP2ThreadLocal.hpp>
+
+#include "CTPP2TestUtil.hpp"
+
+#include <stdio.h>
+
+#ifdef HAVE_SYSEXITS_H
+#include <sysexits.h>
+#endif
+
+using namespace CTPP;
+
+#ifdef HAVE_PTHREAD_H
+
+// Number of worker threads
+#define C_TEST_THREADS 4
+
+// Live copies of object
+static INT_32           iLiveObjects = 0;
+static pthread_mutex_t  oCounterMutex = PTHREAD_MUTEX_INITIALIZER;
+
+//
+// Object that counts its copies
+//
+struct CountedObject
+{
+	CountedObject()           { pthread_mutex_lock(&oCounterMutex); ++iLiveObjects; pthread_mutex_unlock(&oCounterMutex); }
+	~CountedObject() throw()  { pthread_mutex_lock(&oCounterMutex); --iLiveObjects; pthread_mutex_unlock(&oCounterMutex); }
+};
+
+static INT_32 LiveObjects()
+{
+	pthread_mutex_lock(&oCounterMutex);
+	const INT_32 iResult = iLiveObjects;
+	pthread_mutex_unlock(&oCounterMutex);
+
+return iResult;
+}
+
+//
+// Worker: takes its copy, reports it and waits for permission to exit
+//
+struct Worker
+{
+	ThreadLocal<CountedObject>  * holder;
+	CountedObject               * first;
+	CountedObject               * second;
+	pthread_mutex_t             * mutex;
+	pthread_cond_t              * cond;
+	INT_32                      * ready;
+	bool                        * release;
+};
+
+static void * WorkerThread(void * pData)
+{
+	Worker * pWorker = (Worker *)pData;
+
+	pWorker -> first  = pWorker -> holder -> Get();
+	pWorker -> second = pWorker -> holder -> Get();
+
+	pthread_mutex_lock(pWorker -> mutex);
+	++(*(pWorker -> ready));
+	pthread_cond_broadcast(pWorker -> cond);
+	while (!*(pWorker -> release)) { pthread_cond_wait(pWorker -> cond, pWorker -> mutex); }
+	pthread_mutex_unlock(pWorker -> mutex);
+
+return NULL;
+}
+
+//
+// Start workers and wait until every one has its copy
+//
+static void StartWorkers(ThreadLocal<CountedObject> * pHolder, pthread_t * aThreads, Worker * aWorkers,
+                         pthread_mutex_t & oMutex, pthread_cond_t & oCond, INT_32 & iReady, bool & bRelease)
+{
+	iReady   = 0;
+	bRelease = false;
+	for (UINT_32 iPos = 0; iPos < C_TEST_THREADS; ++iPos)
+	{
+		Worker oWorker = { pHolder, NULL, NULL, &oMutex, &oCond, &iReady, &bRelease };
+		aWorkers[iPos] = oWorker;
+		pthread_create(&aThreads[iPos], NULL, WorkerThread, &aWorkers[iPos]);
+	}
+
+	pthread_mutex_lock(&oMutex);
+	while (iReady != C_TEST_THREADS) { pthread_cond_wait(&oCond, &oMutex); }
+	pthread_mutex_unlock(&oMutex);
+}
+
+//
+// Let workers exit
+//
+static void StopWorkers(pthread_t * aThreads, pthread_mutex_t & oMutex, pthread_cond_t & oCond, bool & bRelease)
+{
+	pthread_mutex_lock(&oMutex);
+	bRelease = true;
+	pthread_cond_broadcast(&oCond);
+	pthread_mutex_unlock(&oMutex);
+
+	for (UINT_32 iPos = 0; iPos < C_TEST_THREADS; ++iPos) { pthread_join(aThreads[iPos], NULL); }
+}
+
+#endif // HAVE_PTHREAD_H
+
+int main(void)
+{
+	UINT_32 iFailed = 0;
+
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_t oMutex = PTHREAD_MUTEX_INITIALIZER;
+	pthread_cond_t  oCond  = PTHREAD_COND_INITIALIZER;
+	pthread_t       aThreads[C_TEST_THREADS];
+	Worker          aWorkers[C_TEST_THREADS];
+	INT_32          iReady   = 0;
+	bool            bRelease = false;
+
+	// One copy per thread, destroyed on thread exit
+	{
+		ThreadLocal<CountedObject> oHolder;
+		CountedObject * pMain = oHolder.Get();
+		Check(pMain != NULL && oHolder.Get() == pMain && LiveObjects() == 1, "Copy of main thread", iFailed);
+
+		StartWorkers(&oHolder, aThreads, aWorkers, oMutex, oCond, iReady, bRelease);
+		bool bDistinct = true;
+		for (UINT_32 iPos = 0; iPos < C_TEST_THREADS; ++iPos)
+		{
+			if (aWorkers[iPos].first == NULL || aWorkers[iPos].first != aWorkers[iPos].second || aWorkers[iPos].first == pMain) { bDistinct = false; }
+			for (UINT_32 iOther = 0; iOther < iPos; ++iOther) { if (aWorkers[iPos].first == aWorkers[iOther].first) { bDistinct = false; } }
+		}
+		Check(bDistinct && LiveObjects() == 1 + C_TEST_THREADS, "Copies of workers", iFailed);
+
+		StopWorkers(aThreads, oMutex, oCond, bRelease);
+		Check(LiveObjects() == 1, "Copies destroyed on thread exit", iFailed);
+	}
+	Check(LiveObjects() == 0, "Copy of main thread destroyed with holder", iFailed);
+
+	// Holder destroys copies of threads that are still running
+	{
+		ThreadLocal<CountedObject> * pHolder = new ThreadLocal<CountedObject>();
+		StartWorkers(pHolder, aThreads, aWorkers, oMutex, oCond, iReady, bRelease);
+		Check(LiveObjects() == C_TEST_THREADS, "Copies of running workers", iFailed);
+
+		delete pHolder;
+		Check(LiveObjects() == 0, "Copies of running workers destroyed with holder", iFailed);
+
+		StopWorkers(aThreads, oMutex, oCond, bRelease);
+		Check(LiveObjects() == 0, "No copy destroyed twice on thread exit", iFailed);
+	}
+
+	// No cache when all keys of thread-specific data are in use
+	{
+		STLW::vector<pthread_key_t> vKeys;
+		pthread_key_t oKey;
+		while (vKeys.size() < 1000000 && pthread_key_create(&oKey, NULL) == 0) { vKeys.push_back(oKey); }
+
+		{
+			ThreadLocal<CountedObject> oHolder;
+			Check(oHolder.Get() == NULL && LiveObjects() == 0, "Keys exhausted", iFailed);
+		}
+
+		for (UINT_32 iPos = 0; iPos < vKeys.size(); ++iPos) { pthread_key_delete(vKeys[iPos]); }
+
+		ThreadLocal<CountedObject> oHolder;
+		Check(oHolder.Get() != NULL && LiveObjects() == 1, "Keys available again", iFailed);
+	}
+#endif // HAVE_PTHREAD_H
+
+	INT_32 iExitCode = EX_SOFTWARE;
+
+	if (iFailed == 0) { fprintf(stdout, "OK\n"); iExitCode = EX_OK; }
+	else              { fprintf(stdout, "FAILED\n"); }
+
+	// make valgrind happy
+	fclose(stdin);
+	fclose(stdout);
+	fclose(stderr);
+
+return iExitCode;
+}
+// End.